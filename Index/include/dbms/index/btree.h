@@ -0,0 +1,179 @@
+#ifndef DBMS_INDEX_BTREE_H_
+#define DBMS_INDEX_BTREE_H_
+
+/**
+ * @file btree.h
+ * @brief 磁盘 B+ 树索引：int64 键 → RID，存放在独立的段中，节点页经 BufferPoolManager 读写。
+ *
+ * 结构（Lehman-Yao B-link）：每层节点以右链相连，并各带上界（high key）；
+ * 段内第 0 页为元页，记录根节点与树高。节点格式见 internal/btree_node.h。
+ *
+ * 并发：
+ *  - 读（Find / Get / Scan）不加闩锁：逐节点乐观读（ReadPageGuard::Read），拷出下一跳后即放开；
+ *    读到的节点若已被分裂（键大于上界），沿右链右移即可，无需自顶向下加锁耦合；
+ *  - Insert / Erase 乐观下降到叶子，只对叶子加写闩锁；分裂时再持有新建的右节点，
+ *    写好两个节点后全部放开，再去父节点插入分隔键（父节点同样可能需要右移）。
+ *    任何时刻至多持有两个写闩锁，且第二个总是尚不可达的新页，写者之间不会成环；
+ *  - 节点只分裂不合并：Erase 只从叶子删除条目，空叶子保留在链上（扫描时跳过）。
+ *
+ * 唯一索引（BTreeOptions::unique）只按键排序，重复键插入返回 InvalidArgument；
+ * 非唯一索引按 (key, rid) 排序，同一 (key, rid) 重复插入同样返回 InvalidArgument。
+ */
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "dbms/storage/storage_types.h"
+
+namespace dbms {
+namespace storage {
+class BufferPoolManager;
+class SegmentManager;
+class WritePageGuard;
+}  // namespace storage
+
+namespace index {
+
+using storage::page_id_t;
+using storage::RID;
+using storage::seg_id_t;
+using storage::Status;
+
+struct NodeKey;
+class BTree;
+
+struct BTreeOptions {
+  bool unique = false;  ///< 须与段内已有索引一致，否则 Open 返回 InvalidArgument
+};
+
+struct BTreeEntry {
+  int64_t key{0};
+  RID     rid{};
+};
+
+struct BTreeStats {
+  uint32_t height{0};       ///< 层数（只有一个叶子时为 1）
+  uint64_t entries{0};
+  uint64_t leaf_pages{0};
+  uint64_t inner_pages{0};
+  double   leaf_fill{0};    ///< 叶子平均填充率（条目数 / 容量）
+};
+
+/**
+ * @brief 区间扫描：按 (key, rid) 升序给出 [lo, hi] 内的条目。
+ *
+ * 每次从一个叶子拷出一批条目，之后沿右链前进，从上一条之后继续；
+ * 与并发插入交错时不会重复或乱序，但未必看到扫描开始后插入的条目。
+ */
+class BTreeIterator {
+public:
+  BTreeIterator(BTreeIterator&&) noexcept = default;
+  BTreeIterator& operator=(BTreeIterator&&) noexcept = default;
+  BTreeIterator(const BTreeIterator&) = delete;
+  BTreeIterator& operator=(const BTreeIterator&) = delete;
+
+  /// 前进到下一条；扫完或出错返回 false（出错时 status() 非 OK）
+  bool Next();
+
+  int64_t       key()    const noexcept { return buf_[pos_ - 1].key; }
+  const RID&    rid()    const noexcept { return buf_[pos_ - 1].rid; }
+  const Status& status() const noexcept { return status_; }
+
+private:
+  friend class BTree;
+  BTreeIterator(const BTree* tree, int64_t lo, int64_t hi);
+
+  bool FillFromNextLeaf();
+
+  const BTree*            tree_{nullptr};
+  int64_t                 lo_{0};
+  int64_t                 hi_{0};
+  page_id_t               leaf_{storage::kInvalidPageId};  // 下一个要读的叶子
+  std::vector<BTreeEntry> buf_;                             // 当前叶子中尚未返回的条目
+  size_t                  pos_{0};
+  BTreeEntry              last_{};                          // 上一条返回的条目（started_ 时有效）
+  bool                    started_{false};
+  bool                    done_{false};
+  Status                  status_{};
+};
+
+class BTree {
+public:
+  /**
+   * @brief 打开段 seg 上的索引；段为空时初始化元页与一个空的根叶子。
+   * @note  段须专供本索引使用；bpm、sm 在 BTree 存续期间须保持有效
+   */
+  static Status Open(seg_id_t seg, storage::BufferPoolManager* bpm, storage::SegmentManager* sm,
+                     const BTreeOptions& opt, std::unique_ptr<BTree>* out);
+
+  BTree(const BTree&) = delete;
+  BTree& operator=(const BTree&) = delete;
+
+  /// 插入一条；重复条目返回 InvalidArgument（规则见文件头）
+  Status Insert(int64_t key, const RID& rid);
+  /// 删除 (key, rid)；不存在返回 NotFound
+  Status Erase(int64_t key, const RID& rid);
+
+  /// 键为 key 的第一条（非唯一索引为 RID 最小的一条）；不存在返回 NotFound
+  Status Find(int64_t key, RID* out) const;
+  /// 把键为 key 的所有 RID 按升序追加到 out（没有时 out 不变，返回 OK）
+  Status Get(int64_t key, std::vector<RID>* out) const;
+  /// 键在 [lo, hi] 内的条目
+  BTreeIterator Scan(int64_t lo, int64_t hi) const;
+
+  /**
+   * @brief 由已排序的条目自底向上构建整棵树：叶子按顺序写满（至 fill 比例）并分配在连续页上，
+   *        再逐层建内部节点。
+   * @param sorted 按 (key, rid) 严格升序（唯一索引按 key 严格升序），否则返回 InvalidArgument
+   * @param fill   每个节点的目标填充率 (0, 1]；留出空间可减少之后插入引起的分裂
+   * @note  只能用于空树，且构建期间不得有其他访问
+   */
+  Status BulkBuild(const std::vector<BTreeEntry>& sorted, double fill = 1.0);
+
+  /// 段元数据落盘（页数、空闲区段）；调用方须先把索引页写回（BufferPoolManager::FlushAll）
+  Status Checkpoint();
+
+  /// 逐层沿右链遍历统计（读遍所有节点，观测用）
+  Status GetStats(BTreeStats* out) const;
+
+  seg_id_t seg_id()         const noexcept { return seg_; }
+  bool     unique()         const noexcept { return unique_; }
+  uint32_t leaf_capacity()  const noexcept { return leaf_cap_; }
+  uint32_t inner_capacity() const noexcept { return inner_cap_; }
+
+private:
+  friend class BTreeIterator;
+  BTree(seg_id_t seg, storage::BufferPoolManager* bpm, storage::SegmentManager* sm, bool unique);
+
+  struct Root {
+    page_id_t pid{storage::kInvalidPageId};
+    uint32_t  level{0};
+  };
+
+  Status Init();
+  Status ReadRoot(Root* out) const;
+  Status Descend(const NodeKey& k, uint32_t level, std::vector<page_id_t>* path, page_id_t* out) const;
+  Status LatchCovering(const NodeKey& k, uint32_t level, page_id_t pid, storage::WritePageGuard* g) const;
+  Status InsertAt(NodeKey k, page_id_t child, uint32_t level, page_id_t pid, const std::vector<page_id_t>& path);
+  void   InsertIntoNode(std::uint8_t* page, uint32_t level, uint32_t idx, const NodeKey& k, page_id_t child) const;
+  Status Split(storage::WritePageGuard* left, uint32_t level, uint32_t idx, const NodeKey& k, page_id_t child,
+               NodeKey* out_sep, page_id_t* out_right);
+  Status ParentOf(const NodeKey& sep, page_id_t left, page_id_t right, uint32_t level,
+                  const std::vector<page_id_t>& path, page_id_t* out_parent, bool* out_grown);
+  Status GrowRoot(page_id_t old_root, uint32_t level, const NodeKey& sep, page_id_t right, bool* out_grown);
+
+private:
+  seg_id_t                    seg_;
+  storage::BufferPoolManager* bpm_;
+  storage::SegmentManager*    sm_;
+  bool                        unique_;
+  uint32_t                    page_size_;
+  uint32_t                    leaf_cap_;
+  uint32_t                    inner_cap_;
+};
+
+}  // namespace index
+}  // namespace dbms
+
+#endif  // DBMS_INDEX_BTREE_H_
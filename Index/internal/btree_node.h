@@ -0,0 +1,134 @@
+#ifndef DBMS_INDEX_INTERNAL_BTREE_NODE_H_
+#define DBMS_INDEX_INTERNAL_BTREE_NODE_H_
+
+/**
+ * @file btree_node.h
+ * @brief B+ 树（B-link）节点与元页的页内布局。
+ *
+ * 物理布局：
+ *  - 元页（段内第 0 页）：[ PageHeader | BTreeMeta ]，记录根节点页号与根所在层；
+ *  - 叶子：[ PageHeader | NodeHeader | NodeKey × leaf_capacity ]；
+ *  - 内部节点：[ PageHeader | NodeHeader | NodeKey × inner_capacity | page_id_t × (inner_capacity + 1) ]。
+ *
+ * 关键约定（Lehman-Yao B-link）：
+ *  - PageHeader::slot_count 为节点内的条目数（内部节点为分隔键数，孩子数 = 条目数 + 1）；
+ *  - 每个节点有右链 right 与上界 high：节点只含 <= high 的键，大于 high 的键到右兄弟去找；
+ *    本层最右的节点没有上界（kHasHigh 未置位）；
+ *  - 内部节点第 i 个孩子覆盖 (key[i-1], key[i]]，即找 k 时下到 LowerBound(k) 号孩子；
+ *  - 节点只分裂、不合并，页不回收：读者拿到的页号总指向某个仍在树中的节点。
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "dbms/storage/storage_types.h"
+#include "dbms/storage/page/page.h"
+
+namespace dbms {
+namespace index {
+
+using storage::page_id_t;
+using storage::kInvalidPageId;
+
+constexpr page_id_t kMetaPageId    = 0;
+constexpr uint32_t  kBTreeMagic    = 0x58444942;  // "BIDX"
+constexpr uint32_t  kBTreeVersion  = 1;
+constexpr uint32_t  kNodeMagic     = 0x45444F4E;  // "NODE"
+constexpr uint16_t  kHasHigh       = 1;           // NodeHeader::flags：high 有效
+constexpr uint32_t  kMetaUnique    = 1;           // BTreeMeta::flags：唯一索引
+
+/// 复合键 (key, rid)：非唯一索引按整体排序（同键的多条记录按 RID 排开），唯一索引只比较 key
+struct NodeKey {
+  int64_t  key{0};
+  uint32_t page{0};
+  uint16_t slot{0};
+  uint16_t pad{0};
+};
+static_assert(sizeof(NodeKey) == 16, "NodeKey is part of the on-disk format.");
+
+inline int CompareNodeKey(const NodeKey& a, const NodeKey& b, bool unique) {
+  if (a.key != b.key) return a.key < b.key ? -1 : 1;
+  if (unique) return 0;
+  if (a.page != b.page) return a.page < b.page ? -1 : 1;
+  if (a.slot != b.slot) return a.slot < b.slot ? -1 : 1;
+  return 0;
+}
+
+struct NodeHeader {
+  storage::PageHeader page;                 // slot_count 为条目数
+  uint32_t            magic{kNodeMagic};
+  uint16_t            level{0};             // 0 为叶子
+  uint16_t            flags{0};             // kHasHigh
+  page_id_t           right{kInvalidPageId};
+  uint32_t            reserved{0};
+  NodeKey             high{};
+};
+static_assert(sizeof(NodeHeader) == 64, "NodeHeader is part of the on-disk format.");
+
+struct BTreeMeta {
+  storage::PageHeader page;
+  uint32_t            magic{kBTreeMagic};
+  uint32_t            version{kBTreeVersion};
+  uint32_t            page_size{0};
+  uint32_t            flags{0};             // kMetaUnique
+  page_id_t           root{kInvalidPageId};
+  uint32_t            root_level{0};
+};
+
+/// 各容量只取决于页大小
+inline uint32_t LeafCapacity(uint32_t page_size) {
+  return static_cast<uint32_t>((page_size - sizeof(NodeHeader)) / sizeof(NodeKey));
+}
+inline uint32_t InnerCapacity(uint32_t page_size) {
+  return static_cast<uint32_t>((page_size - sizeof(NodeHeader) - sizeof(page_id_t)) /
+                               (sizeof(NodeKey) + sizeof(page_id_t)));
+}
+
+/**
+ * @brief 节点页适配器（不拥有内存）。
+ *
+ * 读取一律 memcpy：乐观读时页可能正被改写，调用方先以 count() 与容量比较再访问条目。
+ */
+class NodeView {
+public:
+  NodeView(const std::uint8_t* page, uint32_t inner_capacity)
+      : page_(page), inner_cap_(inner_capacity) {}
+
+  NodeHeader header() const { NodeHeader h; std::memcpy(&h, page_, sizeof(h)); return h; }
+
+  NodeKey key(uint32_t i) const {
+    NodeKey k;
+    std::memcpy(&k, page_ + sizeof(NodeHeader) + static_cast<size_t>(i) * sizeof(NodeKey), sizeof(k));
+    return k;
+  }
+  page_id_t child(uint32_t i) const {
+    page_id_t c;
+    std::memcpy(&c, page_ + ChildOffset(inner_cap_) + static_cast<size_t>(i) * sizeof(page_id_t), sizeof(c));
+    return c;
+  }
+
+  /// 前 count 个键中第一个 >= k 的位置
+  uint32_t LowerBound(uint32_t count, const NodeKey& k, bool unique) const {
+    uint32_t lo = 0, hi = count;
+    while (lo < hi) {
+      const uint32_t mid = lo + (hi - lo) / 2;
+      if (CompareNodeKey(key(mid), k, unique) < 0) lo = mid + 1;
+      else hi = mid;
+    }
+    return lo;
+  }
+
+  static size_t ChildOffset(uint32_t inner_capacity) {
+    return sizeof(NodeHeader) + static_cast<size_t>(inner_capacity) * sizeof(NodeKey);
+  }
+
+private:
+  const std::uint8_t* page_;
+  uint32_t            inner_cap_;
+};
+
+}  // namespace index
+}  // namespace dbms
+
+#endif  // DBMS_INDEX_INTERNAL_BTREE_NODE_H_
@@ -0,0 +1,606 @@
+#include "dbms/index/btree.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "dbms/storage/buffer/buffer_pool_manager.h"
+#include "dbms/storage/buffer/page_guard.h"
+#include "dbms/storage/segment/segment_manager.h"
+#include "internal/btree_node.h"
+
+namespace dbms {
+namespace index {
+
+using storage::BufferPoolManager;
+using storage::ReadPageGuard;
+using storage::SegmentManager;
+using storage::WritePageGuard;
+
+namespace {
+
+NodeKey MakeKey(int64_t key, const RID& rid) {
+  NodeKey k;
+  k.key  = key;
+  k.page = rid.page_id;
+  k.slot = rid.slot;
+  return k;
+}
+NodeKey MakeKey(const BTreeEntry& e) { return MakeKey(e.key, e.rid); }
+
+/// 键为 key 的所有复合键中最小的一个（RID 全 0）
+NodeKey LowKey(int64_t key) { return MakeKey(key, RID{}); }
+
+NodeHeader* Header(std::uint8_t* p)  { return reinterpret_cast<NodeHeader*>(p); }
+NodeKey*    Keys(std::uint8_t* p)    { return reinterpret_cast<NodeKey*>(p + sizeof(NodeHeader)); }
+page_id_t*  Children(std::uint8_t* p, uint32_t inner_cap) {
+  return reinterpret_cast<page_id_t*>(p + NodeView::ChildOffset(inner_cap));
+}
+
+void InitNode(std::uint8_t* p, page_id_t pid, uint32_t level, uint32_t page_size) {
+  std::memset(p, 0, page_size);
+  NodeHeader h;
+  h.page.page_id = pid;
+  h.level        = static_cast<uint16_t>(level);
+  std::memcpy(p, &h, sizeof(h));
+}
+
+std::string PageName(seg_id_t seg, page_id_t pid) {
+  return std::to_string(seg) + ":" + std::to_string(pid);
+}
+
+}  // namespace
+
+// ------------------------------ 打开 / 元页 ------------------------------
+
+BTree::BTree(seg_id_t seg, BufferPoolManager* bpm, SegmentManager* sm, bool unique)
+    : seg_(seg), bpm_(bpm), sm_(sm), unique_(unique), page_size_(bpm->page_size()),
+      leaf_cap_(LeafCapacity(page_size_)), inner_cap_(InnerCapacity(page_size_)) {}
+
+Status BTree::Open(seg_id_t seg, BufferPoolManager* bpm, SegmentManager* sm,
+                   const BTreeOptions& opt, std::unique_ptr<BTree>* out) {
+  if (!bpm || !sm || !out) return Status::InvalidArgument("BTree::Open: null argument");
+  if (bpm->page_size() != sm->page_size()) return Status::InvalidArgument("BTree::Open: page size mismatch");
+  // 分裂至少要把一个节点分成两个非空的半边
+  if (bpm->page_size() < sizeof(BTreeMeta) || InnerCapacity(bpm->page_size()) < 4) {
+    return Status::InvalidArgument("BTree::Open: page too small for index nodes");
+  }
+  if (Status s = sm->EnsureSegment(seg); !s.ok()) return s;
+  std::unique_ptr<BTree> tree(new BTree(seg, bpm, sm, opt.unique));
+  if (Status s = tree->Init(); !s.ok()) return s;
+  *out = std::move(tree);
+  return Status::OK();
+}
+
+Status BTree::Init() {
+  if (sm_->PageCount(seg_) == 0) {
+    const page_id_t meta = sm_->AllocatePage(seg_);
+    const page_id_t root = sm_->AllocatePage(seg_);
+    if (meta != kMetaPageId || root == kInvalidPageId) {
+      return Status::IOError("BTree::Open: cannot lay out segment " + std::to_string(seg_));
+    }
+    {
+      WritePageGuard g;
+      if (Status s = bpm_->NewPageAt(seg_, root, &g); !s.ok()) return s;
+      InitNode(g.Data(), root, 0, page_size_);
+      g.MarkDirty();
+    }
+    WritePageGuard g;
+    if (Status s = bpm_->NewPageAt(seg_, meta, &g); !s.ok()) return s;
+    BTreeMeta m;
+    m.page.page_id = meta;
+    m.page_size    = page_size_;
+    m.flags        = unique_ ? kMetaUnique : 0;
+    m.root         = root;
+    m.root_level   = 0;
+    std::memcpy(g.Data(), &m, sizeof(m));
+    g.MarkDirty();
+    return Status::OK();
+  }
+
+  ReadPageGuard g;
+  if (Status s = bpm_->FetchPage(seg_, kMetaPageId, &g); !s.ok()) return s;
+  BTreeMeta m;
+  g.Read([&](const std::uint8_t* p) { std::memcpy(&m, p, sizeof(m)); });
+  if (m.magic != kBTreeMagic || m.version != kBTreeVersion) {
+    return Status::Corruption("BTree::Open: segment " + std::to_string(seg_) + " has no index meta page");
+  }
+  if (m.page_size != page_size_) return Status::InvalidArgument("BTree::Open: page size differs from the index");
+  if (((m.flags & kMetaUnique) != 0) != unique_) {
+    return Status::InvalidArgument("BTree::Open: unique option differs from the existing index");
+  }
+  return Status::OK();
+}
+
+Status BTree::ReadRoot(Root* out) const {
+  ReadPageGuard g;
+  if (Status s = bpm_->FetchPage(seg_, kMetaPageId, &g); !s.ok()) return s;
+  bool ok = false;
+  g.Read([&](const std::uint8_t* p) {
+    BTreeMeta m;
+    std::memcpy(&m, p, sizeof(m));
+    ok = m.magic == kBTreeMagic;
+    out->pid   = m.root;
+    out->level = m.root_level;
+  });
+  return ok ? Status::OK() : Status::Corruption("BTree: bad meta page " + PageName(seg_, kMetaPageId));
+}
+
+Status BTree::Checkpoint() { return sm_->Checkpoint(seg_); }
+
+// ------------------------------ 下降 ------------------------------
+
+Status BTree::Descend(const NodeKey& k, uint32_t level, std::vector<page_id_t>* path, page_id_t* out) const {
+  Root root;
+  if (Status s = ReadRoot(&root); !s.ok()) return s;
+  if (root.level < level) return Status::Unavailable("BTree: tree is lower than the requested level");
+  if (path) path->assign(root.level + 1, kInvalidPageId);
+
+  page_id_t pid = root.pid;
+  for (;;) {
+    ReadPageGuard g;
+    if (Status s = bpm_->FetchPage(seg_, pid, &g); !s.ok()) return s;
+    bool      ok = false, right = false;
+    uint32_t  node_level = 0;
+    page_id_t next = kInvalidPageId;
+    g.Read([&](const std::uint8_t* p) {
+      const NodeView   v(p, inner_cap_);
+      const NodeHeader h = v.header();
+      const uint32_t   n = h.page.slot_count;
+      ok = h.magic == kNodeMagic && n <= (h.level == 0 ? leaf_cap_ : inner_cap_);
+      if (!ok) return;
+      node_level = h.level;
+      right = (h.flags & kHasHigh) && CompareNodeKey(k, h.high, unique_) > 0;
+      if (right) next = h.right;
+      else if (h.level > level) next = v.child(v.LowerBound(n, k, unique_));
+    });
+    if (!ok || (right && next == kInvalidPageId) || node_level < level) {
+      return Status::Corruption("BTree: bad node page " + PageName(seg_, pid));
+    }
+    if (right) { pid = next; continue; }  // 节点已分裂：键在右兄弟中
+    if (node_level == level) { *out = pid; return Status::OK(); }
+    if (path && node_level < path->size()) (*path)[node_level] = pid;
+    pid = next;
+  }
+}
+
+Status BTree::LatchCovering(const NodeKey& k, uint32_t level, page_id_t pid, WritePageGuard* g) const {
+  for (;;) {
+    if (Status s = bpm_->FetchPage(seg_, pid, g); !s.ok()) return s;
+    const NodeHeader* h = Header(g->Data());
+    if (h->magic != kNodeMagic || h->level != level ||
+        h->page.slot_count > (level == 0 ? leaf_cap_ : inner_cap_)) {
+      return Status::Corruption("BTree: bad node page " + PageName(seg_, pid));
+    }
+    if (!(h->flags & kHasHigh) || CompareNodeKey(k, h->high, unique_) <= 0) return Status::OK();
+    // 下降之后节点被分裂：先放开再去右兄弟（B-link 允许，此时不持有其他闩锁）
+    pid = h->right;
+    g->Release();
+  }
+}
+
+// ------------------------------ 插入 / 分裂 ------------------------------
+
+Status BTree::Insert(int64_t key, const RID& rid) {
+  const NodeKey k = MakeKey(key, rid);
+  std::vector<page_id_t> path;
+  page_id_t leaf = kInvalidPageId;
+  if (Status s = Descend(k, 0, &path, &leaf); !s.ok()) return s;
+  return InsertAt(k, kInvalidPageId, 0, leaf, path);
+}
+
+Status BTree::InsertAt(NodeKey k, page_id_t child, uint32_t level, page_id_t pid,
+                       const std::vector<page_id_t>& path) {
+  for (;;) {
+    WritePageGuard g;
+    if (Status s = LatchCovering(k, level, pid, &g); !s.ok()) return s;
+    std::uint8_t*  p   = g.Data();
+    const uint32_t n   = Header(p)->page.slot_count;
+    const uint32_t idx = NodeView(p, inner_cap_).LowerBound(n, k, unique_);
+    if (level == 0 && idx < n && CompareNodeKey(Keys(p)[idx], k, unique_) == 0) {
+      return Status::InvalidArgument("BTree::Insert: duplicate key " + std::to_string(k.key));
+    }
+    if (n < (level == 0 ? leaf_cap_ : inner_cap_)) {
+      InsertIntoNode(p, level, idx, k, child);
+      g.MarkDirty();
+      return Status::OK();
+    }
+
+    NodeKey   sep;
+    page_id_t right = kInvalidPageId;
+    if (Status s = Split(&g, level, idx, k, child, &sep, &right); !s.ok()) return s;
+    const page_id_t left = g.PageId();
+    g.Release();
+
+    // 两个节点都已放开：到上一层登记 (sep, right)
+    page_id_t parent = kInvalidPageId;
+    bool      grown  = false;
+    if (Status s = ParentOf(sep, left, right, level, path, &parent, &grown); !s.ok()) return s;
+    if (grown) return Status::OK();
+    k     = sep;
+    child = right;
+    pid   = parent;
+    ++level;
+  }
+}
+
+void BTree::InsertIntoNode(std::uint8_t* p, uint32_t level, uint32_t idx, const NodeKey& k,
+                           page_id_t child) const {
+  NodeHeader*    h    = Header(p);
+  const uint32_t n    = h->page.slot_count;
+  NodeKey*       keys = Keys(p);
+  std::memmove(keys + idx + 1, keys + idx, static_cast<size_t>(n - idx) * sizeof(NodeKey));
+  keys[idx] = k;
+  if (level > 0) {
+    // 新孩子接在分隔键之后：它覆盖 (k, 原来 idx 号孩子的上界]
+    page_id_t* ch = Children(p, inner_cap_);
+    std::memmove(ch + idx + 2, ch + idx + 1, static_cast<size_t>(n - idx) * sizeof(page_id_t));
+    ch[idx + 1] = child;
+  }
+  h->page.slot_count = static_cast<uint16_t>(n + 1);
+}
+
+Status BTree::Split(WritePageGuard* left, uint32_t level, uint32_t idx, const NodeKey& k, page_id_t child,
+                    NodeKey* out_sep, page_id_t* out_right) {
+  const page_id_t rp = sm_->AllocatePage(seg_);
+  if (rp == kInvalidPageId) return Status::IOError("BTree: cannot allocate a node page");
+  // 新页对其他线程尚不可达：持左节点的同时再持它的写闩锁不会与别的写者成环
+  WritePageGuard rg;
+  if (Status s = bpm_->NewPageAt(seg_, rp, &rg); !s.ok()) {
+    sm_->FreePage(seg_, rp);
+    return s;
+  }
+  std::uint8_t* lp = left->Data();
+  std::uint8_t* np = rg.Data();
+  InitNode(np, rp, level, page_size_);
+  NodeHeader*    lh = Header(lp);
+  NodeHeader*    rh = Header(np);
+  const uint32_t n  = lh->page.slot_count;
+
+  std::vector<NodeKey> keys(Keys(lp), Keys(lp) + n);
+  keys.insert(keys.begin() + idx, k);
+  const uint32_t total = n + 1;
+  // 追加到本层最右节点末尾（升序插入）时左节点保持满，右节点只放新条目，顺序装载的树接近满填充
+  const bool append = idx == n && lh->right == kInvalidPageId;
+
+  uint32_t left_n = 0, right_n = 0;
+  if (level == 0) {
+    // 叶子：左 [0, m)，右 [m, total)，分隔键为左半的最后一条
+    const uint32_t m = append ? n : total / 2;
+    std::memcpy(Keys(lp), keys.data(), static_cast<size_t>(m) * sizeof(NodeKey));
+    std::memcpy(Keys(np), keys.data() + m, static_cast<size_t>(total - m) * sizeof(NodeKey));
+    left_n   = m;
+    right_n  = total - m;
+    *out_sep = keys[m - 1];
+  } else {
+    // 内部节点：左保留键 [0, m) 与孩子 [0, m]，键 m 上移，右得到键 (m, total) 与孩子 [m+1, total]
+    std::vector<page_id_t> ch(Children(lp, inner_cap_), Children(lp, inner_cap_) + n + 1);
+    ch.insert(ch.begin() + idx + 1, child);
+    const uint32_t m = append ? n : total / 2;
+    std::memcpy(Keys(lp), keys.data(), static_cast<size_t>(m) * sizeof(NodeKey));
+    std::memcpy(Children(lp, inner_cap_), ch.data(), static_cast<size_t>(m + 1) * sizeof(page_id_t));
+    std::memcpy(Keys(np), keys.data() + m + 1, static_cast<size_t>(total - m - 1) * sizeof(NodeKey));
+    std::memcpy(Children(np, inner_cap_), ch.data() + m + 1, static_cast<size_t>(total - m) * sizeof(page_id_t));
+    left_n   = m;
+    right_n  = total - m - 1;
+    *out_sep = keys[m];
+  }
+
+  // 右节点接管原来的上界与右链；左节点的上界收到分隔键
+  rh->page.slot_count = static_cast<uint16_t>(right_n);
+  rh->right           = lh->right;
+  rh->flags           = lh->flags & kHasHigh;
+  rh->high            = lh->high;
+  lh->page.slot_count = static_cast<uint16_t>(left_n);
+  lh->right           = rp;
+  lh->flags          |= kHasHigh;
+  lh->high            = *out_sep;
+  left->MarkDirty();
+  rg.MarkDirty();
+  *out_right = rp;
+  return Status::OK();
+}
+
+Status BTree::ParentOf(const NodeKey& sep, page_id_t left, page_id_t right, uint32_t level,
+                       const std::vector<page_id_t>& path, page_id_t* out_parent, bool* out_grown) {
+  *out_grown = false;
+  // 下降时经过的上一层节点；它之后可能已分裂，InsertAt 会沿右链找到覆盖 sep 的那个
+  if (level + 1 < path.size() && path[level + 1] != kInvalidPageId) {
+    *out_parent = path[level + 1];
+    return Status::OK();
+  }
+  // 下降时 left 所在层就是根层：left 仍是根则由本线程长高，否则从新根下降到上一层
+  for (;;) {
+    Root root;
+    if (Status s = ReadRoot(&root); !s.ok()) return s;
+    if (root.level > level) return Descend(sep, level + 1, nullptr, out_parent);
+    if (root.pid == left) {
+      if (Status s = GrowRoot(left, level, sep, right, out_grown); !s.ok()) return s;
+      if (*out_grown) return Status::OK();
+      continue;
+    }
+    // 根已被另一个线程分裂、新根尚未登记到元页：稍候重试
+    std::this_thread::yield();
+  }
+}
+
+Status BTree::GrowRoot(page_id_t old_root, uint32_t level, const NodeKey& sep, page_id_t right,
+                       bool* out_grown) {
+  *out_grown = false;
+  WritePageGuard mg;
+  if (Status s = bpm_->FetchPage(seg_, kMetaPageId, &mg); !s.ok()) return s;
+  auto* m = reinterpret_cast<BTreeMeta*>(mg.Data());
+  if (m->root != old_root || m->root_level != level) return Status::OK();
+
+  const page_id_t rp = sm_->AllocatePage(seg_);
+  if (rp == kInvalidPageId) return Status::IOError("BTree: cannot allocate a root page");
+  WritePageGuard rg;
+  if (Status s = bpm_->NewPageAt(seg_, rp, &rg); !s.ok()) {
+    sm_->FreePage(seg_, rp);
+    return s;
+  }
+  std::uint8_t* p = rg.Data();
+  InitNode(p, rp, level + 1, page_size_);
+  Header(p)->page.slot_count = 1;
+  Keys(p)[0]                 = sep;
+  Children(p, inner_cap_)[0] = old_root;
+  Children(p, inner_cap_)[1] = right;
+  rg.MarkDirty();
+
+  m->root       = rp;
+  m->root_level = level + 1;
+  mg.MarkDirty();
+  *out_grown = true;
+  return Status::OK();
+}
+
+// ------------------------------ 删除 / 查找 ------------------------------
+
+Status BTree::Erase(int64_t key, const RID& rid) {
+  const NodeKey k = MakeKey(key, rid);
+  page_id_t leaf = kInvalidPageId;
+  if (Status s = Descend(k, 0, nullptr, &leaf); !s.ok()) return s;
+  WritePageGuard g;
+  if (Status s = LatchCovering(k, 0, leaf, &g); !s.ok()) return s;
+  std::uint8_t*  p    = g.Data();
+  NodeHeader*    h    = Header(p);
+  NodeKey*       keys = Keys(p);
+  const uint32_t n    = h->page.slot_count;
+  const uint32_t idx  = NodeView(p, inner_cap_).LowerBound(n, k, unique_);
+  // 唯一索引只按键定位，RID 也须一致
+  if (idx >= n || CompareNodeKey(keys[idx], k, /*unique=*/false) != 0) {
+    return Status::NotFound("BTree::Erase: no such entry");
+  }
+  std::memmove(keys + idx, keys + idx + 1, static_cast<size_t>(n - idx - 1) * sizeof(NodeKey));
+  h->page.slot_count = static_cast<uint16_t>(n - 1);
+  g.MarkDirty();
+  return Status::OK();
+}
+
+Status BTree::Find(int64_t key, RID* out) const {
+  BTreeIterator it = Scan(key, key);
+  if (it.Next()) {
+    if (out) *out = it.rid();
+    return Status::OK();
+  }
+  return it.status().ok() ? Status::NotFound("BTree::Find: no such key") : it.status();
+}
+
+Status BTree::Get(int64_t key, std::vector<RID>* out) const {
+  BTreeIterator it = Scan(key, key);
+  while (it.Next()) out->push_back(it.rid());
+  return it.status();
+}
+
+BTreeIterator BTree::Scan(int64_t lo, int64_t hi) const { return BTreeIterator(this, lo, hi); }
+
+// ------------------------------ 区间扫描 ------------------------------
+
+BTreeIterator::BTreeIterator(const BTree* tree, int64_t lo, int64_t hi) : tree_(tree), lo_(lo), hi_(hi) {
+  if (lo > hi) { done_ = true; return; }
+  status_ = tree_->Descend(LowKey(lo), 0, nullptr, &leaf_);
+  if (!status_.ok()) done_ = true;
+}
+
+bool BTreeIterator::Next() {
+  if (done_) return false;
+  if (pos_ >= buf_.size() && !FillFromNextLeaf()) {
+    done_ = true;
+    return false;
+  }
+  last_    = buf_[pos_++];
+  started_ = true;
+  return true;
+}
+
+bool BTreeIterator::FillFromNextLeaf() {
+  buf_.clear();
+  pos_ = 0;
+  const NodeKey last = MakeKey(last_);
+  while (buf_.empty()) {
+    if (leaf_ == kInvalidPageId) return false;
+    ReadPageGuard g;
+    if (Status s = tree_->bpm_->FetchPage(tree_->seg_, leaf_, &g); !s.ok()) {
+      status_ = s;
+      return false;
+    }
+    bool      ok = false, end = false;
+    page_id_t next = kInvalidPageId;
+    g.Read([&](const std::uint8_t* p) {
+      buf_.clear();
+      const NodeView   v(p, tree_->inner_cap_);
+      const NodeHeader h = v.header();
+      const uint32_t   n = h.page.slot_count;
+      ok = h.magic == kNodeMagic && h.level == 0 && n <= tree_->leaf_cap_;
+      if (!ok) return;
+      next = h.right;
+      // 上界的键已大于 hi：右边的叶子不会再有命中
+      end = h.right == kInvalidPageId || ((h.flags & kHasHigh) && h.high.key > hi_);
+      for (uint32_t i = 0; i < n; ++i) {
+        const NodeKey e = v.key(i);
+        if (e.key > hi_) { end = true; break; }
+        // 从上一条之后继续（叶子在两次读取之间可能分裂，已返回的条目会出现在右兄弟里）
+        if (started_ ? CompareNodeKey(e, last, tree_->unique_) <= 0 : e.key < lo_) continue;
+        buf_.push_back(BTreeEntry{e.key, RID{e.page, e.slot}});
+      }
+    });
+    if (!ok) {
+      status_ = Status::Corruption("BTree: bad leaf page " + PageName(tree_->seg_, leaf_));
+      buf_.clear();
+      return false;
+    }
+    leaf_ = end ? kInvalidPageId : next;
+  }
+  return true;
+}
+
+// ------------------------------ 批量构建 ------------------------------
+
+Status BTree::BulkBuild(const std::vector<BTreeEntry>& sorted, double fill) {
+  if (!(fill > 0.0 && fill <= 1.0)) return Status::InvalidArgument("BTree::BulkBuild: fill must be in (0, 1]");
+  for (size_t i = 1; i < sorted.size(); ++i) {
+    if (CompareNodeKey(MakeKey(sorted[i - 1]), MakeKey(sorted[i]), unique_) >= 0) {
+      return Status::InvalidArgument("BTree::BulkBuild: input not strictly ascending at " + std::to_string(i));
+    }
+  }
+  Root root;
+  if (Status s = ReadRoot(&root); !s.ok()) return s;
+  uint32_t root_entries = 0;
+  {
+    ReadPageGuard g;
+    if (Status s = bpm_->FetchPage(seg_, root.pid, &g); !s.ok()) return s;
+    g.Read([&](const std::uint8_t* p) { root_entries = NodeView(p, inner_cap_).header().page.slot_count; });
+  }
+  if (root.level != 0 || root_entries != 0) return Status::InvalidArgument("BTree::BulkBuild: index is not empty");
+  if (sorted.empty()) return Status::OK();
+
+  // 新节点分配在连续页上：sm 一次预留 count 页
+  auto allocate = [&](size_t count, std::vector<page_id_t>* pids) -> Status {
+    if (count == 0) return Status::OK();
+    const page_id_t first = sm_->AllocatePages(seg_, static_cast<uint32_t>(count));
+    if (first == kInvalidPageId) return Status::IOError("BTree::BulkBuild: cannot allocate node pages");
+    for (size_t i = 0; i < count; ++i) pids->push_back(first + static_cast<page_id_t>(i));
+    return Status::OK();
+  };
+
+  struct Built {
+    page_id_t pid;
+    NodeKey   high;  // 子树中最大的键：即它在父节点中的分隔键
+  };
+  const size_t per_leaf  = std::max<size_t>(1, static_cast<size_t>(leaf_cap_ * fill));
+  const size_t per_inner = std::max<size_t>(2, static_cast<size_t>((inner_cap_ + 1) * fill));  // 孩子数
+
+  // 叶子：第一个沿用已有的空根叶子
+  const size_t leaves = (sorted.size() + per_leaf - 1) / per_leaf;
+  std::vector<page_id_t> pids{root.pid};
+  if (Status s = allocate(leaves - 1, &pids); !s.ok()) return s;
+  std::vector<Built> built;
+  built.reserve(leaves);
+  for (size_t i = 0; i < leaves; ++i) {
+    const size_t lo = i * per_leaf, hi = std::min(sorted.size(), lo + per_leaf);
+    WritePageGuard g;
+    Status s = i == 0 ? bpm_->FetchPage(seg_, pids[i], &g) : bpm_->NewPageAt(seg_, pids[i], &g);
+    if (!s.ok()) return s;
+    std::uint8_t* p = g.Data();
+    InitNode(p, pids[i], 0, page_size_);
+    NodeHeader* h = Header(p);
+    h->page.slot_count = static_cast<uint16_t>(hi - lo);
+    for (size_t j = lo; j < hi; ++j) Keys(p)[j - lo] = MakeKey(sorted[j]);
+    const NodeKey high = MakeKey(sorted[hi - 1]);
+    if (i + 1 < leaves) {
+      h->right = pids[i + 1];
+      h->flags = kHasHigh;
+      h->high  = high;
+    }
+    g.MarkDirty();
+    built.push_back({pids[i], high});
+  }
+
+  // 逐层向上：每 per_inner 个孩子一个节点，分隔键取各孩子（最后一个除外）的上界
+  uint32_t level = 0;
+  while (built.size() > 1) {
+    ++level;
+    const size_t nodes = (built.size() + per_inner - 1) / per_inner;
+    pids.clear();
+    if (Status s = allocate(nodes, &pids); !s.ok()) return s;
+    std::vector<Built> up;
+    up.reserve(nodes);
+    for (size_t i = 0; i < nodes; ++i) {
+      const size_t lo = i * per_inner, hi = std::min(built.size(), lo + per_inner);
+      WritePageGuard g;
+      if (Status s = bpm_->NewPageAt(seg_, pids[i], &g); !s.ok()) return s;
+      std::uint8_t* p = g.Data();
+      InitNode(p, pids[i], level, page_size_);
+      NodeHeader* h = Header(p);
+      h->page.slot_count = static_cast<uint16_t>(hi - lo - 1);
+      for (size_t j = lo; j < hi; ++j) {
+        if (j + 1 < hi) Keys(p)[j - lo] = built[j].high;
+        Children(p, inner_cap_)[j - lo] = built[j].pid;
+      }
+      if (i + 1 < nodes) {
+        h->right = pids[i + 1];
+        h->flags = kHasHigh;
+        h->high  = built[hi - 1].high;
+      }
+      g.MarkDirty();
+      up.push_back({pids[i], built[hi - 1].high});
+    }
+    built.swap(up);
+  }
+
+  if (level == 0) return Status::OK();  // 只有一个叶子：根不变
+  WritePageGuard mg;
+  if (Status s = bpm_->FetchPage(seg_, kMetaPageId, &mg); !s.ok()) return s;
+  auto* m = reinterpret_cast<BTreeMeta*>(mg.Data());
+  m->root       = built[0].pid;
+  m->root_level = level;
+  mg.MarkDirty();
+  return Status::OK();
+}
+
+// ------------------------------ 统计 ------------------------------
+
+Status BTree::GetStats(BTreeStats* out) const {
+  if (!out) return Status::InvalidArgument("BTree::GetStats: out=null");
+  *out = BTreeStats{};
+  Root root;
+  if (Status s = ReadRoot(&root); !s.ok()) return s;
+  out->height = root.level + 1;
+
+  // 每层从最左节点出发沿右链走到底；下一层的最左节点是本层最左节点的 0 号孩子
+  page_id_t first = root.pid;
+  for (uint32_t level = root.level + 1; level-- > 0;) {
+    page_id_t down = kInvalidPageId;
+    for (page_id_t pid = first; pid != kInvalidPageId;) {
+      ReadPageGuard g;
+      if (Status s = bpm_->FetchPage(seg_, pid, &g); !s.ok()) return s;
+      NodeHeader h;
+      page_id_t  child0 = kInvalidPageId;
+      g.Read([&](const std::uint8_t* p) {
+        const NodeView v(p, inner_cap_);
+        h = v.header();
+        if (h.level > 0 && pid == first) child0 = v.child(0);
+      });
+      if (h.magic != kNodeMagic || h.level != level) {
+        return Status::Corruption("BTree: bad node page " + PageName(seg_, pid));
+      }
+      if (level == 0) {
+        out->entries += h.page.slot_count;
+        out->leaf_pages++;
+      } else {
+        out->inner_pages++;
+      }
+      if (pid == first) down = child0;
+      pid = h.right;
+    }
+    first = down;
+  }
+  if (out->leaf_pages > 0) {
+    out->leaf_fill = static_cast<double>(out->entries) / (static_cast<double>(out->leaf_pages) * leaf_cap_);
+  }
+  return Status::OK();
+}
+
+}  // namespace index
+}  // namespace dbms
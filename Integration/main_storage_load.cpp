@@ -8,6 +8,15 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <charconv>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include <sys/stat.h>
 
 #include "dbms/storage/storage_options.h"
 #include "dbms/storage/storage_types.h"
@@ -15,15 +24,15 @@
 #include "dbms/storage/space/free_space_manager.h"
 #include "dbms/storage/buffer/buffer_pool_manager.h"
 #include "dbms/storage/table/table_heap.h"
+#include "dbms/storage/record/row_codec.h"
 #include "dbms/storage/record/schema.h"
 #include "dbms/storage/record/tuple.h"
 #include "dbms/storage/table/table_iterator.h"
 
-// 替换器
-#include "internal/buffer/clock_replacer.h"
-#ifdef DBMS_STORAGE_ENABLE_LRUK
-#include "internal/buffer/lruk_replacer.h"
-#endif
+#include "dbms/storage/buffer/replacer.h"
+#include "dbms/index/btree.h"
+#include "dbms/recovery/log_manager.h"
+#include "tbl_input.h"
 
 using namespace dbms::storage;
 
@@ -32,9 +41,43 @@ struct Args {
   std::string base_dir = "./dbdata";   // 段/页输出目录
   uint32_t    page_size = kDefaultPageSize;
   int         frames = 256;            // 缓冲帧数
-  std::string replacer = "clock";      // clock | lruk
+  int         partitions = 1;          // 缓冲池分区数
+  int         bg_writers = 0;          // 后台写回线程数（0=关闭）
+  double      bg_clean = 0.1;          // 后台写回目标：每分区保持干净的帧比例
+  std::string io = "posix";            // 批量页 I/O 后端：posix | io_uring
+  int         direct = 0;              // 1=段文件以 O_DIRECT 打开（绕过页缓存）
+  int         hugepages = 0;           // 1=页池使用透明大页
+  int         hugetlb = 0;             // 1=先尝试 MAP_HUGETLB 预留大页
+  int         numa = 0;                // 1=各分区帧内存轮转绑定到 NUMA 节点
+  int         checksum = 1;            // 1=写回时写入页 CRC-32C，未命中读入时校验
+  int         prefetch = 8;            // 扫描预读窗口（页；0=关闭）
+  int         scan_ring = 32;          // 扫描环形缓冲总帧数（0=扫描页进入普通替换器）
+  int         pscan = 0;               // 1=运行并行扫描对照（[PSCAN]）
+  int         scan_threads = 0;        // 并行扫描的工作线程数（0=hardware_concurrency）
+  int         morsel = 64;             // 并行扫描每个 morsel 的页数
+  int         cold = 0;                // 1=装载后把表冻结为压缩冷段，之后的扫描经解压读页
+  int         index = 0;               // 1=在 suppkey 上建 B+ 树索引（批量构建 / 并发插入各一棵），对照点查与全表扫描（[INDEX]）
+  int         wal = 0;                 // 1=表的页修改写预写日志 base_dir/wal.log，并对照组提交开/关的提交吞吐
+  int         wal_threads = 8;         // 提交对照的并发线程数（每个线程反复“插入一行 + 提交”）
+  int         metrics = 0;             // 1=挂接延迟直方图（命中/未命中/写回/读写盘/fdatasync/锁等待/替换器扫描），结束时输出
+  int         metrics_every_ms = 0;    // >0 时每隔这么多毫秒输出一次该时间段内的分布
+  int         cols = 0;                // 1=对照逐行 / RowCodec / 列投影三种两列聚合扫描（[COLS]）
+  int         batch_scan = 0;          // 1=对照逐行求值与批扫描（SIMD / 标量）的过滤聚合（[BATCH]）
+  int         zone = 0;                // 1=对照区间摘要跳页与逐页读取的范围扫描（[ZONE]）
+  int         warmup = 0;              // 1=退出时把缓冲池热集导出到 base_dir/hotset，启动时若存在则后台预热
+  int         warmup_rate = 0;         // 预热装入速率上限（页/秒，0=不限）
+  int         bulk = 0;                // 0=逐行 Insert（默认，经缓冲池逐行取页，替换策略对照依赖它）；1=经 TableAppender 顺序填页
+  std::string format = "slotted";      // 表页格式：slotted（行存槽位页）| pax（页内按列分组）
+  int         threads = 1;             // 解析+装载线程数（>1 时按字节区间切分输入）
+  int         batch = 256;             // 每个线程先解析 N 行再批量追加
+  int         checkpoint_ms = 0;       // 装载期间每 N 毫秒对 FSM/段元数据做一次检查点（0=仅在结束时）
+  int         extent_min_kb = 1024;    // 段文件扩展区段下限（KiB），之后每次翻倍
+  int         extent_max_kb = 65536;   // 段文件扩展区段上限（KiB）
+  std::string input = "mmap";          // mmap=映射文件 + string_view 字段；stream=ifstream + SplitPipe（对照）
+  std::string replacer = "clock";      // clock | lru | lruk | arc，或完整规格如 lruk:k=3,crp=2
   int         log_every = 1000;        // 每 N 条打印一次统计
   int         k = 2;                   // LRU-K 的 K 值（仅 lruk 有效）
+  int         crp = 1;                 // LRU-K 相关引用期（逻辑访问计数；0=关闭）
   seg_id_t    seg = 1;                 // 测试用单段
 };
 
@@ -44,7 +87,11 @@ Args ParseArgs(int argc, char** argv) {
   if (argc < 2) {
     std::cerr << "Usage: " << argv[0]
               << " <supplier.tbl> [--base_dir=./dbdata] [--frames=256]"
-              << " [--page=8192] [--replacer=clock|lruk] [--k=2] [--log_every=1000]\n";
+              << " [--page=8192] [--replacer=clock|lru|lruk|arc|<spec>] [--k=2] [--crp=1] [--partitions=1]"
+              << " [--bg_writers=0] [--bg_clean=0.1] [--io=posix|io_uring]"
+              << " [--direct=0|1] [--hugepages=0|1] [--hugetlb=0|1] [--numa=0|1] [--checksum=0|1] [--prefetch=8] [--scan_ring=32] [--pscan=0|1] [--scan_threads=0] [--morsel=64] [--cold=0|1] [--index=0|1] [--wal=0|1] [--wal_threads=8] [--metrics=0|1] [--metrics_every_ms=0] [--warmup=0|1] [--warmup_rate=0] [--cols=0|1] [--batch_scan=0|1] [--zone=0|1]"
+              << " [--bulk=0|1] [--format=slotted|pax] [--threads=1] [--batch=256] [--input=mmap|stream] [--checkpoint_ms=0]"
+              << " [--extent_min_kb=1024] [--extent_max_kb=65536] [--log_every=1000]\n";
     std::exit(1);
   }
   a.data_file = argv[1];
@@ -65,6 +112,40 @@ Args ParseArgs(int argc, char** argv) {
     if (eat("replacer", a.replacer)) continue;
     if (eat("log_every", a.log_every)) continue;
     if (eat("k", a.k)) continue;
+    if (eat("crp", a.crp)) continue;
+    if (eat("partitions", a.partitions)) continue;
+    if (eat("bg_writers", a.bg_writers)) continue;
+    if (eat("bg_clean", a.bg_clean)) continue;
+    if (eat("io", a.io)) continue;
+    if (eat("direct", a.direct)) continue;
+    if (eat("hugepages", a.hugepages)) continue;
+    if (eat("hugetlb", a.hugetlb)) continue;
+    if (eat("numa", a.numa)) continue;
+    if (eat("checksum", a.checksum)) continue;
+    if (eat("prefetch", a.prefetch)) continue;
+    if (eat("scan_ring", a.scan_ring)) continue;
+    if (eat("pscan", a.pscan)) continue;
+    if (eat("scan_threads", a.scan_threads)) continue;
+    if (eat("morsel", a.morsel)) continue;
+    if (eat("cold", a.cold)) continue;
+    if (eat("index", a.index)) continue;
+    if (eat("wal", a.wal)) continue;
+    if (eat("wal_threads", a.wal_threads)) continue;
+    if (eat("metrics", a.metrics)) continue;
+    if (eat("metrics_every_ms", a.metrics_every_ms)) continue;
+    if (eat("warmup", a.warmup)) continue;
+    if (eat("cols", a.cols)) continue;
+    if (eat("batch_scan", a.batch_scan)) continue;
+    if (eat("zone", a.zone)) continue;
+    if (eat("warmup_rate", a.warmup_rate)) continue;
+    if (eat("bulk", a.bulk)) continue;
+    if (eat("format", a.format)) continue;
+    if (eat("threads", a.threads)) continue;
+    if (eat("batch", a.batch)) continue;
+    if (eat("input", a.input)) continue;
+    if (eat("checkpoint_ms", a.checkpoint_ms)) continue;
+    if (eat("extent_min_kb", a.extent_min_kb)) continue;
+    if (eat("extent_max_kb", a.extent_max_kb)) continue;
   }
   return a;
 }
@@ -94,6 +175,23 @@ static std::vector<std::string> SplitPipe(const std::string& raw) {
   return fields; // 期望得到 7 段
 }
 
+// --- 文件实际占用的磁盘字节（打洞释放的块不计） ---
+static uint64_t DiskBytes(const std::string& path) {
+  struct stat st {};
+  return ::stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_blocks) * 512 : 0;
+}
+
+// --- 观测快照日志：每个观测项一行，带 [METRICS] 与时段标签 ---
+// 整块一次写出，避免与前台输出交错
+static void LogMetrics(const char* tag, const MetricsSnapshot& snap) {
+  std::istringstream in(snap.ToString());
+  std::ostringstream oss;
+  for (std::string line; std::getline(in, line);) {
+    oss << "[METRICS] " << tag << " secs=" << snap.seconds << " " << line << "\n";
+  }
+  std::cout << oss.str() << std::flush;
+}
+
 // --- FSM 桶尺寸日志 ---
 static void LogFsm(const FreeSpaceManager& fsm) {
   auto bins = fsm.BinSizes();
@@ -121,46 +219,201 @@ Schema MakeSupplierSchema() {
   return Schema(std::move(cols), /*use_null_bitmap=*/false);
 }
 
+// --- 解析一行 supplier 记录并构造 Tuple；格式不符返回 false ---
+static bool BuildSupplierTuple(const Schema& schema, const std::string& line, Tuple* out) {
+  auto fields = SplitPipe(line);
+  if (fields.size() != 7) return false;
+
+  TupleBuilder tb(schema);
+  // suppkey | name | address | nationkey | phone | acctbal | comment
+  tb.SetInt32 (0, std::stoi(fields[0]));
+  tb.SetChar  (1, fields[1]);
+  tb.SetVarChar(2, fields[2]);
+  tb.SetInt32 (3, std::stoi(fields[3]));
+  tb.SetChar  (4, fields[4]);
+  tb.SetDouble(5, std::stod(fields[5]));
+  tb.SetVarChar(6, fields[6]);
+  return tb.Build(out).ok();
+}
+
+// --- string_view 数值解析（要求整个字段都是数字） ---
+template <typename T>
+static bool ParseNumber(std::string_view s, T* out) {
+  const char* e = s.data() + s.size();
+  auto r = std::from_chars(s.data(), e, *out);
+  return r.ec == std::errc() && r.ptr == e;
+}
+
+// --- 零拷贝版本：字段为指向输入映射的 string_view，复用调用方的构造器与 Tuple 缓冲 ---
+static bool BuildSupplierTuple(std::string_view line, TupleBuilder* tb, Tuple* out) {
+  std::string_view f[8];
+  size_t n = dbms::integration::SplitFields(line.data(), line.data() + line.size(), '|', f, 8);
+  if (n == 8 && f[7].empty()) n = 7;  // 行尾带 '|'
+  if (n != 7) return false;
+
+  int32_t suppkey = 0, nation = 0;
+  double  acctbal = 0.0;
+  if (!ParseNumber(f[0], &suppkey) || !ParseNumber(f[3], &nation) || !ParseNumber(f[5], &acctbal)) {
+    return false;
+  }
+
+  tb->Reset();
+  tb->SetInt32 (0, suppkey);
+  tb->SetChar  (1, f[1]);
+  tb->SetVarChar(2, f[2]);
+  tb->SetInt32 (3, nation);
+  tb->SetChar  (4, f[4]);
+  tb->SetDouble(5, acctbal);
+  tb->SetVarChar(6, f[6]);
+  return tb->Build(out).ok();
+}
+
+// --- 把文件切成 n 个字节区间 [begin, end)，每个边界后移到下一行行首 ---
+static std::vector<std::pair<uint64_t, uint64_t>> SplitByLines(const std::string& path, int n) {
+  const uint64_t size = std::filesystem::file_size(path);
+  std::vector<uint64_t> cut(1, 0);
+  std::ifstream in(path, std::ios::binary);
+  for (int i = 1; i < n; ++i) {
+    uint64_t pos = std::max<uint64_t>(size * i / n, cut.back());
+    if (pos > 0 && pos < size) {
+      in.clear();
+      in.seekg(static_cast<std::streamoff>(pos - 1));  // 从前一字节起找：恰好落在行首时不跳过该行
+      std::string skip;
+      std::getline(in, skip);
+      pos = in ? static_cast<uint64_t>(in.tellg()) : size;
+    }
+    cut.push_back(std::min(pos, size));
+  }
+  cut.push_back(size);
+
+  std::vector<std::pair<uint64_t, uint64_t>> ranges;
+  for (int i = 0; i < n; ++i) ranges.emplace_back(cut[i], cut[i + 1]);
+  return ranges;
+}
+
+// --- 多线程共享的装载计数 ---
+struct LoadCounters {
+  std::atomic<size_t>   rows{0};
+  std::atomic<size_t>   bad{0};
+  std::atomic<uint64_t> bytes{0};
+};
+
 int main(int argc, char** argv) {
   Args args = ParseArgs(argc, argv);
   std::filesystem::create_directories(args.base_dir);
 
   // === 组件初始化 ===
-  SegmentManager sm(args.page_size, args.base_dir);
+  // I/O 后端须比段管理器与缓冲池活得更久（二者只借用指针）
+  std::unique_ptr<IoBackend> io = IoBackend::Create(args.io);
+  if (!io) {
+    std::cerr << "[WARN] unknown io backend: " << args.io << " -> fallback to posix\n";
+    io = IoBackend::Create("posix");
+  }
+  // 观测直方图同理（缓冲池与各段 DiskManager 只借用指针）
+  std::unique_ptr<StorageMetrics> metrics;
+  if (args.metrics || args.metrics_every_ms > 0) metrics = std::make_unique<StorageMetrics>();
+  // 预写日志同样须比缓冲池与表活得更久（刷盘回调与 TableHeap 只借用指针）
+  std::unique_ptr<dbms::recovery::LogManager> wal;
+  SegmentManager sm(args.page_size, args.base_dir, args.direct != 0);
+  sm.SetIoBackend(io.get());
+  sm.SetExtentPolicy(static_cast<uint64_t>(std::max(1, args.extent_min_kb)) << 10,
+                     static_cast<uint64_t>(std::max(1, args.extent_max_kb)) << 10);
   if (!sm.EnsureSegment(args.seg).ok()) {
     std::cerr << "EnsureSegment failed\n"; return 2;
   }
-  DiskManager* disk = sm.GetDisk(args.seg);
 
-  // 替换器（支持 clock 与可选 lruk）
-  std::unique_ptr<IReplacer> replacer;
-  if (args.replacer == "clock") {
-    replacer = std::make_unique<ClockReplacer>(args.frames);
-  }
-#ifdef DBMS_STORAGE_ENABLE_LRUK
-  else if (args.replacer == "lruk") {
-    int k = args.k > 1 ? args.k : 2;
-    replacer = std::make_unique<LruKReplacer>(args.frames, k);
+  // 替换器经 IReplacer::Create 按规格串构造；每个分区各建一个。裸 "lruk" 由 --k/--crp 补全参数
+  std::string spec = args.replacer;
+  if (spec == "lruk") {
+    spec += ":k=" + std::to_string(args.k) + ",crp=" + std::to_string(std::max(0, args.crp));
   }
-#endif
-  else {
-    std::cerr << "[WARN] unknown replacer: " << args.replacer
-              << " -> fallback to clock\n";
-    replacer = std::make_unique<ClockReplacer>(args.frames);
+  if (!IReplacer::Create(spec, 1)) {
+    std::cerr << "[WARN] unknown replacer: " << spec << " -> fallback to clock\n";
+    spec = "clock";
   }
+  BufferPoolManager::ReplacerFactory make_replacer = [spec](int cap) {
+    return IReplacer::Create(spec, cap);
+  };
 
-  BufferPoolManager bpm(args.frames, args.page_size, disk, std::move(replacer));
+  // 缓冲池经 SegmentManager 路由各段 I/O，可被多个表共享
+  PoolMemoryOptions mem;
+  mem.hugepages = args.hugepages != 0;
+  mem.hugetlb   = args.hugetlb != 0;
+  mem.numa      = args.numa != 0;
+  const auto pool_t0 = std::chrono::steady_clock::now();
+  BufferPoolManager bpm(args.frames, args.page_size, &sm, make_replacer, args.partitions, mem);
+  const double pool_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - pool_t0).count();
+  bpm.StartBackgroundWriter(args.bg_writers, args.bg_clean, /*interval_ms=*/20);
+  bpm.SetScanRingFrames(args.scan_ring);
+  bpm.SetPageChecksums(args.checksum != 0);
+  if (metrics) {
+    bpm.SetMetrics(metrics.get());
+    sm.SetMetrics(metrics.get());
+    if (args.metrics_every_ms > 0) {
+      metrics->StartPeriodicDump(static_cast<uint32_t>(args.metrics_every_ms),
+                                 [](const MetricsSnapshot& s) { LogMetrics("interval", s); });
+    }
+  }
 
   // FSM（按需设置分桶阈值）
   std::vector<uint32_t> bins = {128, 512, 1024, 2048, 4096, 8192, 16384};
   FreeSpaceManager fsm(args.page_size, bins);
   fsm.RegisterSegmentProbe(
-    [&](seg_id_t seg, page_id_t pid){ return sm.ProbePageFree(seg, pid); },
+    FreeSpaceManager::FreeBatchProbeFn(
+      [&](seg_id_t seg, page_id_t first, uint32_t n, uint16_t* out) {
+        return sm.ProbePagesFree(seg, first, n, out);
+      }),
     [&](seg_id_t seg){ return sm.PageCount(seg); }
   );
 
-  TableHeap table(args.seg, args.page_size, &bpm, &fsm, &sm);
   Schema schema = MakeSupplierSchema();
+  const TableFormat format = args.format == "pax" ? TableFormat::kPax : TableFormat::kSlotted;
+  TableHeap table(args.seg, args.page_size, &bpm, &fsm, &sm, &schema, format);
+
+  // 上次运行留下的冷段只读：先解冻，才能继续装载
+  if (table.IsCold()) {
+    const auto t_thaw = std::chrono::steady_clock::now();
+    Status ts = table.Thaw();
+    std::cout << "[COLD] thaw existing cold segment: " << (ts.ok() ? "ok" : ts.message()) << " ms="
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t_thaw).count() << "\n";
+  }
+
+  // 已有数据（重复使用 base_dir）：恢复 FSM，新行可填入旧页的空闲空间
+  if (sm.PageCount(args.seg) > 0) {
+    const auto t_open = std::chrono::steady_clock::now();
+    bool loaded = false;
+    Status rs = table.RecoverSpace(&loaded);
+    bool zone_loaded = false;
+    Status zs = table.RecoverZoneMap(&zone_loaded);
+    std::cout << "[OPEN] existing pages=" << sm.PageCount(args.seg)
+              << " fsm=" << (!rs.ok() ? "error(" + rs.message() + ")" : loaded ? "checkpoint" : "rebuilt")
+              << " zone=" << (!zs.ok() ? "error(" + zs.message() + ")" : zone_loaded ? "checkpoint" : "rebuilt")
+              << " ms=" << std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - t_open).count() << "\n";
+  }
+
+  // 缓存预热：上次退出时导出的热集由后台线程装回（只占空闲帧），与下面的装载并行
+  if (args.warmup) {
+    const std::string hot_path = args.base_dir + "/hotset";
+    WarmupOptions wo;
+    wo.pages_per_sec = static_cast<uint32_t>(std::max(0, args.warmup_rate));
+    Status hs = bpm.StartWarmup(hot_path, wo);
+    std::cout << "[WARMUP] start: "
+              << (hs.ok() ? "pages=" + std::to_string(bpm.GetStats().warmup_pages) : hs.message()) << "\n";
+    bpm.SetHotSetFile(hot_path);
+  }
+
+  // 预写日志：表的页修改先记日志并把 LSN 盖到页上，缓冲池写页前把日志刷到该 LSN
+  if (args.wal) {
+    Status ws = dbms::recovery::LogManager::Open(args.base_dir + "/wal.log", dbms::recovery::LogOptions{}, &wal);
+    if (!ws.ok()) {
+      std::cerr << "[WARN] wal open failed: " << ws.message() << " -> running without WAL\n";
+    } else {
+      table.SetLogSink(wal.get());
+      wal->AttachTo(&bpm);
+    }
+  }
 
   // === 读取并写入 ===
   std::ifstream fin(args.data_file);
@@ -171,51 +424,154 @@ int main(int argc, char** argv) {
   std::cout << "[LOAD] begin: file=" << args.data_file
             << ", page_size=" << args.page_size
             << ", frames=" << args.frames
-            << ", replacer=" << args.replacer
-#ifdef DBMS_STORAGE_ENABLE_LRUK
-            << (args.replacer == "lruk" ? ("(k=" + std::to_string(args.k) + ")") : "")
-#endif
+            << ", partitions=" << bpm.num_partitions()
+            << ", io=" << io->Name()
+            << ", direct=" << (sm.GetDisk(args.seg)->direct_io() ? 1 : 0)
+            << ", replacer=" << spec
+            << ", bulk=" << args.bulk
+            << ", format=" << (table.format() == TableFormat::kPax ? "pax" : "slotted")
+            << ", threads=" << args.threads
+            << ", input=" << args.input
             << "\n";
+  int numa_bound = 0;  // 帧内存已绑定 NUMA 节点的分区数
+  for (int p = 0; p < bpm.num_partitions(); ++p) numa_bound += bpm.partition_node(p) >= 0 ? 1 : 0;
+  std::cout << "[BUF] pool: mem=" << bpm.memory_backing()
+            << ", numa_partitions=" << numa_bound
+            << ", checksum=" << (bpm.page_checksums() ? "crc32c" : "off")
+            << ", init_ms=" << pool_ms << "\n";
+
+  // 并行时两条路径都不会让两个线程写同一页：追加器各写各的区段，Insert 经 FSM 预留目标页
+  const int threads = std::max(1, args.threads);
+  const size_t batch = static_cast<size_t>(std::max(1, args.batch));
+  const bool bulk = args.bulk != 0;
 
-  std::string line;
-  size_t count = 0, bad = 0;
-  while (std::getline(fin, line)) {
-    if (line.empty()) continue;
-    auto fields = SplitPipe(line);
-    if (fields.size() != 7) { ++bad; continue; }
+  LoadCounters ctr;
+  std::mutex log_mu;
+  auto log_progress = [&](size_t count) {
+    auto st = bpm.GetStats();
+    std::lock_guard<std::mutex> g(log_mu);
+    std::cout << "[PROGRESS] inserted=" << count
+              << " hits=" << st.hits
+              << " misses=" << st.misses
+              << " evictions=" << st.evictions
+              << " flushes=" << st.flushes
+              << " dirty=" << st.dirty_frames
+              << " bgwrites=" << st.bg_flushes
+              << " sync_writebacks=" << st.evict_writebacks
+              << " pages=" << sm.PageCount(args.seg) << "\n";
+    LogFsm(fsm);
+  };
 
+  dbms::integration::MappedFile mapped;
+  bool use_mmap = args.input == "mmap";
+  if (args.input != "mmap" && args.input != "stream") {
+    std::cerr << "[WARN] unknown input mode: " << args.input << " -> fallback to mmap\n";
+    use_mmap = true;
+  }
+  if (use_mmap && !mapped.Open(args.data_file)) {
+    std::cerr << "[WARN] mmap " << args.data_file << " failed -> fallback to stream\n";
+    use_mmap = false;
+  }
+
+  // 单个线程：读 [begin, end) 内的整行，攒满 batch 行后交给自己的追加器
+  auto load_range = [&](uint64_t begin, uint64_t end) {
+    TableAppender appender(&table);
     TupleBuilder tb(schema);
-    // suppkey | name | address | nationkey | phone | acctbal | comment
-    tb.SetInt32 (0, std::stoi(fields[0]));
-    tb.SetChar  (1, fields[1]);
-    tb.SetVarChar(2, fields[2]);
-    tb.SetInt32 (3, std::stoi(fields[3]));
-    tb.SetChar  (4, fields[4]);
-    tb.SetDouble(5, std::stod(fields[5]));
-    tb.SetVarChar(6, fields[6]);
-
-    Tuple t;
-    Status bs = tb.Build(&t);
-    if (!bs.ok()) { ++bad; continue; }
-
-    RID rid;
-    Status is = table.Insert(t, &rid);
-    if (!is.ok()) { ++bad; continue; }
-    ++count;
-
-    if (args.log_every > 0 && (count % args.log_every == 0)) {
-      auto st = bpm.GetStats();
-      std::cout << "[PROGRESS] inserted=" << count
-                << " hits=" << st.hits
-                << " misses=" << st.misses
-                << " evictions=" << st.evictions
-                << " flushes=" << st.flushes
-                << " pages=" << sm.PageCount(args.seg) << "\n";
-      LogFsm(fsm);
-    }
-  }
-
-  bpm.FlushAll(); (void)disk->Sync();
+    std::vector<Tuple> rows(batch);  // 槽位逐批复用：Build 写入已有缓冲，稳定后不再分配
+
+    // 行来源：mmap 直接在映射上切分；stream 保留 getline + SplitPipe 作为对照
+    const char* mp = use_mmap ? mapped.data() + begin : nullptr;
+    const char* me = use_mmap ? mapped.data() + end : nullptr;
+    std::ifstream in;
+    if (!use_mmap) {
+      in.open(args.data_file, std::ios::binary);
+      in.seekg(static_cast<std::streamoff>(begin));
+    }
+    uint64_t pos = begin;
+    std::string line;
+
+    bool eof = false;
+    while (!eof) {
+      size_t   nrows = 0;
+      uint64_t batch_bytes = 0;
+      size_t   batch_bad = 0;   // 格式错误 + 追加失败
+      while (nrows < batch) {
+        bool built = false;
+        if (use_mmap) {
+          const char* start = mp;
+          std::string_view lv;
+          if (!dbms::integration::NextLine(&mp, me, &lv)) { eof = true; break; }
+          batch_bytes += static_cast<uint64_t>(mp - start);
+          if (lv.empty()) continue;
+          built = BuildSupplierTuple(lv, &tb, &rows[nrows]);
+        } else {
+          if (pos >= end || !std::getline(in, line)) { eof = true; break; }
+          const uint64_t n = line.size() + (in.eof() ? 0 : 1);
+          pos += n; batch_bytes += n;
+          if (line.empty()) continue;
+          built = BuildSupplierTuple(schema, line, &rows[nrows]);
+        }
+        if (built) ++nrows; else ++batch_bad;
+      }
+
+      size_t ok = 0;
+      for (size_t i = 0; i < nrows; ++i) {
+        RID rid;
+        Status is = bulk ? appender.Append(rows[i], &rid) : table.Insert(rows[i], &rid);
+        if (is.ok()) ++ok; else ++batch_bad;
+      }
+      ctr.bad.fetch_add(batch_bad, std::memory_order_relaxed);
+      ctr.bytes.fetch_add(batch_bytes, std::memory_order_relaxed);
+      const size_t before = ctr.rows.fetch_add(ok, std::memory_order_relaxed);
+      if (args.log_every > 0 && ok > 0 &&
+          before / args.log_every != (before + ok) / args.log_every) {
+        log_progress(before + ok);
+      }
+    }
+    (void)appender.Finish();
+  };
+
+  // 周期性检查点：崩溃后重启只需载入元数据，不必全段探测
+  std::atomic<bool> loading{true};
+  std::mutex ckpt_mu;
+  std::condition_variable ckpt_cv;
+  std::thread checkpointer;
+  if (args.checkpoint_ms > 0) {
+    checkpointer = std::thread([&] {
+      std::unique_lock<std::mutex> lk(ckpt_mu);
+      while (!ckpt_cv.wait_for(lk, std::chrono::milliseconds(args.checkpoint_ms),
+                               [&] { return !loading.load(); })) {
+        Status cs = table.Checkpoint();
+        if (!cs.ok()) std::cerr << "[WARN] checkpoint failed: " << cs.message() << "\n";
+      }
+    });
+  }
+
+  const auto t_load = std::chrono::steady_clock::now();
+  fin.close();
+  if (threads == 1) {
+    load_range(0, std::filesystem::file_size(args.data_file));
+  } else {
+    std::vector<std::thread> workers;
+    for (const auto& r : SplitByLines(args.data_file, threads)) {
+      workers.emplace_back(load_range, r.first, r.second);
+    }
+    for (auto& w : workers) w.join();
+  }
+  const size_t count = ctr.rows.load(), bad = ctr.bad.load();
+  if (checkpointer.joinable()) {
+    { std::lock_guard<std::mutex> g(ckpt_mu); loading = false; }
+    ckpt_cv.notify_all();
+    checkpointer.join();
+  }
+
+  bpm.StopBackgroundWriter();
+  bpm.FlushAll(); (void)sm.GetDisk(args.seg)->Sync();
+  if (Status cs = table.Checkpoint(); !cs.ok()) {
+    std::cerr << "[WARN] checkpoint failed: " << cs.message() << "\n";
+  }
+  const double load_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - t_load).count();
 
   auto st = bpm.GetStats();
   std::cout << "[LOAD] done: rows=" << count
@@ -225,22 +581,130 @@ int main(int argc, char** argv) {
             << ", misses=" << st.misses
             << ", evictions=" << st.evictions
             << ", flushes=" << st.flushes
+            << ", bgwrites=" << st.bg_flushes
+            << ", sync_writebacks=" << st.evict_writebacks
             << "\n";
+  const double secs = load_ms / 1000.0;
+  std::cout << "[LOAD] time: ms=" << load_ms
+            << " threads=" << threads
+            << " batch=" << batch
+            << " rows_per_s=" << (secs > 0 ? count / secs : 0.0)
+            << " MB_per_s=" << (secs > 0 ? ctr.bytes.load() / (1024.0 * 1024.0) / secs : 0.0) << "\n";
+  const auto sp = sm.GetSpaceStats(args.seg);
+  std::cout << "[SEG] space: pages=" << sp.page_count
+            << " file_pages=" << sp.file_pages
+            << " extents=" << sp.extents
+            << " free_pages=" << sp.free_pages
+            << " free_extent_pages=" << sp.free_extent_pages << "\n";
+
+  // === WAL：装载作为一次提交；随后多个线程各自反复“插入一行 + 提交”，对照组提交开/关 ===
+  if (wal) {
+    const double mb = 1024.0 * 1024.0;
+    uint64_t load_lsn = 0;
+    Status ls = wal->Commit(&load_lsn);
+    const dbms::recovery::LogStats lst = wal->GetStats();
+    std::cout << "[WAL] load: records=" << lst.records << " MB=" << lst.bytes / mb << " syncs=" << lst.syncs
+              << " commit_lsn=" << load_lsn << (ls.ok() ? "" : " error=" + ls.message()) << "\n";
+
+    Tuple sample;
+    TupleBuilder stb(schema);
+    (void)BuildSupplierTuple(std::string_view("0|Supplier#000000000|wal bench|0|00-000-000-0000|0.00|wal bench row|"),
+                             &stb, &sample);
+    const int wthreads = std::max(1, args.wal_threads);
+    const int per_thread = 200;
+    for (bool group : {true, false}) {
+      wal->SetGroupCommit(group);
+      const dbms::recovery::LogStats before = wal->GetStats();
+      std::vector<std::vector<double>> lat(wthreads);
+      std::vector<std::vector<RID>>    added(wthreads);
+      std::atomic<uint64_t> errors{0};
+      const auto t_commit = std::chrono::steady_clock::now();
+      std::vector<std::thread> committers;
+      for (int t = 0; t < wthreads; ++t) {
+        committers.emplace_back([&, t] {
+          for (int i = 0; i < per_thread; ++i) {
+            const auto c0 = std::chrono::steady_clock::now();
+            RID rid;
+            Status s = table.Insert(sample, &rid);
+            if (s.ok()) {
+              added[t].push_back(rid);
+              s = wal->Commit();
+            }
+            if (!s.ok()) errors.fetch_add(1, std::memory_order_relaxed);
+            lat[t].push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - c0).count());
+          }
+        });
+      }
+      for (auto& c : committers) c.join();
+      const double commit_ms = std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - t_commit).count();
+      const dbms::recovery::LogStats after = wal->GetStats();
+
+      // 撤掉对照插入的行（同样记日志），作为一次提交
+      for (const auto& v : added) {
+        for (const RID& r : v) (void)table.Erase(r);
+      }
+      (void)wal->Commit();
+
+      std::vector<double> all;
+      for (const auto& v : lat) all.insert(all.end(), v.begin(), v.end());
+      std::sort(all.begin(), all.end());
+      double avg = 0.0;
+      for (double x : all) avg += x;
+      avg = all.empty() ? 0.0 : avg / all.size();
+      const double p99 = all.empty() ? 0.0 : all[std::min(all.size() - 1, all.size() * 99 / 100)];
+      const uint64_t commits = after.commits - before.commits, syncs = after.syncs - before.syncs;
+      std::cout << "[WAL] group_commit=" << (group ? "on " : "off") << " threads=" << wthreads
+                << " commits=" << commits << " commits_per_s=" << (commit_ms > 0 ? commits * 1000.0 / commit_ms : 0.0)
+                << " avg_us=" << avg << " p99_us=" << p99 << " syncs=" << syncs
+                << " commits_per_sync=" << (syncs ? static_cast<double>(commits) / syncs : 0.0)
+                << " flush_waits=" << after.flush_waits - before.flush_waits
+                << " errors=" << errors.load() << "\n";
+    }
+    wal->SetGroupCommit(true);
+  }
+
+  // === 冷段：整段压缩（PAX 页按列 FOR / 字典 + LZ4，槽位页整页 LZ4），之后的扫描未命中时解压读页 ===
+  if (args.cold) {
+    const uint64_t hot_before = DiskBytes(sm.SegmentPath(args.seg));
+    const auto t_freeze = std::chrono::steady_clock::now();
+    Status fs = table.Freeze();
+    const double freeze_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - t_freeze).count();
+    if (!fs.ok()) {
+      std::cerr << "[ERR] freeze failed: " << fs.message() << "\n";
+    } else {
+      const ColdSegmentStats cst = sm.GetColdStats(args.seg);
+      const double mb = 1024.0 * 1024.0;
+      std::cout << "[COLD] freeze: ms=" << freeze_ms << " pages=" << cst.pages
+                << " raw_MB=" << cst.raw_bytes / mb << " stored_MB=" << cst.stored_bytes / mb
+                << " ratio=" << (cst.stored_bytes ? static_cast<double>(cst.raw_bytes) / cst.stored_bytes : 0.0)
+                << " pax_pages=" << cst.pax_pages << " lz4_pages=" << cst.lz4_pages << " raw_pages=" << cst.raw_pages
+                << " for_cols=" << cst.for_columns << " dict_cols=" << cst.dict_columns
+                << " | disk: seg_MB " << hot_before / mb << " -> " << DiskBytes(sm.SegmentPath(args.seg)) / mb
+                << " cold_MB=" << DiskBytes(sm.SegmentPath(args.seg) + ".cold") / mb << "\n";
+    }
+  }
 
   // === 简单校验：全表扫描 5 行预览 ===
   size_t scan_cnt = 0, preview = 5;
-  for (auto it = table.Begin(); it != table.End(); ++it) {
-    const auto& row = *it;
+  ScanOptions scan_opt;
+  scan_opt.prefetch_pages = static_cast<uint32_t>(std::max(0, args.prefetch));
+  scan_opt.bulk_read      = args.scan_ring > 0;
+  const BufferStats before_scan = bpm.GetStats();
+  auto it = table.Begin(scan_opt);
+  for (; it != table.End(); ++it) {
+    const TupleView& row = it.view();  // 零拷贝：直接读被固定页内的记录
     scan_cnt++;
     if (preview > 0) {
       int32_t suppkey = 0, nation = 0; double acctbal = 0.0;
       std::string name, phone;
-      row.tuple.GetInt32 (schema, 0, &suppkey);
-      row.tuple.GetChar  (schema, 1, &name);
-      row.tuple.GetInt32 (schema, 3, &nation);
-      row.tuple.GetChar  (schema, 4, &phone);
-      row.tuple.GetDouble(schema, 5, &acctbal);
-      std::cout << "[ROW] RID=(" << row.rid.page_id << "," << row.rid.slot
+      row.GetInt32 (schema, 0, &suppkey);
+      row.GetChar  (schema, 1, &name);
+      row.GetInt32 (schema, 3, &nation);
+      row.GetChar  (schema, 4, &phone);
+      row.GetDouble(schema, 5, &acctbal);
+      std::cout << "[ROW] RID=(" << it.rid().page_id << "," << it.rid().slot
                 << ") suppkey=" << suppkey
                 << " name=\"" << name << "\""
                 << " nation=" << nation
@@ -250,6 +714,304 @@ int main(int argc, char** argv) {
     }
   }
   std::cout << "[SCAN] total rows = " << scan_cnt << "\n";
+  if (!it.status().ok()) std::cerr << "[ERR] scan stopped: " << it.status().message() << "\n";
+  const BufferStats after_scan = bpm.GetStats();
+  std::cout << "[SCAN] stats: misses=" << (after_scan.misses - before_scan.misses)
+            << " prefetches=" << (after_scan.prefetches - before_scan.prefetches)
+            << " prefetch_hits=" << (after_scan.prefetch_hits - before_scan.prefetch_hits)
+            << " ring_reuses=" << (after_scan.ring_reuses - before_scan.ring_reuses)
+            << " ring_frames=" << after_scan.ring_frames
+            << " checksum_failures=" << (after_scan.checksum_failures - before_scan.checksum_failures) << "\n";
+
+  // === 两列聚合：逐行读 acctbal 与列投影扫描对照（--cols=1） ===
+  if (args.cols) {
+    const auto t_row = std::chrono::steady_clock::now();
+    size_t row_n = 0;
+    double row_sum = 0.0;
+    for (auto rit = table.Begin(scan_opt); rit != table.End(); ++rit) {
+      int32_t key = 0; double bal = 0.0;
+      if (rit.view().GetInt32(schema, 0, &key).ok() && rit.view().GetDouble(schema, 5, &bal).ok()) {
+        row_sum += bal;
+        ++row_n;
+      }
+    }
+    const double row_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - t_row).count();
+
+    // 同样的逐行扫描，字段经预编译的 RowCodec 读取（类型在绑定时校验一次）
+    const auto t_codec = std::chrono::steady_clock::now();
+    size_t codec_n = 0;
+    double codec_sum = 0.0;
+    RowCodec codec;
+    if (RowCodec::Compile(schema, {0, 5}, &codec).ok() &&
+        codec.Expect(0, Type::INT32).ok() && codec.Expect(1, Type::DOUBLE).ok()) {
+      for (auto rit = table.Begin(scan_opt); rit != table.End(); ++rit) {
+        if (!codec.Valid(rit.view())) continue;
+        codec_sum += codec.Double(rit.view().Data(), 1);
+        ++codec_n;
+      }
+    }
+    const double codec_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - t_codec).count();
+
+    const auto t_col = std::chrono::steady_clock::now();
+    size_t col_n = 0;
+    double col_sum = 0.0;
+    ColumnScanner cs = table.ScanColumns({0, 5}, scan_opt);
+    while (cs.Next()) {
+      const ColumnPage& pg = cs.page();
+      for (uint32_t r = 0; r < pg.rows; ++r) {
+        if (!pg.IsLive(r)) continue;
+        col_sum += pg.Value<double>(1, r);
+        ++col_n;
+      }
+    }
+    const double col_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - t_col).count();
+    if (!cs.status().ok()) std::cerr << "[ERR] column scan stopped: " << cs.status().message() << "\n";
+    std::cout << "[COLS] suppkey+acctbal: row_scan rows=" << row_n << " sum=" << row_sum << " ms=" << row_ms
+              << " | codec_scan rows=" << codec_n << " sum=" << codec_sum << " ms=" << codec_ms
+              << " | column_scan rows=" << col_n << " sum=" << col_sum << " ms=" << col_ms << "\n";
+  }
+
+  // === 带过滤的聚合：acctbal > 5000 AND nationkey IN (1,3,5,7,9)，逐行求值与批扫描（SIMD / 标量）对照（--batch_scan=1） ===
+  if (args.batch_scan) {
+    const auto t_row = std::chrono::steady_clock::now();
+    size_t row_n = 0;
+    double row_sum = 0.0;
+    for (auto rit = table.Begin(scan_opt); rit != table.End(); ++rit) {
+      int32_t nation = 0; double bal = 0.0;
+      if (!rit.view().GetInt32(schema, 3, &nation).ok() || !rit.view().GetDouble(schema, 5, &bal).ok()) continue;
+      if (bal > 5000.0 && nation >= 1 && nation <= 9 && nation % 2 == 1) {
+        row_sum += bal;
+        ++row_n;
+      }
+    }
+    const double row_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - t_row).count();
+    std::cout << "[BATCH] acctbal>5000 AND nationkey IN(1,3,5,7,9): row_scan rows=" << row_n
+              << " sum=" << row_sum << " ms=" << row_ms;
+
+    const Predicate pred = Predicate().Compare(5, CompareOp::kGt, 5000.0).In(3, {1, 3, 5, 7, 9});
+    for (const bool simd : {true, false}) {
+      BatchScanOptions bopt;
+      bopt.simd = simd;
+      bopt.scan = scan_opt;
+      const auto t_batch = std::chrono::steady_clock::now();
+      size_t n = 0;
+      double sum = 0.0;
+      BatchScanner bs = table.ScanBatches({5}, pred, bopt);
+      while (bs.Next()) {
+        const RecordBatch& b = bs.batch();
+        b.ForEachSelected([&](uint32_t r) { sum += b.Value<double>(0, r); });
+        n += b.selected;
+      }
+      const double ms = std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - t_batch).count();
+      if (!bs.status().ok()) std::cerr << "\n[ERR] batch scan stopped: " << bs.status().message() << "\n";
+      std::cout << " | batch(" << bs.kernel() << ") rows=" << n << " sum=" << sum << " ms=" << ms;
+    }
+    std::cout << "\n";
+  }
+
+  // === 区间摘要跳页：suppkey BETWEEN 1 AND 2000（按装载顺序近似有序），跳页与逐页读取对照（--zone=1） ===
+  if (const ZoneMap* zm = args.zone ? table.zone_map() : nullptr) {
+    const Predicate pred = Predicate().Between(0, 1, 2000);
+    std::cout << "[ZONE] suppkey BETWEEN 1 AND 2000:";
+    for (const bool zones : {true, false}) {
+      BatchScanOptions bopt;
+      bopt.zone_maps = zones;
+      bopt.scan      = scan_opt;
+      const auto t_zone = std::chrono::steady_clock::now();
+      size_t n = 0;
+      double sum = 0.0;
+      BatchScanner bs = table.ScanBatches({5}, pred, bopt);
+      while (bs.Next()) {
+        const RecordBatch& b = bs.batch();
+        b.ForEachSelected([&](uint32_t r) { sum += b.Value<double>(0, r); });
+        n += b.selected;
+      }
+      const double ms = std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - t_zone).count();
+      if (!bs.status().ok()) std::cerr << "\n[ERR] zone scan stopped: " << bs.status().message() << "\n";
+      std::cout << (zones ? " " : " | ") << (zones ? "zone_maps" : "full") << " rows=" << n << " sum=" << sum
+                << " skipped_pages=" << bs.pages_skipped() << " ms=" << ms;
+    }
+    std::cout << " | map: columns=" << zm->columns().size() << " tracked_pages=" << zm->TrackedPages()
+              << " mem_KB=" << zm->MemoryBytes() / 1024.0 << "\n";
+  }
+
+  // === B+ 树索引：suppkey → RID。seg+1 由排序后的条目批量构建，seg+2 由并行扫描的各线程并发插入 ===
+  if (args.index) {
+    using dbms::index::BTree;
+    using dbms::index::BTreeEntry;
+    using dbms::index::BTreeIterator;
+    using dbms::index::BTreeStats;
+    // 索引每次按当前表重建：先归还上次运行留下的索引页（高水位回到 0）
+    const seg_id_t bulk_seg = args.seg + 1, insert_seg = args.seg + 2;
+    for (seg_id_t s : {bulk_seg, insert_seg}) {
+      if (sm.EnsureSegment(s).ok() && sm.PageCount(s) > 0) {
+        sm.FreePages(s, 0, static_cast<uint32_t>(sm.PageCount(s)));
+      }
+    }
+    std::unique_ptr<BTree> bulk_tree, insert_tree;
+    Status os = BTree::Open(bulk_seg, &bpm, &sm, {}, &bulk_tree);
+    if (os.ok()) os = BTree::Open(insert_seg, &bpm, &sm, {}, &insert_tree);
+    if (!os.ok()) {
+      std::cerr << "[ERR] index open failed: " << os.message() << "\n";
+    } else {
+      ParallelScanOptions popt;
+      popt.threads = static_cast<uint32_t>(std::max(0, args.scan_threads));
+      popt.scan    = scan_opt;
+
+      // 批量构建：并行扫描收集 (suppkey, rid)，排序后自底向上建树
+      const auto t_bulk = std::chrono::steady_clock::now();
+      ParallelScanner collect = table.ParallelScan(popt);
+      std::vector<std::vector<BTreeEntry>> parts(collect.threads());
+      Status cs = collect.ForEachRow([&](uint32_t w, const TableIterator& rit) {
+        int32_t key = 0;
+        if (rit.view().GetInt32(schema, 0, &key).ok()) parts[w].push_back({key, rit.rid()});
+      });
+      std::vector<BTreeEntry> entries;
+      for (auto& p : parts) entries.insert(entries.end(), p.begin(), p.end());
+      std::sort(entries.begin(), entries.end(), [](const BTreeEntry& a, const BTreeEntry& b) {
+        if (a.key != b.key) return a.key < b.key;
+        return a.rid.page_id != b.rid.page_id ? a.rid.page_id < b.rid.page_id : a.rid.slot < b.rid.slot;
+      });
+      if (cs.ok()) cs = bulk_tree->BulkBuild(entries);
+      const double bulk_ms = std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - t_bulk).count();
+
+      // 并发插入：各工作线程把自己扫到的行直接插入同一棵树
+      const auto t_ins = std::chrono::steady_clock::now();
+      std::atomic<uint64_t> insert_errors{0};
+      ParallelScanner feed = table.ParallelScan(popt);
+      Status fs = feed.ForEachRow([&](uint32_t, const TableIterator& rit) {
+        int32_t key = 0;
+        if (!rit.view().GetInt32(schema, 0, &key).ok() || !insert_tree->Insert(key, rit.rid()).ok()) {
+          insert_errors.fetch_add(1, std::memory_order_relaxed);
+        }
+      });
+      const double insert_ms = std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - t_ins).count();
+      if (!cs.ok()) std::cerr << "[ERR] index bulk build failed: " << cs.message() << "\n";
+      if (!fs.ok()) std::cerr << "[ERR] index insert scan stopped: " << fs.message() << "\n";
+
+      BTreeStats bst, ist;
+      (void)bulk_tree->GetStats(&bst);
+      (void)insert_tree->GetStats(&ist);
+      std::cout << "[INDEX] suppkey: bulk entries=" << bst.entries << " height=" << bst.height
+                << " leaves=" << bst.leaf_pages << " fill=" << bst.leaf_fill << " ms=" << bulk_ms
+                << " | insert threads=" << feed.threads() << " entries=" << ist.entries << " height=" << ist.height
+                << " leaves=" << ist.leaf_pages << " fill=" << ist.leaf_fill << " errors=" << insert_errors.load()
+                << " ms=" << insert_ms << "\n";
+
+      // 点查：随机取已有的键，经索引取全部 RID 并回表读行；对照一次不跳页的全表批扫描
+      const int lookups = 10000;
+      std::mt19937_64 rng(42);
+      size_t hit_rows = 0;
+      std::vector<RID> rids;
+      Tuple row;
+      const auto t_get = std::chrono::steady_clock::now();
+      for (int i = 0; i < lookups && !entries.empty(); ++i) {
+        const int64_t key = entries[rng() % entries.size()].key;
+        rids.clear();
+        if (!bulk_tree->Get(key, &rids).ok()) continue;
+        for (const RID& r : rids) hit_rows += table.Get(r, &row).ok() ? 1 : 0;
+      }
+      const double get_ms = std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - t_get).count();
+
+      const int64_t probe = entries.empty() ? 0 : entries[entries.size() / 2].key;
+      BatchScanOptions bopt;
+      bopt.zone_maps = false;
+      bopt.scan      = scan_opt;
+      const auto t_full = std::chrono::steady_clock::now();
+      size_t full_rows = 0;
+      BatchScanner bs = table.ScanBatches({0}, Predicate().Compare(0, CompareOp::kEq, probe), bopt);
+      while (bs.Next()) full_rows += bs.batch().selected;
+      const double full_ms = std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - t_full).count();
+      std::vector<RID> probe_rids;
+      (void)bulk_tree->Get(probe, &probe_rids);
+
+      // 区间：与 [ZONE] 同一条件，沿叶子右链扫描
+      const auto t_range = std::chrono::steady_clock::now();
+      size_t range_n = 0;
+      BTreeIterator it_range = bulk_tree->Scan(1, 2000);
+      while (it_range.Next()) ++range_n;
+      const double range_ms = std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - t_range).count();
+
+      std::cout << "[INDEX] point lookups=" << lookups << " rows=" << hit_rows
+                << " us_per_lookup=" << (lookups ? get_ms * 1000.0 / lookups : 0.0)
+                << " | suppkey=" << probe << ": index rows=" << probe_rids.size()
+                << " full_scan rows=" << full_rows << " ms=" << full_ms
+                << " | range 1..2000 rows=" << range_n << " ms=" << range_ms << "\n";
+
+      bpm.FlushAll();
+      for (BTree* t : {bulk_tree.get(), insert_tree.get()}) {
+        if (Status ks = t->Checkpoint(); !ks.ok()) std::cerr << "[WARN] index checkpoint failed: " << ks.message() << "\n";
+      }
+    }
+  }
+
+  // === 并行扫描：按 morsel 分给工作线程；各线程的部分结果按 worker 下标分开累计，最后合并（--pscan=1） ===
+  if (args.pscan) {
+    ParallelScanOptions popt;
+    popt.threads      = static_cast<uint32_t>(std::max(0, args.scan_threads));
+    popt.morsel_pages = static_cast<uint32_t>(std::max(1, args.morsel));
+    popt.scan         = scan_opt;
+    ParallelScanner ps = table.ParallelScan(popt);
+    struct alignas(64) Partial { size_t n = 0; double sum = 0.0; };
+    std::vector<Partial> parts(ps.threads());
+
+    const auto t_rows = std::chrono::steady_clock::now();
+    Status rs = ps.ForEachRow([&](uint32_t w, const TableIterator& rit) { ++parts[w].n; (void)rit; });
+    const double rows_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - t_rows).count();
+    size_t rows_n = 0;
+    for (auto& p : parts) { rows_n += p.n; p = Partial{}; }
+    const ParallelScanStats row_stats = ps.stats();
+
+    const auto t_batch = std::chrono::steady_clock::now();
+    const Predicate pred = Predicate().Compare(5, CompareOp::kGt, 5000.0).In(3, {1, 3, 5, 7, 9});
+    Status bs = ps.ForEachBatch({5}, pred, BatchScanOptions{}, [&](uint32_t w, const RecordBatch& b) {
+      b.ForEachSelected([&](uint32_t r) { parts[w].sum += b.Value<double>(0, r); });
+      parts[w].n += b.selected;
+    });
+    const double batch_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - t_batch).count();
+    size_t batch_n = 0;
+    double batch_sum = 0.0;
+    for (const auto& p : parts) { batch_n += p.n; batch_sum += p.sum; }
+
+    if (!rs.ok()) std::cerr << "[ERR] parallel scan stopped: " << rs.message() << "\n";
+    if (!bs.ok()) std::cerr << "[ERR] parallel batch scan stopped: " << bs.message() << "\n";
+    std::cout << "[PSCAN] threads=" << row_stats.threads << " morsel_pages=" << popt.morsel_pages
+              << " morsels=" << row_stats.morsels << " stolen=" << row_stats.stolen
+              << " | rows=" << rows_n << " ms=" << rows_ms
+              << " | batch rows=" << batch_n << " sum=" << batch_sum << " ms=" << batch_ms
+              << " stolen=" << ps.stats().stolen << "\n";
+  }
+  if (args.cold && table.IsCold()) {
+    const ColdSegmentStats cst = sm.GetColdStats(args.seg);
+    std::cout << "[COLD] reads: decoded_pages=" << cst.decoded_pages
+              << " read_MB=" << cst.read_bytes / (1024.0 * 1024.0)
+              << " decode_ms=" << cst.decode_ns / 1e6
+              << " ns_per_page=" << (cst.decoded_pages ? static_cast<double>(cst.decode_ns) / cst.decoded_pages : 0.0)
+              << "\n";
+  }
+  if (args.warmup) {
+    const BufferStats wst = bpm.GetStats();
+    std::cout << "[WARMUP] pages=" << wst.warmup_pages << " loaded=" << wst.warmup_loaded
+              << " skipped=" << wst.warmup_skipped << " running=" << (wst.warmup_running ? 1 : 0)
+              << " prefetch_hits=" << wst.prefetch_hits << "\n";
+  }
+  if (metrics) {
+    metrics->StopPeriodicDump();
+    LogMetrics(args.metrics_every_ms > 0 ? "last_interval" : "total", metrics->Snapshot());
+  }
   LogFsm(fsm);
   return 0;
 }
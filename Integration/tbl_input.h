@@ -0,0 +1,128 @@
+#ifndef DBMS_INTEGRATION_TBL_INPUT_H_
+#define DBMS_INTEGRATION_TBL_INPUT_H_
+
+/**
+ * @file tbl_input.h
+ * @brief .tbl 输入的零拷贝读取：mmap 整个文件，按 '\n' / '|' 切分为 string_view 字段。
+ *
+ * 与 ifstream + SplitPipe 的区别：
+ *  - 不逐行拷贝到 std::string，也不为每个字段分配 std::string；
+ *  - 行尾用 memchr 查找（libc 内部已向量化），行内 '|' 用 SSE2 每次比较 16 字节，
+ *    得到位掩码后逐位取出分隔符位置；非 x86 平台退化为逐字节扫描；
+ *  - 字段视图直接指向映射内存，生命周期随 MappedFile。
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace dbms {
+namespace integration {
+
+/// 只读映射整个文件（RAII）
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile() { Close(); }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool Open(const std::string& path) {
+    Close();
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) { ::close(fd); return false; }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+      void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p == MAP_FAILED) { ::close(fd); size_ = 0; return false; }
+      ::madvise(p, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<const char*>(p);
+    }
+    ::close(fd);  // 映射不依赖 fd
+    return true;
+  }
+
+  void Close() {
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  const char* data() const noexcept { return data_; }
+  size_t      size() const noexcept { return size_; }
+
+private:
+  const char* data_{nullptr};
+  size_t      size_{0};
+};
+
+/**
+ * @brief 把 [b, e) 按 delim 切分，最多写出 max 个字段；返回字段数（超过 max 时返回 max+1）。
+ *        末尾字段为最后一个分隔符之后的部分（可能为空）。
+ */
+inline size_t SplitFields(const char* b, const char* e, char delim,
+                          std::string_view* out, size_t max) {
+  size_t n = 0;
+  const char* field = b;
+  auto emit = [&](const char* at) {
+    if (n < max) out[n] = std::string_view(field, static_cast<size_t>(at - field));
+    ++n;
+    field = at + 1;
+  };
+
+  const char* p = b;
+#if defined(__SSE2__)
+  const __m128i needle = _mm_set1_epi8(delim);
+  for (; e - p >= 16; p += 16) {
+    const __m128i blk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(blk, needle)));
+    while (mask) {
+      emit(p + __builtin_ctz(mask));
+      if (n > max) return n;
+      mask &= mask - 1;
+    }
+  }
+#endif
+  for (; p < e; ++p) {
+    if (*p == delim) {
+      emit(p);
+      if (n > max) return n;
+    }
+  }
+  if (n < max) out[n] = std::string_view(field, static_cast<size_t>(e - field));
+  return n + 1;
+}
+
+/**
+ * @brief 顺序遍历 [b, e) 中的行（去掉行末 '\r'）；返回 false 表示已无更多行。
+ *        *pos 为游标，初值为起点。
+ */
+inline bool NextLine(const char** pos, const char* e, std::string_view* line) {
+  const char* p = *pos;
+  if (p >= e) return false;
+  const void* nl = std::memchr(p, '\n', static_cast<size_t>(e - p));
+  const char* end = nl ? static_cast<const char*>(nl) : e;
+  *pos = nl ? end + 1 : e;
+  const char* le = (end > p && end[-1] == '\r') ? end - 1 : end;
+  *line = std::string_view(p, static_cast<size_t>(le - p));
+  return true;
+}
+
+}  // namespace integration
+}  // namespace dbms
+
+#endif  // DBMS_INTEGRATION_TBL_INPUT_H_
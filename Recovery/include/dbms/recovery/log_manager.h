@@ -0,0 +1,123 @@
+#ifndef DBMS_RECOVERY_LOG_MANAGER_H_
+#define DBMS_RECOVERY_LOG_MANAGER_H_
+
+/**
+ * @file log_manager.h
+ * @brief 预写日志（WAL）：只追加的日志缓冲 + 组提交，实现 storage::ILogSink 供 TableHeap 挂接。
+ *
+ * 追加：定长环形缓冲，写者以一次 fetch_add 预留 [start, end) 并拷贝记录（不持任何锁），
+ *       再按预留顺序发布（等前一条发布完成后推进 filled）。LSN 即记录末尾的文件偏移。
+ * 组提交：Flush(lsn) 时若已有线程在写盘，则等待它完成；否则成为领头者，把当时已发布的全部日志
+ *        一次写出并 fdatasync，等待者中 LSN 被覆盖的直接返回。并发提交越多，每次同步分摊的提交越多。
+ *        关闭组提交时提交逐个串行，每个提交者写到自己的 LSN 并各自同步（对照用）。
+ * 写前约束：AttachTo(bpm) 注册刷盘回调，页写盘前先把日志刷到该页的 page_lsn。
+ *
+ * 本模块只负责日志的产生与持久化；按日志重做（恢复）与日志截断尚未实现，LogReader 可用于检查日志内容。
+ * 日志对象须比挂接它的表与缓冲池活得更久（或先 Detach）。
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "dbms/storage/storage_types.h"
+#include "dbms/storage/io/file.h"
+#include "dbms/storage/table/log_sink.h"
+#include "dbms/recovery/log_record.h"
+
+namespace dbms {
+namespace storage { class BufferPoolManager; }
+
+namespace recovery {
+
+struct LogOptions {
+  size_t   buffer_bytes  = 4u << 20;  ///< 环形缓冲大小（向上取 2 的幂）；单条记录不能超过它
+  bool     group_commit  = true;      ///< false 则每个提交者各自写盘同步
+  uint32_t group_wait_us = 0;         ///< 领头者写盘前额外等待的微秒数，用来攒更多提交（0 不等）
+};
+
+struct LogStats {
+  uint64_t records{0};      ///< 追加的记录数
+  uint64_t bytes{0};        ///< 追加的字节数
+  uint64_t commits{0};      ///< Commit 次数
+  uint64_t syncs{0};        ///< fdatasync 次数
+  uint64_t flush_waits{0};  ///< Flush 时等待其他领头者的次数
+  uint64_t space_waits{0};  ///< 追加时因缓冲满而等待写盘的次数
+};
+
+class LogManager : public storage::ILogSink {
+public:
+  /// 打开（不存在则创建）日志文件；已有日志时从有效末尾继续追加（其后不完整的尾部被截掉）
+  static Status Open(const std::string& path, const LogOptions& opt, std::unique_ptr<LogManager>* out);
+
+  /// 析构时把已追加的日志刷盘
+  ~LogManager() override;
+
+  LogManager(const LogManager&) = delete;
+  LogManager& operator=(const LogManager&) = delete;
+
+  /// ILogSink：追加一条页修改记录（不等待写盘）
+  uint64_t LogPage(storage::PageLogOp op, seg_id_t seg, page_id_t pid, uint16_t slot,
+                   const std::uint8_t* data, uint32_t len) override;
+
+  /// 追加任意记录；返回其 LSN，日志已出错或记录超过缓冲大小返回 0
+  uint64_t Append(LogRecordType type, seg_id_t seg, page_id_t pid, uint16_t slot,
+                  const std::uint8_t* data, uint32_t len);
+
+  /// 追加提交记录并等待其持久；out_lsn 可为 nullptr
+  Status Commit(uint64_t* out_lsn = nullptr);
+
+  /// 等待 LSN <= lsn 的日志持久（必要时由本线程领头写盘）；写盘出错后一直返回该错误
+  Status Flush(uint64_t lsn);
+
+  /// 已预留的末尾（下一条记录的起点）
+  uint64_t current_lsn() const noexcept { return reserved_.load(std::memory_order_acquire); }
+  /// 已持久的末尾
+  uint64_t durable_lsn() const noexcept { return durable_.load(std::memory_order_acquire); }
+
+  LogStats GetStats() const;
+  void     SetGroupCommit(bool on) noexcept { group_commit_.store(on, std::memory_order_relaxed); }
+
+  /// 注册缓冲池刷盘回调，使页不会先于其日志落盘；Detach 注销
+  void AttachTo(storage::BufferPoolManager* bpm);
+  void Detach(storage::BufferPoolManager* bpm);
+
+private:
+  LogManager(storage::File file, const LogOptions& opt, uint64_t tail);
+
+  void   Publish(uint64_t start, uint64_t end);        // 等前序记录发布完成后推进 filled_
+  Status WriteOut(uint64_t from, uint64_t to);          // 把环中 [from, to) 写到文件同偏移处（仅领头者）
+  Status LastError();                                   // 粘滞错误的副本
+
+private:
+  storage::File             file_;
+  LogOptions                opt_;
+  std::vector<std::uint8_t> ring_;
+  uint64_t                  mask_{0};
+  std::atomic<bool>         group_commit_{true};
+
+  // 四个递增的 LSN：durable <= written <= filled <= reserved
+  std::atomic<uint64_t> reserved_{0};  // 已预留
+  std::atomic<uint64_t> filled_{0};    // 已拷入环且之前无空洞
+  std::atomic<uint64_t> written_{0};   // 已写入文件（同时释放环空间）
+  std::atomic<uint64_t> durable_{0};   // 已同步
+
+  std::mutex              commit_mu_;         // 关闭组提交时串行化“追加提交记录 + 刷盘”
+  std::mutex              flush_mu_;
+  std::condition_variable flush_cv_;
+  bool                    flushing_{false};   // 有领头者在写盘
+  uint64_t                allocated_{0};      // 文件已预留到的偏移
+  Status                  error_{};
+  std::atomic<bool>       failed_{false};
+
+  std::atomic<uint64_t> records_{0}, bytes_{0}, commits_{0}, syncs_{0}, flush_waits_{0}, space_waits_{0};
+};
+
+}  // namespace recovery
+}  // namespace dbms
+
+#endif  // DBMS_RECOVERY_LOG_MANAGER_H_
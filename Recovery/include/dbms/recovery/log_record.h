@@ -0,0 +1,105 @@
+#ifndef DBMS_RECOVERY_LOG_RECORD_H_
+#define DBMS_RECOVERY_LOG_RECORD_H_
+
+/**
+ * @file log_record.h
+ * @brief WAL 文件格式与顺序读取器。
+ *
+ * 文件布局：[ LogFileHeader (64B) | 记录 | 记录 | ... ]，只追加。
+ *  - LSN 即记录末尾在文件中的字节偏移：page_lsn <= durable_lsn 表示该页的所有修改都已落盘；
+ *  - 每条记录：[ LogRecordHeader | 负载 data_len 字节 ]，头部的 crc 覆盖其后的头部字段与负载；
+ *  - 文件按块预留（fallocate），尾部是全零：读到长度为 0、越界或校验失败的记录即为日志末尾
+ *    （崩溃时未完整写出的一组记录从未被确认提交，丢弃是安全的）。
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "dbms/storage/storage_types.h"
+#include "dbms/storage/io/file.h"
+#include "dbms/storage/table/log_sink.h"
+
+namespace dbms {
+namespace recovery {
+
+using storage::page_id_t;
+using storage::seg_id_t;
+using storage::Status;
+
+constexpr uint32_t kLogMagic       = 0x4C415744;  // "DWAL"
+constexpr uint32_t kLogVersion     = 1;
+constexpr uint64_t kLogHeaderBytes = 64;
+
+/// 记录类型：页修改沿用 storage::PageLogOp 的取值，其后为日志自身的记录
+enum class LogRecordType : uint8_t {
+  kPageInit  = static_cast<uint8_t>(storage::PageLogOp::kPageInit),
+  kInsert    = static_cast<uint8_t>(storage::PageLogOp::kInsert),
+  kUpdate    = static_cast<uint8_t>(storage::PageLogOp::kUpdate),
+  kErase     = static_cast<uint8_t>(storage::PageLogOp::kErase),
+  kPageImage = static_cast<uint8_t>(storage::PageLogOp::kPageImage),
+  kCommit    = 16,  ///< 提交点：其 LSN 持久即此前的所有记录持久
+};
+
+struct LogFileHeader {
+  uint32_t magic{kLogMagic};
+  uint32_t version{kLogVersion};
+  uint8_t  reserved[kLogHeaderBytes - 8]{};
+};
+static_assert(sizeof(LogFileHeader) == kLogHeaderBytes, "LogFileHeader is part of the on-disk format.");
+
+struct LogRecordHeader {
+  uint32_t crc{0};       ///< CRC-32C：从 length 起到负载末尾
+  uint32_t length{0};    ///< 整条记录字节数（含头部）
+  uint8_t  type{0};      ///< LogRecordType
+  uint8_t  reserved{0};
+  uint16_t slot{0};
+  seg_id_t seg{0};
+  page_id_t page{0};
+  uint32_t data_len{0};
+};
+static_assert(sizeof(LogRecordHeader) == 24, "LogRecordHeader is part of the on-disk format.");
+
+/// 读取器给出的一条记录
+struct LogRecord {
+  uint64_t                  lsn{0};  ///< 记录末尾的偏移
+  LogRecordType             type{LogRecordType::kCommit};
+  seg_id_t                  seg{0};
+  page_id_t                 page{0};
+  uint16_t                  slot{0};
+  std::vector<std::uint8_t> data;
+};
+
+/**
+ * @brief 从头顺序读取日志文件，直到第一条不完整或校验失败的记录。
+ *
+ * 用法：LogReader r(path); if (r.Open().ok()) while (r.Next(&rec)) {...}; r.end_lsn() 为有效日志的末尾。
+ */
+class LogReader {
+public:
+  explicit LogReader(std::string path) : file_(std::move(path)) {}
+
+  /// 打开并校验文件头；文件不存在返回 NotFound
+  Status Open();
+
+  /// 读出下一条记录；到达末尾或出错返回 false（出错时 status() 非 OK）
+  bool Next(LogRecord* out);
+
+  uint64_t      end_lsn() const noexcept { return pos_; }
+  const Status& status()  const noexcept { return status_; }
+
+private:
+  bool Fill(uint64_t need);  // 保证缓冲中从 pos_ 起至少有 need 字节（不足时读到文件末尾为止）
+
+  storage::File             file_;
+  uint64_t                  size_{0};
+  uint64_t                  pos_{kLogHeaderBytes};  // 下一条记录的起始偏移
+  std::vector<std::uint8_t> buf_;                   // 缓存文件 [buf_off_, buf_off_ + buf_.size())
+  uint64_t                  buf_off_{0};
+  Status                    status_{};
+};
+
+}  // namespace recovery
+}  // namespace dbms
+
+#endif  // DBMS_RECOVERY_LOG_RECORD_H_
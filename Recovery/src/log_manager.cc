@@ -0,0 +1,243 @@
+#include "dbms/recovery/log_manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+#include "dbms/storage/buffer/buffer_pool_manager.h"
+#include "internal/util/crc32c.h"
+
+namespace dbms {
+namespace recovery {
+
+namespace {
+
+constexpr uint64_t kAllocChunk = 16u << 20;  // 文件按块预留，减少同步时的元数据更新
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+}  // namespace
+
+Status LogManager::Open(const std::string& path, const LogOptions& opt, std::unique_ptr<LogManager>* out) {
+  if (!out) return Status::InvalidArgument("LogManager::Open: out is null");
+  if (opt.buffer_bytes < 4096) return Status::InvalidArgument("LogManager::Open: buffer_bytes too small");
+
+  // 已有日志：扫到有效末尾，从那里继续
+  uint64_t tail = 0;
+  LogReader reader(path);
+  Status s = reader.Open();
+  if (s.ok()) {
+    LogRecord rec;
+    while (reader.Next(&rec)) {}
+    if (!reader.status().ok()) return reader.status();
+    tail = reader.end_lsn();
+  } else if (s.code() != storage::StatusCode::kNotFound) {
+    return s;
+  }
+
+  storage::File file(path);
+  s = file.Open(/*create_if_missing=*/true);
+  if (!s.ok()) return s;
+  if (tail == 0) {
+    const LogFileHeader h{};
+    s = file.Resize(0);
+    if (s.ok()) s = file.WriteAt(&h, sizeof(h), 0);
+    tail = kLogHeaderBytes;
+  } else {
+    // 截掉不完整的尾部，免得新记录之后残留旧内容
+    s = file.Resize(tail);
+  }
+  if (s.ok()) s = file.Sync();
+  if (!s.ok()) return s;
+
+  out->reset(new LogManager(std::move(file), opt, tail));
+  return Status::OK();
+}
+
+LogManager::LogManager(storage::File file, const LogOptions& opt, uint64_t tail)
+    : file_(std::move(file)), opt_(opt), group_commit_(opt.group_commit), allocated_(tail) {
+  size_t cap = 4096;
+  while (cap < opt.buffer_bytes) cap <<= 1;
+  ring_.assign(cap, 0);
+  mask_ = cap - 1;
+  reserved_.store(tail, std::memory_order_relaxed);
+  filled_.store(tail, std::memory_order_relaxed);
+  written_.store(tail, std::memory_order_relaxed);
+  durable_.store(tail, std::memory_order_relaxed);
+}
+
+LogManager::~LogManager() {
+  (void)Flush(current_lsn());
+}
+
+uint64_t LogManager::LogPage(storage::PageLogOp op, seg_id_t seg, page_id_t pid, uint16_t slot,
+                             const std::uint8_t* data, uint32_t len) {
+  return Append(static_cast<LogRecordType>(op), seg, pid, slot, data, len);
+}
+
+uint64_t LogManager::Append(LogRecordType type, seg_id_t seg, page_id_t pid, uint16_t slot,
+                            const std::uint8_t* data, uint32_t len) {
+  if (failed_.load(std::memory_order_acquire)) return 0;
+  const uint64_t n = sizeof(LogRecordHeader) + static_cast<uint64_t>(len);
+  if (n > ring_.size() || n > std::numeric_limits<uint32_t>::max()) return 0;
+
+  // 校验和在预留之前算好：预留之后到发布之前的时间会挡住后继者，越短越好
+  LogRecordHeader h;
+  h.length   = static_cast<uint32_t>(n);
+  h.type     = static_cast<uint8_t>(type);
+  h.slot     = slot;
+  h.seg      = seg;
+  h.page     = pid;
+  h.data_len = len;
+  h.crc = storage::Crc32c(reinterpret_cast<const std::uint8_t*>(&h) + sizeof(h.crc), sizeof(h) - sizeof(h.crc));
+  if (len) h.crc = storage::Crc32c(data, len, h.crc);
+
+  const uint64_t start = reserved_.fetch_add(n, std::memory_order_acq_rel);
+  const uint64_t end   = start + n;
+
+  // 环里还有未写盘的旧日志占着位置：把 start 之前的日志刷出去腾出空间
+  if (end - written_.load(std::memory_order_acquire) > ring_.size()) {
+    space_waits_.fetch_add(1, std::memory_order_relaxed);
+    if (!Flush(start).ok()) {
+      Publish(start, end);  // 不拷贝内容也要发布，否则后继者永远等不到；出错后不会再写盘
+      return 0;
+    }
+  }
+
+  auto copy = [&](uint64_t at, const void* src, size_t bytes) {
+    const size_t pos   = static_cast<size_t>(at & mask_);
+    const size_t first = std::min(bytes, ring_.size() - pos);
+    std::memcpy(ring_.data() + pos, src, first);
+    if (bytes > first) std::memcpy(ring_.data(), static_cast<const std::uint8_t*>(src) + first, bytes - first);
+  };
+  copy(start, &h, sizeof(h));
+  if (len) copy(start + sizeof(h), data, len);
+
+  Publish(start, end);
+  records_.fetch_add(1, std::memory_order_relaxed);
+  bytes_.fetch_add(n, std::memory_order_relaxed);
+  return end;
+}
+
+void LogManager::Publish(uint64_t start, uint64_t end) {
+  // 前一条记录的拷贝通常只需几百纳秒：先自旋，久等才让出 CPU
+  for (uint32_t spins = 0; filled_.load(std::memory_order_acquire) != start; ++spins) {
+    if (spins < 64) CpuRelax();
+    else std::this_thread::yield();
+  }
+  filled_.store(end, std::memory_order_release);
+}
+
+Status LogManager::Commit(uint64_t* out_lsn) {
+  std::unique_lock<std::mutex> serial(commit_mu_, std::defer_lock);
+  if (!group_commit_.load(std::memory_order_relaxed)) serial.lock();
+  const uint64_t lsn = Append(LogRecordType::kCommit, 0, 0, 0, nullptr, 0);
+  if (lsn == 0) return LastError();
+  commits_.fetch_add(1, std::memory_order_relaxed);
+  if (out_lsn) *out_lsn = lsn;
+  return Flush(lsn);
+}
+
+Status LogManager::Flush(uint64_t lsn) {
+  // page_lsn 可能来自更早的日志文件：最多刷到当前末尾
+  lsn = std::min(lsn, current_lsn());
+  if (durable_.load(std::memory_order_acquire) >= lsn) return Status::OK();
+
+  std::unique_lock<std::mutex> lk(flush_mu_);
+  for (;;) {
+    if (durable_.load(std::memory_order_acquire) >= lsn) return Status::OK();
+    if (failed_.load(std::memory_order_relaxed)) return error_;
+    if (flushing_) {
+      // 跟随者：领头者这一轮写盘很可能已经覆盖 lsn
+      flush_waits_.fetch_add(1, std::memory_order_relaxed);
+      flush_cv_.wait(lk);
+      continue;
+    }
+    flushing_ = true;
+    const uint64_t from  = written_.load(std::memory_order_relaxed);
+    const bool     group = group_commit_.load(std::memory_order_relaxed);
+    lk.unlock();
+
+    if (group && opt_.group_wait_us) std::this_thread::sleep_for(std::chrono::microseconds(opt_.group_wait_us));
+    // 组提交写出当时已发布的全部日志；否则只写到自己的 LSN
+    uint64_t to = filled_.load(std::memory_order_acquire);
+    if (!group) to = std::min(to, lsn);
+    Status s;
+    if (to > from) {
+      s = WriteOut(from, to);
+      if (s.ok()) s = file_.Sync();
+      syncs_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    lk.lock();
+    flushing_ = false;
+    if (!s.ok()) {
+      error_ = s;
+      failed_.store(true, std::memory_order_release);
+    } else if (to > from) {
+      written_.store(to, std::memory_order_release);
+      durable_.store(to, std::memory_order_release);
+    }
+    flush_cv_.notify_all();
+    if (to <= from) {
+      // lsn 之前还有记录在拷贝：稍等再试
+      lk.unlock();
+      std::this_thread::yield();
+      lk.lock();
+    }
+  }
+}
+
+Status LogManager::WriteOut(uint64_t from, uint64_t to) {
+  if (to > allocated_) {
+    const uint64_t want = std::max(to, allocated_ + kAllocChunk);
+    Status s = file_.Allocate(allocated_, want - allocated_);
+    if (!s.ok()) return s;
+    allocated_ = want;
+  }
+  const size_t   pos   = static_cast<size_t>(from & mask_);
+  const uint64_t n     = to - from;
+  const size_t   first = static_cast<size_t>(std::min<uint64_t>(n, ring_.size() - pos));
+  Status s = file_.WriteAt(ring_.data() + pos, first, from);
+  if (s.ok() && n > first) s = file_.WriteAt(ring_.data(), static_cast<size_t>(n - first), from + first);
+  return s;
+}
+
+Status LogManager::LastError() {
+  std::lock_guard<std::mutex> g(flush_mu_);
+  if (!error_.ok()) return error_;
+  return Status::OutOfRange("LogManager: record larger than the log buffer");
+}
+
+LogStats LogManager::GetStats() const {
+  LogStats st;
+  st.records     = records_.load(std::memory_order_relaxed);
+  st.bytes       = bytes_.load(std::memory_order_relaxed);
+  st.commits     = commits_.load(std::memory_order_relaxed);
+  st.syncs       = syncs_.load(std::memory_order_relaxed);
+  st.flush_waits = flush_waits_.load(std::memory_order_relaxed);
+  st.space_waits = space_waits_.load(std::memory_order_relaxed);
+  return st;
+}
+
+void LogManager::AttachTo(storage::BufferPoolManager* bpm) {
+  if (!bpm) return;
+  bpm->RegisterFlushCallback([this](seg_id_t, page_id_t, uint64_t page_lsn) {
+    if (page_lsn) (void)Flush(page_lsn);
+  });
+}
+
+void LogManager::Detach(storage::BufferPoolManager* bpm) {
+  if (bpm) bpm->RegisterFlushCallback({});
+}
+
+}  // namespace recovery
+}  // namespace dbms
@@ -0,0 +1,76 @@
+#include "dbms/recovery/log_record.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "internal/util/crc32c.h"
+
+namespace dbms {
+namespace recovery {
+
+namespace {
+constexpr uint64_t kReadChunk = 1u << 20;
+}  // namespace
+
+Status LogReader::Open() {
+  struct stat st {};
+  if (::stat(file_.path().c_str(), &st) != 0 || st.st_size == 0) {
+    return Status::NotFound("LogReader: no log at " + file_.path());
+  }
+  Status s = file_.Open(/*create_if_missing=*/false);
+  if (!s.ok()) return s;
+  size_ = file_.SizeBytes();
+  if (size_ < kLogHeaderBytes) return Status::Corruption("LogReader: truncated header in " + file_.path());
+
+  LogFileHeader h;
+  s = file_.ReadAt(&h, sizeof(h), 0);
+  if (!s.ok()) return s;
+  if (h.magic != kLogMagic || h.version != kLogVersion) {
+    return Status::Corruption("LogReader: bad magic/version in " + file_.path());
+  }
+  pos_ = kLogHeaderBytes;
+  return Status::OK();
+}
+
+bool LogReader::Fill(uint64_t need) {
+  if (pos_ + need > size_) return false;
+  if (pos_ >= buf_off_ && pos_ + need <= buf_off_ + buf_.size()) return true;
+  const uint64_t n = std::min(size_ - pos_, std::max(need, kReadChunk));
+  buf_.resize(n);
+  Status s = file_.ReadAt(buf_.data(), n, pos_);
+  if (!s.ok()) {
+    status_ = s;
+    buf_.clear();
+    return false;
+  }
+  buf_off_ = pos_;
+  return true;
+}
+
+bool LogReader::Next(LogRecord* out) {
+  if (!status_.ok() || !file_.Valid()) return false;
+  if (!Fill(sizeof(LogRecordHeader))) return false;
+
+  LogRecordHeader h;
+  std::memcpy(&h, buf_.data() + (pos_ - buf_off_), sizeof(h));
+  // 预留区的全零、写了一半的尾部都在这里或校验处终止
+  if (h.length != sizeof(h) + static_cast<uint64_t>(h.data_len)) return false;
+  if (!Fill(h.length)) return false;
+
+  const std::uint8_t* p = buf_.data() + (pos_ - buf_off_);
+  if (storage::Crc32c(p + sizeof(h.crc), h.length - sizeof(h.crc)) != h.crc) return false;
+
+  pos_ += h.length;
+  out->lsn  = pos_;
+  out->type = static_cast<LogRecordType>(h.type);
+  out->seg  = h.seg;
+  out->page = h.page;
+  out->slot = h.slot;
+  out->data.assign(p + sizeof(h), p + h.length);
+  return true;
+}
+
+}  // namespace recovery
+}  // namespace dbms
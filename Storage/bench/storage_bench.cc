@@ -0,0 +1,636 @@
+/**
+ * @file storage_bench.cc
+ * @brief 存储层微基准套件：缓冲池命中/未命中、替换器 Victim、槽位页、FSM、表扫描与行编解码，结果可输出为 JSON / CSV。
+ *
+ * 用法：dbms_storage_bench [--format=text|json|csv] [--out=FILE] [--filter=SUBSTR] [--scale=1.0]
+ *                          [--threads=1,2,4,8] [--dir=/tmp]
+ *  - 每个结果一条记录：suite, name, workload, threads, params, ops, seconds, ops_per_s, ns_per_op, hit_ratio；
+ *    hit_ratio 只有缓冲池用例有（其余 JSON 为 null、CSV 为空）；
+ *  - --filter 只运行 "suite/name" 含该子串的用例；--scale 等比缩放操作数（CI 回归可用 0.1）；
+ *  - 访问模式：uniform（均匀）、zipf（θ=0.99，热点经散列打散到整个键空间）、scan_mix（zipf 点访问中
+ *    穿插 10% 的 32 页顺序扫描）。随机种子固定，同一版本多次运行的访问序列相同。
+ * 段文件建在 dir 下的临时目录，结束时删除；文件经页缓存读写（未命中衡量的是缓冲池路径而不是磁盘）。
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "dbms/storage/buffer/buffer_pool_manager.h"
+#include "dbms/storage/buffer/page_guard.h"
+#include "dbms/storage/buffer/replacer.h"
+#include "dbms/storage/record/row_codec.h"
+#include "dbms/storage/record/tuple.h"
+#include "dbms/storage/segment/segment_manager.h"
+#include "dbms/storage/space/free_space_manager.h"
+#include "dbms/storage/table/table_appender.h"
+#include "dbms/storage/table/table_heap.h"
+#include "dbms/storage/table/table_iterator.h"
+#include "internal/page/slotted_page_layout.h"
+
+using namespace dbms::storage;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t kPageSize = 8192;
+
+volatile uint64_t g_sink = 0;
+
+// ============================ 参数与结果 ============================
+
+struct Options {
+  std::string           format = "text";
+  std::string           out;
+  std::string           filter;
+  double                scale = 1.0;
+  std::vector<int>      threads = {1, 2, 4, 8};
+  std::string           dir = "/tmp";
+};
+
+struct Result {
+  std::string suite, name, workload;
+  int         threads{1};
+  std::string params;
+  uint64_t    ops{0};
+  double      seconds{0};
+  double      hit_ratio{std::numeric_limits<double>::quiet_NaN()};
+
+  double ops_per_s() const { return seconds > 0 ? ops / seconds : 0.0; }
+  double ns_per_op() const { return ops ? seconds * 1e9 / ops : 0.0; }
+};
+
+class Reporter {
+public:
+  explicit Reporter(const Options& opt) : opt_(opt) {}
+
+  bool Enabled(const std::string& suite, const std::string& name) const {
+    return opt_.filter.empty() || (suite + "/" + name).find(opt_.filter) != std::string::npos;
+  }
+
+  void Add(Result r) {
+    // 边跑边打印（机器可读格式时打印到 stderr，结果最后一次写出）
+    FILE* log = opt_.format == "text" ? stdout : stderr;
+    std::fprintf(log, "%-8s %-16s %-9s threads=%-2d %-34s %12.0f ops/s %10.1f ns/op",
+                 r.suite.c_str(), r.name.c_str(), r.workload.c_str(), r.threads, r.params.c_str(),
+                 r.ops_per_s(), r.ns_per_op());
+    if (!std::isnan(r.hit_ratio)) std::fprintf(log, "  hit=%.3f", r.hit_ratio);
+    std::fprintf(log, "\n");
+    results_.push_back(std::move(r));
+  }
+
+  bool Write() const {
+    if (opt_.format == "text") return true;
+    FILE* f = opt_.out.empty() ? stdout : std::fopen(opt_.out.c_str(), "w");
+    if (!f) { std::perror(opt_.out.c_str()); return false; }
+    if (opt_.format == "csv") {
+      std::fprintf(f, "suite,name,workload,threads,params,ops,seconds,ops_per_s,ns_per_op,hit_ratio\n");
+      for (const Result& r : results_) {
+        std::fprintf(f, "%s,%s,%s,%d,\"%s\",%llu,%.6f,%.1f,%.2f,", r.suite.c_str(), r.name.c_str(),
+                     r.workload.c_str(), r.threads, r.params.c_str(), static_cast<unsigned long long>(r.ops),
+                     r.seconds, r.ops_per_s(), r.ns_per_op());
+        if (!std::isnan(r.hit_ratio)) std::fprintf(f, "%.4f", r.hit_ratio);
+        std::fprintf(f, "\n");
+      }
+    } else {
+      std::fprintf(f, "{\n  \"benchmark\": \"dbms_storage_bench\",\n  \"page_size\": %u,\n  \"hardware_threads\": %u,\n"
+                      "  \"scale\": %g,\n  \"results\": [\n",
+                   kPageSize, std::thread::hardware_concurrency(), opt_.scale);
+      for (size_t i = 0; i < results_.size(); ++i) {
+        const Result& r = results_[i];
+        std::fprintf(f, "    {\"suite\": \"%s\", \"name\": \"%s\", \"workload\": \"%s\", \"threads\": %d, "
+                        "\"params\": \"%s\", \"ops\": %llu, \"seconds\": %.6f, \"ops_per_s\": %.1f, \"ns_per_op\": %.2f, ",
+                     r.suite.c_str(), r.name.c_str(), r.workload.c_str(), r.threads, r.params.c_str(),
+                     static_cast<unsigned long long>(r.ops), r.seconds, r.ops_per_s(), r.ns_per_op());
+        if (std::isnan(r.hit_ratio)) std::fprintf(f, "\"hit_ratio\": null}");
+        else std::fprintf(f, "\"hit_ratio\": %.4f}", r.hit_ratio);
+        std::fprintf(f, "%s\n", i + 1 < results_.size() ? "," : "");
+      }
+      std::fprintf(f, "  ]\n}\n");
+    }
+    if (f != stdout) std::fclose(f);
+    return true;
+  }
+
+  uint64_t Scaled(uint64_t n) const {
+    return std::max<uint64_t>(1, static_cast<uint64_t>(static_cast<double>(n) * opt_.scale));
+  }
+  const Options& options() const { return opt_; }
+
+private:
+  const Options&      opt_;
+  std::vector<Result> results_;
+};
+
+// ============================ 访问模式 ============================
+
+enum class Workload { kUniform, kZipf, kScanMix };
+constexpr Workload kWorkloads[] = {Workload::kUniform, Workload::kZipf, Workload::kScanMix};
+
+const char* WorkloadName(Workload w) {
+  switch (w) {
+    case Workload::kUniform: return "uniform";
+    case Workload::kZipf:    return "zipf";
+    case Workload::kScanMix: return "scan_mix";
+  }
+  return "?";
+}
+
+/// Zipf 分布（Gray 等人的常数时间生成法），zeta(n) 在构造时计算一次，可被多个线程共享
+class ZipfTable {
+public:
+  ZipfTable(uint64_t n, double theta) : n_(n), theta_(theta) {
+    double zn = 0;
+    for (uint64_t i = 1; i <= n; ++i) zn += 1.0 / std::pow(static_cast<double>(i), theta);
+    zetan_ = zn;
+    const double zeta2 = 1.0 + 1.0 / std::pow(2.0, theta);
+    alpha_ = 1.0 / (1.0 - theta);
+    eta_   = (1.0 - std::pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan_);
+  }
+  /// u ∈ [0, 1) → 秩 [0, n)（0 最热）
+  uint64_t Rank(double u) const {
+    const double uz = u * zetan_;
+    if (uz < 1.0) return 0;
+    if (uz < 1.0 + std::pow(0.5, theta_)) return 1;
+    const uint64_t r = static_cast<uint64_t>(n_ * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+    return std::min(r, n_ - 1);
+  }
+
+private:
+  uint64_t n_;
+  double   theta_, zetan_{0}, alpha_{0}, eta_{0};
+};
+
+/// 每线程一个的键流：Next() 返回 [0, n) 内的下一个键
+class KeyStream {
+public:
+  KeyStream(Workload w, uint64_t n, const ZipfTable* zipf, uint64_t seed)
+      : w_(w), n_(n), zipf_(zipf), rng_(seed) {}
+
+  uint64_t Next() {
+    if (w_ == Workload::kUniform) return rng_() % n_;
+    if (w_ == Workload::kScanMix) {
+      if (scan_left_ > 0) { --scan_left_; return scan_pos_++ % n_; }
+      if (rng_() % 10000 < kScanStartPer10k) {
+        scan_pos_  = rng_() % n_;
+        scan_left_ = kScanLen - 1;
+        return scan_pos_++ % n_;
+      }
+    }
+    // 热点按秩散列到整个键空间，避免全部落在低页号（同一分区、同一区段）
+    const uint64_t rank = zipf_->Rank(std::uniform_real_distribution<double>(0.0, 1.0)(rng_));
+    return (rank * 0x9E3779B97F4A7C15ull) % n_;
+  }
+
+private:
+  static constexpr uint32_t kScanLen = 32;
+  // 每次点访问以 0.35% 的概率开始一段扫描：32p / (32p + 1 - p) ≈ 10% 的访问来自扫描
+  static constexpr uint32_t kScanStartPer10k = 35;
+  Workload     w_;
+  uint64_t     n_;
+  const ZipfTable* zipf_;
+  std::mt19937_64 rng_;
+  uint64_t     scan_pos_{0};
+  uint32_t     scan_left_{0};
+};
+
+/// 用 threads 个线程各执行 body(t)，返回墙钟秒数
+double RunThreads(int threads, const std::function<void(int)>& body) {
+  std::vector<std::thread> ws;
+  const auto t0 = Clock::now();
+  for (int t = 0; t < threads; ++t) ws.emplace_back(body, t);
+  for (auto& w : ws) w.join();
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+template <typename Fn>
+double Time(Fn&& fn) {
+  const auto t0 = Clock::now();
+  fn();
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+std::string Join(std::initializer_list<std::string> kv) {
+  std::string s;
+  for (const std::string& x : kv) s += (s.empty() ? "" : " ") + x;
+  return s;
+}
+
+// ============================ 缓冲池 ============================
+
+/// 建一个含 pages 页的段：每页写入页号，落盘后由调用方的缓冲池读入
+bool MakeSegment(SegmentManager* sm, seg_id_t seg, uint32_t pages) {
+  if (!sm->EnsureSegment(seg).ok() || sm->AllocatePages(seg, pages) == kInvalidPageId) return false;
+  BufferPoolManager bpm(256, kPageSize, sm, IReplacer::Create("clock", 256));
+  for (page_id_t p = 0; p < pages; ++p) {
+    WritePageGuard g;
+    if (!bpm.NewPageAt(seg, p, &g).ok()) return false;
+    std::memcpy(g.Data() + sizeof(PageHeader), &p, sizeof(p));
+    g.MarkDirty();
+  }
+  bpm.FlushAll();
+  return true;
+}
+
+/// FetchPage 后读一个字段再释放；返回读到的页号之和
+uint64_t FetchLoop(BufferPoolManager* bpm, seg_id_t seg, KeyStream* keys, uint64_t ops) {
+  uint64_t acc = 0;
+  for (uint64_t i = 0; i < ops; ++i) {
+    ReadPageGuard g;
+    if (!bpm->FetchPage(seg, static_cast<page_id_t>(keys->Next()), &g).ok()) continue;
+    page_id_t p = 0;
+    g.Read([&](const std::uint8_t* d) { std::memcpy(&p, d + sizeof(PageHeader), sizeof(p)); });
+    acc += p;
+  }
+  return acc;
+}
+
+void BenchBufferPool(Reporter* rep, SegmentManager* sm) {
+  const Options& opt = rep->options();
+  constexpr seg_id_t kSeg = 1;
+  constexpr uint32_t kPages = 8192;  // 64 MiB
+  if (!MakeSegment(sm, kSeg, kPages)) { std::fprintf(stderr, "buffer: segment setup failed\n"); return; }
+  const ZipfTable zipf(kPages, 0.99);
+
+  // 命中：页全部常驻，衡量查表 + 固定 + 乐观读的开销与分区锁的扩展性
+  if (rep->Enabled("buffer", "fetch_hit")) {
+    const int frames = static_cast<int>(kPages + 256);
+    BufferPoolManager bpm(frames, kPageSize, sm, [](int cap) { return IReplacer::Create("clock", cap); }, 16);
+    for (page_id_t p = 0; p < kPages; ++p) {
+      ReadPageGuard g;
+      (void)bpm.FetchPage(kSeg, p, &g);
+    }
+    for (Workload w : {Workload::kUniform, Workload::kZipf}) {
+      for (int threads : opt.threads) {
+        const uint64_t per = rep->Scaled(400000);
+        const BufferStats s0 = bpm.GetStats();
+        const double secs = RunThreads(threads, [&](int t) {
+          KeyStream keys(w, kPages, &zipf, 1000 + t);
+          g_sink = g_sink + FetchLoop(&bpm, kSeg, &keys, per);
+        });
+        const BufferStats s1 = bpm.GetStats();
+        Result r{"buffer", "fetch_hit", WorkloadName(w), threads,
+                 Join({"frames=" + std::to_string(frames), "pages=" + std::to_string(kPages), "partitions=16"}),
+                 per * threads, secs};
+        const uint64_t h = s1.hits - s0.hits, m = s1.misses - s0.misses;
+        r.hit_ratio = h + m ? static_cast<double>(h) / (h + m) : 0.0;
+        rep->Add(std::move(r));
+      }
+    }
+  }
+
+  // 未命中：工作集是缓冲池的 8 倍，衡量淘汰 + 读盘（页缓存）路径与各替换器的命中率
+  if (rep->Enabled("buffer", "fetch_miss")) {
+    const int frames = static_cast<int>(kPages / 8);
+    for (const char* spec : {"clock", "lruk:k=2,crp=1"}) {
+      for (Workload w : kWorkloads) {
+        for (int threads : opt.threads) {
+          BufferPoolManager bpm(frames, kPageSize, sm, [spec](int cap) { return IReplacer::Create(spec, cap); }, 16);
+          // 预热一轮，让命中率反映稳态
+          {
+            KeyStream warm(w, kPages, &zipf, 7);
+            g_sink = g_sink + FetchLoop(&bpm, kSeg, &warm, frames * 4);
+          }
+          const uint64_t per = rep->Scaled(100000) / threads + 1;
+          const BufferStats s0 = bpm.GetStats();
+          const double secs = RunThreads(threads, [&](int t) {
+            KeyStream keys(w, kPages, &zipf, 2000 + t);
+            g_sink = g_sink + FetchLoop(&bpm, kSeg, &keys, per);
+          });
+          const BufferStats s1 = bpm.GetStats();
+          Result r{"buffer", "fetch_miss", WorkloadName(w), threads,
+                   Join({"frames=" + std::to_string(frames), "pages=" + std::to_string(kPages),
+                         std::string("replacer=") + spec}),
+                   per * threads, secs};
+          const uint64_t h = s1.hits - s0.hits, m = s1.misses - s0.misses;
+          r.hit_ratio = h + m ? static_cast<double>(h) / (h + m) : 0.0;
+          rep->Add(std::move(r));
+        }
+      }
+    }
+  }
+}
+
+// ============================ 替换器 ============================
+
+/// 稳态下的一次淘汰周期：4 次命中（Pin + RecordAccess + Unpin）+ Victim + 装入新页
+void BenchReplacers(Reporter* rep) {
+  if (!rep->Enabled("replacer", "victim")) return;
+  for (const char* spec : {"clock", "lru", "lruk:k=2,crp=1", "arc"}) {
+    for (int cap : {1024, 16384, 262144}) {
+      const ZipfTable zipf(static_cast<uint64_t>(cap), 0.99);
+      for (Workload w : {Workload::kUniform, Workload::kZipf}) {
+        std::unique_ptr<IReplacer> r = IReplacer::Create(spec, cap);
+        for (int f = 0; f < cap; ++f) { r->RecordLoad(f, static_cast<uint64_t>(f)); r->Unpin(f); }
+        KeyStream keys(w, static_cast<uint64_t>(cap), &zipf, 3);
+        uint64_t next_key = static_cast<uint64_t>(cap);
+        const uint64_t ops = rep->Scaled(200000);
+        uint64_t evicted = 0;
+        const double secs = Time([&] {
+          for (uint64_t i = 0; i < ops; ++i) {
+            for (int k = 0; k < 4; ++k) {
+              const frame_id_t f = static_cast<frame_id_t>(keys.Next());
+              r->Pin(f);
+              r->RecordAccess(f);
+              r->Unpin(f);
+            }
+            frame_id_t v = -1;
+            if (!r->Victim(&v)) continue;
+            r->RecordLoad(v, next_key++);
+            r->Unpin(v);
+            ++evicted;
+          }
+        });
+        g_sink = g_sink + evicted;
+        rep->Add({"replacer", "victim", WorkloadName(w), 1,
+                  Join({std::string("replacer=") + spec, "frames=" + std::to_string(cap), "hits_per_victim=4"}),
+                  ops, secs});
+      }
+    }
+  }
+}
+
+// ============================ 槽位页 ============================
+
+void BenchSlottedPage(Reporter* rep) {
+  std::vector<std::uint8_t> page(kPageSize);
+  std::vector<std::uint8_t> rec(400, 0xAB);
+  const uint64_t pages = rep->Scaled(20000);
+
+  for (uint16_t len : {std::uint16_t{64}, std::uint16_t{200}}) {
+    const std::string params = "record_bytes=" + std::to_string(len);
+    if (rep->Enabled("page", "insert")) {
+      uint64_t ops = 0;
+      const double secs = Time([&] {
+        for (uint64_t p = 0; p < pages; ++p) {
+          SlottedPage::InitNew(page.data(), static_cast<page_id_t>(p), kPageSize);
+          SlottedPage sp(page.data(), kPageSize);
+          uint16_t slot = 0;
+          while (sp.Insert(rec.data(), len, &slot).ok()) ++ops;
+        }
+      });
+      rep->Add({"page", "insert", "fill", 1, params, ops, secs});
+    }
+    if (rep->Enabled("page", "get")) {
+      SlottedPage::InitNew(page.data(), 0, kPageSize);
+      SlottedPage sp(page.data(), kPageSize);
+      uint16_t slot = 0, n = 0;
+      while (sp.Insert(rec.data(), len, &slot).ok()) ++n;
+      std::mt19937 rng(5);
+      const uint64_t ops = pages * 100;
+      uint64_t acc = 0;
+      const double secs = Time([&] {
+        for (uint64_t i = 0; i < ops; ++i) {
+          const std::uint8_t* p = nullptr;
+          uint16_t l = 0;
+          if (sp.Get(static_cast<uint16_t>(rng() % n), &p, &l).ok()) acc += p[0] + l;
+        }
+      });
+      g_sink = g_sink + acc;
+      rep->Add({"page", "get", "uniform", 1, params, ops, secs});
+    }
+    // 填满后删掉隔一个的记录，再插入两倍长的记录：连续空闲不够，触发一次页内压缩后填入
+    if (rep->Enabled("page", "erase_compact")) {
+      uint64_t ops = 0;
+      const double secs = Time([&] {
+        for (uint64_t p = 0; p < pages; ++p) {
+          SlottedPage::InitNew(page.data(), static_cast<page_id_t>(p), kPageSize);
+          SlottedPage sp(page.data(), kPageSize);
+          uint16_t slot = 0, n = 0;
+          while (sp.Insert(rec.data(), len, &slot).ok()) ++n;
+          for (uint16_t s = 0; s < n; s += 2) (void)sp.Erase(s);
+          while (sp.Insert(rec.data(), static_cast<uint16_t>(len * 2), &slot).ok()) {}
+          ++ops;
+        }
+      });
+      rep->Add({"page", "erase_compact", "fill", 1, params + " (ops=pages)", ops, secs});
+    }
+  }
+}
+
+// ============================ FSM ============================
+
+void BenchFsm(Reporter* rep) {
+  if (!rep->Enabled("fsm", "update") && !rep->Enabled("fsm", "find")) return;
+  const Options& opt = rep->options();
+  const uint32_t pages = static_cast<uint32_t>(rep->Scaled(1u << 20));
+  FreeSpaceManager fsm(kPageSize, {128, 512, 1024, 2048, 4096, 8192});
+  std::mt19937_64 rng(11);
+  // 接近装满的表：95% 的页只剩不到 100 字节，其余随机
+  std::vector<uint16_t> free(pages);
+  for (auto& f : free) f = static_cast<uint16_t>(rng() % 100 < 95 ? rng() % 100 : rng() % (kPageSize - 64));
+  const std::string params = "pages=" + std::to_string(pages);
+
+  const double up = Time([&] {
+    for (uint32_t p = 0; p < pages; ++p) fsm.Update(p, free[p]);
+  });
+  if (rep->Enabled("fsm", "update")) rep->Add({"fsm", "update", "sequential", 1, params, pages, up});
+
+  if (rep->Enabled("fsm", "find")) {
+    for (int threads : opt.threads) {
+      const uint64_t per = rep->Scaled(400000);
+      const double secs = RunThreads(threads, [&](int t) {
+        std::mt19937 r(100 + t);
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < per; ++i) acc += fsm.Find(static_cast<uint16_t>(64 + r() % 4032));
+        g_sink = g_sink + acc;
+      });
+      rep->Add({"fsm", "find", "uniform", threads, params + " need=64..4096", per * threads, secs});
+    }
+  }
+}
+
+// ============================ 表扫描与行编解码 ============================
+
+const char kAddress[] = "17 Industrial Way, Suite 400";
+const char kComment[] = "carefully regular requests sleep quickly along the even, final accounts";
+
+Schema MakeSchema() {
+  return Schema({
+    {"suppkey",   Type::INT32,   0,   false},
+    {"name",      Type::CHAR,    25,  false},
+    {"address",   Type::VARCHAR, 40,  false},
+    {"nationkey", Type::INT32,   0,   false},
+    {"phone",     Type::CHAR,    15,  false},
+    {"acctbal",   Type::DOUBLE,  0,   false},
+    {"comment",   Type::VARCHAR, 101, true},
+  }, /*use_null_bitmap=*/true);
+}
+
+void Fill(TupleBuilder* tb, uint32_t i) {
+  tb->Reset();
+  tb->SetInt32(0, static_cast<int32_t>(i));
+  tb->SetChar(1, "Supplier#000000001");
+  tb->SetVarChar(2, std::string_view(kAddress, 12 + i % 16));
+  tb->SetInt32(3, static_cast<int32_t>(i % 25));
+  tb->SetChar(4, "27-918-335-1736");
+  tb->SetDouble(5, static_cast<double>(i % 10000) - 999.99);
+  if (i % 10 == 0) tb->SetNull(6);
+  else tb->SetVarChar(6, std::string_view(kComment, 30 + i % 40));
+}
+
+void BenchScan(Reporter* rep, SegmentManager* sm, const Schema& schema) {
+  if (!rep->Enabled("scan", "table_iterator")) return;
+  const uint32_t rows = static_cast<uint32_t>(rep->Scaled(500000));
+  const int frames = static_cast<int>(rows / 40 + 512);  // 表全部常驻：衡量页内遍历本身
+  BufferPoolManager bpm(frames, kPageSize, sm, IReplacer::Create("clock", frames));
+  FreeSpaceManager fsm(kPageSize, {128, 512, 1024, 2048, 4096, 8192});
+  seg_id_t seg = 10;
+  for (TableFormat fmt : {TableFormat::kSlotted, TableFormat::kPax}) {
+    const char* fname = fmt == TableFormat::kPax ? "pax" : "slotted";
+    if (!sm->EnsureSegment(seg).ok()) return;
+    TableHeap table(seg++, kPageSize, &bpm, &fsm, sm, &schema, fmt);
+    {
+      TableAppender app(&table);
+      TupleBuilder tb(schema);
+      for (uint32_t i = 0; i < rows; ++i) { Fill(&tb, i); (void)app.Append(tb); }
+      (void)app.Finish();
+    }
+    uint64_t n = 0, acc = 0;
+    const double secs = Time([&] {
+      for (auto it = table.Begin(); it != table.End(); ++it) {
+        int32_t k = 0;
+        (void)it.view().GetInt32(schema, 0, &k);
+        acc += static_cast<uint64_t>(k);
+        ++n;
+      }
+    });
+    g_sink = g_sink + acc;
+    rep->Add({"scan", "table_iterator", "sequential", 1,
+              Join({std::string("format=") + fname, "rows=" + std::to_string(rows)}), n, secs});
+  }
+}
+
+void BenchTuple(Reporter* rep, const Schema& schema) {
+  const uint32_t rows = 4096;  // 行常驻缓存
+  const uint64_t rounds = rep->Scaled(100);
+  TupleBuilder tb(schema);
+
+  if (rep->Enabled("tuple", "encode")) {
+    Tuple t;
+    uint64_t acc = 0;
+    const double secs = Time([&] {
+      for (uint64_t r = 0; r < rounds; ++r) {
+        for (uint32_t i = 0; i < rows; ++i) { Fill(&tb, i); tb.Build(&t); acc += t.Size(); }
+      }
+    });
+    g_sink = g_sink + acc;
+    rep->Add({"tuple", "encode", "reuse", 1, "columns=7", rows * rounds, secs});
+  }
+
+  std::vector<Tuple> tuples(rows);
+  for (uint32_t i = 0; i < rows; ++i) { Fill(&tb, i); tb.Build(&tuples[i]); }
+  if (rep->Enabled("tuple", "decode")) {
+    uint64_t acc = 0;
+    const double checked = Time([&] {
+      for (uint64_t r = 0; r < rounds; ++r) {
+        for (const Tuple& t : tuples) {
+          const TupleView v = t.View();
+          int32_t a = 0, d = 0; double f = 0; std::string_view b, c, e, g;
+          v.GetInt32(schema, 0, &a);
+          v.GetCharView(schema, 1, &b);
+          v.GetVarCharView(schema, 2, &c);
+          v.GetInt32(schema, 3, &d);
+          v.GetCharView(schema, 4, &e);
+          v.GetDouble(schema, 5, &f);
+          if (!v.IsNull(schema, 6)) v.GetVarCharView(schema, 6, &g);
+          acc += static_cast<uint64_t>(a + d) + b.size() + c.size() + e.size() + g.size() + static_cast<uint64_t>(f);
+        }
+      }
+    });
+    rep->Add({"tuple", "decode", "tuple_view", 1, "columns=7", rows * rounds, checked});
+
+    RowCodec codec;
+    if (RowCodec::Compile(schema, &codec).ok()) {
+      const double compiled = Time([&] {
+        for (uint64_t r = 0; r < rounds; ++r) {
+          for (const Tuple& t : tuples) {
+            const TupleView v = t.View();
+            if (!codec.Valid(v)) continue;
+            const std::uint8_t* p = v.Data();
+            const size_t g = codec.IsNull(p, 6) ? 0 : codec.VarChar(p, 6).size();
+            acc += static_cast<uint64_t>(codec.Int32(p, 0) + codec.Int32(p, 3)) + codec.Char(p, 1).size() +
+                   codec.VarChar(p, 2).size() + codec.Char(p, 4).size() + g + static_cast<uint64_t>(codec.Double(p, 5));
+          }
+        }
+      });
+      rep->Add({"tuple", "decode", "row_codec", 1, "columns=7", rows * rounds, compiled});
+    }
+    g_sink = g_sink + acc;
+  }
+}
+
+// ============================ 入口 ============================
+
+bool ParseArgs(int argc, char** argv, Options* o) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view a(argv[i]);
+    auto val = [&](std::string_view key, std::string* out) {
+      if (a.substr(0, key.size()) != key) return false;
+      *out = std::string(a.substr(key.size()));
+      return true;
+    };
+    std::string v;
+    if (val("--format=", &o->format)) continue;
+    if (val("--out=", &o->out)) continue;
+    if (val("--filter=", &o->filter)) continue;
+    if (val("--dir=", &o->dir)) continue;
+    if (val("--scale=", &v)) { o->scale = std::max(0.001, std::atof(v.c_str())); continue; }
+    if (val("--threads=", &v)) {
+      o->threads.clear();
+      for (size_t p = 0; p < v.size();) {
+        const size_t q = std::min(v.find(',', p), v.size());
+        const int t = std::atoi(v.substr(p, q - p).c_str());
+        if (t > 0) o->threads.push_back(t);
+        p = q + 1;
+      }
+      if (o->threads.empty()) o->threads = {1};
+      continue;
+    }
+    return false;
+  }
+  return o->format == "text" || o->format == "json" || o->format == "csv";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!ParseArgs(argc, argv, &opt)) {
+    std::fprintf(stderr, "usage: %s [--format=text|json|csv] [--out=FILE] [--filter=SUBSTR] [--scale=1.0]"
+                         " [--threads=1,2,4,8] [--dir=/tmp]\n", argv[0]);
+    return 2;
+  }
+  const std::string base = opt.dir + "/dbms_storage_bench";
+  std::filesystem::remove_all(base);
+  std::filesystem::create_directories(base);
+
+  Reporter rep(opt);
+  const Schema schema = MakeSchema();
+  {
+    SegmentManager sm(kPageSize, base);
+    if (rep.Enabled("buffer", "fetch_hit") || rep.Enabled("buffer", "fetch_miss")) BenchBufferPool(&rep, &sm);
+    BenchReplacers(&rep);
+    BenchSlottedPage(&rep);
+    BenchFsm(&rep);
+    BenchScan(&rep, &sm, schema);
+    BenchTuple(&rep, schema);
+  }
+  std::filesystem::remove_all(base);
+  return rep.Write() ? 0 : 1;
+}
@@ -0,0 +1,215 @@
+/**
+ * @file tuple_alloc_bench.cc
+ * @brief 行路径的堆分配微基准：构造、装载、扫描与点查各做法的 每行分配次数 与 ns/行。
+ *
+ * 用法：bench_tuple_alloc [rows=200000] [dir=/tmp]
+ * 本文件替换全局 operator new 以计数（含库内所有分配）；表建在 dir 下的临时目录，结束时删除。
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "dbms/storage/buffer/buffer_pool_manager.h"
+#include "dbms/storage/buffer/replacer.h"
+#include "dbms/storage/record/tuple_arena.h"
+#include "dbms/storage/segment/segment_manager.h"
+#include "dbms/storage/space/free_space_manager.h"
+#include "dbms/storage/table/table_appender.h"
+#include "dbms/storage/table/table_heap.h"
+
+namespace {
+std::atomic<uint64_t> g_allocs{0};
+}  // namespace
+
+void* operator new(size_t n) {
+  g_allocs.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+void* operator new[](size_t n) { return operator new(n); }
+void  operator delete(void* p) noexcept { std::free(p); }
+void  operator delete[](void* p) noexcept { std::free(p); }
+void  operator delete(void* p, size_t) noexcept { std::free(p); }
+void  operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+using namespace dbms::storage;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile uint64_t g_sink = 0;
+
+Schema MakeSchema() {
+  std::vector<Column> cols = {
+    {"suppkey",   Type::INT32,   0,   false},
+    {"name",      Type::CHAR,    25,  false},
+    {"address",   Type::VARCHAR, 40,  false},
+    {"nationkey", Type::INT32,   0,   false},
+    {"phone",     Type::CHAR,    15,  false},
+    {"acctbal",   Type::DOUBLE,  0,   false},
+    {"comment",   Type::VARCHAR, 101, true},
+  };
+  return Schema(std::move(cols), /*use_null_bitmap=*/false);
+}
+
+const char kAddress[] = "17 Industrial Way, Suite 400";
+const char kComment[] = "carefully regular requests sleep quickly along the even, final accounts";
+
+void Fill(TupleBuilder* tb, uint32_t i) {
+  tb->SetInt32(0, static_cast<int32_t>(i));
+  tb->SetChar(1, "Supplier#000000001");
+  tb->SetVarChar(2, std::string_view(kAddress, 12 + i % 16));
+  tb->SetInt32(3, static_cast<int32_t>(i % 25));
+  tb->SetChar(4, "27-918-335-1736");
+  tb->SetDouble(5, static_cast<double>(i % 10000) - 999.99);
+  tb->SetVarChar(6, std::string_view(kComment, 30 + i % 40));
+}
+
+/// 对 rows 行执行 fn，打印 每行分配次数 与 ns/行
+template <typename Fn>
+void Run(const char* name, uint32_t rows, Fn&& fn) {
+  const uint64_t a0 = g_allocs.load();
+  const auto     t0 = Clock::now();
+  fn();
+  const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+  const uint64_t a = g_allocs.load() - a0;
+  std::printf("%-44s allocs/row=%-8.3f ns/row=%.1f\n", name, static_cast<double>(a) / rows, ns / rows);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t    rows = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 200000;
+  const std::string base = (argc > 2 ? argv[2] : "/tmp") + std::string("/bench_tuple_alloc");
+  std::filesystem::remove_all(base);
+  std::filesystem::create_directories(base);
+  constexpr uint32_t kPageSize = 8192;
+
+  const Schema schema = MakeSchema();
+  {
+    SegmentManager sm(kPageSize, base);
+    if (!sm.EnsureSegment(1).ok() || !sm.EnsureSegment(2).ok()) { std::fprintf(stderr, "EnsureSegment failed\n"); return 1; }
+    // 帧数足以容纳两张表：装载与扫描都不落盘，只衡量行路径本身
+    const int frames = static_cast<int>(rows / 20 + 256);
+    BufferPoolManager bpm(frames, kPageSize, &sm, IReplacer::Create("clock", frames));
+    FreeSpaceManager fsm(kPageSize, {128, 512, 1024, 2048, 4096, 8192});
+    TableHeap fresh(1, kPageSize, &bpm, &fsm, &sm, &schema);
+    TableHeap table(2, kPageSize, &bpm, &fsm, &sm, &schema);
+
+    std::printf("rows=%u page_size=%u\n", rows, kPageSize);
+
+    // ---- 构造 ----
+    Run("build: new TupleBuilder + Tuple per row", rows, [&] {
+      for (uint32_t i = 0; i < rows; ++i) {
+        TupleBuilder tb(schema);
+        Fill(&tb, i);
+        Tuple t;
+        tb.Build(&t);
+        g_sink = g_sink + t.Size();
+      }
+    });
+    {
+      TupleBuilder tb(schema);
+      Tuple t;
+      Run("build: Reset + Build into reused Tuple", rows, [&] {
+        for (uint32_t i = 0; i < rows; ++i) {
+          tb.Reset();
+          Fill(&tb, i);
+          tb.Build(&t);
+          g_sink = g_sink + t.Size();
+        }
+      });
+      std::vector<std::uint8_t> buf(kPageSize);
+      Run("build: Reset + BuildInto caller buffer", rows, [&] {
+        for (uint32_t i = 0; i < rows; ++i) {
+          tb.Reset();
+          Fill(&tb, i);
+          size_t n = 0;
+          tb.BuildInto(buf.data(), buf.size(), &n);
+          g_sink = g_sink + n;
+        }
+      });
+    }
+
+    // ---- 装载（追加器；页分配按区段摊薄） ----
+    std::vector<RID> rids;
+    rids.reserve(rows);
+    Run("load: Append(Tuple), builder per row", rows, [&] {
+      TableAppender app(&fresh);
+      for (uint32_t i = 0; i < rows; ++i) {
+        TupleBuilder tb(schema);
+        Fill(&tb, i);
+        Tuple t;
+        tb.Build(&t);
+        app.Append(t);
+      }
+    });
+    Run("load: Append(TupleBuilder) into page", rows, [&] {
+      TableAppender app(&table);
+      TupleBuilder  tb(schema);
+      for (uint32_t i = 0; i < rows; ++i) {
+        tb.Reset();
+        Fill(&tb, i);
+        RID rid;
+        app.Append(tb, &rid);
+        rids.push_back(rid);
+      }
+    });
+
+    // ---- 扫描 ----
+    Run("scan: operator* (Tuple per row)", rows, [&] {
+      for (auto it = table.Begin(); it != table.End(); ++it) g_sink = g_sink + it->tuple.Size();
+    });
+    Run("scan: view() zero-copy", rows, [&] {
+      for (auto it = table.Begin(); it != table.End(); ++it) g_sink = g_sink + it.view().Size();
+    });
+    {
+      TupleArena arena;
+      Run("scan: CopyTo(arena), Reset every 1024 rows", rows, [&] {
+        uint32_t n = 0;
+        for (auto it = table.Begin(); it != table.End(); ++it) {
+          TupleView v;
+          if (it.CopyTo(&arena, &v).ok()) g_sink = g_sink + v.Size();
+          if (++n % 1024 == 0) arena.Reset();
+        }
+      });
+    }
+
+    // ---- 点查 ----
+    Run("get: Get(rid, fresh Tuple)", rows, [&] {
+      for (const RID& rid : rids) {
+        Tuple t;
+        table.Get(rid, &t);
+        g_sink = g_sink + t.Size();
+      }
+    });
+    {
+      Tuple t;
+      Run("get: Get(rid, reused Tuple)", rows, [&] {
+        for (const RID& rid : rids) {
+          table.Get(rid, &t);
+          g_sink = g_sink + t.Size();
+        }
+      });
+      TupleArena arena;
+      Run("get: Get(rid, arena), Reset every 1024 rows", rows, [&] {
+        uint32_t n = 0;
+        for (const RID& rid : rids) {
+          TupleView v;
+          if (table.Get(rid, &arena, &v).ok()) g_sink = g_sink + v.Size();
+          if (++n % 1024 == 0) arena.Reset();
+        }
+      });
+    }
+  }
+  std::filesystem::remove_all(base);
+  return 0;
+}
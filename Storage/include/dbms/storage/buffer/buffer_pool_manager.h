@@ -5,10 +5,29 @@
  * @file buffer_pool_manager.h
  * @brief 缓冲池管理器：页的装入/固定/解固定/刷盘；对接替换器。
  *
+ * 页标识：
+ *  - 缓冲池以 (seg_id, page_id) 作为页的身份；各段页号独立从 0 编号；
+ *  - 读写经 SegmentManager 路由到对应段的 DiskManager，因此一个缓冲池可同时
+ *    缓存任意多个段（表/索引），容量在全体段之间共享。
+ *
  * 线程模型：
- *  - 内部用一把互斥锁保护 page table / free list / 统计；
- *  - 页级并发（shared_mutex）在 frame 中（实现细节），推荐由上层按需配合使用；
+ *  - 帧被划分为 N 个分区（按页号散列），每个分区有独立的 page table / free list /
+ *    替换器实例 / 互斥锁与统计；不同分区上的操作互不阻塞；
+ *  - 磁盘读写（未命中装入、脏页写回）在分区锁之外进行；帧上带“I/O 进行中”标记，
+ *    并发获取同一页的线程会等待该次 I/O 完成，而不会重复读盘；
+ *  - 页级并发：经 ReadPageGuard（乐观读，版本校验）/ WritePageGuard（独占闩锁）访问页内容，
+ *    见 page_guard.h；刷盘时持页的共享闩锁，不会写出正被修改的页；
+ *  - 预读（Prefetch）经 DiskManager 的批量异步接口提交，完成前帧处于“I/O 进行中”；
  *  - 提供与 Recovery 对接的“刷盘前回调”接口。
+ *
+ * 观测：
+ *  - 统计计数按分区存放，在分区锁内修改、无锁读取：GetStats 不与前台争用分区锁；
+ *  - 经 SetMetrics 可挂接 StorageMetrics，记录命中 / 未命中 / 淘汰写回延迟、分区锁等待与替换器扫描长度。
+ *
+ * 缓存预热：
+ *  - SaveHotSet 把驻留页的 (seg, page_id) 按替换器热度导出到小文件（SetHotSetFile 后 FlushAll 与析构时自动导出）；
+ *  - 重启后 StartWarmup 由后台线程分批装回：每批按热度取下一段，批内按页号排序、合并成连续区间预读；
+ *    只占用空闲帧、不淘汰前台已装入的页，可限速；进度见 BufferStats::warmup_*。
  */
 
 #include <cstdint>
@@ -18,30 +37,103 @@
 #include <string>
 #include <vector>
 
+#include "dbms/storage/metrics.h"
 #include "dbms/storage/storage_types.h"
+#include "dbms/storage/buffer/page_guard.h"
 #include "dbms/storage/page/page.h"
-#include "dbms/storage/io/disk_manager.h"
+#include "dbms/storage/segment/segment_manager.h"
 #include "dbms/storage/buffer/replacer.h"
 
 namespace dbms {
 namespace storage {
 
-class PageGuard;  // 前置声明
-
+/**
+ * @brief 缓冲池统计。计数器均为累计值；dirty_frames 为快照。
+ *        脏页比例 = dirty_frames / num_frames；写回速率可由两次快照的 bg_flushes 差值求得。
+ */
 struct BufferStats {
   uint64_t hits{0};
   uint64_t misses{0};
   uint64_t evictions{0};
-  uint64_t flushes{0};
+  uint64_t flushes{0};           ///< 所有写回（含淘汰、FlushPage/FlushAll、后台写回）
+
+  uint64_t dirty_frames{0};      ///< 当前脏帧数
+  uint64_t bg_flushes{0};        ///< 后台写回线程写出的页数
+  uint64_t evict_writebacks{0};  ///< 未命中路径上同步写回脏受害者的次数（后台写回旨在压低它）
+
+  uint64_t prefetches{0};        ///< 预读发起的页数
+  uint64_t prefetch_hits{0};     ///< 预读装入的页被首次访问的次数（命中率 = prefetch_hits / prefetches）
+  uint64_t ring_reuses{0};       ///< 批量读复用环中旧帧的次数（每次即少淘汰一个普通页）
+  uint64_t ring_frames{0};       ///< 当前属于批量读环的帧数
+
+  uint64_t checksum_failures{0}; ///< 读入（含预读）时页校验和不匹配的次数
+
+  uint64_t warmup_pages{0};      ///< 最近一次预热计划装入的页数（热集文件中的页，截断到帧数）
+  uint64_t warmup_loaded{0};     ///< 其中已发起装入的页数
+  uint64_t warmup_skipped{0};    ///< 其中跳过的页数（已驻留、没有空闲帧、段或页已不存在）
+  bool     warmup_running{false};///< 预热线程是否仍在运行
+};
+
+/**
+ * @brief 访问方式。
+ *  - kNormal  ：页进入替换器（CLOCK / LRU-K），与其他页公平竞争；
+ *  - kBulkRead：大扫描等一次性访问；页放入每分区一个的小“环形缓冲”，环满后复用环内最老的帧，
+ *               不把热点工作集挤出缓冲池。此后若被普通访问命中，该页移出环、转为普通页。
+ */
+enum class AccessMode : uint8_t { kNormal, kBulkRead };
+
+/**
+ * @brief 页池内存选项（对应 StorageOptions::buffer_pool_hugepages / _hugetlb / _numa）。
+ *        页池总是匿名映射、不预先清零也不预先触碰；各项在内核不支持时静默退化。
+ */
+struct PoolMemoryOptions {
+  bool hugepages = false;  ///< 2 MiB 对齐 + MADV_HUGEPAGE（透明大页）
+  bool hugetlb   = false;  ///< 先尝试 MAP_HUGETLB 预留大页，不足时退化为透明大页
+  bool numa      = false;  ///< 分区 p 的帧优先放在 NUMA 节点 p % 节点数；后台写回线程绑到其分区的节点
+};
+
+/// 缓存预热选项（见 BufferPoolManager::StartWarmup）
+struct WarmupOptions {
+  uint32_t pages_per_sec = 0;    ///< 装入速率上限（0 = 不限速）
+  uint32_t batch_pages   = 1024; ///< 每批按热度取的页数；批内排序合并为顺序读
 };
 
 class BufferPoolManager {
 public:
+  /// 替换器工厂：为每个分区创建一个容量为 capacity 的替换器（帧号为分区内局部编号）
+  using ReplacerFactory = std::function<std::unique_ptr<IReplacer>(int capacity)>;
+
+  /// 批量读环形缓冲的默认总帧数（见 SetScanRingFrames）
+  static constexpr int kDefaultScanRingFrames = 32;
+
+  /// 单分区构造：replacer 的容量应为 num_frames
   BufferPoolManager(int num_frames,
                     uint32_t page_size,
-                    DiskManager* disk,
+                    SegmentManager* sm,
                     std::unique_ptr<IReplacer> replacer);
 
+  /**
+   * @brief 分区构造：num_frames 个帧均分到 partitions 个分区（截断到 [1, num_frames]）。
+   * @param make_replacer 每个分区调用一次，参数为该分区的帧数
+   * @param hugepages     页池按 2 MiB 对齐并建议内核使用透明大页（StorageOptions::buffer_pool_hugepages）
+   *
+   * 页池总是按页对齐分配，可直接用于 O_DIRECT 读写。
+   */
+  BufferPoolManager(int num_frames,
+                    uint32_t page_size,
+                    SegmentManager* sm,
+                    const ReplacerFactory& make_replacer,
+                    int partitions,
+                    bool hugepages = false);
+
+  /// 同上，完整的页池内存选项（大页 / 预留大页 / NUMA 放置）
+  BufferPoolManager(int num_frames,
+                    uint32_t page_size,
+                    SegmentManager* sm,
+                    const ReplacerFactory& make_replacer,
+                    int partitions,
+                    const PoolMemoryOptions& mem);
+
   ~BufferPoolManager();
 
   BufferPoolManager(const BufferPoolManager&) = delete;
@@ -53,37 +145,139 @@ public:
    * @brief 将页装入内存并固定，返回页内字节缓冲区指针（长度=page_size）。
    *        调用方应在使用完成后尽快调用 UnpinPage()。
    */
-  Status FetchPage(page_id_t pid, std::uint8_t** out_data);
+  Status FetchPage(seg_id_t seg, page_id_t pid, std::uint8_t** out_data);
+  Status FetchPage(seg_id_t seg, page_id_t pid, std::uint8_t** out_data, AccessMode mode);
+
+  /**
+   * @brief RAII 版 Fetch：固定页并返回乐观读守卫（不加闩锁，读后以版本号校验）。
+   */
+  Status FetchPage(seg_id_t seg, page_id_t pid, ReadPageGuard* out,
+                   AccessMode mode = AccessMode::kNormal);
+
+  /**
+   * @brief RAII 版 Fetch：固定页并持有其独占闩锁；并发的乐观读者会看到版本变化而重读。
+   *        修改后需调用 WritePageGuard::MarkDirty()。
+   */
+  Status FetchPage(seg_id_t seg, page_id_t pid, WritePageGuard* out);
+
+  /**
+   * @brief 异步预读 [first, first+count) 中未驻留的页（截断到段尾），立即返回。
+   *        已驻留、无可用帧或受害者为脏页（需同步写回）的页会被跳过；
+   *        预读中的页被 FetchPage 访问时会等待其读完，而不会重复读盘。
+   * @param out_issued 可选：实际发起预读的页数
+   */
+  Status Prefetch(seg_id_t seg, page_id_t first, uint32_t count,
+                  AccessMode mode = AccessMode::kNormal, uint32_t* out_issued = nullptr);
+
+  /**
+   * @brief 经 SegmentManager::AllocatePage 在段内分配一个新页并返回其缓冲区（已置零、已固定）。
+   *        新页不从磁盘读取；由于可能复用段内空闲页，帧被标记为脏以覆盖旧内容。
+   */
+  Status NewPage(seg_id_t seg, page_id_t* out_pid, std::uint8_t** out_data);
 
   /**
-   * @brief 分配一个新页并返回其缓冲区（已置零）。page_id 由文件长度推导。
-   *        （当接入 SegmentManager 后，上层更推荐用 Segment->AllocatePage()）
+   * @brief 为调用方已分配的页（如 SegmentManager::AllocatePages 预留的连续页）装入一个置零、
+   *        已固定、已标脏的帧，不读盘。若该页恰已驻留（例如被扫描预读），则原帧被清零后返回。
    */
-  Status NewPage(page_id_t* out_pid, std::uint8_t** out_data);
+  Status NewPageAt(seg_id_t seg, page_id_t pid, std::uint8_t** out_data);
+  /// 同上，并持有该页的独占闩锁（帧已标脏）
+  Status NewPageAt(seg_id_t seg, page_id_t pid, WritePageGuard* out);
 
   /**
    * @brief 解固定页；当 pin_count 归 0，替换器可将其作为受害者。
    * @param is_dirty 若为 true，标记该页脏（Flush 时会写回）
    */
-  Status UnpinPage(page_id_t pid, bool is_dirty);
+  Status UnpinPage(seg_id_t seg, page_id_t pid, bool is_dirty);
 
   /// 立即将页写回磁盘（若在缓冲池中且为脏）
-  Status FlushPage(page_id_t pid);
+  Status FlushPage(seg_id_t seg, page_id_t pid);
 
-  /// 将所有脏页刷盘
+  /// 将所有脏页刷盘（按 (seg, page_id) 升序写出，尽量顺序 I/O）
   void   FlushAll();
 
+  /**
+   * @brief 只把段 seg 的脏页刷盘（同 FlushAll 的顺序写），并等正在进行的写回完成后复查：
+   *        该段仍有脏页（写回失败，或刷盘期间又被写入）时返回首个写错误或 Unavailable。
+   *        其他段的脏页不受影响。
+   * @param wait false 时不等待页的使用者：被固定的脏页与闩锁被占用的页不写，返回 Unavailable
+   *             （例如未 Finish 的 TableAppender 一直固定并写闩锁着当前页）。正在进行的写回仍会等它完成
+   */
+  Status FlushSegment(seg_id_t seg, bool wait = true);
+
+  /**
+   * @brief 设置批量读环形缓冲的总帧数（均分到各分区，每分区不超过其帧数的 1/4；<=0 关闭）。
+   *        关闭后 kBulkRead 等同 kNormal。默认 kDefaultScanRingFrames。
+   */
+  void   SetScanRingFrames(int frames);
+
+  /**
+   * @brief 开关页校验和（对应 StorageOptions::enable_checksum，默认开启）。
+   *        开启时每次写回前把整页 CRC-32C 写入 PageHeader::checksum，未命中读入（含预读）后校验，
+   *        不匹配则 FetchPage 返回 Corruption。checksum 为 0 的页（从未经缓冲池写回）不校验。
+   */
+  void   SetPageChecksums(bool on);
+  bool   page_checksums() const noexcept;
+
+  // ----------------- 后台写回 -----------------
+
+  /**
+   * @brief 启动后台写回线程（若已启动则先停止）。
+   *
+   * 每个线程负责一部分分区：每隔 interval_ms（或前台脏帧数越过阈值时被唤醒）检查一次，
+   * 若某分区“干净帧”占比低于 clean_ratio，则把其中未固定的脏帧按 (seg, page_id) 升序写回，
+   * 使前台未命中时尽量选到干净的受害者。写回同样经过 RegisterFlushCallback 的 WAL 回调。
+   *
+   * @param threads      线程数（<=0 等价于 StopBackgroundWriter）
+   * @param clean_ratio  每个分区希望保持干净的帧比例，截断到 [0, 1]
+   */
+  void StartBackgroundWriter(int threads, double clean_ratio, uint32_t interval_ms);
+
+  /// 停止并等待后台写回线程退出（幂等；析构时自动调用）
+  void StopBackgroundWriter();
+
+  // ----------------- 缓存预热 -----------------
+
+  /**
+   * @brief 把当前驻留页的 (seg, page_id) 按替换器热度（最热在前）写到 path（先写 path.tmp 再改名）。
+   *        扫描环中的页与正在读入的页不导出；被固定的页视为最热。
+   */
+  Status SaveHotSet(const std::string& path) const;
+  /// 设置热集文件（空串关闭）：此后每次 FlushAll 与析构时自动 SaveHotSet
+  void   SetHotSetFile(const std::string& path);
+
+  /**
+   * @brief 读入 path 中的热集并启动后台预热线程后立即返回（已有预热在运行则先停止）。
+   *        文件不存在返回 NotFound，校验失败返回 Corruption 或 InvalidArgument（页大小不符）。
+   *        预热经批量预读装入，只使用空闲帧；空闲帧用完即提前结束。
+   */
+  Status StartWarmup(const std::string& path, const WarmupOptions& opt = WarmupOptions{});
+  /// 停止并等待预热线程退出（幂等；析构时自动调用）
+  void   StopWarmup();
+
   // ----------------- 统计与配置 -----------------
 
+  /// 各分区统计之和（不加分区锁；各项分别读取，不是同一时刻的一致快照）
   BufferStats GetStats() const;
+  /// 清零累计计数（dirty_frames / ring_frames 为现状，不受影响）
+  void        ResetStats();
+  /// 挂接延迟直方图（nullptr 取消）；不取得所有权，metrics 须比缓冲池活得久或先取消挂接
+  void        SetMetrics(StorageMetrics* metrics) noexcept;
+  StorageMetrics* metrics() const noexcept;
   uint32_t    page_size() const noexcept { return page_size_; }
   int         num_frames() const noexcept { return num_frames_; }
+  int         num_partitions() const noexcept;
+  /// 页池实际使用的页："hugetlb" / "thp"（透明大页）/ "4k"
+  const char* memory_backing() const noexcept;
+  /// 分区 p 的帧内存所绑定的 NUMA 节点（未启用或绑定失败为 -1）
+  int         partition_node(int p) const noexcept;
 
   /**
    * @brief 注册刷盘回调：在真正写盘前调用（用于 WAL 对齐）。
-   *        回调参数：page_id, page_lsn（来源于 PageHeader）。
+   *        回调参数：seg_id, page_id, page_lsn（来源于 PageHeader）。
+   *        调用时写者已被挡在页外（持共享闩锁或帧未固定），回调返回后才写盘：
+   *        WAL 在回调里把日志刷到 page_lsn，页就不会先于其日志落盘。
    */
-  void RegisterFlushCallback(std::function<void(page_id_t, uint64_t)> cb);
+  void RegisterFlushCallback(std::function<void(seg_id_t, page_id_t, uint64_t)> cb);
 
 private:
   friend class PageGuard;
@@ -92,11 +286,13 @@ private:
   struct Impl;
   std::unique_ptr<Impl> p_;  // Pimpl：隐藏具体数据结构以稳定头文件
 
-  // 非接口的内部方法（给 PageGuard 使用）
-  frame_id_t LookupFrame(page_id_t pid) const;
-  frame_id_t AcquireFrameFor(page_id_t pid, page_id_t* evicted_pid);
-  bool       FlushFrame(frame_id_t fid);
+  // 非接口的内部方法（给 PageGuard 使用；内部自行获取所属分区的锁）
   Status     UnpinFrame(frame_id_t fid, bool is_dirty);
+  // 对已固定的页加独占闩锁并构造写守卫
+  WritePageGuard LatchForWrite(seg_id_t seg, page_id_t pid, std::uint8_t* data);
+  // Prefetch 的实现；free_only 时只使用空闲帧（预热不淘汰已驻留的页）
+  Status     PrefetchRange(seg_id_t seg, page_id_t first, uint32_t count, AccessMode mode,
+                           bool free_only, uint32_t* out_issued);
 
 private:
   const int      num_frames_;
@@ -3,14 +3,23 @@
 
 /**
  * @file page_guard.h
- * @brief RAII 封装：获取页数据并在析构时自动 Unpin。
+ * @brief RAII 封装：获取页数据并在析构时自动 Unpin；读写变体附带页级闩锁语义。
  *
- * 用法建议：
- *  - 由 BufferPoolManager 暴露的“RAII 版 Fetch”接口创建 PageGuard 最为安全；
- *    当前版本保留 PageGuard 类型与友元关系，便于后续无缝扩展。
+ *  - PageGuard      ：只固定，不加闩锁；
+ *  - ReadPageGuard  ：乐观读。读者不加锁，先 ReadBegin() 取帧版本号，读完以 Validate() 校验；
+ *                     版本变化说明期间有写者，应丢弃读到的内容重读（Read() 封装了该循环）；
+ *  - WritePageGuard ：持有帧的独占闩锁，存续期间版本号为奇数，释放时再加一回到偶数。
+ *
+ * 乐观读期间页内容可能正被修改（读到撕裂的数据）：校验通过之前，读者对页内偏移、长度
+ * 必须做越界检查，且不能把读到的指针留到校验之后解引用。
+ * 同一线程同时持有多个 WritePageGuard 时须按固定顺序获取（如索引分裂：先左节点，再新建的右节点），
+ * 否则两个写者可能互相等待；刷盘路径持有共享闩锁时不会阻塞等待别的帧，不参与成环。
+ * 均由 BufferPoolManager::FetchPage / NewPageAt 的对应重载创建。
  */
 
+#include <atomic>
 #include <cstdint>
+#include <shared_mutex>
 #include <utility>
 
 #include "dbms/storage/storage_types.h"
@@ -36,6 +45,7 @@ public:
 
   bool           Valid()  const noexcept { return bpm_ != nullptr; }
   std::uint8_t*  Data()   const noexcept { return data_; }
+  seg_id_t       SegId()  const noexcept { return seg_; }
   page_id_t      PageId() const noexcept { return pid_; }
 
   /// 标记为脏；析构/Release 时将把 dirty 标志传给 BPM
@@ -46,22 +56,131 @@ public:
 
 private:
   friend class BufferPoolManager;
-  PageGuard(BufferPoolManager* bpm, page_id_t pid, int fid, std::uint8_t* data)
-      : bpm_(bpm), pid_(pid), fid_(fid), data_(data) {}
+  PageGuard(BufferPoolManager* bpm, seg_id_t seg, page_id_t pid, int fid, std::uint8_t* data)
+      : bpm_(bpm), seg_(seg), pid_(pid), fid_(fid), data_(data) {}
 
   void MoveFrom(PageGuard&& o) noexcept {
-    bpm_ = o.bpm_;  pid_ = o.pid_;  fid_ = o.fid_;  data_ = o.data_;  dirty_ = o.dirty_;
-    o.bpm_ = nullptr; o.pid_ = kInvalidPageId; o.fid_ = -1; o.data_ = nullptr; o.dirty_ = false;
+    bpm_ = o.bpm_;  seg_ = o.seg_;  pid_ = o.pid_;  fid_ = o.fid_;  data_ = o.data_;  dirty_ = o.dirty_;
+    o.bpm_ = nullptr; o.seg_ = kInvalidSegId; o.pid_ = kInvalidPageId; o.fid_ = -1;
+    o.data_ = nullptr; o.dirty_ = false;
   }
 
 private:
   BufferPoolManager* bpm_{nullptr};
+  seg_id_t           seg_{kInvalidSegId};
   page_id_t          pid_{kInvalidPageId};
   int                fid_{-1};
   std::uint8_t*      data_{nullptr};
   bool               dirty_{false};
 };
 
+/**
+ * @brief 乐观读守卫：固定页，但不持有闩锁。
+ *
+ * 典型用法：
+ *   page.Read([&](const uint8_t* data) { ...解析并拷出所需内容（需越界检查）... });
+ * 或手动：v = ReadBegin(); ...读...; if (!Validate(v)) 重读。
+ */
+class ReadPageGuard {
+public:
+  ReadPageGuard() = default;
+
+  ReadPageGuard(ReadPageGuard&& o) noexcept
+      : guard_(std::move(o.guard_)), version_(std::exchange(o.version_, nullptr)),
+        latch_(std::exchange(o.latch_, nullptr)) {}
+  ReadPageGuard& operator=(ReadPageGuard&& o) noexcept {
+    if (this != &o) {
+      guard_   = std::move(o.guard_);
+      version_ = std::exchange(o.version_, nullptr);
+      latch_   = std::exchange(o.latch_, nullptr);
+    }
+    return *this;
+  }
+
+  bool                Valid()  const noexcept { return guard_.Valid(); }
+  const std::uint8_t* Data()   const noexcept { return guard_.Data(); }
+  seg_id_t            SegId()  const noexcept { return guard_.SegId(); }
+  page_id_t           PageId() const noexcept { return guard_.PageId(); }
+
+  /// 开始一次乐观读：返回稳定（偶数）版本号；有写者时先等它释放闩锁
+  std::uint64_t ReadBegin() const {
+    const std::uint64_t v = version_->load(std::memory_order_acquire);
+    return (v & 1) == 0 ? v : WaitStable();
+  }
+
+  /// 读完后校验：自 ReadBegin 返回 v 以来没有写者进入过该页
+  bool Validate(std::uint64_t v) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_->load(std::memory_order_relaxed) == v;
+  }
+
+  /// 以乐观读执行 fn(const uint8_t* page)，直到某一次读取通过校验；fn 可能被执行多次
+  template <class Fn>
+  void Read(Fn&& fn) const {
+    for (;;) {
+      const std::uint64_t v = ReadBegin();
+      fn(Data());
+      if (Validate(v)) return;
+    }
+  }
+
+  /// 及早释放（解固定）；释放后本 Guard 变为无效
+  void Release() { guard_.Release(); version_ = nullptr; latch_ = nullptr; }
+
+private:
+  friend class BufferPoolManager;
+  ReadPageGuard(PageGuard&& g, const std::atomic<std::uint64_t>* version, std::shared_mutex* latch)
+      : guard_(std::move(g)), version_(version), latch_(latch) {}
+
+  std::uint64_t WaitStable() const;  // 慢路径：经共享闩锁等待写者离开
+
+  PageGuard                          guard_;
+  const std::atomic<std::uint64_t>*  version_{nullptr};
+  std::shared_mutex*                 latch_{nullptr};
+};
+
+/**
+ * @brief 写守卫：固定页并持有帧的独占闩锁；析构/Release 时先放闩锁再解固定。
+ *        修改过页面需调用 MarkDirty()。
+ */
+class WritePageGuard {
+public:
+  WritePageGuard() = default;
+  ~WritePageGuard() { Release(); }
+
+  WritePageGuard(WritePageGuard&& o) noexcept
+      : guard_(std::move(o.guard_)), version_(std::exchange(o.version_, nullptr)),
+        latch_(std::exchange(o.latch_, nullptr)) {}
+  WritePageGuard& operator=(WritePageGuard&& o) noexcept {
+    if (this != &o) {
+      Release();
+      guard_   = std::move(o.guard_);
+      version_ = std::exchange(o.version_, nullptr);
+      latch_   = std::exchange(o.latch_, nullptr);
+    }
+    return *this;
+  }
+
+  bool           Valid()  const noexcept { return guard_.Valid(); }
+  std::uint8_t*  Data()   const noexcept { return guard_.Data(); }
+  seg_id_t       SegId()  const noexcept { return guard_.SegId(); }
+  page_id_t      PageId() const noexcept { return guard_.PageId(); }
+
+  void MarkDirty() noexcept { guard_.MarkDirty(); }
+
+  /// 及早释放：结束写（版本号回到偶数）、放闩锁并解固定
+  void Release();
+
+private:
+  friend class BufferPoolManager;
+  WritePageGuard(PageGuard&& g, std::atomic<std::uint64_t>* version, std::shared_mutex* latch)
+      : guard_(std::move(g)), version_(version), latch_(latch) {}
+
+  PageGuard                    guard_;
+  std::atomic<std::uint64_t>*  version_{nullptr};
+  std::shared_mutex*           latch_{nullptr};
+};
+
 }  // namespace storage
 }  // namespace dbms
 
@@ -8,10 +8,28 @@
  * 约定：
  *  - Pin(fid)   ：从候选集移出（不可被淘汰）；
  *  - Unpin(fid) ：加入候选集（pin_count==0）；
- *  - Victim(out)：从候选集中选择一个 frame（策略自定），成功返回 true。
+ *  - RecordLoad(fid, key)：帧装入了页 key（Fetch/NewPage 未命中、预读），计为该页的第一次访问；
+ *    需要跨淘汰记住页的策略（ARC 的幽灵表）据此识别页，其余策略按一次访问处理；
+ *  - RecordAccess(fid)：一次命中访问（BPM 在每次 Fetch 命中时调用，帧可能已被固定）；
+ *    只看 Pin/Unpin 的策略可忽略；
+ *  - Victim(out)：从候选集中选择一个 frame（策略自定），成功返回 true；
+ *  - ScanSteps()：各次 Victim 检查过的候选数之和（观测扫描长度用；不统计的实现返回 0）；
+ *  - Hotness(out)：按预计被淘汰的先后给每帧打分（导出热集用；不区分的实现全为 0）。
+ *
+ * 线程安全：BPM 在分区锁内调用；各实现另行说明能否脱离外部锁使用。
+ *
+ * 工厂：Create(spec, capacity) 解析 StorageOptions::replacer 的文本约定
+ *   "<name>[:key=value[,key=value...]]"，可用的有：
+ *   - "clock"
+ *   - "lru"                    （等同 lruk:k=1）
+ *   - "lruk[:k=2][,crp=1]"     （K 值与相关引用期）
+ *   - "arc"
  */
 
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace dbms {
 namespace storage {
@@ -24,11 +42,24 @@ struct IReplacer {
   virtual void Pin(frame_id_t fid)   = 0;
   virtual void Unpin(frame_id_t fid) = 0;
 
+  /// 记录一次命中访问（默认忽略）
+  virtual void RecordAccess(frame_id_t /*fid*/) {}
+
+  /// 记录帧装入新页（默认按一次访问处理）
+  virtual void RecordLoad(frame_id_t fid, uint64_t /*page_key*/) { RecordAccess(fid); }
+
   /// 选择受害者 frame（成功返回 true，并在 *out 写入 frame_id）
   virtual bool Victim(frame_id_t* out) = 0;
 
   /// 候选集大小（调试/统计用）
   virtual int  Size() const = 0;
+  /// 累计扫描长度（BPM 在分区锁内取 Victim 前后的差值，即这一次的扫描长度）
+  virtual uint64_t ScanSteps() const { return 0; }
+  /// 每帧的热度分（越大越晚被淘汰）：out 已由调用方按容量置零，实现只需填写所跟踪的帧
+  virtual void Hotness(std::vector<uint64_t>* /*out*/) const {}
+
+  /// 按文本规格创建替换器；名称或参数无法识别时返回 nullptr
+  static std::unique_ptr<IReplacer> Create(const std::string& spec, int capacity);
 };
 
 }  // namespace storage
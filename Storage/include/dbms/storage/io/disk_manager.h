@@ -9,21 +9,36 @@
  *  - ReadPage(pid) ：读取第 pid 页到 out_buf（page_size 字节）；
  *  - WritePage(pid)：将缓冲区写入第 pid 页；必要时扩容文件；
  *  - PageCount()   ：(file_size / page_size) 的向下取整。
+ *
+ * 单页 ReadPage/WritePage 直接走 pread/pwrite（同步、最低延迟）；批量与异步接口
+ * 经可插拔的 IoBackend（默认 IoBackend::Posix()，可换成 io_uring）。
+ *
+ * 直接 I/O：direct_io=true 且 page_size 为 kDirectIoAlignment 的整数倍时以 O_DIRECT 打开
+ * （文件系统不支持则自动退回，见 File）；此时批量接口要求缓冲区按 kDirectIoAlignment 对齐，
+ * 不对齐的批次改走同步的 File 读写（内部中转）。
+ *
+ * 观测：挂接 StorageMetrics 后，同步读写（单页、ReadPages、ExecutePages 每批一次）与 Sync 记录耗时；
+ * 异步提交（SubmitPages / *Async）的完成时刻不在本类掌握之中，不计入。
  */
 
+#include <atomic>
 #include <cstdint>
+#include <functional>
+#include <future>
 #include <string>
 #include <memory>
+#include "dbms/storage/metrics.h"
 #include "dbms/storage/storage_types.h"
 #include "dbms/storage/page/page.h"
 #include "dbms/storage/io/file.h"
+#include "dbms/storage/io/io_backend.h"
 
 namespace dbms {
 namespace storage {
 
 class DiskManager {
 public:
-  DiskManager(std::string file_path, uint32_t page_size = kDefaultPageSize);
+  DiskManager(std::string file_path, uint32_t page_size = kDefaultPageSize, bool direct_io = false);
 
   DiskManager(const DiskManager&) = delete;
   DiskManager& operator=(const DiskManager&) = delete;
@@ -34,21 +49,55 @@ public:
   Status ReadPage(page_id_t pid, void* out_buf) const;
   Status WritePage(page_id_t pid, const void* in_buf);
 
+  /// 一次顺序读取 [first, first+n) 连续 n 页到 out_buf（长度 n*page_size；直接 I/O 下应按页对齐）
+  Status ReadPages(page_id_t first, uint32_t n, void* out_buf) const;
+
+  // ---- 批量 / 异步（经 IoBackend）----
+  struct PageIo {
+    IoOp      op{IoOp::kRead};
+    page_id_t pid{kInvalidPageId};
+    void*     buf{nullptr};       ///< 写请求时只读
+  };
+  using PageDoneFn = std::function<void(size_t /*index*/, const Status&)>;
+
+  /// 异步提交一批页 I/O；第 i 个请求完成时调用 done(i, status)（可能在后端线程中）。
+  /// 返回错误时各请求同样会以错误回调，调用方须等回调结束后才能复用缓冲区
+  Status SubmitPages(const PageIo* ios, size_t n, PageDoneFn done);
+
+  /// 同步执行一批页 I/O 并等待完成；per_page 非空时写入每个请求各自的状态
+  Status ExecutePages(const PageIo* ios, size_t n, Status* per_page = nullptr);
+
+  std::future<Status> ReadPageAsync(page_id_t pid, void* out_buf);
+  std::future<Status> WritePageAsync(page_id_t pid, const void* in_buf);
+
+  /// 设置 I/O 后端（不取得所有权；nullptr 表示恢复为 POSIX）
+  void       SetIoBackend(IoBackend* io) noexcept { io_ = io ? io : IoBackend::Posix(); }
+  IoBackend* io_backend() const noexcept { return io_; }
+
+  /// 挂接延迟直方图（不取得所有权；nullptr 取消）
+  void       SetMetrics(StorageMetrics* m) noexcept { metrics_.store(m, std::memory_order_relaxed); }
+
+  /// 是否实际以 O_DIRECT 访问文件（请求了直接 I/O 但文件系统拒绝时为 false）
+  bool       direct_io() const noexcept { return file_.direct(); }
+
   // ---- 文件级 ----
   Status  Sync() const;
   uint64_t PageCount() const;
   Status  ResizeToPages(uint64_t new_page_count);
+  /// 扩展到 new_page_count 页并预留新增页的磁盘块（减少后续写入时的块分配与碎片）
+  Status  PreallocateToPages(uint64_t new_page_count);
+  /// 释放 [first, first+n) 页的磁盘块（文件大小不变，之后读为全零；见 File::PunchHole）
+  Status  DiscardPages(page_id_t first, uint64_t n);
 
   // ---- 访问器 ----
   uint32_t page_size() const noexcept { return page_size_; }
   const std::string& file_path() const noexcept { return file_.path(); }
 
 private:
-  Status EnsureCapacityFor(page_id_t pid);  // 确保能写第 pid 页
-
-private:
-  File      file_;
-  uint32_t  page_size_{kDefaultPageSize};
+  File       file_;
+  uint32_t   page_size_{kDefaultPageSize};
+  IoBackend* io_{IoBackend::Posix()};
+  std::atomic<StorageMetrics*> metrics_{nullptr};
 };
 
 }  // namespace storage
@@ -6,8 +6,15 @@
  * @brief 轻量 POSIX 文件封装（RAII）：最小读写/扩容/同步能力。
  *
  * 统一错误返回 Status，不抛异常；支持 64 位文件偏移（_FILE_OFFSET_BITS=64）。
+ *
+ * 直接 I/O：Open(direct=true) 以 O_DIRECT 打开，绕过内核页缓存。
+ *  - 文件系统拒绝 O_DIRECT（如 tmpfs 在 open 时返回 EINVAL，或首次对齐读失败）时退回普通打开；
+ *  - 不满足 kDirectIoAlignment 对齐的读写经对齐中转缓冲区完成，调用方无需关心；
+ *  - 运行中若对齐读写仍返回 EINVAL，则关闭该文件的 O_DIRECT 并重试。
+ *  实际是否处于直接 I/O 以 direct() 为准。
  */
 
+#include <atomic>
 #include <cstdint>
 #include <string>
 
@@ -31,8 +38,8 @@ public:
     return *this;
   }
 
-  /// 以读写模式打开；不存在时可选择创建
-  Status Open(bool create_if_missing = true);
+  /// 以读写模式打开；不存在时可选择创建；direct=true 时尝试 O_DIRECT（见文件头说明）
+  Status Open(bool create_if_missing = true, bool direct = false);
 
   /// 关闭（幂等）
   void   Close();
@@ -46,10 +53,16 @@ public:
   /// 调整文件大小（字节）（扩展/截断）
   Status Resize(uint64_t new_size);
 
+  /// 为 [offset, offset+len) 预留磁盘块（必要时扩展文件）；文件系统不支持时退化为 Resize
+  Status Allocate(uint64_t offset, uint64_t len);
+
+  /// 释放 [offset, offset+len) 的磁盘块（打洞，文件大小不变，之后读为全零）；文件系统不支持返回 Unavailable
+  Status PunchHole(uint64_t offset, uint64_t len);
+
   /// 写入 n 字节到 offset（保证写满或报错）
   Status WriteAt(const void* buf, size_t n, uint64_t offset);
 
-  /// 从 offset 读取 n 字节（保证读满；越界返回 NotFound/Corruption）
+  /// 从 offset 读取 n 字节（保证读满；整段越过 EOF 返回 NotFound，读到一半遇 EOF 返回 Corruption）
   Status ReadAt(void* buf, size_t n, uint64_t offset) const;
 
   /// 刷新到稳定存储
@@ -57,16 +70,23 @@ public:
 
   const std::string& path() const noexcept { return path_; }
   int  fd() const noexcept { return fd_; }
+  bool direct() const noexcept { return direct_.load(std::memory_order_relaxed); }
 
 private:
   void MoveFrom(File&& o) noexcept {
     fd_ = o.fd_; path_ = std::move(o.path_);
+    direct_.store(o.direct(), std::memory_order_relaxed);
     o.fd_ = -1;  o.path_.clear();
+    o.direct_.store(false, std::memory_order_relaxed);
   }
 
+  /// 运行中退出直接 I/O（文件系统不接受对齐读写时）
+  void DisableDirect() const;
+
 private:
   int         fd_{-1};
   std::string path_;
+  mutable std::atomic<bool> direct_{false};
 };
 
 }  // namespace storage
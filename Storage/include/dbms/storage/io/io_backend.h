@@ -0,0 +1,84 @@
+#ifndef DBMS_STORAGE_IO_IO_BACKEND_H_
+#define DBMS_STORAGE_IO_IO_BACKEND_H_
+
+/**
+ * @file io_backend.h
+ * @brief 可插拔的页 I/O 后端：批量提交、异步完成回调、固定（注册）缓冲区。
+ *
+ * 语义：
+ *  - Submit()       ：提交一批请求后立即返回；每个请求完成时调用其 done 回调
+ *                     （回调可能在后端的完成线程中执行，应尽量轻量、不得阻塞）；
+ *  - SubmitAndWait()：提交并等待整批完成，返回首个错误；
+ *  - RegisterBuffer()：登记一段常驻内存（如缓冲池 arena），落在其中的请求可走
+ *                     “固定缓冲区”路径，免去每次 I/O 的用户页映射开销。
+ *
+ * 实现：
+ *  - "posix"   ：在调用线程内逐个 pread/pwrite，回调在 Submit 返回前执行（兜底实现）；
+ *  - "io_uring"：单环 + 完成线程；构建时检测到 <linux/io_uring.h> 才可用，
+ *                运行时初始化失败（内核不支持/被禁用）则 Create() 回退到 posix。
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "dbms/storage/storage_types.h"
+
+namespace dbms {
+namespace storage {
+
+enum class IoOp : uint8_t { kRead, kWrite };
+
+using IoCallback = std::function<void(const Status&)>;
+
+/**
+ * @brief 单个 I/O 请求：对 fd 的 [offset, offset+len) 读或写（保证读满/写满或报错）。
+ *        读越过 EOF 返回 NotFound；读到一半遇到 EOF 返回 Corruption（与 File::ReadAt 一致）。
+ */
+struct IoRequest {
+  IoOp       op{IoOp::kRead};
+  int        fd{-1};
+  void*      buf{nullptr};
+  uint32_t   len{0};
+  uint64_t   offset{0};
+  IoCallback done;          ///< 完成回调（可为空）
+};
+
+class IoBackend {
+public:
+  virtual ~IoBackend() = default;
+
+  virtual const char* Name() const noexcept = 0;
+
+  /**
+   * @brief 异步提交 n 个请求。
+   * @return 非 OK 表示提交失败。无论成功与否，每个请求的 done 都恰好被调用一次
+   *         （失败时未能下发的请求以该错误完成），但可能晚于 Submit 返回，
+   *         因此回调捕获的状态应能在 Submit 返回后继续存活。
+   */
+  virtual Status Submit(IoRequest* reqs, size_t n) = 0;
+
+  /// 登记固定缓冲区（可多次调用）；不支持的后端直接返回 OK
+  virtual Status RegisterBuffer(void* base, size_t len) { (void)base; (void)len; return Status::OK(); }
+
+  /// 提交并等待全部完成；会覆盖各请求原有的 done 回调
+  Status SubmitAndWait(IoRequest* reqs, size_t n);
+
+  // ---- 工厂 ----
+
+  /// 进程内共享的 POSIX 后端（无状态）
+  static IoBackend* Posix();
+
+  /**
+   * @brief 按名字创建后端："posix" / "io_uring"。
+   *        io_uring 不可用时回退为 posix（Name() 可用于确认实际类型）；未知名字返回 nullptr。
+   */
+  static std::unique_ptr<IoBackend> Create(const std::string& name, unsigned queue_depth = 64);
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_IO_IO_BACKEND_H_
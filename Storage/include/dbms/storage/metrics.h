@@ -0,0 +1,139 @@
+#ifndef DBMS_STORAGE_METRICS_H_
+#define DBMS_STORAGE_METRICS_H_
+
+/**
+ * @file metrics.h
+ * @brief 存储层细粒度观测：HDR 风格的延迟直方图（分条、无锁记录）与快照 / 清零 / 周期输出。
+ *
+ * 挂接：StorageMetrics 由调用方创建，经 BufferPoolManager::SetMetrics / SegmentManager::SetMetrics
+ * 借给各组件（不取得所有权，须比它们活得久）；未挂接时各记录点只多一次指针判断。
+ *
+ * 直方图：值按对数分段、段内线性 16 格（相对误差不超过 1/16，与 HdrHistogram 的 1 位有效数字相当），
+ * 覆盖 [0, 2^40)，更大的值计入最后一格。记录只做一次 relaxed fetch_add，写入当前线程所属的分条，
+ * 多线程记录同一直方图不争用同一缓存行；快照时各分条合并。
+ *
+ * 清零与并发记录之间不做同步：清零期间到达的样本可能被计入或丢弃，用于统计观测足够。
+ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dbms {
+namespace storage {
+
+/// 单调时钟的纳秒读数（记录点计时用）
+inline uint64_t MetricsNowNs() noexcept {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/// 直方图快照：可合并、可求分位数
+struct HistogramSnapshot {
+  uint64_t              count{0};
+  uint64_t              sum{0};
+  uint64_t              max{0};
+  std::vector<uint64_t> buckets;  ///< 与 LatencyHistogram 的分格一一对应
+
+  double   Mean() const noexcept { return count ? static_cast<double>(sum) / count : 0.0; }
+  /// q ∈ [0, 1] 的分位数（所在格的上界，不超过 max）；空直方图返回 0
+  uint64_t Percentile(double q) const noexcept;
+  void     Merge(const HistogramSnapshot& o);
+};
+
+class LatencyHistogram {
+public:
+  static constexpr int    kSubBits = 4;
+  static constexpr int    kSub     = 1 << kSubBits;
+  static constexpr int    kMaxExp  = 40;                                   ///< 覆盖 [0, 2^kMaxExp)
+  static constexpr size_t kBuckets = (kMaxExp - kSubBits + 1) * kSub;      ///< 592 格
+  static constexpr size_t kStripes = 8;
+
+  LatencyHistogram();
+
+  void Record(uint64_t v) noexcept;
+
+  HistogramSnapshot Snapshot() const;
+  void              Reset() noexcept;
+
+  /// 值 v 所在格；格 i 的取值区间为 [BucketLow(i), BucketHigh(i)]
+  static size_t   BucketOf(uint64_t v) noexcept;
+  static uint64_t BucketLow(size_t i) noexcept;
+  static uint64_t BucketHigh(size_t i) noexcept;
+
+private:
+  struct alignas(64) Stripe {
+    std::array<std::atomic<uint64_t>, kBuckets> buckets;
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+  };
+  std::unique_ptr<Stripe[]> stripes_;
+};
+
+/// 观测项：前 6 项为纳秒延迟，kReplacerScan 为一次 Victim 检查过的候选数
+enum class Metric : uint8_t {
+  kFetchHit,        ///< FetchPage 命中（含分区锁与固定）
+  kFetchMiss,       ///< FetchPage 未命中（选受害者、写回、读盘）
+  kEvictWriteback,  ///< 未命中路径上同步写回脏受害者
+  kDiskRead,        ///< DiskManager 同步读页（ReadPages / ExecutePages 每批计一次）
+  kDiskWrite,       ///< DiskManager 同步写页（ExecutePages 每批计一次）
+  kDiskSync,        ///< DiskManager::Sync（fdatasync）
+  kLockWait,        ///< 等待缓冲池分区锁（只记录未能立即取得的那些次）
+  kReplacerScan,    ///< 替换器一次 Victim 的扫描长度
+  kCount
+};
+const char* MetricName(Metric m) noexcept;
+
+struct MetricsSnapshot {
+  std::array<HistogramSnapshot, static_cast<size_t>(Metric::kCount)> hist;
+  double seconds{0};  ///< 自创建或上次 Reset 起经过的时间
+
+  const HistogramSnapshot& operator[](Metric m) const { return hist[static_cast<size_t>(m)]; }
+  /// 每个非空项一行：name count mean p50 p99 p999 max（延迟以 us 计）
+  std::string ToString() const;
+};
+
+class StorageMetrics {
+public:
+  StorageMetrics();
+  ~StorageMetrics();
+
+  StorageMetrics(const StorageMetrics&) = delete;
+  StorageMetrics& operator=(const StorageMetrics&) = delete;
+
+  void Record(Metric m, uint64_t v) noexcept { hist_[static_cast<size_t>(m)].Record(v); }
+
+  MetricsSnapshot Snapshot() const;
+  void            Reset() noexcept;
+
+  /**
+   * @brief 每 interval_ms 毫秒取一次快照交给 sink（在后台线程中调用）；reset_after 时随后清零，
+   *        使每次输出的是该时间段内的分布。再次调用会先停掉旧的输出线程。
+   */
+  void StartPeriodicDump(uint32_t interval_ms, std::function<void(const MetricsSnapshot&)> sink,
+                         bool reset_after = true);
+  /// 停止周期输出（幂等；析构时自动调用）
+  void StopPeriodicDump();
+
+private:
+  std::array<LatencyHistogram, static_cast<size_t>(Metric::kCount)> hist_;
+  std::atomic<uint64_t> since_ns_;
+
+  std::mutex              dump_mu_;
+  std::condition_variable dump_cv_;
+  bool                    dump_stop_{false};
+  std::thread             dump_thread_;
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_METRICS_H_
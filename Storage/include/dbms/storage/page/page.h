@@ -8,6 +8,7 @@
  * 注：槽位页（Slotted Page）的内部布局与算法在 internal/page/slotted_page_layout.h。
  */
 
+#include <cstddef>
 #include <cstdint>
 #include "dbms/storage/storage_types.h"
 
@@ -23,21 +24,33 @@ namespace storage {
  *  - slot_count    : 槽位数量（堆页有意义，索引页可自定义含义）
  *  - free_off      : 连续空闲区起始偏移（从页首起算）
  *  - free_size     : 连续空闲区大小（字节）
- *  - checksum      : 可选页校验（0 表示未启用）
+ *  - frag_size     : 可经页内压缩回收的碎片字节（已删记录、更新留下的旧副本与尾部）
+ *  - free_slot_hint: 空槽查找起点：槽号小于它的槽均为存活记录（0 总是合法的保守值）
+ *  - checksum      : 整页 CRC-32C（不含本字段；写回时由缓冲池写入，0 表示未写入）
  *  - format_version: 页格式版本（兼容性检查）
  */
 struct PageHeader {
   page_id_t page_id{ kInvalidPageId };
+  uint16_t  free_slot_hint{ 0 };
   uint64_t  page_lsn{ 0 };
   uint16_t  slot_count{ 0 };
   uint16_t  free_off{ static_cast<uint16_t>(sizeof(PageHeader)) };
   uint16_t  free_size{ 0 };
+  uint16_t  frag_size{ 0 };
   uint32_t  checksum{ 0 };
   uint32_t  format_version{ kPageFormatVersion };
 };
 
 // 尽量保持紧凑（有助于页内布局与缓存友好）
 static_assert(sizeof(PageHeader) <= 64, "PageHeader should remain compact (<64 bytes).");
+// free_slot_hint / frag_size 占用的是原先的对齐填充（旧页中恒为 0）：其余字段偏移不变，无需升级页格式
+static_assert(offsetof(PageHeader, page_lsn) == 8 && offsetof(PageHeader, checksum) == 24,
+              "PageHeader field offsets are part of the on-disk format.");
+
+/// 页内可用空间 = 连续空闲 + 可回收碎片（压缩一次即可得到的连续空间；FSM 登记此值）
+inline uint16_t PageUsableSpace(const PageHeader& h) {
+  return static_cast<uint16_t>(h.free_size + h.frag_size);
+}
 
 }  // namespace storage
 }  // namespace dbms
@@ -0,0 +1,136 @@
+#ifndef DBMS_STORAGE_RECORD_ROW_CODEC_H_
+#define DBMS_STORAGE_RECORD_ROW_CODEC_H_
+
+/**
+ * @file row_codec.h
+ * @brief 按 Schema 预编译的行访问计划：一次算好所选列的类型、固定区偏移、宽度与 NULL 位，
+ *        之后逐字段读取只是一次定址加载，不再查 Schema、不再逐字段校验。
+ *
+ * TupleView::GetInt32 等接口每次读取都要经 Schema::GetColumn / FixedOffsetOf（带越界检查）
+ * 核对类型、NULL 位与偏移；对固定 Schema 的热循环，这些检查被重复了 行数 × 列数 次。
+ * RowCodec 把它们前移：
+ *  - 编译期（Compile）：列号越界一次性报错，各列的访问参数存成紧凑数组；
+ *  - 绑定期（Expect）：调用方声明每个投影列的类型，只校验一次；
+ *  - 每行（Valid）：整行长度与所选 VARCHAR 引用一次性校验；
+ *  - 每字段：IsNull / Int32 / Double / Char / VarChar … 无分支、无校验（NULL 位掩码在未启用
+ *    位图时为 0，IsNull 恒为 false）。
+ *
+ * 用法：
+ *   RowCodec codec;
+ *   RowCodec::Compile(schema, {0, 5}, &codec);          // 投影序号 0 → 列 0，1 → 列 5
+ *   codec.Expect(0, Type::INT32); codec.Expect(1, Type::DOUBLE);
+ *   for (...) { if (!codec.Valid(view)) continue;
+ *               sum += codec.Double(view.Data(), 1); }
+ *
+ * 无校验读取要求行已通过 Valid，且投影列类型与所调用的读取函数一致（由 Expect 保证），
+ * 否则结果未定义（调试构建下以 assert 捕获类型误用）。
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "dbms/storage/storage_types.h"
+#include "dbms/storage/record/schema.h"
+#include "dbms/storage/record/tuple.h"
+
+namespace dbms {
+namespace storage {
+
+class RowCodec {
+public:
+  /// 一个投影列的访问参数
+  struct Field {
+    Type     type{Type::INT32};
+    uint32_t column{0};     ///< Schema 中的列序
+    uint32_t offset{0};     ///< 固定区偏移（自行起始，含 NULL 位图）
+    uint32_t width{0};      ///< 固定区宽度（VARCHAR 为 4）
+    uint32_t null_byte{0};  ///< NULL 位所在字节（未启用位图时为 0）
+    uint8_t  null_mask{0};  ///< NULL 位掩码（未启用位图时为 0）
+  };
+
+  RowCodec() = default;
+
+  /**
+   * @brief 为 projection 中的列（为空则按序取全部列）编译访问计划。
+   * @return 列号越界返回 OutOfRange（out 不变）
+   */
+  static Status Compile(const Schema& s, const std::vector<size_t>& projection, RowCodec* out);
+  static Status Compile(const Schema& s, RowCodec* out) { return Compile(s, {}, out); }
+
+  /// 要求第 k 个投影列为类型 t：k 越界返回 OutOfRange，类型不符返回 InvalidArgument
+  Status Expect(size_t k, Type t) const;
+
+  size_t       size()            const noexcept { return fields_.size(); }
+  const Field& field(size_t k)   const noexcept { return fields_[k]; }
+  /// 有效行的最小字节数（NULL 位图 + 固定区）
+  size_t       min_row_size()    const noexcept { return min_row_size_; }
+
+  /// 整行校验：长度不小于固定区，且所选的非 NULL VARCHAR 列引用落在行内
+  bool Valid(const std::uint8_t* row, size_t len) const noexcept;
+  bool Valid(const TupleView& row) const noexcept { return Valid(row.Data(), row.Size()); }
+
+  // ---- 无校验读取（k 为投影序号；行须已通过 Valid） ----
+
+  bool IsNull(const std::uint8_t* row, size_t k) const noexcept {
+    const Field& f = fields_[k];
+    return (row[f.null_byte] & f.null_mask) != 0;
+  }
+  int32_t Int32(const std::uint8_t* row, size_t k) const noexcept {
+    assert(fields_[k].type == Type::INT32);
+    return Load<int32_t>(row, k);
+  }
+  int64_t Int64(const std::uint8_t* row, size_t k) const noexcept {
+    assert(fields_[k].type == Type::INT64);
+    return Load<int64_t>(row, k);
+  }
+  float Float(const std::uint8_t* row, size_t k) const noexcept {
+    assert(fields_[k].type == Type::FLOAT);
+    return Load<float>(row, k);
+  }
+  double Double(const std::uint8_t* row, size_t k) const noexcept {
+    assert(fields_[k].type == Type::DOUBLE);
+    return Load<double>(row, k);
+  }
+  int32_t Date(const std::uint8_t* row, size_t k) const noexcept {
+    assert(fields_[k].type == Type::DATE);
+    return Load<int32_t>(row, k);
+  }
+  /// CHAR 列（去除右侧 '\0' 填充），指向行内存
+  std::string_view Char(const std::uint8_t* row, size_t k) const noexcept {
+    const Field& f = fields_[k];
+    assert(f.type == Type::CHAR);
+    const char* p = reinterpret_cast<const char*>(row + f.offset);
+    size_t n = f.width;
+    while (n > 0 && p[n - 1] == '\0') --n;
+    return std::string_view(p, n);
+  }
+  /// VARCHAR 列，指向行内存
+  std::string_view VarChar(const std::uint8_t* row, size_t k) const noexcept {
+    const Field& f = fields_[k];
+    assert(f.type == Type::VARCHAR);
+    uint16_t ref[2];
+    std::memcpy(ref, row + f.offset, sizeof(ref));
+    return std::string_view(reinterpret_cast<const char*>(row + ref[0]), ref[1]);
+  }
+  /// 定长列的原始值（T 的宽度须与列宽一致）
+  template <class T>
+  T Load(const std::uint8_t* row, size_t k) const noexcept {
+    assert(sizeof(T) == fields_[k].width);
+    T v;
+    std::memcpy(&v, row + fields_[k].offset, sizeof(T));
+    return v;
+  }
+
+private:
+  std::vector<Field>    fields_;
+  std::vector<uint32_t> var_fields_;  // 投影中 VARCHAR 列的序号（Valid 只需检查这些）
+  size_t                min_row_size_{0};
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_RECORD_ROW_CODEC_H_
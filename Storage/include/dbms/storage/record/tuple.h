@@ -8,6 +8,9 @@
  * 布局见 schema.h： [NullBitmap?][Fixed Area][Var Area]
  * - VARCHAR 的固定区为 (uint16_t offset, uint16_t len)，offset 从行起始算起。
  * - CHAR(N) 固定 N 字节（右侧 '\0' 填充；超长则截断）。
+ *
+ * TupleView 是同一字节布局的非拥有视图（指针 + 长度），读取接口与 Tuple 相同；
+ * 常用于直接读取被固定页内的记录，生命周期不得超过底层内存。
  */
 
 #include <cstdint>
@@ -21,6 +24,41 @@
 namespace dbms {
 namespace storage {
 
+class Tuple;
+
+class TupleView {
+public:
+  TupleView() = default;
+  TupleView(const std::uint8_t* data, size_t len) : data_(data), size_(len) {}
+
+  const std::uint8_t* Data() const noexcept { return data_; }
+  size_t Size()  const noexcept { return size_; }
+  bool   Empty() const noexcept { return size_ == 0; }
+
+  /// 物化为拥有内存的 Tuple（拷贝）
+  Tuple  ToTuple() const;
+
+  // NULL 位图
+  bool   IsNull(const Schema& schema, size_t col_idx) const;
+
+  // 读取接口（与 Tuple 一致：列为 NULL 返回 NotFound；类型不匹配返回 InvalidArgument）
+  Status GetInt32 (const Schema& s, size_t i, int32_t*  out) const;
+  Status GetInt64 (const Schema& s, size_t i, int64_t*  out) const;
+  Status GetFloat (const Schema& s, size_t i, float*    out) const;
+  Status GetDouble(const Schema& s, size_t i, double*   out) const;
+  Status GetDate  (const Schema& s, size_t i, int32_t*  out_days) const;
+  Status GetChar  (const Schema& s, size_t i, std::string* out) const;
+  Status GetVarChar(const Schema& s, size_t i, std::string* out) const;
+
+  // 零拷贝读取字符串列（结果指向底层内存；CHAR 去除右侧 '\0' 填充）
+  Status GetCharView   (const Schema& s, size_t i, std::string_view* out) const;
+  Status GetVarCharView(const Schema& s, size_t i, std::string_view* out) const;
+
+private:
+  const std::uint8_t* data_{nullptr};
+  size_t              size_{0};
+};
+
 class Tuple {
 public:
   Tuple() = default;
@@ -34,6 +72,14 @@ public:
   void   Serialize(std::uint8_t* out) const;
   static Tuple Deserialize(const std::uint8_t* src, size_t len);
 
+  /// 以 src[0, len) 覆盖内容，复用已有容量（反复读入同一个 Tuple 时不再分配）
+  void   Assign(const std::uint8_t* src, size_t len) { data_.assign(src, src + len); }
+  /// 取走底层缓冲（连同容量，便于填充后再交还）；Tuple 变为空
+  std::vector<std::uint8_t> ReleaseBytes() noexcept { return std::move(data_); }
+
+  /// 指向自身字节的视图（Tuple 修改或析构后失效）
+  TupleView View() const noexcept { return TupleView(data_.data(), data_.size()); }
+
   // NULL 位图
   bool   IsNull(const Schema& schema, size_t col_idx) const;
 
@@ -63,11 +109,21 @@ private:
  *   tb.SetInt32(0, 42);
  *   tb.SetVarChar(1, "hello");
  *   Tuple t; tb.Build(&t);
+ *
+ * 复用：Reset() 清空已设置的值但保留内部缓冲；Build() 写入 out 现有的缓冲，
+ * 同一个构造器与同一个 Tuple 反复使用时，每行不再产生堆分配。
+ * BuildInto() 把行直接写入调用方的内存（例如页内，见 TableAppender::Append(const TupleBuilder&)）。
+ * 构造器只可移动：它引用 Schema 且持有逐行复用的缓冲，拷贝没有意义。
  */
 class TupleBuilder {
 public:
   explicit TupleBuilder(const Schema& s);
 
+  TupleBuilder(TupleBuilder&&) noexcept = default;
+  TupleBuilder& operator=(TupleBuilder&&) noexcept = default;
+  TupleBuilder(const TupleBuilder&) = delete;
+  TupleBuilder& operator=(const TupleBuilder&) = delete;
+
   // 设置 NULL 与各类型值（下标 i 为列序）
   Status SetNull(size_t i);
   Status SetInt32 (size_t i, int32_t  v);
@@ -78,11 +134,21 @@ public:
   Status SetChar  (size_t i, std::string_view v);   // 固定 N 字节
   Status SetVarChar(size_t i, std::string_view v);  // 限定最大长度
 
+  /// 清空所有列的值（保留缓冲容量），用于逐行复用同一个构造器
+  void   Reset();
+
   // 生成最终 Tuple
   Status Build(Tuple* out);
 
+  /// 所有列都已设置（或标为 NULL）
+  bool   Complete()  const noexcept;
+  /// Build / BuildInto 将产生的字节数
+  size_t BuiltSize() const noexcept { return row_.size() + var_.size(); }
+  /// 把行写入 dst[0, cap)；列未设置返回 InvalidArgument，cap 不足返回 OutOfRange（均不写入）
+  Status BuildInto(std::uint8_t* dst, size_t cap, size_t* out_len = nullptr) const;
+
 private:
-  const Schema& s_;
+  const Schema* s_;
 
   std::vector<std::uint8_t> row_;  // Fixed + NullBitmap
   std::vector<std::uint8_t> var_;  // Var 区缓冲
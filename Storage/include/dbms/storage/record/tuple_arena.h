@@ -0,0 +1,90 @@
+#ifndef DBMS_STORAGE_RECORD_TUPLE_ARENA_H_
+#define DBMS_STORAGE_RECORD_TUPLE_ARENA_H_
+
+/**
+ * @file tuple_arena.h
+ * @brief 记录的顺推（bump）分配区：按查询或按线程使用，逐条分配、整体释放。
+ *
+ * 用法：
+ *   TupleArena arena;
+ *   TupleView v;
+ *   table.Get(rid, &arena, &v);         // 记录拷入 arena，v 指向该拷贝
+ *   ...
+ *   arena.Reset();                      // 一次性作废本轮的所有记录，保留内存块
+ *
+ * 内存按块（默认 64 KiB）向系统申请；Reset() 后块留作下一轮复用，稳定后不再分配。
+ * 超过块大小的单次分配单独成块。非线程安全：每个线程各用一个。
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "dbms/storage/record/tuple.h"
+
+namespace dbms {
+namespace storage {
+
+class TupleArena {
+public:
+  static constexpr size_t kDefaultBlockSize = 64u << 10;
+
+  explicit TupleArena(size_t block_size = kDefaultBlockSize);
+
+  TupleArena(TupleArena&&) noexcept = default;
+  TupleArena& operator=(TupleArena&&) noexcept = default;
+  TupleArena(const TupleArena&) = delete;
+  TupleArena& operator=(const TupleArena&) = delete;
+
+  /// 分配 n 字节（align 须为 2 的幂）；n 为 0 时也返回可用的非空指针
+  std::uint8_t* Allocate(size_t n, size_t align = alignof(std::max_align_t));
+
+  /// 把 data[0, len) 拷入 arena，返回指向拷贝的视图
+  TupleView Copy(const std::uint8_t* data, size_t len);
+  TupleView Copy(const TupleView& v) { return Copy(v.Data(), v.Size()); }
+
+  /// 作废所有分配（之前返回的指针与视图随之失效），保留内存块供复用
+  void Reset() noexcept;
+  /// 作废所有分配并把内存块还给系统
+  void Release() noexcept;
+
+  size_t bytes_used()     const noexcept { return used_; }      ///< 自上次 Reset 以来分配的字节数
+  size_t bytes_reserved() const noexcept { return reserved_; }  ///< 持有的块总大小
+  size_t blocks()         const noexcept { return blocks_.size(); }
+
+private:
+  struct Block {
+    std::unique_ptr<std::uint8_t[]> mem;
+    size_t                          size{0};
+  };
+
+  std::uint8_t* AllocateSlow(size_t n, size_t align);
+
+private:
+  size_t             block_size_;
+  std::vector<Block> blocks_;
+  size_t             cur_{0};   // 当前块下标（blocks_ 为空时无意义）
+  size_t             off_{0};   // 当前块内已用字节
+  size_t             used_{0};
+  size_t             reserved_{0};
+};
+
+inline std::uint8_t* TupleArena::Allocate(size_t n, size_t align) {
+  if (!blocks_.empty()) {
+    Block&       b   = blocks_[cur_];
+    const size_t pad = (align - reinterpret_cast<uintptr_t>(b.mem.get() + off_) % align) % align;
+    if (off_ + pad + n <= b.size) {
+      std::uint8_t* p = b.mem.get() + off_ + pad;
+      off_  += pad + n;
+      used_ += n;
+      return p;
+    }
+  }
+  return AllocateSlow(n, align);
+}
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_RECORD_TUPLE_ARENA_H_
@@ -7,14 +7,33 @@
  *
  * 职责：
  *  - seg_id → 文件（DiskManager）映射与生命周期；
- *  - AllocatePage/FreePage：段内页的编号管理（优先复用空闲栈，否则扩容）；
- *  - PageCount(seg)、ProbePageFree(seg,pid)：便于 FSM 重建；
+ *  - AllocatePage/FreePage：段内页的编号管理（优先复用空闲栈/空闲区段，否则推进高水位）；
+ *  - AllocatePages/FreePages：一次分配/归还一段连续页（批量装载用）；
+ *  - PageCount(seg)、ProbePageFree(seg,pid)/ProbePagesFree：便于 FSM 重建；
+ *  - 段元数据（页数、空闲栈、区段表）持久化到 seg_<id>.meta：Checkpoint 时原子替换，
+ *    打开段时校验并恢复；每段另有一个 FSM 分叉文件 seg_<id>.fsm（格式由 FSM 定义）
+ *    和一个区间摘要文件 seg_<id>.zone（格式由 ZoneMap 定义）；
+ *  - 冷段：FreezeSegment 把段内各页压缩进 seg_<id>.cold 并释放原段文件的磁盘块，之后段只读，
+ *    读页经 GetColdSegment 解压（缓冲池未命中时）；ThawSegment 解压回原文件并恢复可写；
+ *  - 只读闸门：写入方在 WriteScope 内修改段的页；SetReadOnly 置位后拒绝新的分配与 WriteScope，
+ *    并等到在途的写入区间全部结束，冻结前据此让段文件先变为最新。
  *
- * 线程安全：对外方法内部加锁（std::mutex）。
+ * 区段（extent）分配：
+ *  - 文件按区段扩展（fallocate），区段大小从 extent_min 起每次翻倍，封顶 extent_max
+ *    （默认 1 MiB → 64 MiB）；区段表记录每次扩展，用于重启后延续增长节奏；
+ *  - 高水位（已分配出去的页数）只在内存中维护，PageCount 不再 fstat，分配也不做系统调用，
+ *    只有高水位越过文件已预留的页时才扩展一次；
+ *  - FreePages 归还的连续页并入空闲区段（相邻合并；位于高水位末尾时直接回退高水位），
+ *    供之后的 AllocatePage(s) 复用，表收缩后不必继续增长文件。
+ *
+ * 线程安全：段表由读写锁保护；每个段有自己的互斥锁，不同段（表）的分配互不争用。
  */
 
 #include <cstdint>
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -26,13 +45,38 @@
 namespace dbms {
 namespace storage {
 
+class ColdSegment;
+class Schema;
+
+/// 冷段概况（观测用；段不是冷段时各项为 0）
+struct ColdSegmentStats {
+  bool     cold{false};
+  uint64_t pages{0};          ///< 冷冻时的页数
+  uint64_t raw_bytes{0};      ///< pages × page_size
+  uint64_t stored_bytes{0};   ///< 冷段文件中页数据的字节数（压缩比 = raw_bytes / stored_bytes）
+  uint64_t raw_pages{0};      ///< 原样存放的页
+  uint64_t lz4_pages{0};      ///< 整页 LZ4 的页
+  uint64_t pax_pages{0};      ///< PAX 按列编码的页
+  uint64_t for_columns{0};    ///< FOR + 位打包的列小页
+  uint64_t dict_columns{0};   ///< 字典编码的列小页
+  uint64_t decoded_pages{0};  ///< 打开以来解压的页数
+  uint64_t read_bytes{0};     ///< 打开以来读盘的压缩字节
+  uint64_t decode_ns{0};      ///< 打开以来的解压耗时（纳秒）
+};
+
 class SegmentManager {
+  struct Segment;  // 单个段的内存状态（定义见下方私有部分）
+
 public:
   /**
    * @param page_size  页大小（字节）
    * @param base_dir   段文件所在目录（需已存在且可写）
+   * @param direct_io  段文件以 O_DIRECT 打开（对应 StorageOptions::io_direct；不支持时自动退回）
    */
-  SegmentManager(uint32_t page_size, std::string base_dir);
+  SegmentManager(uint32_t page_size, std::string base_dir, bool direct_io = false);
+
+  static constexpr uint64_t kDefaultExtentMinBytes = 1ull << 20;   ///< 1 MiB
+  static constexpr uint64_t kDefaultExtentMaxBytes = 64ull << 20;  ///< 64 MiB
 
   SegmentManager(const SegmentManager&) = delete;
   SegmentManager& operator=(const SegmentManager&) = delete;
@@ -48,30 +92,144 @@ public:
   // ---- 页分配 / 回收 ----
   page_id_t   AllocatePage(seg_id_t seg);         ///< 失败时返回 kInvalidPageId
   void        FreePage(seg_id_t seg, page_id_t);  ///< 简单放回空闲栈，不收缩文件
+  /// 分配 n 个连续页（优先首次适配空闲区段，否则取高水位之后），返回首页号；失败时返回 kInvalidPageId
+  page_id_t   AllocatePages(seg_id_t seg, uint32_t n);
+  /// 归还 [first, first+n)（页内不得再有存活记录），并入空闲区段
+  void        FreePages(seg_id_t seg, page_id_t first, uint32_t n);
+
+  /// 区段增长策略（字节，按页大小取整；对已打开的段之后的扩展同样生效）
+  void        SetExtentPolicy(uint64_t min_bytes, uint64_t max_bytes);
+
+  /// 段空间概况（观测用）
+  struct SpaceStats {
+    uint64_t page_count{0};        ///< 高水位
+    uint64_t file_pages{0};        ///< 文件已预留的页数
+    uint64_t extents{0};           ///< 扩展次数（区段表长度）
+    uint64_t free_pages{0};        ///< 空闲栈中的页数
+    uint64_t free_extent_pages{0}; ///< 空闲区段中的页数
+  };
+  SpaceStats  GetSpaceStats(seg_id_t seg) const;
 
   // ---- 查询 / 探测 ----
-  uint64_t    PageCount(seg_id_t seg) const;      ///< 文件可寻址页数
-  uint16_t    ProbePageFree(seg_id_t seg, page_id_t pid) const;  ///< 读取 PageHeader.free_size
+  uint64_t    PageCount(seg_id_t seg) const;      ///< 已分配页数（高水位；无系统调用）
+  uint16_t    ProbePageFree(seg_id_t seg, page_id_t pid) const;  ///< 读取页的可用空间（PageUsableSpace）
+  /// 以大块顺序读批量探测 [first, first+count) 各页的可用空间（未初始化的页为 0）
+  Status      ProbePagesFree(seg_id_t seg, page_id_t first, uint32_t count, uint16_t* out) const;
+
+  // ---- 元数据持久化 ----
+  /**
+   * @brief 把段元数据写入 seg_<id>.meta（先写临时文件并 fsync，再 rename 覆盖）。
+   *        重新打开段时校验魔数/页大小/校验和；空闲栈中仍含存活记录的页（检查点之后被复用）会被丢弃。
+   */
+  Status      Checkpoint(seg_id_t seg);
+  Status      CheckpointAll();
+  /// 段的 FSM 分叉文件（seg_<id>.fsm，页大小与数据段相同）；首次调用时打开/创建
+  DiskManager* GetFsmDisk(seg_id_t seg);
+  /// 段的区间摘要文件（seg_<id>.zone，格式由 ZoneMap 定义）；首次调用时打开/创建
+  DiskManager* GetZoneDisk(seg_id_t seg);
+
+  // ---- 冷段 ----
+  /**
+   * @brief 把段的 [0, PageCount) 页压缩写入 seg_<id>.cold，此后该段只读：读页解压自冷段文件，
+   *        分配新页失败，原段文件的磁盘块被释放（打洞；文件系统不支持时保留，不影响正确性）。
+   * @param schema 非空时 PAX 页按列编码（FOR / 字典 + LZ4），否则整页 LZ4
+   * @note 调用方须先经 SetReadOnly 挡住写入，再把该段的脏页写回（TableHeap::Freeze 负责）；
+   *       已是冷段时直接返回 OK。成功后段保持只读，直到 ThawSegment。
+   *       压缩与写冷段文件期间不持段锁；同一段上另一次冻结 / 解冻正在进行时返回 Unavailable
+   */
+  Status      FreezeSegment(seg_id_t seg, const Schema* schema = nullptr);
+  /// 把冷段各页解压写回原段文件并落盘，删除冷段文件，段恢复可写；不是冷段时返回 OK。
+  /// 写回期间不持段锁（读页仍经冷段），只在最后切换时加锁；与 FreezeSegment 一样互斥于另一次冻结 / 解冻
+  Status      ThawSegment(seg_id_t seg);
+  bool        IsCold(seg_id_t seg) const;
+
+  /**
+   * @brief 置 / 清段的只读标记。置位在段锁内发布：此后 AllocatePage(s) 失败、WriteScope 登记失败，
+   *        返回前等待已登记的写入区间全部结束。段已只读（冷段或另一次冻结正在进行）时返回 Unavailable；
+   *        清除对冷段无效（须 ThawSegment）。
+   */
+  Status      SetReadOnly(seg_id_t seg, bool on);
+  bool        IsReadOnly(seg_id_t seg) const;  ///< 冷段或正在冻结
+
+  /**
+   * @brief 写入区间：构造时登记为段的在途写者，段只读时登记失败（ok() 为 false，调用方应拒绝写入）。
+   *        区间内完成的页修改（含解固定时置脏）都发生在 SetReadOnly 返回之前。
+   */
+  class WriteScope {
+  public:
+    WriteScope(SegmentManager* sm, seg_id_t seg);
+    ~WriteScope();
+    WriteScope(const WriteScope&) = delete;
+    WriteScope& operator=(const WriteScope&) = delete;
+
+    bool ok() const noexcept { return ok_; }
+
+  private:
+    Segment* seg_{nullptr};  // 已登记的段（登记失败或段不存在时为空）
+    bool     ok_{false};
+  };
+  /// 冷段读取器（缓冲池未命中时经它解压读页）；不是冷段返回 nullptr。指针在 SegmentManager 存续期间有效
+  ColdSegment* GetColdSegment(seg_id_t seg) const;
+  ColdSegmentStats GetColdStats(seg_id_t seg) const;
+
+  // ---- I/O 后端 ----
+  /// 设置各段 DiskManager 的批量/异步 I/O 后端（对已打开与之后打开的段都生效；不取得所有权）
+  void         SetIoBackend(IoBackend* io);
+  IoBackend*   io_backend() const;
+  /// 各段 DiskManager 挂接延迟直方图（同样对之后打开的段生效；nullptr 取消）
+  void         SetMetrics(StorageMetrics* m);
 
   // ---- 访问器 ----
   DiskManager* GetDisk(seg_id_t seg);
   uint32_t     page_size() const noexcept { return page_size_; }
+  bool         direct_io() const noexcept { return direct_io_; }  ///< 请求值；实际以 DiskManager::direct_io() 为准
   const std::string& base_dir() const noexcept { return base_dir_; }
 
 private:
+  struct Extent {
+    page_id_t first;
+    uint32_t  count;
+  };
+
   struct Segment {
-    std::unique_ptr<DiskManager> disk;     // 段文件
-    std::vector<page_id_t>       free_list; // 空闲页栈（后进先出）
+    std::mutex                   mu;        // 保护以下分配状态（hwm 的读取无需加锁）
+    std::unique_ptr<DiskManager> disk;      // 段文件
+    std::unique_ptr<DiskManager> fsm_disk;  // FSM 分叉（按需打开）
+    std::unique_ptr<DiskManager> zone_disk; // 区间摘要（按需打开）
+    std::atomic<uint64_t>        hwm{0};    // 高水位：[0, hwm) 已分配过
+    uint64_t                     file_pages{0};  // 文件已预留的页数（>= hwm）
+    std::vector<Extent>          extents;        // 文件扩展记录（按页号升序）
+    std::vector<Extent>          free_extents;   // 空闲区段（按页号升序、互不相邻）
+    std::vector<page_id_t>       free_list;      // 空闲页栈（后进先出）
+    std::atomic<ColdSegment*>    cold{nullptr};  // 冷段读取器（无锁读取；解冻后旧读取器留在 retired 中）
+    std::atomic<bool>            read_only{false};  // 冷段或正在冻结：拒绝分配与新的写入区间
+    std::atomic<uint32_t>        writers{0};         // 在途的写入区间数（WriteScope）
+    std::condition_variable      writers_cv;         // 只读期间写入区间归零时通知（配合 mu）
+    bool                         transition{false};  // 冻结或解冻正在进行（受 mu 保护）
+    std::vector<std::unique_ptr<ColdSegment>> retired;  // 持有全部冷段读取器（受 mu 保护）
   };
 
   std::string MakePath(seg_id_t seg) const;
+  Segment*    FindSegment(seg_id_t seg) const;    // 共享锁查找；不存在返回 nullptr
+  Segment*    GetOrCreateSegment(seg_id_t seg);  // 不存在时创建并恢复元数据
+  void        LoadMeta(seg_id_t seg, Segment* s);      // 打开段时恢复元数据与高水位
+  bool        GrowLocked(Segment* s, uint64_t pages);  // 确保文件至少预留 pages 页（需持有 s->mu）
+  void        FreeRunLocked(Segment* s, page_id_t first, uint64_t n);  // 需持有 s->mu
+  static void LeaveWrite(Segment* s);  // 注销一个写入区间；段只读且计数归零时唤醒 SetReadOnly
+  /// 顺序读 [first, first+n) 页：冷段经解压，否则直接读段文件
+  Status      ReadPagesRouted(Segment* s, page_id_t first, uint32_t n, void* out) const;
 
 private:
   uint32_t    page_size_{0};
   std::string base_dir_;
-
-  mutable std::mutex                 mu_;
-  std::unordered_map<seg_id_t, Segment> segs_;
+  bool        direct_io_{false};
+  std::atomic<uint64_t> extent_min_pages_{1};
+  std::atomic<uint64_t> extent_max_pages_{1};
+
+  mutable std::shared_mutex          mu_;  // 保护段表与 io_ / metrics_
+  std::unordered_map<seg_id_t, std::unique_ptr<Segment>> segs_;
+  IoBackend*                         io_{IoBackend::Posix()};
+  StorageMetrics*                    metrics_{nullptr};
 };
 
 }  // namespace storage
@@ -3,24 +3,42 @@
 
 /**
  * @file free_space_manager.h
- * @brief 空闲空间管理器（FSM）：按“剩余空间”分桶管理页，快速定位可插入页。
+ * @brief 空闲空间管理器（FSM）：每页 1 字节记录“空闲类别”，经最大值树快速定位可插入页。
  *
- * 桶定义：
+ * 编码（与 PostgreSQL FSM 类似）：
+ *  - step = ceil(page_size / 255)；页的类别 = 1 + min(254, free / step)，0 表示该页未被跟踪；
+ *  - 类别向下取整，Find(need) 只返回类别 >= 1 + ceil(need / step) 的页，保证真的放得下
+ *    （代价是至多 step 字节的低估）；
+ *  - 查找为首次适配（页号最小者），O(log64 n)。
+ *
+ * 并发（面向多线程插入）：
+ *  - 页按 pid % kStripes 交错分到 kStripes 个条带，每个条带有独立的锁、最大值树与桶计数，
+ *    不同线程的查找/更新大多落在不同的锁上；
+ *  - 每个线程有一个“主条带”（按线程首次调用轮转分配），Acquire 先试该线程最近释放的页
+ *    （页内数据多半仍在缓存中），再从主条带起依次查找其余条带；
+ *  - Acquire 会“预留”返回的页：页在 Release 前对其他 Acquire/Find 不可见，
+ *    因此两个插入者不会被引到只够一条记录的同一页上，插入路径也不会争用同一页。
+ *
+ * 桶（仅用于观测）：
  *  thresholds_ = {t0, t1, ..., tN-1}（严格递增）
  *   Bin0: [0, t0)
  *   Bin1: [t0, t1)
  *   ...
  *   BinN: [tN-1, +∞)  （实现中以 page_size 截断）
+ *  页按其类别的下界（(类别-1) * step）归桶。
  *
- * 线程安全：内部用互斥锁保护所有状态；Find/Update/Remove/重建均为线程安全。
+ * 持久化：SaveTo/LoadFrom 把类别数组写入独立的 FSM 段文件（首页为头，其后按字节平铺）。
+ *  启动时先 LoadFrom，再用 RebuildFromSegment(seg, size()) 只补探检查点之后追加的页；
+ *  FSM 文件缺失/损坏时才全量重建（注册了批量探测时按大块顺序读、多线程并行）。
+ *
+ * 线程安全：所有接口均为线程安全；整体操作（重建/载入/快照）按条带逐个加锁。
  */
 
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 #include "dbms/storage/storage_types.h"
@@ -28,25 +46,42 @@
 namespace dbms {
 namespace storage {
 
+class DiskManager;
+class FsmTree;
+
 class FreeSpaceManager {
 public:
   /**
    * @param page_size   页大小（字节）
-   * @param thresholds  桶阈值（严格递增），例如 {128,512,1024,2048,4096,8192}
+   * @param thresholds  观测用的桶阈值（严格递增），例如 {128,512,1024,2048,4096,8192}
    */
   FreeSpaceManager(uint32_t page_size, std::vector<uint32_t> thresholds);
+  ~FreeSpaceManager();
 
   FreeSpaceManager(const FreeSpaceManager&) = delete;
   FreeSpaceManager& operator=(const FreeSpaceManager&) = delete;
 
+  static constexpr size_t kStripes = 16;
+
   /**
-   * @brief 查找一个可容纳 need_bytes 的页（任意一个即可）。
+   * @brief 查找一个可容纳 need_bytes 的页（页号最小者）。
    * @return 命中返回 pid；否则返回 kInvalidPageId。
    */
   page_id_t Find(uint16_t need_bytes) const;
 
   /**
-   * @brief 插入/更新某页的空闲空间（自动在桶间迁移）。
+   * @brief 查找并预留一个可容纳 need_bytes 的页；调用方写完后必须 Release。
+   * @return 命中返回 pid；否则返回 kInvalidPageId（调用方应分配新页）。
+   */
+  page_id_t Acquire(uint16_t need_bytes);
+
+  /// 结束预留并记录该页新的空闲空间（对未预留的页等同 Update，例如刚分配的新页）
+  void Release(page_id_t pid, uint16_t free_bytes);
+  /// 结束预留，空闲空间保持不变（例如取页失败）
+  void Release(page_id_t pid);
+
+  /**
+   * @brief 插入/更新某页的空闲空间。
    * @param pid         页号
    * @param free_bytes  该页连续空闲空间大小（字节）
    */
@@ -58,33 +93,64 @@ public:
   // ---------- 与段管理的低耦合重建支持 ----------
   using FreeProbeFn  = std::function<uint16_t(seg_id_t /*seg*/, page_id_t /*pid*/)>;
   using PageCountFn  = std::function<uint64_t(seg_id_t /*seg*/)>;
+  /// 批量探测：写出 [first, first+count) 各页的空闲字节数（如 SegmentManager::ProbePagesFree）
+  using FreeBatchProbeFn =
+      std::function<Status(seg_id_t /*seg*/, page_id_t /*first*/, uint32_t /*count*/, uint16_t* /*out*/)>;
 
-  /// Integration/Segment 层在启动后注入
+  /// Integration/Segment 层在启动后注入（逐页探测）
   void RegisterSegmentProbe(FreeProbeFn free_probe, PageCountFn page_count);
+  /// 注入批量探测（优先于逐页探测）
+  void RegisterSegmentProbe(FreeBatchProbeFn batch_probe, PageCountFn page_count);
+
+  /**
+   * @brief 扫描某段并重建 [first, 段尾) 的 FSM 项（first=0 即全量重建，之前的项保持不变）。
+   *        探测期间不持有 FSM 锁；批量探测时按页区间分给 threads 个线程（0=按硬件并发数）。
+   *        未注册回调返回 Unavailable。
+   */
+  Status RebuildFromSegment(seg_id_t seg, page_id_t first = 0, int threads = 0);
 
-  /// 全量扫描某段并重建 FSM；未注册回调返回 Unavailable
-  Status RebuildFromSegment(seg_id_t seg);
+  /// 当前跟踪的页号范围上界（即全局类别数组长度）
+  uint64_t size() const;
+
+  // ---------- 持久化（FSM 段） ----------
+  /// 把类别数组写入 disk（覆盖原内容并 Sync）；disk 的页大小须不小于 64 字节
+  Status SaveTo(DiskManager* disk) const;
+  /// 从 disk 载入；头部不匹配（魔数/版本/页大小）或校验和错误返回 Corruption，原状态不变
+  Status LoadFrom(DiskManager* disk);
 
   // ---------- 观测 ----------
   std::vector<size_t>   BinSizes() const;        ///< 每个桶的 pid 数量
   std::vector<uint32_t> BinThresholds() const;   ///< 桶阈值快照
   size_t                TotalTrackedPages() const;
+  size_t                MemoryBytes() const;     ///< 类别数组与最大值树占用的字节数
 
 private:
-  size_t BinIndex(uint32_t free_bytes) const;
+  struct Stripe;
+
+  size_t  BinIndex(uint32_t free_bytes) const;
+  uint8_t ToCategory(uint16_t free_bytes) const;
+  uint8_t MinCategory(uint16_t need_bytes) const;  // 超出可表示范围返回 0
+  Stripe& StripeOf(page_id_t pid) const;
+
+  void    SetCategory(Stripe& st, uint32_t local, uint8_t cat);  // 需持有 st.mu
+  void    Reserve(Stripe& st, uint32_t local);                   // 需持有 st.mu
+  void    RecountBins(Stripe& st);                               // 需持有 st.mu
+  std::vector<uint8_t> Snapshot() const;         ///< 全局类别数组（预留页取真实类别）
+  void    AssignAll(const std::vector<uint8_t>& cats);
 
 private:
   uint32_t page_size_{0};
-  std::vector<uint32_t> thresholds_;                       // 桶阈值
-  std::vector<std::unordered_set<page_id_t>> bins_;        // 每桶的 pid 集合
+  uint32_t step_{1};                          // 每个类别代表的字节数
+  std::vector<uint32_t> thresholds_;          // 桶阈值（构造后不变）
+  std::vector<uint8_t>  cat2bin_;             // 类别 -> 桶（类别 0 不计）
 
-  std::unordered_map<page_id_t, size_t>   pid2bin_;        // pid -> bin
-  std::unordered_map<page_id_t, uint16_t> pid2free_;       // pid -> free
+  std::unique_ptr<Stripe[]> stripes_;         // kStripes 个条带（各自的最大值树 + 锁）
 
-  FreeProbeFn  probe_free_;
-  PageCountFn  probe_count_;
+  FreeProbeFn      probe_free_;
+  FreeBatchProbeFn probe_batch_;
+  PageCountFn      probe_count_;
 
-  mutable std::mutex mu_;
+  mutable std::mutex mu_;                     // 仅保护探测回调
 };
 
 }  // namespace storage
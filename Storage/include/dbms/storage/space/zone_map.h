@@ -0,0 +1,129 @@
+#ifndef DBMS_STORAGE_SPACE_ZONE_MAP_H_
+#define DBMS_STORAGE_SPACE_ZONE_MAP_H_
+
+/**
+ * @file zone_map.h
+ * @brief 区间摘要（zone map）：表的每页、每个数值列记录 min / max / NULL 数，
+ *        扫描据此跳过谓词不可能命中的页，不经缓冲池取页。
+ *
+ * 覆盖的列：Schema 中的 INT32 / INT64 / DATE / FLOAT / DOUBLE 列（谓词可求值的定长列）。
+ *
+ * 语义（保守）：摘要只会放宽、不会收窄——插入/更新把新值并入范围，删除不改摘要，
+ * 因此范围总是覆盖页上曾经出现过的所有值；rows / nulls 同理只增不减（是上界）。
+ * 只有从页内容重建（TableHeap::RecoverZoneMap）给出精确值。从未记入的页 rows=0，视为“可能命中”，不会被跳过。
+ * 浮点列遇到 NaN 时范围放宽为 [-inf, +inf]。
+ *
+ * 并发：页按 pid % kStripes 分到各条带（同 FSM），记入与查询只锁一个条带。
+ *
+ * 持久化：SaveTo/LoadFrom 把摘要写入独立的 zone 文件（seg_<id>.zone，首页为头）。
+ *  磁盘上的摘要须覆盖磁盘上的页：保存（或载入）之后、第一次修改之前，调用方经 Invalidate 把文件头作废并落盘
+ *  （TableHeap 在取页写闩锁之前调用，I/O 不在闩锁内），崩溃后文件头无效即整表重建，不会用到过时的范围。
+ *  文件头已作废时 Invalidate 与各次修改只读一个原子标记、不加表级锁。
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "dbms/storage/storage_types.h"
+#include "dbms/storage/record/row_codec.h"
+#include "dbms/storage/record/schema.h"
+
+namespace dbms {
+namespace storage {
+
+class DiskManager;
+
+/// 一列在一页上的摘要。rows > nulls 时 min/max 有效（只覆盖非 NULL 值）
+struct ZoneEntry {
+  uint32_t rows{0};   ///< 记入的行数（上界；0 表示该页未被跟踪）
+  uint32_t nulls{0};  ///< 其中为 NULL 的行数（上界）
+  int64_t  min{0};    ///< 整数列（INT32/INT64/DATE）的值；浮点列为 double 的位模式，经 dmin() 读取
+  int64_t  max{0};
+
+  bool   tracked()    const noexcept { return rows > 0; }
+  bool   has_values() const noexcept { return rows > nulls; }
+  double dmin() const noexcept { double d; std::memcpy(&d, &min, sizeof(d)); return d; }
+  double dmax() const noexcept { double d; std::memcpy(&d, &max, sizeof(d)); return d; }
+};
+
+class ZoneMap {
+public:
+  static constexpr size_t kStripes = 16;
+
+  /// schema 须比 ZoneMap 活得久；schema 没有可覆盖的列时 empty() 为 true
+  explicit ZoneMap(const Schema& schema);
+  ~ZoneMap();
+
+  ZoneMap(const ZoneMap&) = delete;
+  ZoneMap& operator=(const ZoneMap&) = delete;
+
+  bool   empty() const noexcept { return columns_.empty(); }
+  /// 覆盖的列（Schema 列序）；按页摘要数组按此顺序排列
+  const std::vector<size_t>& columns() const noexcept { return columns_; }
+  /// column 在 columns() 中的位置；未覆盖返回 -1
+  int    SlotOf(size_t column) const noexcept;
+
+  // ---------- 记入 ----------
+  /// 把一行（行格式记录）并入 pid 的摘要；长度不足固定区的记录忽略
+  void Add(page_id_t pid, const std::uint8_t* row, size_t len);
+  /// 把一行并入页外的累加器（columns().size() 项，初值为默认 ZoneEntry），之后整页 Merge
+  void Accumulate(ZoneEntry* acc, const std::uint8_t* row, size_t len) const;
+  /// 把一个值并入 e（value 指向列宽字节的定长值；null 时只计数）
+  static void AccumulateValue(ZoneEntry* e, Type type, const std::uint8_t* value, bool null);
+  /// 把累加器并入 pid 的摘要（取并集）
+  void Merge(page_id_t pid, const ZoneEntry* acc);
+  /// 以精确摘要替换 pid 的摘要（重建用）
+  void Assign(page_id_t pid, const ZoneEntry* entries);
+
+  // ---------- 查询 ----------
+  /// 拷出 pid 各列的摘要（columns().size() 项）；页未被跟踪返回 false
+  bool     Get(page_id_t pid, ZoneEntry* out) const;
+  uint64_t size() const;            ///< 页号范围上界
+  size_t   TrackedPages() const;
+  size_t   MemoryBytes() const;
+
+  // ---------- 持久化（zone 文件） ----------
+  /// 写入 disk（覆盖原内容并 Sync）；之后修改前须先 Invalidate
+  Status SaveTo(DiskManager* disk);
+  /// 从 disk 载入；头部不匹配（魔数/版本/列）或校验和错误返回 Corruption，原状态不变
+  Status LoadFrom(DiskManager* disk);
+  /**
+   * @brief 若最近一次 SaveTo/LoadFrom 的文件头仍有效，写零头页并 Sync 将其作废（写失败时截断文件）。
+   *        已作废时只读一个原子标记。两种方式都失败时返回错误，文件仍视为有效，下次调用重试。
+   * @note  不要在持有页写闩锁时调用；漏调时修改会在内部补做作废（I/O 落在调用方的闩锁内）
+   */
+  Status Invalidate();
+
+private:
+  struct Stripe;
+
+  Stripe&  StripeOf(page_id_t pid) const;
+  /// 在 st.mu 下返回 pid 的摘要数组（必要时扩展）
+  ZoneEntry* EntriesLocked(Stripe& st, page_id_t pid);
+  /// 在 pid 的条带锁下以其摘要数组执行 fn；磁盘上的文件头仍有效时先经 Invalidate 作废
+  template <class Fn>
+  void   Mutate(page_id_t pid, Fn&& fn);
+  Status InvalidateLocked();  // 需持有 persist_mu_
+  /// 拷出全部摘要并清除各条带的 changed 标记
+  std::vector<ZoneEntry> Snapshot(uint64_t* pages);
+
+private:
+  const Schema*         schema_{nullptr};
+  std::vector<size_t>   columns_;
+  std::vector<Type>     types_;
+  RowCodec              codec_;                // 覆盖列的访问计划
+  std::unique_ptr<Stripe[]> stripes_;
+
+  std::mutex            persist_mu_;           // 串行化 SaveTo / LoadFrom / 作废（修改不持此锁）
+  DiskManager*          disk_{nullptr};        // 最近一次 SaveTo/LoadFrom 的文件
+  std::atomic<bool>     persisted_{false};     // disk_ 上的文件头有效且覆盖内存中的摘要
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_SPACE_ZONE_MAP_H_
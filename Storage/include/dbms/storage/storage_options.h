@@ -15,6 +15,7 @@
 #include <string>
 #include <vector>
 
+#include "dbms/storage/buffer/replacer.h"
 #include "dbms/storage/storage_types.h"
 
 namespace dbms {
@@ -24,23 +25,45 @@ struct StorageOptions {
   // ---- Page & Buffer 基本设置 ----
   uint32_t page_size          = kDefaultPageSize;  // 页大小（字节）
   uint32_t buffer_pool_frames = 256;               // 缓冲帧数量
+  uint32_t buffer_pool_partitions = 1;             // 缓冲池分区数（按页号分片，各分区独立加锁）
+  bool     buffer_pool_hugepages  = false;         // 页池使用透明大页（2 MiB 对齐 + MADV_HUGEPAGE）
+  bool     buffer_pool_hugetlb    = false;         // 先尝试 MAP_HUGETLB 预留大页（不足时退化为透明大页）
+  bool     buffer_pool_numa       = false;         // 各分区的帧内存轮转绑定到 NUMA 节点
+
+  // ---- 后台写回（0 个线程表示关闭；脏页只在淘汰/显式刷盘时写出）----
+  uint32_t bg_writer_threads     = 0;     // 后台写回线程数
+  double   bg_writer_clean_ratio = 0.1;   // 每个分区希望保持干净的帧比例 [0,1]
+  uint32_t bg_writer_interval_ms = 50;    // 检查周期（毫秒）
+
+  // ---- 段文件扩展（fallocate 区段：从 min 起每次翻倍，封顶 max）----
+  uint64_t segment_extent_min_bytes = 1ull << 20;   // 1 MiB
+  uint64_t segment_extent_max_bytes = 64ull << 20;  // 64 MiB
 
   // ---- 替换策略（可插拔，文本约定）----
-  // 示例："clock" / "lruk:k=2"
+  // 示例："clock" / "lru" / "lruk:k=2,crp=1" / "arc"（由 IReplacer::Create 解析）
   std::string replacer = "clock";
 
   // ---- 空闲空间管理（FSM 分桶阈值，单位：字节）----
   std::vector<uint32_t> fsm_bins = {128, 512, 1024, 2048, 4096, 8192};
 
-  // ---- I/O 行为与校验（预留）----
-  bool io_direct       = false;  // 直接 I/O（需要对齐约束）
-  bool enable_checksum = true;   // 是否启用页校验（实现可后置）
+  // ---- I/O 行为与校验 ----
+  std::string io_backend     = "posix";  // 批量/异步页 I/O 后端："posix" / "io_uring"
+  uint32_t    io_queue_depth = 64;       // io_uring 提交队列深度
+  bool io_direct       = false;  // 直接 I/O（O_DIRECT；page_size 须为 kDirectIoAlignment 的整数倍）
+  bool enable_checksum = true;   // 页校验和（CRC-32C，写回时写入、读入时校验；见 BufferPoolManager::SetPageChecksums）
 
   // ---- 合法性检查（轻量）----
   bool Validate() const {
     if (page_size < 1024) return false;              // 粗略下限（避免过小）
     if (buffer_pool_frames == 0) return false;
+    if (buffer_pool_partitions == 0 || buffer_pool_partitions > buffer_pool_frames) return false;
     if (fsm_bins.empty()) return false;
+    if (!IReplacer::Create(replacer, 1)) return false;
+    if (segment_extent_min_bytes < page_size || segment_extent_min_bytes > segment_extent_max_bytes) return false;
+    if (bg_writer_clean_ratio < 0.0 || bg_writer_clean_ratio > 1.0) return false;
+    if (io_backend != "posix" && io_backend != "io_uring") return false;
+    if (io_queue_depth == 0) return false;
+    if (io_direct && page_size % kDirectIoAlignment != 0) return false;  // O_DIRECT 对齐约束
     return true;
   }
 };
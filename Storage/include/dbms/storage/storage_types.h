@@ -39,6 +39,9 @@ struct RID {
 /// 默认页大小：8 KiB（可通过配置覆盖）
 constexpr uint32_t kDefaultPageSize = 8192;
 
+/// 直接 I/O（O_DIRECT）要求的缓冲区地址、文件偏移与长度对齐（取常见逻辑块大小上限）
+constexpr uint32_t kDirectIoAlignment = 4096;
+
 /// 无效占位（用于未初始化/错误返回）
 constexpr page_id_t kInvalidPageId = static_cast<page_id_t>(-1);
 constexpr seg_id_t  kInvalidSegId  = static_cast<seg_id_t>(-1);
@@ -0,0 +1,191 @@
+#ifndef DBMS_STORAGE_TABLE_BATCH_SCAN_H_
+#define DBMS_STORAGE_TABLE_BATCH_SCAN_H_
+
+/**
+ * @file batch_scan.h
+ * @brief 向量化批扫描：每批约 1024 行的列向量 + 选择位图，谓词在定长列上以 SIMD 内核求值。
+ *
+ * 流程：在 ColumnScanner 之上把连续若干页的投影列与谓词列拼成一批（不跨批拆页），
+ * 以存活位图为初始选择位图，逐项求值谓词（合取）后给出选中的行；选择位图为空的批直接跳过。
+ * 谓词列不必出现在投影中。与 ColumnScanner 一样，结果归扫描器所有，在下一次 Next() 前有效。
+ *
+ * 页跳过：表有区间摘要（ZoneMap）时，取页之前先按各页的 min/max 判断谓词能否命中，
+ * 不可能命中的页既不取页也不预读（摘要是保守的，跳过的页一定没有选中行）。
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "dbms/storage/storage_types.h"
+#include "dbms/storage/record/schema.h"
+#include "dbms/storage/table/column_scan.h"
+
+namespace dbms {
+namespace storage {
+
+class TableHeap;
+struct FilterKernels;
+
+enum class CompareOp : uint8_t { kEq, kNe, kLt, kLe, kGt, kGe };
+
+/**
+ * @brief 合取谓词（各项之间为 AND）。
+ *
+ * 列须为 INT32 / INT64 / DATE / DOUBLE；NULL 不满足任何一项（包括 kNe）。
+ * 整数列上的浮点常量按数学含义换算（x > 2.5 即 x >= 3），超出列类型范围的常量同样按数学含义处理。
+ * 用法：Predicate().Compare(5, CompareOp::kGt, 5000.0).In(3, {1, 3, 5});
+ */
+class Predicate {
+public:
+  /// 整数或浮点常量
+  struct Operand {
+    template <class T, std::enable_if_t<std::is_arithmetic_v<T>, int> = 0>
+    Operand(T v)  // NOLINT: 允许隐式转换，便于书写常量
+        : integral(std::is_integral_v<T>), i(static_cast<int64_t>(v)), d(static_cast<double>(v)) {}
+    bool    integral;
+    int64_t i;  ///< integral 时有效
+    double  d;
+  };
+
+  struct Term {
+    enum class Kind : uint8_t { kCompare, kBetween, kIn };
+    Kind                 kind{Kind::kCompare};
+    size_t               column{0};
+    CompareOp            op{CompareOp::kEq};  ///< kCompare
+    Operand              lo{0};               ///< kCompare 的常量 / kBetween 的下界
+    Operand              hi{0};               ///< kBetween 的上界
+    std::vector<int64_t> values;              ///< kIn
+  };
+
+  Predicate& Compare(size_t column, CompareOp op, Operand v);
+  /// lo <= x <= hi
+  Predicate& Between(size_t column, Operand lo, Operand hi);
+  /// x 属于 values（仅整数列）
+  Predicate& In(size_t column, std::vector<int64_t> values);
+
+  bool empty() const noexcept { return terms_.empty(); }
+  const std::vector<Term>& terms() const noexcept { return terms_; }
+
+private:
+  std::vector<Term> terms_;
+};
+
+struct BatchScanOptions {
+  uint32_t    batch_rows = 1024;  ///< 目标批大小；一批在不超过它的前提下容纳整页（单页超出时一页一批）
+  bool        simd       = true;  ///< false 则使用标量内核（对照用）
+  bool        zone_maps  = true;  ///< false 则不按区间摘要跳页（对照用）
+  ScanOptions scan{};
+};
+
+/// 批内一列：定长列为 rows × width 字节，VARCHAR 为 offsets + data（Arrow 风格）
+struct BatchColumn {
+  size_t              column{0};
+  Type                type{Type::INT32};
+  uint32_t            width{0};
+  const std::uint8_t* values{nullptr};   ///< 定长列：第 r 个值位于 values + r * width；VARCHAR 为 nullptr
+  const uint64_t*     nulls{nullptr};    ///< 每行 1 位，置位为 NULL；Schema 未启用 NULL 位图时为 nullptr
+  const uint32_t*     offsets{nullptr};  ///< VARCHAR：rows + 1 项，第 r 个值为 data[offsets[r], offsets[r + 1])
+  const char*         data{nullptr};
+};
+
+struct RecordBatch {
+  uint32_t                 rows{0};             ///< 批内行数（含未选中的行）
+  uint32_t                 selected{0};         ///< 选中行数
+  const uint64_t*          selection{nullptr};  ///< ceil(rows / 64) 个字，第 r 位置位为选中
+  std::vector<BatchColumn> columns;             ///< 与投影列表同序
+
+  bool IsSelected(uint32_t r) const { return (selection[r / 64] >> (r % 64)) & 1; }
+  bool IsNull(size_t k, uint32_t r) const {
+    const uint64_t* n = columns[k].nulls;
+    return n && ((n[r / 64] >> (r % 64)) & 1);
+  }
+  /// 定长列的第 r 个值（T 须与列宽一致，同 ColumnPage::Value）
+  template <class T>
+  T Value(size_t k, uint32_t r) const {
+    T v;
+    std::memcpy(&v, columns[k].values + static_cast<size_t>(r) * sizeof(T), sizeof(T));
+    return v;
+  }
+  /// CHAR 列（去除右侧 '\0' 填充）或 VARCHAR 列的第 r 个值
+  std::string_view String(size_t k, uint32_t r) const;
+
+  /// 按行号升序对每个选中行调用 fn(r)
+  template <class Fn>
+  void ForEachSelected(Fn&& fn) const {
+    for (uint32_t w = 0, words = (rows + 63) / 64; w < words; ++w) {
+      for (uint64_t bits = selection[w]; bits; bits &= bits - 1) {
+        fn(w * 64 + static_cast<uint32_t>(__builtin_ctzll(bits)));
+      }
+    }
+  }
+};
+
+class BatchScanner {
+public:
+  /// 通常经 TableHeap::ScanBatches 创建；列号越界、谓词列类型不支持时 status() 为 InvalidArgument
+  BatchScanner(const TableHeap* table, std::vector<size_t> projection, const Predicate& predicate,
+               const BatchScanOptions& opt = BatchScanOptions{});
+
+  BatchScanner(BatchScanner&&) noexcept = default;
+  BatchScanner& operator=(BatchScanner&&) noexcept = default;
+  BatchScanner(const BatchScanner&) = delete;
+  BatchScanner& operator=(const BatchScanner&) = delete;
+
+  /// 前进到下一个至少有一行选中的批；扫完或出错返回 false（出错时 status() 非 OK）
+  bool Next();
+
+  const RecordBatch& batch()  const noexcept { return batch_; }
+  const Status&      status() const noexcept { return status_; }
+  /// 谓词内核的实现名："avx2" / "neon" / "scalar"
+  const char*        kernel() const noexcept;
+  /// 按区间摘要跳过的页数
+  uint64_t           pages_skipped() const noexcept { return scan_.pages_skipped(); }
+
+private:
+  /// 绑定后的一项：整数列为闭区间 [lo, hi] 或 IN 集合，DOUBLE 列为闭区间 [dlo, dhi]；negate 取补
+  struct BoundTerm {
+    enum class Kind : uint8_t { kRangeI32, kRangeI64, kRangeF64, kInI32, kInI64 };
+    Kind                 kind{Kind::kRangeI32};
+    size_t               slot{0};  ///< 在扫描列中的位置
+    bool                 negate{false};
+    int64_t              lo{0}, hi{0};
+    double               dlo{0}, dhi{0};
+    std::vector<int32_t> set32;
+    std::vector<int64_t> set64;
+  };
+
+  static std::vector<size_t> ScanColumnsFor(std::vector<size_t> projection, const Predicate& predicate);
+  Status Bind(const Predicate& predicate);
+  void   InstallZoneFilter(const TableHeap* table);
+  void   Append(const ColumnPage& page);
+  void   Filter();
+
+private:
+  const Schema*          schema_{nullptr};
+  BatchScanOptions       opt_{};
+  std::vector<size_t>    cols_;        // 扫描列：投影列在前，其后是投影中没有的谓词列
+  size_t                 nproj_{0};
+  ColumnScanner          scan_;
+  std::vector<BoundTerm> terms_;
+  const FilterKernels*   kernels_{nullptr};
+  Status                 status_{};
+  bool                   pending_{false};  // scan_ 当前页已取出但未并入批（放不下，留给下一批）
+  bool                   done_{false};
+
+  // 批缓冲（跨批复用容量）
+  uint32_t                               rows_{0};
+  std::vector<std::vector<std::uint8_t>> values_;
+  std::vector<std::vector<uint64_t>>     nulls_;
+  std::vector<std::vector<uint32_t>>     offsets_;
+  std::vector<std::vector<char>>         data_;
+  std::vector<uint64_t>                  sel_;
+  RecordBatch                            batch_;
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_TABLE_BATCH_SCAN_H_
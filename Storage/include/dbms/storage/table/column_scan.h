@@ -0,0 +1,126 @@
+#ifndef DBMS_STORAGE_TABLE_COLUMN_SCAN_H_
+#define DBMS_STORAGE_TABLE_COLUMN_SCAN_H_
+
+/**
+ * @file column_scan.h
+ * @brief 列投影扫描：逐页给出所选列各自的连续值数组（分析型扫描只读需要的列）。
+ *
+ * 两种页格式都支持：
+ *  - PAX 页：列值在页内本就按列连续，每列一次整块拷贝；
+ *  - 槽位页：按预编译的 RowCodec 从各行固定区收集到列数组（仍避免物化 Tuple）。
+ * 每页在乐观读下拷出、校验通过后立即解固定：结果归扫描器所有，在下一次 Next() 前有效。
+ * 可设置页过滤器（BatchScanner 据区间摘要设置）：被过滤的页既不取页也不预读。
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "dbms/storage/storage_types.h"
+#include "dbms/storage/record/row_codec.h"
+#include "dbms/storage/record/schema.h"
+#include "dbms/storage/table/table_iterator.h"
+
+namespace dbms {
+namespace storage {
+
+class TableHeap;
+
+/// 一列在一页内的值数组
+struct ColumnChunk {
+  size_t              column{0};        ///< Schema 中的列序
+  Type                type{Type::INT32};
+  uint32_t            width{0};         ///< 每个值的字节数（Schema::FixedSizeOf；VARCHAR 为 4）
+  const std::uint8_t* values{nullptr};  ///< rows × width 字节；第 r 个值位于 values + r * width
+  const std::uint8_t* nulls{nullptr};   ///< 每行 1 位，置位为 NULL；Schema 未启用 NULL 位图时为 nullptr
+  const std::uint8_t* var{nullptr};     ///< VARCHAR：values 中 (uint16_t off, uint16_t len) 的 off 相对于此
+};
+
+/**
+ * @brief 一页的投影结果。第 r 行（0 <= r < rows）仅在 IsLive(r) 时有意义
+ *        （槽位页的空槽、PAX 页的已删除行都不是存活行）。
+ */
+struct ColumnPage {
+  page_id_t                page_id{kInvalidPageId};
+  uint32_t                 rows{0};
+  const std::uint8_t*      live{nullptr};  ///< 每行 1 位，置位为存活；尾部多余的位为 0
+  std::vector<ColumnChunk> columns;        ///< 与投影列表同序
+
+  bool IsLive(uint32_t r) const { return (live[r / 8] >> (r % 8)) & 1; }
+  bool IsNull(size_t k, uint32_t r) const {
+    const std::uint8_t* n = columns[k].nulls;
+    return n && ((n[r / 8] >> (r % 8)) & 1);
+  }
+  /// 定长列的第 r 个值（T 须与列宽一致：INT32/DATE→int32_t，INT64→int64_t，FLOAT→float，DOUBLE→double）
+  template <class T>
+  T Value(size_t k, uint32_t r) const {
+    T v;
+    std::memcpy(&v, columns[k].values + static_cast<size_t>(r) * sizeof(T), sizeof(T));
+    return v;
+  }
+  /// CHAR 列（去除右侧 '\0' 填充）或 VARCHAR 列的第 r 个值
+  std::string_view String(size_t k, uint32_t r) const;
+};
+
+class ColumnScanner {
+public:
+  /// 页过滤器：返回 false 的页被跳过
+  using PageFilter = std::function<bool(page_id_t)>;
+
+  /// 通常经 TableHeap::ScanColumns 创建；列号越界或表没有 Schema 时 status() 为 InvalidArgument
+  ColumnScanner(const TableHeap* table, std::vector<size_t> columns,
+                const ScanOptions& opt = ScanOptions{});
+
+  ColumnScanner(ColumnScanner&&) noexcept = default;
+  ColumnScanner& operator=(ColumnScanner&&) noexcept = default;
+  ColumnScanner(const ColumnScanner&) = delete;
+  ColumnScanner& operator=(const ColumnScanner&) = delete;
+
+  /// 前进到下一张非空页；扫完或出错返回 false（出错时 status() 非 OK）
+  bool Next();
+
+  const ColumnPage& page()   const noexcept { return page_; }
+  const Status&     status() const noexcept { return status_; }
+
+  /// 设置页过滤器（应在第一次 Next() 之前；为空则不过滤）。过滤器可能对同一页调用多次
+  void     SetPageFilter(PageFilter keep) { keep_ = std::move(keep); }
+  /// 被页过滤器跳过的页数
+  uint64_t pages_skipped() const noexcept { return pages_skipped_; }
+
+private:
+  Status LoadPage(page_id_t pid, bool* out_empty);
+  void   CopySlotted(const std::uint8_t* data, Status* st);
+  void   CopyPax(const std::uint8_t* data, Status* st);
+  void   Prefetch(page_id_t pid);
+
+private:
+  const TableHeap*  table_{nullptr};
+  const Schema*     schema_{nullptr};
+  std::vector<size_t> cols_;
+  RowCodec          codec_;  // 槽位页：所选列的偏移 / 宽度 / NULL 位
+  ScanOptions       opt_{};
+  Status            status_{};
+  PageFilter        keep_;
+  uint64_t          pages_skipped_{0};
+
+  page_id_t         next_pid_{0};
+  uint64_t          page_count_{0};
+  page_id_t         prefetched_until_{0};
+
+  // 每列的拷贝缓冲（跨页复用容量）
+  std::vector<std::vector<std::uint8_t>> values_;
+  std::vector<std::vector<std::uint8_t>> nulls_;
+  std::vector<std::vector<std::uint8_t>> var_;
+  std::vector<std::uint8_t>              live_;
+  struct MinipageOff { uint32_t values, nulls; };
+  std::vector<MinipageOff>               col_off_;  // PAX：当前页各列小页偏移
+  ColumnPage                             page_;
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_TABLE_COLUMN_SCAN_H_
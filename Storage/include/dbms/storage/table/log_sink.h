@@ -0,0 +1,46 @@
+#ifndef DBMS_STORAGE_TABLE_LOG_SINK_H_
+#define DBMS_STORAGE_TABLE_LOG_SINK_H_
+
+/**
+ * @file log_sink.h
+ * @brief 表堆页修改的日志接口：由恢复模块（WAL）实现，经 TableHeap::SetLogSink 挂接。
+ *
+ * 约定：
+ *  - TableHeap 在持有页写闩锁、页内修改已完成时调用 LogPage，并把返回的 LSN 写入该页的
+ *    PageHeader::page_lsn；因此页写回时看到的 page_lsn 覆盖了页上的所有修改；
+ *  - 配合 BufferPoolManager::RegisterFlushCallback（写页前把日志刷到 page_lsn），页不会先于其日志落盘；
+ *  - LogPage 在页闩锁内执行，实现须尽快返回（只预留并拷贝，不等待写盘）。
+ */
+
+#include <cstdint>
+
+#include "dbms/storage/storage_types.h"
+
+namespace dbms {
+namespace storage {
+
+/// 页修改的种类（数值是日志格式的一部分）
+enum class PageLogOp : uint8_t {
+  kPageInit  = 1,  ///< 新页按表格式初始化（无负载）
+  kInsert    = 2,  ///< 负载为插入的行（行格式）
+  kUpdate    = 3,  ///< 原地更新，负载为新行
+  kErase     = 4,  ///< 删除槽位（无负载）
+  kPageImage = 5,  ///< 整页映像（追加器封页时），负载为 page_size 字节
+};
+
+class ILogSink {
+public:
+  virtual ~ILogSink() = default;
+
+  /**
+   * @brief 记录一次页修改的重做信息。
+   * @return 该记录的 LSN（> 0，随调用顺序单调递增）；日志已不可写时返回 0（之后的提交会报错）
+   */
+  virtual uint64_t LogPage(PageLogOp op, seg_id_t seg, page_id_t pid, uint16_t slot,
+                           const std::uint8_t* data, uint32_t len) = 0;
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_TABLE_LOG_SINK_H_
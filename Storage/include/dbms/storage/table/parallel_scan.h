@@ -0,0 +1,79 @@
+#ifndef DBMS_STORAGE_TABLE_PARALLEL_SCAN_H_
+#define DBMS_STORAGE_TABLE_PARALLEL_SCAN_H_
+
+/**
+ * @file parallel_scan.h
+ * @brief 按 morsel 并行的全表扫描。
+ *
+ * 做法：
+ *  - 开始时按段页数快照把 [0, PageCount) 切成 morsel_pages 页一个的 morsel（扫描期间追加的页不在其内）；
+ *  - 每个工作线程先领一段连续的 morsel，从前端逐个取；取空后从剩余最多的线程尾端窃取一半；
+ *  - 每个 morsel 在线程内用有界的 TableIterator / BatchScanner 扫描（ScanOptions 的页区间），
+ *    领到时先对其首部几页发起预读（ForEachBatch 可按区间摘要跳页时不做，由批扫描只预读保留的页）。
+ * 调用线程本身也是 0 号工作线程；回调在各工作线程上并发执行，结果的合并由调用方负责
+ * （按 worker 下标分开累计即可免锁）。
+ */
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "dbms/storage/storage_types.h"
+#include "dbms/storage/table/batch_scan.h"
+#include "dbms/storage/table/table_iterator.h"
+
+namespace dbms {
+namespace storage {
+
+class TableHeap;
+
+struct ParallelScanOptions {
+  uint32_t    threads      = 0;   ///< 工作线程数（0 取 hardware_concurrency；不超过 morsel 数）
+  uint32_t    morsel_pages = 64;  ///< 每个 morsel 的页数
+  ScanOptions scan{};             ///< morsel 内的预读与环形缓冲策略（页区间由驱动设置）
+};
+
+struct ParallelScanStats {
+  uint32_t threads{0};  ///< 实际参与的工作线程数
+  uint64_t morsels{0};  ///< 处理的 morsel 数
+  uint64_t stolen{0};   ///< 其中经窃取得到的 morsel 数
+  uint64_t pages_skipped{0};  ///< ForEachBatch：按区间摘要跳过的页数
+};
+
+class ParallelScanner {
+public:
+  /// 处理一个 morsel 的页区间 [first, end)；返回非 OK 时所有线程在各自的当前 morsel 后停止
+  using MorselFn = std::function<Status(uint32_t worker, page_id_t first, page_id_t end)>;
+  /// 每条记录一次；it 指向当前记录（view() / ViewValid() / operator* 的约定同 TableIterator）
+  using RowFn    = std::function<void(uint32_t worker, const TableIterator& it)>;
+  /// 每个至少有一行选中的批一次
+  using BatchFn  = std::function<void(uint32_t worker, const RecordBatch& batch)>;
+
+  /// 通常经 TableHeap::ParallelScan 创建
+  explicit ParallelScanner(const TableHeap* table, const ParallelScanOptions& opt = ParallelScanOptions{});
+
+  Status ForEachMorsel(const MorselFn& fn);
+  Status ForEachRow(const RowFn& fn);
+  /// bopt.scan 不使用：取页策略取自 ParallelScanOptions::scan
+  Status ForEachBatch(std::vector<size_t> projection, const Predicate& predicate,
+                      const BatchScanOptions& bopt, const BatchFn& fn);
+
+  /// 本次扫描将使用的工作线程数（按当前页数估算）
+  uint32_t                 threads() const;
+  /// 最近一次 ForEach* 的统计
+  const ParallelScanStats& stats()   const noexcept { return stats_; }
+
+private:
+  /// prefetch：领到 morsel 时是否先预读其首部几页
+  Status RunMorsels(const MorselFn& fn, bool prefetch);
+
+private:
+  const TableHeap*    table_{nullptr};
+  ParallelScanOptions opt_{};
+  ParallelScanStats   stats_{};
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_TABLE_PARALLEL_SCAN_H_
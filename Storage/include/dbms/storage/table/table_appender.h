@@ -0,0 +1,82 @@
+#ifndef DBMS_STORAGE_TABLE_TABLE_APPENDER_H_
+#define DBMS_STORAGE_TABLE_TABLE_APPENDER_H_
+
+/**
+ * @file table_appender.h
+ * @brief 堆表批量追加器：初始装载时绕过 FSM，直接把记录顺序填入新页。
+ *
+ * 与 TableHeap::Insert 的区别：
+ *  - 不查询 FSM：始终写入自己持有的“当前页”，该页在写满前一直保持固定；
+ *  - 新页按区段（extent_pages 个连续页）一次性向 SegmentManager 申请并预留磁盘块，
+ *    经 BufferPoolManager::NewPageAt 直接得到置零帧，不读盘；
+ *  - 每页只在封页（写满或 Finish）时向 FSM 上报一次剩余空间，区间摘要也在页内累加、封页时并入一次。
+ *
+ * 约束：
+ *  - 追加器独占它申请到的页；未用完的预留页在 Finish 时归还给段的空闲栈；
+ *  - 非线程安全：每个装载线程各持有一个追加器（它们彼此写入不同的页）；
+ *  - 追加得到的记录在封页前对 FSM 不可见，但对扫描可见（与普通插入一致）；
+ *  - 当前页在封页前一直持有写闩锁（WritePageGuard）：其他线程读该页会等到封页；
+ *    同一线程在 Finish 之前不要读取自己正在填充的页，否则会自锁。
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "dbms/storage/storage_types.h"
+#include "dbms/storage/buffer/page_guard.h"
+#include "dbms/storage/record/tuple.h"
+#include "dbms/storage/space/zone_map.h"
+
+namespace dbms {
+namespace storage {
+
+class TableHeap;
+
+class TableAppender {
+public:
+  static constexpr uint32_t kDefaultExtentPages = 64;
+
+  explicit TableAppender(TableHeap* table, uint32_t extent_pages = kDefaultExtentPages);
+  ~TableAppender();  // 隐式 Finish()
+
+  TableAppender(const TableAppender&) = delete;
+  TableAppender& operator=(const TableAppender&) = delete;
+
+  /// 追加一条记录；out 可为空
+  Status Append(const Tuple& t, RID* out = nullptr);
+  Status Append(const std::uint8_t* rec, uint16_t len, RID* out = nullptr);
+  /// 由构造器直接把行写入当前页（槽位页不经中间 Tuple）；tb 须已设置所有列
+  Status Append(const TupleBuilder& tb, RID* out = nullptr);
+
+  /// 封存当前页并归还未用的预留页（幂等）；之后仍可继续 Append
+  Status Finish();
+
+  uint64_t rows()  const noexcept { return rows_; }
+  uint64_t pages() const noexcept { return pages_; }  ///< 已开启的页数
+
+private:
+  Status OpenPage();   // 取下一张预留页（必要时申请新区段）并初始化
+  void   SealPage();   // 上报 FSM 与区间摘要，放开写闩锁并解固定当前页
+  template <class InsertFn>
+  Status AppendWith(InsertFn&& insert, RID* out);  // insert(page, &slot)；当前页放不下时换页重试一次
+
+private:
+  TableHeap*     table_{nullptr};
+  uint32_t       extent_pages_{kDefaultExtentPages};
+
+  page_id_t      pid_{kInvalidPageId};  // 当前固定（并写闩锁）的页
+  WritePageGuard page_;
+
+  std::vector<ZoneEntry> zone_acc_;     // 当前页的区间摘要累加器（表有摘要时）
+
+  page_id_t      next_{0};              // 预留区段内下一张可用页
+  page_id_t      limit_{0};             // 预留区段上界（不含）
+
+  uint64_t       rows_{0};
+  uint64_t       pages_{0};
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_TABLE_TABLE_APPENDER_H_
@@ -8,22 +8,54 @@
  * 约定：
  *  - 一个表对应一个段（seg_id_t），由 SegmentManager 分配/回收页；
  *  - 记录以 SlottedPage 写入页内，RID=(page_id, slot)；
- *  - 每次页内变更后，用 FSM.Update(pid, free_size) 维护空闲空间信息。
+ *  - 每次页内变更后，用 FSM.Update(pid, 连续空闲 + 可回收碎片) 维护空闲空间信息；
+ *  - 初始装载用 BulkInsert / TableAppender：顺序填充新页，每页只在封页时更新一次 FSM。
+ *
+ * 页格式（建表时选定）：
+ *  - kSlotted：槽位页，整行连续存放（默认，适合 OLTP 点查/更新）；
+ *  - kPax    ：PAX 页，页内各列定长值分组连续存放（需要 Schema），适合只读少数列的分析扫描，
+ *              配合 ScanColumns 使用；只追加，删除不回收空间。
+ * 两种格式对外接口相同：Insert/Get/Update/Erase 与 TableIterator 进出的都是行格式 Tuple。
+ *
+ * 区间摘要：有 Schema 的表为各数值列维护每页的 min/max/NULL 数（ZoneMap），插入/更新在持有页写闩锁时
+ * 并入新行；ScanBatches 据此跳过谓词不可能命中的页。Checkpoint 时写入 seg_<id>.zone，
+ * 启动时经 RecoverZoneMap 载入（缺失或失效则从页内容重建）。
+ *
+ * 日志：SetLogSink 挂接 WAL 后，Insert/Update/Erase 在持有页写闩锁时记录重做信息并把 LSN 写入页的
+ * page_lsn；追加器（BulkInsert / TableAppender）在封页时记录整页映像，封页之前追加的行不在日志中。
+ *
+ * 冷表：Freeze 把整段压缩为冷段（见 SegmentManager::FreezeSegment），之后只读：读取与扫描照常，
+ * Insert/Update/Erase/BulkInsert 返回 InvalidArgument，直到 Thaw。各写操作在 SegmentManager::WriteScope
+ * 内修改页：Freeze 先置只读并等这些写入结束，再只写回本段的脏页，然后压缩。
  */
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "dbms/storage/storage_types.h"
 #include "dbms/storage/record/tuple.h"
+#include "dbms/storage/record/tuple_arena.h"
 #include "dbms/storage/buffer/buffer_pool_manager.h"
 #include "dbms/storage/space/free_space_manager.h"
+#include "dbms/storage/space/zone_map.h"
 #include "dbms/storage/segment/segment_manager.h"
+#include "dbms/storage/table/table_iterator.h"
+#include "dbms/storage/table/table_appender.h"
+#include "dbms/storage/table/column_scan.h"
+#include "dbms/storage/table/batch_scan.h"
+#include "dbms/storage/table/parallel_scan.h"
+#include "dbms/storage/table/log_sink.h"
 
 namespace dbms {
 namespace storage {
 
-class TableIterator;  // 前置
+/// 表的页格式
+enum class TableFormat : uint8_t {
+  kSlotted,  ///< 槽位页（行存）
+  kPax,      ///< 页内按列分组（PAX）
+};
 
 class TableHeap {
 public:
@@ -34,6 +66,19 @@ public:
             SegmentManager* sm)
       : seg_id_(seg_id), page_size_(page_size), bpm_(bpm), fsm_(fsm), sm_(sm) {}
 
+  /**
+   * @brief 带 Schema 的表：可选 PAX 页格式，并支持 ScanColumns。
+   * @param schema 须比表活得久；为空时 format 退化为 kSlotted
+   * @note  同一段必须始终以同一格式打开（页内不记录格式之外的 Schema 信息）。
+   */
+  TableHeap(seg_id_t seg_id,
+            uint32_t page_size,
+            BufferPoolManager* bpm,
+            FreeSpaceManager* fsm,
+            SegmentManager* sm,
+            const Schema* schema,
+            TableFormat format = TableFormat::kSlotted);
+
   TableHeap(const TableHeap&) = delete;
   TableHeap& operator=(const TableHeap&) = delete;
 
@@ -41,27 +86,107 @@ public:
   Status Insert(const Tuple& t, RID* out);
   Status Update(const RID& rid, const Tuple& t);
   Status Erase (const RID& rid);
-  Status Get   (const RID& rid, Tuple* out) const;
+  Status Get   (const RID& rid, Tuple* out) const;  ///< 复用 out 已有的缓冲
+  /// 把记录拷入 arena，out 指向该拷贝（随 arena 的 Reset 一起失效）
+  Status Get   (const RID& rid, TupleArena* arena, TupleView* out) const;
+
+  /**
+   * @brief 批量追加 n 条记录（经 TableAppender，不走 FSM 查找）。
+   * @param out_rids 可选：按输入顺序追加各记录的 RID
+   * @note  中途失败时已追加的记录保留，out_rids 中为已成功的前缀。
+   */
+  Status BulkInsert(const Tuple* rows, size_t n, std::vector<RID>* out_rids = nullptr);
+
+  // ---- 空闲空间持久化 ----
+  /// 把本表的 FSM 与段元数据写到磁盘（可在装载/运行期间周期性调用）
+  Status Checkpoint();
+
+  /**
+   * @brief 启动时恢复 FSM：优先载入 FSM 分叉并补探检查点之后追加的页；
+   *        分叉缺失或校验失败时并行全量重建。
+   * @param out_loaded 可选：true 表示来自检查点（否则为全量重建）
+   */
+  Status RecoverSpace(bool* out_loaded = nullptr);
+
+  /**
+   * @brief 启动时恢复区间摘要：优先载入 zone 文件并从页内容补齐之后追加的页；
+   *        文件缺失或已失效（检查点之后有过修改）时按 morsel 并行扫描整表重建。没有摘要的表直接返回 OK。
+   * @param out_loaded 可选：true 表示来自检查点（否则为全量重建）
+   */
+  Status RecoverZoneMap(bool* out_loaded = nullptr);
+
+  // ---- 日志 ----
+  /// 挂接页修改日志（nullptr 为关闭）；须在并发修改开始前设置，sink 须比表活得久
+  void       SetLogSink(ILogSink* sink) noexcept { log_ = sink; }
+  ILogSink*  log_sink() const noexcept { return log_; }
+
+  // ---- 冷段 ----
+  /// 置只读、写回本段脏页后把本表的段冻结为压缩的冷段（PAX 页按列编码）；之后表只读。
+  /// 写回不等待页的使用者：本段有被固定的脏页（如未 Finish 的追加器持有的当前页）、
+  /// 被写闩锁占用的页或写回失败时撤销只读并返回错误（多为 Unavailable），不冻结
+  Status Freeze();
+  /// 解冻：各页解压写回段文件，表恢复可写
+  Status Thaw();
+  bool   IsCold() const { return sm_->IsCold(seg_id_); }
 
   // ---- 扫描 ----
-  TableIterator Begin() const;
+  TableIterator Begin(const ScanOptions& opt = ScanOptions{}) const;
   TableIterator End()   const;
 
+  /// 列投影扫描：逐页返回 columns 所列各列的连续值数组（需要 Schema）
+  ColumnScanner ScanColumns(std::vector<size_t> columns, const ScanOptions& opt = ScanOptions{}) const;
+
+  /// 向量化批扫描：约 batch_rows 行一批，predicate 以 SIMD 内核求值为选择位图（需要 Schema）
+  BatchScanner  ScanBatches(std::vector<size_t> projection, const Predicate& predicate = Predicate{},
+                            const BatchScanOptions& opt = BatchScanOptions{}) const;
+
+  /// 按 morsel 并行扫描（工作线程在 ForEach* 调用期间存在）
+  ParallelScanner ParallelScan(const ParallelScanOptions& opt = ParallelScanOptions{}) const;
+
   // ---- 访问器 ----
-  seg_id_t  segment_id() const noexcept { return seg_id_; }
-  uint32_t  page_size()  const noexcept { return page_size_; }
+  seg_id_t      segment_id() const noexcept { return seg_id_; }
+  uint32_t      page_size()  const noexcept { return page_size_; }
+  TableFormat   format()     const noexcept { return format_; }
+  const Schema* schema()     const noexcept { return schema_; }
+  /// 区间摘要；没有 Schema 或没有数值列时为 nullptr
+  const ZoneMap* zone_map()  const noexcept { return zones_.get(); }
 
 private:
   void UpdateFsmForPage(page_id_t pid, std::uint8_t* page);
 
+  // ---- 按页格式分派的页内操作 ----
+  void     InitPage(std::uint8_t* page, page_id_t pid) const;
+  uint16_t SpaceNeeded(const std::uint8_t* rec, uint16_t len) const;  // FSM 查找用的需求量
+  Status   PageInsert(std::uint8_t* page, const std::uint8_t* rec, uint16_t len, uint16_t* slot) const;
+  /// 由构造器直接生成记录：槽位页写入页内分配的空间，PAX 页经线程内的拼行缓冲；
+  /// row 可选：成功时指向生成的行（供区间摘要记入，下一次插入前有效）
+  Status   PageInsert(std::uint8_t* page, const TupleBuilder& tb, uint16_t len, uint16_t* slot,
+                      const std::uint8_t** row = nullptr) const;
+  Status   PageUpdate(std::uint8_t* page, uint16_t slot, const std::uint8_t* rec, uint16_t len) const;
+  Status   PageErase (std::uint8_t* page, uint16_t slot) const;
+  /// 拷出一条记录（行格式）；乐观读下可能在撕裂的页上调用，须保证不越界
+  Status   PageGet   (const std::uint8_t* page, uint16_t slot, std::vector<std::uint8_t>* out) const;
+  void     NoteSealedPage(const std::uint8_t* page);  // PAX：以封页的实际变长用量修正容量估计
+  /// 挂接了日志时记录一次页修改并把 LSN 写入 page_lsn（调用方持有该页写闩锁）
+  void     LogPage(std::uint8_t* page, PageLogOp op, page_id_t pid, uint16_t slot,
+                   const std::uint8_t* data = nullptr, uint32_t len = 0) const;
+
 private:
   seg_id_t            seg_id_{kInvalidSegId};
   uint32_t            page_size_{0};
   BufferPoolManager*  bpm_{nullptr};
   FreeSpaceManager*   fsm_{nullptr};
   SegmentManager*     sm_{nullptr};
+  const Schema*       schema_{nullptr};
+  TableFormat         format_{TableFormat::kSlotted};
+  std::atomic<uint32_t> pax_var_estimate_{0};  // PAX 新页按它决定行容量（每行平均变长字节）
+  std::unique_ptr<ZoneMap> zones_;              // 区间摘要（有数值列的 Schema 才有）
+  ILogSink*           log_{nullptr};            // 页修改日志（WAL），未挂接时为空
 
   friend class TableIterator;  // 迭代器访问 bpm_/sm_/page_size_/seg_id_
+  friend class TableAppender;  // 追加器直接申请/填充页
+  friend class ColumnScanner;  // 列扫描直接读页
+  friend class ParallelScanner;  // 并行扫描按段页数切分 morsel 并预读
 };
 
 }  // namespace storage
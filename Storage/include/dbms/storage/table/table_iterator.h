@@ -6,19 +6,40 @@
  * @brief 堆表顺序扫描迭代器：跨页/跨槽位，自动跳过 tombstone。
  *
  * 资源策略：
- *  - operator* 返回“值类型快照”（Tuple 拷贝），不依赖页 pin 的生命周期。
+ *  - 逐页扫描：每页只固定一次，在页内按槽位顺序推进；迭代器离开该页（或析构）时才解固定；
+ *  - 页经 ReadPageGuard 乐观读：不加页闩锁，槽目录的遍历在读后以页版本号校验，失败即重读；
+ *  - view() 返回指向被固定页内记录的 TupleView（零拷贝），迭代器前进到下一页后失效；
+ *    页可能被并发修改，使用完视图后可用 ViewValid() 确认其间没有写者；
+ *  - operator* 返回“值类型快照”（Tuple 拷贝，按需物化，校验版本后才返回），不依赖页 pin 的生命周期；
+ *  - 检测到顺序访问（连续两页相邻）后，按 ScanOptions::prefetch_pages 维持一个预读窗口，
+ *    经 BufferPoolManager::Prefetch 异步读入后续页；
+ *  - 默认以 AccessMode::kBulkRead 访问，扫描页只占用缓冲池的小环形缓冲，不冲刷热点页。
+ *
+ * 复制迭代器会再固定一次当前页；移动则转移该固定。
  */
 
 #include <cstdint>
+#include <vector>
 
 #include "dbms/storage/storage_types.h"
+#include "dbms/storage/buffer/page_guard.h"
 #include "dbms/storage/record/tuple.h"
+#include "dbms/storage/record/tuple_arena.h"
 
 namespace dbms {
 namespace storage {
 
 class TableHeap;
 
+/// 扫描选项
+struct ScanOptions {
+  uint32_t prefetch_pages = 8;     ///< 预读窗口（页数；0 关闭预读）
+  bool     bulk_read      = true;  ///< 扫描页进入环形缓冲（false 则与普通访问一样进入替换器）
+  /// 只扫描 [first_page, end_page)；end_page 为 kInvalidPageId 时扫到段末尾（含扫描期间追加的页）
+  page_id_t first_page    = 0;
+  page_id_t end_page      = kInvalidPageId;
+};
+
 class TableIterator {
 public:
   struct Row {
@@ -26,33 +47,70 @@ public:
     Tuple tuple;
   };
 
-  TableIterator() : table_(nullptr), pid_(0), slot_(0), end_(true) {}
-  explicit TableIterator(const TableHeap* table);
+  TableIterator() = default;
+  explicit TableIterator(const TableHeap* table, const ScanOptions& opt = ScanOptions{});
+  ~TableIterator();
+
+  TableIterator(const TableIterator& other);
+  TableIterator& operator=(const TableIterator& other);
+  TableIterator(TableIterator&& other) noexcept;
+  TableIterator& operator=(TableIterator&& other) noexcept;
 
   bool IsEnd() const noexcept { return end_; }
+  /// 扫描因数据损坏（页校验和不匹配）提前结束时为 Corruption，否则为 OK
+  const Status& status() const noexcept { return status_; }
+
+  /// 当前记录的 RID 与视图（离开当前页后视图失效；槽位页为零拷贝，PAX 页指向迭代器内的拼行缓冲）
+  const RID&       rid()  const noexcept { return rid_; }
+  const TupleView& view() const noexcept { return view_; }
+  /// 自定位 view() 以来当前页没有被修改过（读完视图后调用；false 时应改用 operator*）
+  bool ViewValid() const { return page_.Valid() && (view_copied_ || page_.Validate(view_version_)); }
 
-  const Row& operator*()  const { return current_; }
-  const Row* operator->() const { return &current_; }
+  /// 兼容接口：物化当前记录的拷贝（同一记录只拷贝一次）
+  const Row& operator*()  const;
+  const Row* operator->() const { return &**this; }
+
+  /// 把当前记录拷入 arena（不产生逐行的堆分配）；拷贝期间页被改过则按 RID 重读，记录已删除返回 NotFound
+  Status CopyTo(TupleArena* arena, TupleView* out) const;
 
   TableIterator& operator++();
 
   bool operator==(const TableIterator& rhs) const {
     if (end_ && rhs.end_) return true;
-    return table_ == rhs.table_ && pid_ == rhs.pid_ && slot_ == rhs.slot_ && end_ == rhs.end_;
+    return table_ == rhs.table_ && rid_.page_id == rhs.rid_.page_id &&
+           rid_.slot == rhs.rid_.slot && end_ == rhs.end_;
   }
   bool operator!=(const TableIterator& rhs) const { return !(*this == rhs); }
 
 private:
-  void SeekFirst();                       // 定位到第一个有效记录
-  bool LoadAt(page_id_t pid, uint16_t slot);  // 读取 (pid,slot)，填充 current_
-  bool AdvanceOne();                      // 向下一个有效记录推进
+  Status PinPage(page_id_t pid);          // 解固定旧页并固定 pid
+  void   ReleasePage();                   // 解固定当前页（幂等）
+  bool   SeekFrom(page_id_t pid, uint32_t slot);  // 从 (pid, slot) 起找下一个有效记录
+  Status FetchForScan(page_id_t pid, ReadPageGuard* page);  // 按扫描策略取页，并推进预读窗口
+  void   OnPageAccess(page_id_t pid);     // 顺序检测 + 预读
+  bool   PastEnd(page_id_t pid);          // pid 超出扫描范围（必要时刷新页数快照）
 
 private:
   const TableHeap* table_{nullptr};
-  page_id_t  pid_{0};
-  uint16_t   slot_{0};
-  bool       end_{true};
-  Row        current_{};
+  bool          end_{true};
+  Status        status_{};
+  RID           rid_{};
+  TupleView     view_{};
+
+  // 当前固定的页（乐观读）与 view_ 定位时的页版本号
+  ReadPageGuard page_;
+  uint64_t      view_version_{0};
+  bool          view_copied_{false};      // view_ 指向 row_buf_（PAX 页拼出的行）
+  std::vector<std::uint8_t> row_buf_;
+  uint64_t      page_count_{0};           // 段页数快照（扫到末尾时刷新一次，容纳扫描期间的追加）
+
+  mutable Row   current_{};
+  mutable bool  materialized_{false};
+
+  ScanOptions opt_{};
+  page_id_t  last_pid_{kInvalidPageId};   // 上一次访问的页（顺序检测）
+  uint32_t   seq_run_{0};                 // 连续相邻页的访问次数
+  page_id_t  prefetched_until_{0};        // 已发起预读的上界（不含）
 };
 
 }  // namespace storage
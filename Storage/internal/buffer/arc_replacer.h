@@ -0,0 +1,94 @@
+#ifndef DBMS_STORAGE_INTERNAL_BUFFER_ARC_REPLACER_H_
+#define DBMS_STORAGE_INTERNAL_BUFFER_ARC_REPLACER_H_
+
+/**
+ * @file arc_replacer.h
+ * @brief ARC（Adaptive Replacement Cache，Megiddo & Modha）：在“近期性”与“频率”之间自适应。
+ *
+ * 结构（c = 帧数）：
+ *  - T1：只被访问过一次的驻留帧；T2：至少访问过两次的驻留帧（均为按访问先后排列的侵入式双向链表）；
+ *  - B1/B2：从 T1/T2 淘汰的页的“幽灵”（只记 PageKey，不占帧），|T1|+|B1| <= c，总数 <= 2c；
+ *  - p：T1 的目标大小。新装入的页命中 B1（说明 T1 太小）时增大 p，命中 B2 时减小 p；
+ *    Victim 在 |T1| > p 时从 T1 的最久未用端淘汰，否则从 T2 淘汰。
+ *
+ * 与 IReplacer 的映射：
+ *  - RecordLoad(fid, key)：帧装入新页，据 key 是否在幽灵表中决定进入 T1 还是 T2 并调整 p；
+ *  - RecordAccess(fid)：命中，移到 T2 的最近端；
+ *  - Pin/Unpin 只改变帧能否被淘汰，不改变其在链表中的位置；Victim 从链表尾跳过被固定的帧。
+ *
+ * 线程安全：内部互斥锁保护（BPM 已在分区锁内调用，此锁无竞争）。
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "dbms/storage/buffer/replacer.h"
+
+namespace dbms {
+namespace storage {
+
+class ArcReplacer final : public IReplacer {
+public:
+  explicit ArcReplacer(int capacity);
+
+  void Pin(frame_id_t fid) override;
+  void Unpin(frame_id_t fid) override;
+  void RecordAccess(frame_id_t fid) override;
+  void RecordLoad(frame_id_t fid, uint64_t page_key) override;
+  bool Victim(frame_id_t* out) override;
+  int  Size() const override;
+  uint64_t ScanSteps() const override { return scan_steps_.load(std::memory_order_relaxed); }
+  void     Hotness(std::vector<uint64_t>* out) const override;
+
+  int  target_t1() const;  ///< 当前的 p（观测用）
+
+private:
+  enum class List : uint8_t { kNone, kT1, kT2 };
+  static constexpr uint64_t kNoKey = ~uint64_t{0};
+
+  struct Node {
+    int      prev{-1};
+    int      next{-1};
+    List     list{List::kNone};
+    bool     evictable{false};
+    uint64_t key{kNoKey};  // 帧中页的 PageKey（未经 RecordLoad 的帧为 kNoKey，淘汰时不留幽灵）
+  };
+  struct Lru {
+    int head{-1};  // 最近端
+    int tail{-1};  // 最久未用端
+    int size{0};
+  };
+  struct Ghosts {
+    std::list<uint64_t> order;  // 前端为最近淘汰
+    std::unordered_map<uint64_t, std::list<uint64_t>::iterator> index;
+    int size() const { return static_cast<int>(index.size()); }
+  };
+
+  Lru& ListOf(List l) { return l == List::kT1 ? t1_ : t2_; }
+  void Link(List l, frame_id_t fid);   // 插到链表最近端
+  void Unlink(frame_id_t fid);
+  bool EvictFrom(List l, frame_id_t* out);
+  void PushGhost(Ghosts& g, uint64_t key);
+  bool EraseGhost(Ghosts& g, uint64_t key);
+  void PopGhost(Ghosts& g);
+  void TrimGhosts();
+
+private:
+  std::vector<Node> nodes_;
+  Lru    t1_, t2_;
+  Ghosts b1_, b2_;
+  int    p_{0};
+  int    cap_{0};
+  int    evictable_{0};  // T1/T2 中可淘汰的帧数
+  std::atomic<uint64_t> scan_steps_{0};  // 累计走过的链表节点数（跳过被固定的帧）
+  mutable std::mutex mu_;
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_INTERNAL_BUFFER_ARC_REPLACER_H_
@@ -6,11 +6,22 @@
  * @brief CLOCK 策略：维护一圈“可替换帧”，用引用位决定是否跳过。
  *
  * 约定：
- *  - Pin(fid)：从候选集中移出，并清除引用位；
+ *  - Pin(fid)：从候选集中移出；
  *  - Unpin(fid)：加入候选集，设置引用位=1；
+ *  - RecordAccess(fid)：设置引用位=1（一次 relaxed store）；
  *  - Victim(out)：顺时针扫描，遇到引用位=0 的候选帧即选择之；扫描时将 1→0。
+ *
+ * 无锁实现（自身线程安全，不依赖 BPM 的分区锁）：
+ *  - 候选位按 64 帧一组打包在原子字中：Pin/Unpin 各一次 fetch_and/fetch_or，
+ *    据旧值精确维护候选计数，Size() 为 O(1)；Victim 按字跳过整组被固定的帧；
+ *  - 引用位每帧 1 字节：置位/清零都是一次 relaxed store，热点页的访问不会争用同一个字；
+ *  - 时钟指针为单调递增的 64 位计数（取模得到位置），以 CAS 推进：
+ *    每个线程独占自己推进过的那段位置，摘除候选以 fetch_and 的旧值判定胜者，并发 Victim 不会选中同一帧。
  */
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "dbms/storage/buffer/replacer.h"
@@ -24,14 +35,21 @@ public:
 
   void Pin(frame_id_t fid) override;
   void Unpin(frame_id_t fid) override;
+  void RecordAccess(frame_id_t fid) override;
   bool Victim(frame_id_t* out) override;
   int  Size() const override;
+  uint64_t ScanSteps() const override { return scan_steps_.load(std::memory_order_relaxed); }
+  void     Hotness(std::vector<uint64_t>* out) const override;
 
 private:
-  std::vector<char> present_;   // 是否在候选集
-  std::vector<char> ref_;       // 引用位
-  int               hand_{0};   // 时钟指针
-  int               cap_{0};
+  static constexpr int kWordBits = 64;
+
+  std::unique_ptr<std::atomic<uint64_t>[]> present_;  // 候选位（每字 64 帧）
+  std::unique_ptr<std::atomic<uint8_t>[]>  ref_;      // 引用位（每帧 1 字节）
+  std::atomic<uint64_t> hand_{0};  // 时钟指针（单调递增，取模 cap_）
+  std::atomic<int>      size_{0};  // 候选帧数
+  std::atomic<uint64_t> scan_steps_{0};  // 累计扫过的位置数
+  int                   cap_{0};
 };
 
 }  // namespace storage
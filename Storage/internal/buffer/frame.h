@@ -3,11 +3,16 @@
 
 /**
  * @file frame.h
- * @brief 缓冲帧元数据：pin_count / dirty / page_id / 页级读写锁。
+ * @brief 缓冲帧元数据：pin_count / dirty / (seg_id, page_id) / 页级读写锁与版本号。
  *
  * 数据区由 BufferPoolManager 管理为一整块连续内存，每个 frame 拿一个切片。
+ * 除 latch / version 外，其余字段均由所属分区的互斥锁保护。
+ *
+ * 页级并发（见 page_guard.h）：写者持 latch 独占并把 version 加一（奇数），写完再加一；
+ * 读者不加锁，读前读后比较 version。刷盘持 latch 共享，不会写出正在修改的页。
  */
 
+#include <atomic>
 #include <cstdint>
 #include <shared_mutex>
 
@@ -17,20 +22,30 @@ namespace dbms {
 namespace storage {
 
 struct Frame {
+  seg_id_t          seg_id{ kInvalidSegId };
   page_id_t         page_id{ kInvalidPageId };
   int               pin_count{ 0 };
   bool              dirty{ false };
+  bool              io_in_progress{ false };  // 正在装入/写回；期间数据区内容不可用
+  bool              in_ring{ false };         // 属于批量读环形缓冲（不进入替换器）
+  bool              prefetched{ false };      // 由预读装入且尚未被访问
 
   // 每帧的页级读写锁（物理保护，非事务锁）
   mutable std::shared_mutex latch;
+  // 乐观读版本号：奇数表示有写者正在修改页；帧易主时不清零（单调递增）
+  std::atomic<uint64_t> version{ 0 };
 
   // 指向该 frame 的页内存起始（长度 = page_size）
   std::uint8_t*     data{ nullptr };
 
   void Reset(std::uint8_t* p) {
+    seg_id    = kInvalidSegId;
     page_id   = kInvalidPageId;
     pin_count = 0;
     dirty     = false;
+    io_in_progress = false;
+    in_ring   = false;
+    prefetched = false;
     data      = p;
   }
 };
@@ -0,0 +1,59 @@
+#ifndef DBMS_STORAGE_INTERNAL_BUFFER_FRAME_ARENA_H_
+#define DBMS_STORAGE_INTERNAL_BUFFER_FRAME_ARENA_H_
+
+/**
+ * @file frame_arena.h
+ * @brief 缓冲池页内存（arena）：匿名 mmap 分配，起始地址至少按 kDirectIoAlignment 对齐。
+ *
+ * - 匿名映射由内核按需清零，无需构造时逐字节置零，启动时也不逐页触碰（首次访问才缺页）；
+ * - hugepages=true 时按 2 MiB 对齐并 madvise(MADV_HUGEPAGE)，交给透明大页合并，
+ *   以减少大缓冲池的 TLB 开销；内核不支持时静默退化为普通页；
+ * - hugetlb=true 时先尝试 MAP_HUGETLB（需事先在 vm.nr_hugepages 预留足够的大页），
+ *   映射失败则退化为透明大页；
+ * - BindToNode 在首次访问前为一段区间指定 NUMA 节点（缓冲池按分区调用）。
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dbms {
+namespace storage {
+
+class FrameArena {
+public:
+  FrameArena() = default;
+  ~FrameArena();
+
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  /// 分配 bytes 字节（先释放旧映射）；失败返回 false
+  bool Allocate(size_t bytes, bool hugepages, bool hugetlb = false);
+  void Release();
+
+  /**
+   * @brief 让 [offset, offset+len) 优先使用 node 上的内存。区间两端向上取整到映射粒度
+   *        （大页映射为 2 MiB），因此相邻区间按同一规则调用时恰好首尾相接、互不重叠。
+   */
+  bool BindToNode(size_t offset, size_t len, int node);
+
+  std::uint8_t* data() const noexcept { return data_; }
+  size_t        size() const noexcept { return size_; }
+  bool          empty() const noexcept { return size_ == 0; }
+  bool          hugepages() const noexcept { return huge_; }     ///< 已启用透明大页或 hugetlb
+  bool          hugetlb() const noexcept { return hugetlb_; }    ///< 由 MAP_HUGETLB 预留大页支撑
+  size_t        granule() const noexcept;                       ///< 映射粒度（NUMA 绑定的最小单位）
+
+private:
+  std::uint8_t* data_{nullptr};   // 对齐后的起始地址
+  size_t        size_{0};         // 可用字节数
+  void*         map_{nullptr};    // 实际映射（含对齐余量）
+  size_t        map_len_{0};
+  bool          huge_{false};
+  bool          hugetlb_{false};
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_INTERNAL_BUFFER_FRAME_ARENA_H_
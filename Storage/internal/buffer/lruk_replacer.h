@@ -3,12 +3,25 @@
 
 /**
  * @file lruk_replacer.h
- * @brief 简化版 LRU-K (K=2 默认)：记录最近两次访问时间戳，选择“最不常用”的未固定帧。
+ * @brief LRU-K：按“倒数第 K 次访问”的先后淘汰，访问不足 K 次的帧（后向 K 距离为无穷）优先淘汰。
  *
- * 注意：教学用途的轻量实现；追求可读性与可比性而非极致性能。
+ * 实现要点：
+ *  - 每帧一个长度为 K 的历史环，时间戳为逻辑访问计数（每次 RecordAccess 加一），不读时钟；
+ *  - 相关引用期（correlated reference period）：同一帧与其上次访问相隔不超过 crp 个逻辑时钟时，
+ *    视为同一次引用的延续，只刷新最近一次时间戳、不推进历史
+ *    （默认 crp=1：连续两次 Fetch 同一页只算一次，逐行插入/顺序扫描不会把页“刷”成热页）；
+ *  - 候选集为按 (访问是否满 K 次, 最早一次历史时间戳, fid) 排序的索引最小堆：
+ *    满 K 次前按首个记录的访问先进先出（一次性扫描的页最先被淘汰），满 K 次后即标准 LRU-K；
+ *    Pin/Unpin/RecordAccess/Victim 均为 O(log n)，Size() 为 O(1)；
+ *  - K=1 时退化为 LRU；
+ *  - 帧装入新页（RecordLoad）时清空其历史：新页不继承被淘汰页的访问记录。
+ *
+ * 线程安全：内部互斥锁保护（BPM 已在分区锁内调用，此锁无竞争）。
  */
 
-#include <chrono>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <vector>
 
 #include "dbms/storage/buffer/replacer.h"
@@ -18,30 +31,52 @@ namespace storage {
 
 class LruKReplacer final : public IReplacer {
 public:
-  explicit LruKReplacer(int capacity, int k = 2);
+  static constexpr uint64_t kDefaultCorrelatedPeriod = 1;
+
+  /**
+   * @param capacity           帧数
+   * @param k                  K 值（>=1）
+   * @param correlated_period  相关引用期（逻辑访问计数；0=每次访问都单独计入历史）
+   */
+  explicit LruKReplacer(int capacity, int k = 2, uint64_t correlated_period = kDefaultCorrelatedPeriod);
 
   void Pin(frame_id_t fid) override;
   void Unpin(frame_id_t fid) override;
+  void RecordAccess(frame_id_t fid) override;
+  void RecordLoad(frame_id_t fid, uint64_t page_key) override;
   bool Victim(frame_id_t* out) override;
   int  Size() const override;
+  uint64_t ScanSteps() const override { return scan_steps_.load(std::memory_order_relaxed); }
+  void     Hotness(std::vector<uint64_t>* out) const override;
 
-private:
-  using Clock = std::chrono::steady_clock;
-  using Time  = Clock::time_point;
+  int      k() const noexcept { return k_; }
+  uint64_t correlated_period() const noexcept { return crp_; }
 
+private:
   struct Entry {
-    bool   present{false};   // 是否在候选集
-    int    k{2};             // K 值（目前只用到 2）
-    Time   last1{};          // 最近一次访问
-    Time   last2{};          // 倒数第二次访问（未满时为 epoch）
+    uint32_t count{0};     // 已记录的历史访问次数（封顶 K）
+    uint32_t head{0};      // 历史环中最近一次访问的下标
+    int      heap_pos{-1}; // 在候选堆中的下标（-1 表示不在候选集）
   };
 
-  void Touch(frame_id_t fid);
+  uint64_t Oldest(frame_id_t fid) const;          // 历史环中最早的时间戳（无历史为 0）
+  bool     Less(frame_id_t a, frame_id_t b) const; // a 是否应先于 b 被淘汰
+  void     Place(int i, frame_id_t fid);
+  void     SiftUp(int i);
+  void     SiftDown(int i);
+  void     HeapErase(frame_id_t fid);
+  void     AccessLocked(frame_id_t fid);  // 需持有 mu_
 
 private:
-  std::vector<Entry> entries_;
-  int                cap_{0};
-  int                k_{2};
+  std::vector<Entry>      entries_;
+  std::vector<uint64_t>   hist_;    // cap * K 个时间戳（按帧连续存放）
+  std::vector<frame_id_t> heap_;    // 候选帧的最小堆
+  uint64_t                now_{0};  // 逻辑时钟
+  int                     cap_{0};
+  int                     k_{2};
+  uint64_t                crp_{kDefaultCorrelatedPeriod};
+  std::atomic<uint64_t>   scan_steps_{0};  // 堆顶即受害者：每次 Victim 计 1
+  mutable std::mutex      mu_;
 };
 
 }  // namespace storage
@@ -3,9 +3,12 @@
 
 /**
  * @file page_table.h
- * @brief 简单的 page_id → frame_id 映射（hash map）。
+ * @brief 简单的 (seg_id, page_id) → frame_id 映射（hash map）。
+ *
+ * 键为 PageKey：高 32 位为段号、低 32 位为段内页号。
  */
 
+#include <cstdint>
 #include <unordered_map>
 
 #include "dbms/storage/storage_types.h"
@@ -14,22 +17,28 @@
 namespace dbms {
 namespace storage {
 
+using PageKey = uint64_t;
+
+inline PageKey MakePageKey(seg_id_t seg, page_id_t pid) {
+  return (static_cast<uint64_t>(seg) << 32) | static_cast<uint64_t>(pid);
+}
+
 class PageTable {
 public:
-  bool Lookup(page_id_t pid, frame_id_t* out_fid) const {
-    auto it = map_.find(pid);
+  bool Lookup(PageKey key, frame_id_t* out_fid) const {
+    auto it = map_.find(key);
     if (it == map_.end()) return false;
     *out_fid = it->second;
     return true;
   }
 
-  void   Insert(page_id_t pid, frame_id_t fid) { map_[pid] = fid; }
-  void   Erase(page_id_t pid) { map_.erase(pid); }
+  void   Insert(PageKey key, frame_id_t fid) { map_[key] = fid; }
+  void   Erase(PageKey key) { map_.erase(key); }
   void   Clear() { map_.clear(); }
   size_t Size() const { return map_.size(); }
 
 private:
-  std::unordered_map<page_id_t, frame_id_t> map_;
+  std::unordered_map<PageKey, frame_id_t> map_;
 };
 
 }  // namespace storage
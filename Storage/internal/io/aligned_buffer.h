@@ -0,0 +1,54 @@
+#ifndef DBMS_STORAGE_INTERNAL_IO_ALIGNED_BUFFER_H_
+#define DBMS_STORAGE_INTERNAL_IO_ALIGNED_BUFFER_H_
+
+/**
+ * @file aligned_buffer.h
+ * @brief 按 kDirectIoAlignment 对齐的临时缓冲区（RAII）。
+ *
+ * 用于 O_DIRECT 下的零散读写（探测页头、非对齐调用方的中转等）；
+ * 分配失败时 data() 为 nullptr，由调用方返回错误。
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "dbms/storage/storage_types.h"
+
+namespace dbms {
+namespace storage {
+
+class AlignedBuffer {
+public:
+  explicit AlignedBuffer(size_t n, size_t align = kDirectIoAlignment) : size_(n) {
+    void* p = nullptr;
+    const size_t len = (n + align - 1) / align * align;
+    if (len > 0 && ::posix_memalign(&p, align, len) == 0) {
+      std::memset(p, 0, len);
+      data_ = static_cast<std::uint8_t*>(p);
+    }
+  }
+  ~AlignedBuffer() { std::free(data_); }
+
+  AlignedBuffer(const AlignedBuffer&) = delete;
+  AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+  std::uint8_t* data() noexcept { return data_; }
+  size_t        size() const noexcept { return size_; }
+
+  /// 判断 (地址, 长度, 偏移) 是否满足直接 I/O 的对齐要求
+  static bool IsAligned(const void* p, size_t n, uint64_t offset,
+                        size_t align = kDirectIoAlignment) noexcept {
+    return reinterpret_cast<uintptr_t>(p) % align == 0 && n % align == 0 && offset % align == 0;
+  }
+
+private:
+  std::uint8_t* data_{nullptr};
+  size_t        size_{0};
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_INTERNAL_IO_ALIGNED_BUFFER_H_
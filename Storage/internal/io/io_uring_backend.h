@@ -0,0 +1,76 @@
+#ifndef DBMS_STORAGE_INTERNAL_IO_IO_URING_BACKEND_H_
+#define DBMS_STORAGE_INTERNAL_IO_IO_URING_BACKEND_H_
+
+/**
+ * @file io_uring_backend.h
+ * @brief io_uring 后端（直接使用系统调用，不依赖 liburing）。
+ *
+ * 结构：
+ *  - 一个 SQ/CQ 环；提交端以互斥锁串行化 SQ 尾指针的推进；
+ *  - 一个完成线程阻塞在 io_uring_enter(GETEVENTS) 上，收割 CQE 并调用请求回调；
+ *  - 在途请求数不超过 CQ 容量，超出时提交端等待，避免 CQ 溢出；
+ *  - 落在已登记缓冲区内的请求使用 READ_FIXED / WRITE_FIXED。
+ *
+ * 短读/短写（极少见）在完成线程内用 pread/pwrite 同步补齐剩余部分。
+ *
+ * 收割时 io_uring_enter 出现不可重试的错误：所有在途请求以 IOError 完成，之后的提交直接失败，
+ * 仍保证每个请求的回调恰好调用一次。
+ */
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "dbms/storage/io/io_backend.h"
+
+namespace dbms {
+namespace storage {
+
+class IoUringBackend final : public IoBackend {
+public:
+  /// 初始化失败时返回 nullptr（例如内核不支持或被 seccomp 禁用）
+  static std::unique_ptr<IoUringBackend> Open(unsigned queue_depth);
+
+  ~IoUringBackend() override;
+
+  const char* Name() const noexcept override { return "io_uring"; }
+  Status Submit(IoRequest* reqs, size_t n) override;
+  Status RegisterBuffer(void* base, size_t len) override;
+
+private:
+  IoUringBackend() = default;
+
+  struct Ring;     // mmap 出来的 SQ/CQ 视图
+  struct Pending;  // 在途请求上下文（user_data 指向它）
+
+  void   Reap();                         // 完成线程主循环
+  void   Complete(Pending* p, int res);  // 处理单个 CQE
+  int    FixedIndexOf(const void* buf, size_t len) const;
+  void   LinkPending(Pending* p);        // 需持有 sq_mu_
+  void   UnlinkPending(Pending* p);      // 需持有 sq_mu_
+  void   FailOutstanding(const Status& err);  // 环已不可用：在途请求全部以 err 完成
+
+private:
+  int                   ring_fd_{-1};
+  std::unique_ptr<Ring> ring_;
+
+  std::mutex              sq_mu_;      // 保护 SQ 与 inflight_
+  std::condition_variable room_cv_;    // 在途数下降时唤醒提交端
+  unsigned                inflight_{0};
+  unsigned                max_inflight_{0};
+  Pending*                outstanding_{nullptr};  // 在途请求链表（失败时据此逐个完成）
+  bool                    dead_{false};           // 完成线程已因错误退出
+
+  struct FixedBuf { std::uint8_t* base; size_t len; };
+  std::vector<FixedBuf> fixed_;        // 已登记的缓冲区（下标即 buf_index）
+
+  std::thread reaper_;
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_INTERNAL_IO_IO_URING_BACKEND_H_
@@ -0,0 +1,27 @@
+#ifndef DBMS_STORAGE_INTERNAL_IO_POSIX_IO_H_
+#define DBMS_STORAGE_INTERNAL_IO_POSIX_IO_H_
+
+/**
+ * @file posix_io.h
+ * @brief pread/pwrite 的“读满/写满”循环（File 与 POSIX 后端共用）。
+ *
+ * 读语义：一个字节都没读到即遇 EOF → NotFound；读到一半遇 EOF → Corruption。
+ * 以 pread 的返回值判断 EOF，不再为每次读取额外调用 fstat。
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "dbms/storage/storage_types.h"
+
+namespace dbms {
+namespace storage {
+
+/// err 非空时，系统调用失败会写入对应 errno（否则置 0），便于调用方区分 EINVAL 等情况
+Status PosixReadFull(int fd, void* buf, size_t n, uint64_t offset, int* err = nullptr);
+Status PosixWriteFull(int fd, const void* buf, size_t n, uint64_t offset, int* err = nullptr);
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_INTERNAL_IO_POSIX_IO_H_
@@ -0,0 +1,31 @@
+#ifndef DBMS_STORAGE_INTERNAL_PAGE_PAGE_CHECKSUM_H_
+#define DBMS_STORAGE_INTERNAL_PAGE_PAGE_CHECKSUM_H_
+
+/**
+ * @file page_checksum.h
+ * @brief 页校验和：写回前写入 PageHeader::checksum，未命中读入后校验。
+ *
+ * 约定：
+ *  - 校验覆盖整页（含页头，checksum 字段本身除外），算法为 CRC-32C；
+ *  - checksum == 0 表示“未写入校验和”（从未经缓冲池写回的页，如 fallocate 出的零页、
+ *    旧版本写出的页），校验时直接放行；计算结果恰为 0 时存为 1 以免与之混淆。
+ */
+
+#include <cstdint>
+
+namespace dbms {
+namespace storage {
+
+/// 计算 page 的校验和（不读 checksum 字段；结果非 0）
+uint32_t ComputePageChecksum(const std::uint8_t* page, uint32_t page_size);
+
+/// 计算并写入 PageHeader::checksum
+void StampPageChecksum(std::uint8_t* page, uint32_t page_size);
+
+/// 校验 PageHeader::checksum（为 0 时视为未写入、返回 true）
+bool VerifyPageChecksum(const std::uint8_t* page, uint32_t page_size);
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_INTERNAL_PAGE_PAGE_CHECKSUM_H_
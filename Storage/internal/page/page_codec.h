@@ -0,0 +1,51 @@
+#ifndef DBMS_STORAGE_INTERNAL_PAGE_PAGE_CODEC_H_
+#define DBMS_STORAGE_INTERNAL_PAGE_PAGE_CODEC_H_
+
+/**
+ * @file page_codec.h
+ * @brief 冷段的页压缩：把整页映像无损编码为变长字节串，读入时还原为逐字节相同的页
+ *        （页校验和随之不变，缓冲池照常校验）。
+ *
+ * 编码方式（字节串首字节）：
+ *  - kPax：PAX 页按列编码。INT32/DATE 列的值小页用参考帧 + 位打包（FOR：存最小值与位宽，
+ *          其余为 value - min 的 b 位打包）；CHAR 列在不同取值不超过 256 个时用字典编码
+ *          （字典 + 位打包的码）；其余字节（页头、删除/NULL 位图、其他列、空闲区与变长区）
+ *          按原顺序拼接后整体 LZ4；
+ *  - kLz4：其他页（槽位页，或给不出 Schema 的 PAX 页）整页 LZ4；
+ *  - kRaw：以上都不比原页小时原样存放。
+ *
+ * kPax 的字节串自描述（列编码区间记录了页内偏移与行数），解码不需要 Schema。
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "dbms/storage/storage_types.h"
+#include "dbms/storage/record/schema.h"
+
+namespace dbms {
+namespace storage {
+
+enum class PageEncoding : std::uint8_t { kRaw = 0, kLz4 = 1, kPax = 2 };
+
+/// 编码时累计的列编码次数（观测用）
+struct PageCodecCounts {
+  uint64_t for_columns{0};   ///< 以 FOR + 位打包编码的列小页
+  uint64_t dict_columns{0};  ///< 以字典编码的 CHAR 列小页
+};
+
+/**
+ * @brief 编码一页。
+ * @param schema 非空且页为匹配该 Schema 的 PAX 页时按列编码；否则整页 LZ4
+ * @param out    被覆盖为编码结果（复用容量）
+ */
+PageEncoding EncodePage(const std::uint8_t* page, uint32_t page_size, const Schema* schema,
+                        std::vector<std::uint8_t>* out, PageCodecCounts* counts = nullptr);
+
+/// 把 EncodePage 的结果还原到 page[0, page_size)；格式错误返回 Corruption
+Status DecodePage(const std::uint8_t* blob, size_t len, std::uint8_t* page, uint32_t page_size);
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_INTERNAL_PAGE_PAGE_CODEC_H_
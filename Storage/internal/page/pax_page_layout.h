@@ -0,0 +1,129 @@
+#ifndef DBMS_STORAGE_INTERNAL_PAGE_PAX_PAGE_LAYOUT_H_
+#define DBMS_STORAGE_INTERNAL_PAGE_PAX_PAGE_LAYOUT_H_
+
+/**
+ * @file pax_page_layout.h
+ * @brief PAX 页（页内按列分组）布局与页内算法接口。
+ *
+ * 物理布局（自低地址到高地址）：
+ *  [ PageHeader | PaxHeader | 删除位图 | 列0 (NULL 位图) 值小页 | 列1 ... | ...空闲... | 变长区 ]
+ *
+ * 关键约定：
+ *  - 行容量 capacity 在初始化时按 Schema 与预估的每行变长字节数确定，各列小页按它一次预留；
+ *    小页起点 8 字节对齐，偏移只由 (page_size, Schema, capacity) 决定，不在页内另存；
+ *  - 第 r 行的第 c 列位于 “列 c 值小页 + r × FixedSizeOf(c)”；VARCHAR 存 (uint16_t off, uint16_t len)，
+ *    off 从页首起算，指向自页尾向前生长的变长区；
+ *  - PageHeader 复用：slot_count = 已追加行数（含已删除），free_off = 变长区起点，
+ *    free_size = 还能追加行时小页末尾到变长区之间的字节数（行已满为 0），frag_size 恒为 0；
+ *  - 只追加：删除只置删除位，不复用行号、不回收空间（面向追加为主的分析表）。
+ *
+ * 对外交换的记录仍是 schema.h 的行格式：Insert 把一行拆散到各列小页，Get 再拼回行格式。
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "dbms/storage/storage_types.h"
+#include "dbms/storage/page/page.h"
+#include "dbms/storage/record/schema.h"
+
+namespace dbms {
+namespace storage {
+
+/// 紧随 PageHeader 的 PAX 页头
+struct PaxHeader {
+  uint32_t magic{0};
+  uint16_t capacity{0};  ///< 行容量
+  uint16_t ncols{0};     ///< 列数（与 Schema 校对）
+};
+
+class PaxPage {
+public:
+  static constexpr uint32_t kMagic = 0x31584150;  // "PAX1"
+
+  /**
+   * @param schema 必须与写入该页时的 Schema 一致（须比本对象活得久）
+   * @note 构造时按页头的 capacity 校验布局；页头损坏（或乐观读撕裂）时 Valid() 为 false
+   */
+  PaxPage(std::uint8_t* page, std::uint32_t page_size, const Schema& schema);
+
+  /**
+   * @brief 初始化一张全新 PAX 页。
+   * @param var_bytes_per_row 每行平均变长字节数的估计，决定行容量（偏小则变长区先满，偏大则行号先满）
+   */
+  static void InitNew(std::uint8_t* page, page_id_t pid, std::uint32_t page_size,
+                      const Schema& schema, std::uint32_t var_bytes_per_row);
+
+  /// 每行变长字节数的默认估计：各 VARCHAR 最大长度的一半
+  static std::uint32_t DefaultVarEstimate(const Schema& schema);
+
+  /// 一行（行格式）中变长数据的总字节数（插入所需的变长区空间）；行格式非法返回 0
+  static std::uint32_t VarBytesOf(const Schema& schema, const std::uint8_t* row, std::uint16_t len);
+
+  // ----------------- 基础操作（行格式进出） -----------------
+
+  /// 追加一行；行号或变长区用尽返回 OutOfRange；行格式非法返回 InvalidArgument
+  Status Insert(const std::uint8_t* row, std::uint16_t len, std::uint16_t* out_slot);
+
+  /// 把第 slot 行拼回行格式写入 out（复用其容量）；已删除/越界返回 NotFound
+  Status Get(std::uint16_t slot, std::vector<std::uint8_t>* out) const;
+
+  /// 原地更新：VARCHAR 变长时在变长区另取空间，不足返回 OutOfRange（交由上层迁移）
+  Status Update(std::uint16_t slot, const std::uint8_t* row, std::uint16_t len);
+
+  /// 置删除位
+  Status Erase(std::uint16_t slot);
+
+  // ----------------- 观测与列访问 -----------------
+
+  bool           Valid()    const noexcept { return valid_; }
+  std::uint16_t  Capacity() const noexcept { return cap_; }
+  /// 已追加的行数（已截断到容量以内）
+  std::uint16_t  RowCount() const;
+  /// 变长区起点（已截断到 [小页末尾, 页尾]）
+  std::uint16_t  VarBegin() const;
+  /// 最后一个小页的末尾
+  std::uint32_t  FixedEnd() const noexcept { return fixed_end_; }
+
+  /// 删除位图（每行 1 位，置位为已删除）
+  const std::uint8_t* DeletedBitmap() const { return page_ + kDeletedOff; }
+  bool IsDeleted(std::uint16_t r) const { return (DeletedBitmap()[r / 8] >> (r % 8)) & 1; }
+
+  /**
+   * @brief 依次给出各列小页的偏移：fn(col, values_off, nulls_off)。
+   *        nulls_off 为该列 NULL 位图（Schema 未启用 NULL 位图时为 0）。O(列数)，不分配内存。
+   */
+  template <class Fn>
+  void ForEachColumn(Fn&& fn) const {
+    const uint32_t bitmap = Align8((cap_ + 7u) / 8u);
+    uint32_t off = kDeletedOff + bitmap;
+    for (size_t c = 0; c < schema_.ColumnCount(); ++c) {
+      uint32_t nulls_off = 0;
+      if (schema_.UseNullBitmap()) { nulls_off = off; off += bitmap; }
+      fn(c, off, nulls_off);
+      off += Align8(static_cast<uint32_t>(cap_) * static_cast<uint32_t>(schema_.FixedSizeOf(c)));
+    }
+  }
+
+  /// 小页起点对齐（便于按列做宽加载）
+  static constexpr uint32_t Align8(uint32_t x) { return (x + 7u) & ~7u; }
+  static constexpr uint32_t kDeletedOff = (sizeof(PageHeader) + sizeof(PaxHeader) + 7u) & ~7u;
+
+private:
+  PageHeader* Hdr() const { return reinterpret_cast<PageHeader*>(page_); }
+  void        RefreshFree();  // 按行数与变长区起点重算 free_size
+  static uint32_t FixedEndFor(const Schema& schema, uint32_t cap);
+
+private:
+  std::uint8_t*  page_{nullptr};
+  std::uint32_t  page_size_{0};
+  const Schema&  schema_;
+  std::uint16_t  cap_{0};
+  std::uint32_t  fixed_end_{0};
+  bool           valid_{false};
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_INTERNAL_PAGE_PAX_PAGE_LAYOUT_H_
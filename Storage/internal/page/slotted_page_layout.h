@@ -10,8 +10,10 @@
  *
  * 关键约定：
  *  - 槽目录位于页尾，按 slot_id 递增排列；每个槽记录一个记录的 (offset,len)。
- *  - 删除：将槽标记为空（len==0），并在需要时进行紧凑化（可延后）。
- *  - Update：尝试原地覆盖；若空间不足则触发页内压缩；仍不足则返回 OutOfRange。
+ *  - 删除：将槽标记为空（len==0），记录占用的空间计入 frag_size（紧邻连续空闲区时直接退还）；
+ *    尾部的空槽连同目录项一起退还。
+ *  - 插入从 free_slot_hint 起找空槽；连续空闲不足而 free_size + frag_size 足够时压缩一次。
+ *  - Update：尝试原地覆盖/延长；若空间不足则触发页内压缩；仍不足则返回 OutOfRange。
  *
  * 对外只暴露 SlottedPage 的方法；具体槽结构细节不泄漏到其他模块。
  */
@@ -27,6 +29,9 @@ namespace storage {
 
 class SlottedPage {
 public:
+  /// 每个槽目录项占用的字节数（插入新槽位时在记录之外额外消耗）
+  static constexpr std::uint16_t kSlotBytes = 4;
+
   /**
    * @brief 构造一个页适配器（不会初始化页头）。
    * @param page       指向页的首地址（长度不少于 page_size）
@@ -44,13 +49,20 @@ public:
 
   /**
    * @brief 插入一条记录，返回分配的 slot id。
-   * @note  若空间不足将尝试一次页内压缩；仍不足则返回 OutOfRange。
+   * @note  连续空闲不足但加上碎片足够时先压缩一次；否则返回 OutOfRange。
    */
   Status Insert(const std::uint8_t* rec, std::uint16_t len, std::uint16_t* out_slot);
 
+  /**
+   * @brief 分配一条 len 字节的记录并返回其在页内的地址，由调用方直接写入内容（免去中间缓冲）。
+   * @note  空间规则同 Insert；写入完成前页不得被其他人读取（调用方持有写闩锁）。
+   */
+  Status Allocate(std::uint16_t len, std::uint16_t* out_slot, std::uint8_t** out_rec);
+
   /**
    * @brief 读取某槽位的记录内容指针与长度（零拷贝视图）。
    * @return 若槽空/被删/越界返回 NotFound。
+   * @note  可用于乐观读：即使页正被并发修改，返回的区间也总在页内（内容须事后校验版本）。
    */
   Status Get(std::uint16_t slot, const std::uint8_t** out_ptr, std::uint16_t* out_len) const;
 
@@ -76,15 +88,22 @@ public:
     return reinterpret_cast<const PageHeader*>(page_)->free_size;
   }
 
+  /// 连续空闲 + 可回收碎片（压缩后可得的连续空间；应据此更新 FSM）
+  std::uint16_t UsableSize() const {
+    return PageUsableSpace(*reinterpret_cast<const PageHeader*>(page_));
+  }
+
   /// 槽位总数（包含 tombstone/空槽）
   std::uint16_t SlotCount() const {
     return reinterpret_cast<const PageHeader*>(page_)->slot_count;
   }
 
 private:
-  // 内部工具：触发一次页内压缩（将存活记录紧凑到前部，重建槽目录）
-  // 压缩后保证：free_off 指向首个空闲字节；free_size 为连续空闲大小。
+  // 内部工具：触发一次页内压缩（将存活记录紧凑到前部，重写槽内偏移；不分配堆内存）
+  // 压缩后保证：free_off 指向首个空闲字节；free_size 为连续空闲大小；frag_size 为 0。
   void Compact();
+  // 退还尾部连续的空槽（slot_count 回缩，目录空间并入连续空闲区）
+  void TrimTrailingSlots();
 
 private:
   std::uint8_t*  page_{nullptr};
@@ -0,0 +1,93 @@
+#ifndef DBMS_STORAGE_INTERNAL_SEGMENT_COLD_SEGMENT_H_
+#define DBMS_STORAGE_INTERNAL_SEGMENT_COLD_SEGMENT_H_
+
+/**
+ * @file cold_segment.h
+ * @brief 冷段文件 seg_<id>.dbseg.cold：段内各页压缩后的映像（见 page_codec.h）顺序存放，
+ *        供只读为主的历史表以更少的字节读盘；页在缓冲池未命中时读出并解压进帧。
+ *
+ * 文件布局：
+ *   [ ColdHeader | 目录（每页一项：偏移、长度、CRC-32C、页可用空间、编码） | 各页数据（按页号顺序） ]
+ *  - 头部与目录由 FNV-1a 校验和覆盖，打开时校验；每页数据另有 CRC-32C，读出时校验；
+ *  - 页号连续的若干页在文件中也连续，批量读取合并为一次 pread；
+ *  - 目录里存有每页的可用空间，FSM 重建无需解压；
+ *  - 冷段只读：页号不小于 page_count() 的页读为全零（从未初始化）。
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dbms/storage/storage_types.h"
+#include "dbms/storage/io/disk_manager.h"
+#include "dbms/storage/io/file.h"
+#include "dbms/storage/record/schema.h"
+#include "dbms/storage/segment/segment_manager.h"
+
+namespace dbms {
+namespace storage {
+
+class ColdSegment {
+public:
+  /**
+   * @brief 读出 src 的 [0, pages) 页，逐页压缩写入 path（先写 path.tmp 并 fsync，再 rename 覆盖）。
+   * @param schema 非空时 PAX 页按列编码，否则整页 LZ4
+   */
+  static Status Build(const std::string& path, DiskManager* src, uint64_t pages, uint32_t page_size,
+                      const Schema* schema);
+
+  /// 打开并校验 path；文件不存在返回 NotFound，头部/目录损坏或页大小不符返回 Corruption
+  static Status Open(const std::string& path, uint32_t page_size, std::unique_ptr<ColdSegment>* out);
+
+  ColdSegment(const ColdSegment&) = delete;
+  ColdSegment& operator=(const ColdSegment&) = delete;
+
+  uint64_t           page_count() const noexcept { return dir_.size(); }
+  const std::string& path()       const noexcept { return file_.path(); }
+
+  /// 读出并解压 [first, first+n) 到 out（n × page_size 字节）
+  Status ReadPages(page_id_t first, uint32_t n, void* out) const;
+  Status ReadPage(page_id_t pid, void* out) const { return ReadPages(pid, 1, out); }
+
+  /// 执行一批读请求（页号相邻的请求合并为一次读）；per_page[i] 为第 i 个请求的结果
+  void   ReadBatch(const DiskManager::PageIo* ios, size_t n, Status* per_page) const;
+
+  /// 目录记录的页可用空间（PageUsableSpace；越界为 0）
+  uint16_t UsableSpace(page_id_t pid) const noexcept { return pid < dir_.size() ? dir_[pid].usable : 0; }
+
+  /// 填入压缩统计（建段时写入文件头）与运行期的读取 / 解压计数
+  void   FillStats(ColdSegmentStats* st) const;
+
+private:
+  struct DirEntry {
+    uint64_t off;
+    uint32_t len;
+    uint32_t crc;
+    uint16_t usable;
+    uint8_t  encoding;
+    uint8_t  reserved[5];
+  };
+  static_assert(sizeof(DirEntry) == 24, "DirEntry is part of the on-disk format.");
+
+  ColdSegment(std::string path, uint32_t page_size) : file_(std::move(path)), page_size_(page_size) {}
+
+  /// 读出 [first, first+n)（须在 page_count 之内），第 i 页解压到 outs[i]；per_page 可为空
+  Status ReadRun(page_id_t first, uint32_t n, std::uint8_t* const* outs, Status* per_page) const;
+
+private:
+  File                  file_;
+  uint32_t              page_size_{0};
+  std::vector<DirEntry> dir_;
+  ColdSegmentStats      built_{};  // 文件头中的压缩统计
+
+  mutable std::atomic<uint64_t> decoded_pages_{0};
+  mutable std::atomic<uint64_t> read_bytes_{0};
+  mutable std::atomic<uint64_t> decode_ns_{0};
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_INTERNAL_SEGMENT_COLD_SEGMENT_H_
@@ -0,0 +1,57 @@
+#ifndef DBMS_STORAGE_INTERNAL_SPACE_FSM_TREE_H_
+#define DBMS_STORAGE_INTERNAL_SPACE_FSM_TREE_H_
+
+/**
+ * @file fsm_tree.h
+ * @brief FSM 的紧凑存储：每页 1 字节的“空闲类别”数组 + 分层最大值树（扇出 64）。
+ *
+ * 结构：
+ *  - levels_[0] 为叶子（下标即 page_id）；levels_[k+1][g] = max(levels_[k][g*64 .. g*64+63])；
+ *  - 顶层不超过 64 项；除叶子外的额外内存约为 1/63；
+ *  - FindFirst(min)：自顶向下，每层在 64 项内找第一个 >= min 的位置，O(log64 n) 层；
+ *  - Set(i, v)：更新叶子后向上修正，父节点不变即停止。
+ *
+ * 非线程安全（由 FreeSpaceManager 加锁）。
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dbms {
+namespace storage {
+
+class FsmTree {
+public:
+  static constexpr size_t kFanout = 64;
+  static constexpr size_t npos    = static_cast<size_t>(-1);
+
+  size_t  size() const noexcept { return levels_.empty() ? 0 : levels_[0].size(); }
+  uint8_t Get(size_t i) const noexcept { return i < size() ? levels_[0][i] : 0; }
+
+  /// 设置叶子 i（超出当前大小时自动扩展，新增叶子为 0）
+  void    Set(size_t i, uint8_t v);
+
+  /// 值 >= min 的最小叶子下标；不存在返回 npos（min==0 时返回 0，若非空）
+  size_t  FindFirst(uint8_t min) const;
+
+  /// 整体替换叶子并重建上层
+  void    Assign(std::vector<uint8_t> leaves);
+  void    Clear() { levels_.clear(); }
+
+  const std::vector<uint8_t>& leaves() const;
+  size_t  MemoryBytes() const;
+
+private:
+  void    Resize(size_t n);
+  void    BuildLevel(size_t k);  // 由 levels_[k] 整体计算 levels_[k+1]
+  static uint8_t GroupMax(const std::vector<uint8_t>& lv, size_t g);
+
+private:
+  std::vector<std::vector<uint8_t>> levels_;
+};
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_INTERNAL_SPACE_FSM_TREE_H_
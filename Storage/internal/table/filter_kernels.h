@@ -0,0 +1,41 @@
+#ifndef DBMS_STORAGE_INTERNAL_TABLE_FILTER_KERNELS_H_
+#define DBMS_STORAGE_INTERNAL_TABLE_FILTER_KERNELS_H_
+
+/**
+ * @file filter_kernels.h
+ * @brief 批扫描的谓词内核：在一列连续的定长值上求值，结果与选择位图按位与。
+ *
+ * 约定：
+ *  - values 为 n 个小端定长值（不要求对齐）；sel 为 ceil(n/64) 个 64 位字，第 r 位对应第 r 行；
+ *  - 区间均为闭区间 [lo, hi]（开区间由调用方先换成闭区间）；negate 时取补；
+ *  - 只改写 sel 中为 1 的位：sel 字为 0 时整字跳过（合取的后续项因此越来越便宜）；
+ *  - DOUBLE 比较为有序比较：NaN 不落在任何区间内。
+ * 运行时选择实现：x86-64 的 AVX2、AArch64 的 NEON，否则为标量实现，三者结果一致。
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dbms {
+namespace storage {
+
+struct FilterKernels {
+  const char* name;
+  void (*range_i32)(const std::uint8_t* values, uint32_t n, int32_t lo, int32_t hi, bool negate, uint64_t* sel);
+  void (*range_i64)(const std::uint8_t* values, uint32_t n, int64_t lo, int64_t hi, bool negate, uint64_t* sel);
+  void (*range_f64)(const std::uint8_t* values, uint32_t n, double  lo, double  hi, bool negate, uint64_t* sel);
+  /// 值属于 set[0, k)（k 可以为 0：此时无行满足）
+  void (*in_i32)(const std::uint8_t* values, uint32_t n, const int32_t* set, size_t k, uint64_t* sel);
+  void (*in_i64)(const std::uint8_t* values, uint32_t n, const int64_t* set, size_t k, uint64_t* sel);
+};
+
+/// 标量实现（对照与 BatchScanOptions::simd = false 时使用）
+const FilterKernels& ScalarFilterKernels();
+
+/// 当前 CPU 上最快的实现："avx2" / "neon" / "scalar"
+const FilterKernels& BestFilterKernels();
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_INTERNAL_TABLE_FILTER_KERNELS_H_
@@ -0,0 +1,31 @@
+#ifndef DBMS_STORAGE_INTERNAL_UTIL_CRC32C_H_
+#define DBMS_STORAGE_INTERNAL_UTIL_CRC32C_H_
+
+/**
+ * @file crc32c.h
+ * @brief CRC-32C（Castagnoli，反射多项式 0x82F63B78），用于数据页校验。
+ *
+ * 运行时选择实现：x86-64 的 SSE4.2 crc32 指令（三路交错，隐藏指令延迟）、
+ * 编译目标支持时的 ARMv8 CRC 指令，否则为查表（slicing-by-8）软件实现。
+ * 各实现结果一致；crc 参数可用于分段续算：Crc32c(b, nb, Crc32c(a, na)) == Crc32c(a||b)。
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dbms {
+namespace storage {
+
+/// 计算 data[0, n) 的 CRC-32C；crc 为此前各段的结果（首段为 0）
+uint32_t Crc32c(const void* data, size_t n, uint32_t crc = 0);
+
+/// 纯软件实现（基准对照与自检用）
+uint32_t Crc32cSoftware(const void* data, size_t n, uint32_t crc = 0);
+
+/// 当前使用的实现："sse4.2" / "armv8-crc" / "software"
+const char* Crc32cImplementation();
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_INTERNAL_UTIL_CRC32C_H_
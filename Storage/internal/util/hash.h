@@ -0,0 +1,28 @@
+#ifndef DBMS_STORAGE_INTERNAL_UTIL_HASH_H_
+#define DBMS_STORAGE_INTERNAL_UTIL_HASH_H_
+
+/**
+ * @file hash.h
+ * @brief 元数据文件用的轻量校验和（FNV-1a 64 位）。
+ *
+ * 只用于检测元数据文件的截断/损坏（如 FSM 分叉、段元数据），不用于数据页。
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dbms {
+namespace storage {
+
+constexpr uint64_t kFnv64Offset = 1469598103934665603ull;
+
+inline uint64_t Fnv1a64(const void* data, size_t n, uint64_t h = kFnv64Offset) {
+  const auto* p = static_cast<const std::uint8_t*>(data);
+  for (size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+  return h;
+}
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_INTERNAL_UTIL_HASH_H_
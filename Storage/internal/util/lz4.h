@@ -0,0 +1,34 @@
+#ifndef DBMS_STORAGE_INTERNAL_UTIL_LZ4_H_
+#define DBMS_STORAGE_INTERNAL_UTIL_LZ4_H_
+
+/**
+ * @file lz4.h
+ * @brief LZ4 块格式（block format，无帧头）的最小实现，用于冷段页的压缩。
+ *
+ * 输出与标准 LZ4 块格式兼容（可被 liblz4 的 LZ4_decompress_safe 解出），但只实现贪心匹配的
+ * 快速档：4 KiB 项散列表、单候选；输入限于 64 KiB 以内（页大小），偏移恒可用 16 位表示。
+ * 解压做完整的越界检查，损坏的输入返回 false 而不会越界读写。
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dbms {
+namespace storage {
+
+/// 压缩结果的最坏长度（不可压缩输入）
+constexpr size_t Lz4CompressBound(size_t n) { return n + n / 255 + 16; }
+
+/**
+ * @brief 压缩 src[0, n) 到 dst[0, cap)。
+ * @return 压缩后的字节数；cap 不足或 n 超过 64 KiB 时返回 0
+ */
+size_t Lz4Compress(const std::uint8_t* src, size_t n, std::uint8_t* dst, size_t cap);
+
+/// 把 src[0, n) 解压到 dst，输出必须恰好为 out_n 字节；格式错误或长度不符返回 false
+bool Lz4Decompress(const std::uint8_t* src, size_t n, std::uint8_t* dst, size_t out_n);
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_INTERNAL_UTIL_LZ4_H_
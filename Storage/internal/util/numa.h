@@ -0,0 +1,31 @@
+#ifndef DBMS_STORAGE_INTERNAL_UTIL_NUMA_H_
+#define DBMS_STORAGE_INTERNAL_UTIL_NUMA_H_
+
+/**
+ * @file numa.h
+ * @brief 最小的 NUMA 辅助：节点数、内存放置偏好、线程绑核（Linux sysfs + 系统调用，不依赖 libnuma）。
+ *
+ * 失败一律静默返回（false / 1 个节点），调用方退化为不感知 NUMA 的行为。
+ */
+
+#include <cstddef>
+
+namespace dbms {
+namespace storage {
+
+/// 在线 NUMA 节点数（/sys/devices/system/node/online；非 NUMA 系统或读取失败返回 1）
+int NumaNodeCount();
+
+/**
+ * @brief 让 [addr, addr+len) 的物理页优先分配在 node 上（mbind MPOL_PREFERRED）。
+ *        只影响此后首次访问时的缺页分配，须在页池被触碰前调用；addr 须按页对齐。
+ */
+bool PreferNumaNode(void* addr, size_t len, int node);
+
+/// 把调用线程的 CPU 亲和性限制在 node 的 CPU 上；失败时保持原亲和性
+bool PinThreadToNumaNode(int node);
+
+}  // namespace storage
+}  // namespace dbms
+
+#endif  // DBMS_STORAGE_INTERNAL_UTIL_NUMA_H_
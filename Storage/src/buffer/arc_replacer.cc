@@ -0,0 +1,166 @@
+#include "internal/buffer/arc_replacer.h"
+
+#include <algorithm>
+
+namespace dbms {
+namespace storage {
+
+ArcReplacer::ArcReplacer(int capacity)
+    : nodes_(static_cast<size_t>(std::max(0, capacity))), cap_(std::max(0, capacity)) {}
+
+void ArcReplacer::Link(List l, frame_id_t fid) {
+  Lru& lst = ListOf(l);
+  Node& n = nodes_[fid];
+  n.list = l;
+  n.prev = -1;
+  n.next = lst.head;
+  if (lst.head >= 0) nodes_[lst.head].prev = fid;
+  lst.head = fid;
+  if (lst.tail < 0) lst.tail = fid;
+  lst.size++;
+  if (n.evictable) evictable_++;
+}
+
+void ArcReplacer::Unlink(frame_id_t fid) {
+  Node& n = nodes_[fid];
+  if (n.list == List::kNone) return;
+  Lru& lst = ListOf(n.list);
+  if (n.prev >= 0) nodes_[n.prev].next = n.next; else lst.head = n.next;
+  if (n.next >= 0) nodes_[n.next].prev = n.prev; else lst.tail = n.prev;
+  lst.size--;
+  if (n.evictable) evictable_--;
+  n.prev = n.next = -1;
+  n.list = List::kNone;
+}
+
+void ArcReplacer::PushGhost(Ghosts& g, uint64_t key) {
+  g.order.push_front(key);
+  g.index[key] = g.order.begin();
+}
+
+bool ArcReplacer::EraseGhost(Ghosts& g, uint64_t key) {
+  auto it = g.index.find(key);
+  if (it == g.index.end()) return false;
+  g.order.erase(it->second);
+  g.index.erase(it);
+  return true;
+}
+
+void ArcReplacer::PopGhost(Ghosts& g) {
+  if (g.order.empty()) return;
+  g.index.erase(g.order.back());
+  g.order.pop_back();
+}
+
+void ArcReplacer::TrimGhosts() {
+  // |T1| + |B1| <= c；|T1| + |T2| + |B1| + |B2| <= 2c
+  while (t1_.size + b1_.size() > cap_ && b1_.size() > 0) PopGhost(b1_);
+  while (t1_.size + t2_.size + b1_.size() + b2_.size() > 2 * cap_) {
+    if (b2_.size() > 0) PopGhost(b2_);
+    else if (b1_.size() > 0) PopGhost(b1_);
+    else break;
+  }
+}
+
+void ArcReplacer::Pin(frame_id_t fid) {
+  if (fid < 0 || fid >= cap_) return;
+  std::lock_guard<std::mutex> g(mu_);
+  Node& n = nodes_[fid];
+  if (!n.evictable) return;
+  n.evictable = false;
+  if (n.list != List::kNone) evictable_--;
+}
+
+void ArcReplacer::Unpin(frame_id_t fid) {
+  if (fid < 0 || fid >= cap_) return;
+  std::lock_guard<std::mutex> g(mu_);
+  Node& n = nodes_[fid];
+  if (n.list == List::kNone) Link(List::kT1, fid);  // 未经 RecordLoad 的帧按一次访问处理
+  if (n.evictable) return;
+  n.evictable = true;
+  evictable_++;
+}
+
+void ArcReplacer::RecordAccess(frame_id_t fid) {
+  if (fid < 0 || fid >= cap_) return;
+  std::lock_guard<std::mutex> g(mu_);
+  const List to = nodes_[fid].list == List::kNone ? List::kT1 : List::kT2;
+  Unlink(fid);
+  Link(to, fid);
+}
+
+void ArcReplacer::RecordLoad(frame_id_t fid, uint64_t page_key) {
+  if (fid < 0 || fid >= cap_) return;
+  std::lock_guard<std::mutex> g(mu_);
+  Unlink(fid);  // 帧未经 Victim 就换了页（例如释放后复用）：旧页不留幽灵
+  nodes_[fid].key = page_key;
+
+  const int b1 = b1_.size(), b2 = b2_.size();
+  if (EraseGhost(b1_, page_key)) {
+    p_ = std::min(cap_, p_ + std::max(1, b2 / b1));  // 近期被淘汰的页又回来了：T1 应更大
+    Link(List::kT2, fid);
+  } else if (EraseGhost(b2_, page_key)) {
+    p_ = std::max(0, p_ - std::max(1, b1 / b2));     // 频繁页被淘汰又回来了：T2 应更大
+    Link(List::kT2, fid);
+  } else {
+    Link(List::kT1, fid);
+  }
+  TrimGhosts();
+}
+
+bool ArcReplacer::EvictFrom(List l, frame_id_t* out) {
+  // 从最久未用端找第一个未被固定的帧
+  for (int fid = ListOf(l).tail; fid >= 0; fid = nodes_[fid].prev) {
+    Node& n = nodes_[fid];
+    scan_steps_.fetch_add(1, std::memory_order_relaxed);
+    if (!n.evictable) continue;
+    const uint64_t key = n.key;
+    Unlink(fid);
+    n.evictable = false;
+    n.key = kNoKey;
+    if (key != kNoKey) PushGhost(l == List::kT1 ? b1_ : b2_, key);
+    TrimGhosts();
+    *out = fid;
+    return true;
+  }
+  return false;
+}
+
+bool ArcReplacer::Victim(frame_id_t* out) {
+  if (!out) return false;
+  std::lock_guard<std::mutex> g(mu_);
+  if (evictable_ == 0) return false;
+  // |T1| 超过目标时淘汰 T1，否则淘汰 T2；首选链表的帧全被固定时退而取另一个
+  const bool t1_first = t1_.size > 0 && (t1_.size > p_ || t2_.size == 0);
+  const List first = t1_first ? List::kT1 : List::kT2;
+  const List second = t1_first ? List::kT2 : List::kT1;
+  return EvictFrom(first, out) || EvictFrom(second, out);
+}
+
+int ArcReplacer::Size() const {
+  std::lock_guard<std::mutex> g(mu_);
+  return evictable_;
+}
+
+void ArcReplacer::Hotness(std::vector<uint64_t>* out) const {
+  if (!out) return;
+  std::lock_guard<std::mutex> g(mu_);
+  // T2（访问过至少两次）整体热于 T1；各链表内从最久未用端到最近端递增。
+  // 实际淘汰还取决于 p，这里只给出不随 p 摆动的近似次序
+  const int n = static_cast<int>(out->size());
+  uint64_t rank = 1;
+  for (const Lru* l : {&t1_, &t2_}) {
+    for (int fid = l->tail; fid >= 0; fid = nodes_[fid].prev) {
+      if (fid < n) (*out)[fid] = rank;
+      ++rank;
+    }
+  }
+}
+
+int ArcReplacer::target_t1() const {
+  std::lock_guard<std::mutex> g(mu_);
+  return p_;
+}
+
+}  // namespace storage
+}  // namespace dbms
@@ -1,235 +1,1282 @@
 #include "dbms/storage/buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
 #include <cstring>
 #include <deque>
 #include <memory>
 #include <mutex>
+#include <new>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
+#include "dbms/storage/io/file.h"
+#include "dbms/storage/metrics.h"
 #include "dbms/storage/page/page.h"
 #include "internal/buffer/frame.h"
+#include "internal/buffer/frame_arena.h"
 #include "internal/buffer/page_table.h"
 #include "internal/buffer/clock_replacer.h"
 #include "internal/buffer/lruk_replacer.h"
+#include "internal/page/page_checksum.h"
+#include "internal/segment/cold_segment.h"
+#include "internal/util/hash.h"
+#include "internal/util/numa.h"
 
 namespace dbms {
 namespace storage {
 
 // -------------------- 内部实现（Pimpl） --------------------
 
+using FlushCallback = std::function<void(seg_id_t, page_id_t, uint64_t)>;
+
+namespace {
+
+constexpr uint32_t kHotSetMagic   = 0x544F4844;  // "DHOT"
+constexpr uint32_t kHotSetVersion = 1;
+
+/// 热集文件头；其后为 count 个 HotSetEntry（最热在前）
+struct HotSetHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t page_size;
+  uint32_t reserved;
+  uint64_t count;
+  uint64_t checksum;   // 全部条目的 FNV-1a
+};
+
+struct HotSetEntry {
+  seg_id_t  seg;
+  page_id_t pid;
+};
+
+}  // namespace
+
+/**
+ * 分区计数：修改总在持有该分区锁时进行（写者已被串行化），故用 relaxed 读改写而非原子加；
+ * 读取端（GetStats）无需加锁，多个统计项之间不保证是同一时刻的值。
+ */
+template <class T>
+class LockedCounter {
+public:
+  T operator++(int) noexcept { const T x = v_.load(std::memory_order_relaxed); v_.store(x + 1, std::memory_order_relaxed); return x; }
+  T operator--(int) noexcept { const T x = v_.load(std::memory_order_relaxed); v_.store(x - 1, std::memory_order_relaxed); return x; }
+  T operator++() noexcept { const T x = v_.load(std::memory_order_relaxed) + 1; v_.store(x, std::memory_order_relaxed); return x; }
+  operator T() const noexcept { return Get(); }
+  T    Get() const noexcept { return v_.load(std::memory_order_relaxed); }
+  void Set(T x) noexcept { v_.store(x, std::memory_order_relaxed); }
+
+private:
+  std::atomic<T> v_{0};
+};
+
+/// 与 BufferStats 的累计项同名，使记录点写法不变
+struct PartitionCounters {
+  LockedCounter<uint64_t> hits, misses, evictions, flushes, bg_flushes, evict_writebacks;
+  LockedCounter<uint64_t> prefetches, prefetch_hits, ring_reuses, checksum_failures;
+
+  void Reset() noexcept {
+    for (auto* c : {&hits, &misses, &evictions, &flushes, &bg_flushes, &evict_writebacks,
+                    &prefetches, &prefetch_hits, &ring_reuses, &checksum_failures}) {
+      c->Set(0);
+    }
+  }
+};
+
+/**
+ * 分区：拥有连续的一段帧 [base, base+count)，以及独立的 page table / free list / 替换器。
+ * 替换器内使用分区内局部帧号（fid - base）。
+ */
+struct Partition {
+  int                        base{0};
+  int                        count{0};
+  int                        node{-1};   // 帧内存所在的 NUMA 节点（-1 = 未绑定）
+  PageTable                  table;      // (seg, page_id) -> 全局 frame_id
+  std::deque<int>            free_list;  // 全局 frame_id
+  std::unique_ptr<IReplacer> replacer;
+  PartitionCounters          stats;
+  LockedCounter<int>         dirty_count;     // 当前脏帧数
+  int                        max_dirty{0};    // 超过即需要后台写回（由 clean_ratio 推导）
+  int                        io_pins{0};      // 仅因写回而被临时固定的帧数（写完即释放）
+  std::deque<int>            ring;            // 批量读（扫描）专用的环形缓冲帧，最老的在前
+  LockedCounter<size_t>      ring_size;       // ring.size() 的镜像，供 GetStats 免锁读取
+  int                        ring_cap{0};     // 环的容量上限（0 = 关闭）
+
+  mutable std::mutex         mu;
+  std::condition_variable    io_cv;      // 等待帧上的 I/O 完成
+};
+
 struct BufferPoolManager::Impl {
-  explicit Impl(int num_frames, uint32_t page_size, DiskManager* disk, std::unique_ptr<IReplacer> r)
-      : frames(num_frames), num_frames(num_frames), page_size(page_size), disk(disk), replacer(std::move(r)) {
-    // 预分配一整块连续内存作为“页池”
-    arena.resize(static_cast<size_t>(num_frames) * page_size, 0);
+  Impl(int num_frames, uint32_t page_size, SegmentManager* sm,
+       const ReplacerFactory& make_replacer, int num_partitions, const PoolMemoryOptions& mem)
+      : frames(num_frames), frame2part(num_frames, 0), num_frames(num_frames),
+        page_size(page_size), sm(sm) {
+    // 预分配一整块连续、按页对齐的内存作为“页池”（O_DIRECT 可直接读写帧）；此时尚未触碰任何页
+    if (!arena.Allocate(static_cast<size_t>(num_frames) * page_size, mem.hugepages, mem.hugetlb)) {
+      throw std::bad_alloc();
+    }
     for (int i = 0; i < num_frames; ++i) {
       frames[i].Reset(arena.data() + static_cast<size_t>(i) * page_size);
-      free_list.push_back(i);
     }
+
+    // 均分帧到各分区（前 rem 个分区各多 1 帧）
+    const int n   = std::max(1, std::min(num_partitions, num_frames));
+    const int per = num_frames / n;
+    const int rem = num_frames % n;
+    int base = 0;
+    parts.reserve(static_cast<size_t>(n));
+    for (int p = 0; p < n; ++p) {
+      auto part   = std::make_unique<Partition>();
+      part->base  = base;
+      part->count = per + (p < rem ? 1 : 0);
+      part->replacer = make_replacer(part->count);
+      for (int i = 0; i < part->count; ++i) {
+        part->free_list.push_back(base + i);
+        frame2part[base + i] = p;
+      }
+      base += part->count;
+      parts.push_back(std::move(part));
+    }
+
+    // 分区 p 的帧优先放在节点 p % nodes：须在首次触碰（含下面的缓冲区登记）之前设定
+    if (mem.numa) {
+      const int nodes = NumaNodeCount();
+      for (size_t p = 0; p < parts.size(); ++p) {
+        Partition& P = *parts[p];
+        const int node = static_cast<int>(p % static_cast<size_t>(nodes));
+        if (arena.BindToNode(static_cast<size_t>(P.base) * page_size,
+                             static_cast<size_t>(P.count) * page_size, node)) {
+          P.node = node;
+        }
+      }
+    }
+
+    // 页池登记为 I/O 后端的固定缓冲区（io_uring 可免去每次 I/O 的页映射；失败不影响正确性）
+    if (sm && !arena.empty()) (void)sm->io_backend()->RegisterBuffer(arena.data(), arena.size());
+  }
+
+  Partition& PartOf(PageKey key) {
+    // 乘法散列：打散相邻页号与段号，避免跨步访问集中在同一分区
+    const uint64_t h = key * 0x9E3779B97F4A7C15ull;
+    return *parts[((h >> 32) * parts.size()) >> 32];
+  }
+  Partition& PartOfFrame(frame_id_t fid) { return *parts[frame2part[fid]]; }
+
+  /// 写回一页（在分区锁之外调用）：先触发 WAL 回调，再写入校验和、经段路由落盘
+  Status WriteBack(seg_id_t seg, page_id_t pid, std::uint8_t* data) {
+    if (checksums.load(std::memory_order_relaxed)) StampPageChecksum(data, page_size);
+    if (auto cb = std::atomic_load(&flush_cb); cb && *cb) {
+      const auto* hdr = reinterpret_cast<const PageHeader*>(data);
+      (*cb)(seg, pid, hdr->page_lsn);
+    }
+    DiskManager* disk = sm ? sm->GetDisk(seg) : nullptr;
+    if (!disk) return Status::IOError("WriteBack: unknown segment " + std::to_string(seg));
+    if (sm->IsCold(seg)) return Status::IOError("WriteBack: segment " + std::to_string(seg) + " is cold (read-only)");
+    return disk->WritePage(pid, data);
   }
 
+  Status ReadIn(seg_id_t seg, page_id_t pid, std::uint8_t* data) {
+    DiskManager* disk = sm ? sm->GetDisk(seg) : nullptr;
+    if (!disk) return Status::NotFound("ReadIn: unknown segment " + std::to_string(seg));
+    // 冷段：从冷段文件读出压缩映像，直接解压进帧；校验和覆盖的是解压后的页
+    const ColdSegment* cold = sm->GetColdSegment(seg);
+    Status s = cold ? cold->ReadPage(pid, data) : disk->ReadPage(pid, data);
+    if (s.ok() && !VerifyChecksum(data)) {
+      s = Status::Corruption("ReadIn: checksum mismatch at seg " + std::to_string(seg) +
+                             " page " + std::to_string(pid));
+    }
+    return s;
+  }
+
+  bool VerifyChecksum(const std::uint8_t* data) const {
+    return !checksums.load(std::memory_order_relaxed) || VerifyPageChecksum(data, page_size);
+  }
+
+  Status Load(Partition& P, std::unique_lock<std::mutex>& lk, seg_id_t seg, page_id_t pid,
+              bool zero_fill, AccessMode mode, std::uint8_t** out_data);
+  int    AcquireFrame(Partition& P);
+  int    AcquireRingFrame(Partition& P);
+  bool   HasIdleRingFrame(const Partition& P) const {
+    for (frame_id_t fid : P.ring) {
+      if (frames[fid].pin_count == 0 && !frames[fid].io_in_progress) return true;
+    }
+    return false;
+  }
+  void   RemoveFromRing(Partition& P, frame_id_t fid);
+  void   SetRingCap(Partition& P, int cap);
+  void   FinishPrefetch(frame_id_t fid, const Status& st);
+
+  // 替换器只跟踪普通帧；环形缓冲中的帧由环自己轮换，不参与 CLOCK/LRU-K 的竞争
+  void ReplPin(Partition& P, frame_id_t fid)   { if (!frames[fid].in_ring) P.replacer->Pin(fid - P.base); }
+  void ReplUnpin(Partition& P, frame_id_t fid) { if (!frames[fid].in_ring) P.replacer->Unpin(fid - P.base); }
+  /// 一次命中访问（Fetch 命中）；写回等内部临时固定不计
+  void ReplAccess(Partition& P, frame_id_t fid) { if (!frames[fid].in_ring) P.replacer->RecordAccess(fid - P.base); }
+  /// 由页指针反查帧号（帧数据是页池中按序排列的切片）
+  frame_id_t FrameOf(const std::uint8_t* data) const {
+    return static_cast<frame_id_t>(static_cast<size_t>(data - arena.data()) / page_size);
+  }
+  /// 帧装入新页（或从扫描环转入替换器）：对替换器而言是该页的第一次访问
+  void ReplLoad(Partition& P, frame_id_t fid, PageKey key) {
+    if (!frames[fid].in_ring) P.replacer->RecordLoad(fid - P.base, key);
+  }
+
+  /// 分区暂无可用帧、但有帧只是被写回临时固定时等待其释放（持有 P.mu）；发生过等待返回 true
+  bool WaitForFrame(Partition& P, std::unique_lock<std::mutex>& lk) {
+    bool waited = false;
+    while (P.free_list.empty() && P.replacer->Size() == 0 && !HasIdleRingFrame(P) && P.io_pins > 0) {
+      P.io_cv.wait(lk);
+      waited = true;
+    }
+    return waited;
+  }
+  Status FlushFrame(Partition& P, std::unique_lock<std::mutex>& lk, frame_id_t fid);
+
+  StorageMetrics* Metrics() const noexcept { return metrics.load(std::memory_order_relaxed); }
+  /// 前台取分区锁：先试一次，未能立即取得时（且挂接了观测）记录阻塞等待的时长
+  std::unique_lock<std::mutex> LockPartition(Partition& P) {
+    std::unique_lock<std::mutex> lk(P.mu, std::try_to_lock);
+    if (!lk.owns_lock()) {
+      StorageMetrics* m = Metrics();
+      const uint64_t t0 = m ? MetricsNowNs() : 0;
+      lk.lock();
+      if (m) m->Record(Metric::kLockWait, MetricsNowNs() - t0);
+    }
+    return lk;
+  }
+
+  /// 修改帧的 dirty 标志并维护分区脏帧计数（持有 P.mu）
+  void SetDirty(Partition& P, Frame& f, bool dirty) {
+    if (f.dirty == dirty) return;
+    f.dirty = dirty;
+    if (!dirty) { P.dirty_count--; return; }
+    if (++P.dirty_count == P.max_dirty + 1 && bg_running.load(std::memory_order_relaxed)) {
+      bg_cv.notify_all();  // 越过阈值：提前唤醒后台写回
+    }
+  }
+
+  struct DirtyRef { PageKey key; frame_id_t fid; };
+  void   CollectDirty(Partition& P, bool unpinned_only, std::vector<DirtyRef>* out,
+                      seg_id_t only_seg = kInvalidSegId);
+  Status FlushSorted(std::vector<DirtyRef>* refs, bool background, bool no_wait = false);
+  void   WriterLoop(int idx, int nthreads);
+
   // 元数据
-  std::vector<std::uint8_t> arena;   // 页内存
+  FrameArena                arena;   // 页内存
   std::vector<Frame>        frames;  // 帧元信息
-  PageTable                 table;   // page_id -> frame_id
-  std::deque<int>           free_list;
+  std::vector<int>          frame2part;  // frame_id -> 分区下标
+  std::vector<std::unique_ptr<Partition>> parts;
   int                       num_frames{0};
   uint32_t                  page_size{0};
 
-  // 组件
-  DiskManager*              disk{nullptr};
-  std::unique_ptr<IReplacer> replacer;
+  // 组件：按段路由 I/O
+  SegmentManager*           sm{nullptr};
 
-  // 统计与锁
-  BufferStats               stats;
-  mutable std::mutex        mu;
+  // 刷盘回调（用于 WAL 对齐）：在写盘前调用；以 shared_ptr 原子替换，读取端无需加锁
+  std::shared_ptr<FlushCallback> flush_cb;
 
-  // 刷盘回调（用于 WAL 对齐）：在写盘前调用
-  std::function<void(page_id_t, uint64_t)> flush_cb;
-};
+  // 页校验和：写回时写入、未命中读入时校验
+  std::atomic<bool>         checksums{true};
 
-// -------------------- BPM 外部接口 --------------------
+  // 细粒度观测（延迟直方图）：未挂接时为空
+  std::atomic<StorageMetrics*> metrics{nullptr};
 
-BufferPoolManager::BufferPoolManager(int num_frames,
-                                     uint32_t page_size,
-                                     DiskManager* disk,
-                                     std::unique_ptr<IReplacer> replacer)
-    : p_(new Impl(num_frames, page_size, disk, std::move(replacer))),
-      num_frames_(num_frames),
-      page_size_(page_size) {}
+  // 缓存预热：热集文件路径（FlushAll / 析构时导出）与后台预热线程
+  mutable std::mutex        hot_mu;  // 保护 hot_path
+  std::string               hot_path;
+  std::thread               warmer;
+  std::mutex                warm_mu;
+  std::condition_variable   warm_cv;
+  bool                      warm_stop{false};
+  std::atomic<bool>         warm_running{false};
+  std::atomic<uint64_t>     warm_pages{0};
+  std::atomic<uint64_t>     warm_loaded{0};
+  std::atomic<uint64_t>     warm_skipped{0};
 
-BufferPoolManager::~BufferPoolManager() = default;
+  bool HasFreeFrame() const {
+    for (const auto& part : parts) {
+      std::lock_guard<std::mutex> g(part->mu);
+      if (!part->free_list.empty()) return true;
+    }
+    return false;
+  }
 
-// 查找 frame
-frame_id_t BufferPoolManager::LookupFrame(page_id_t pid) const {
-  frame_id_t fid = -1;
-  if (p_->table.Lookup(pid, &fid)) return fid;
-  return -1;
-}
+  // 后台写回
+  std::vector<std::thread>  writers;
+  std::mutex                bg_mu;
+  std::condition_variable   bg_cv;
+  bool                      bg_stop{false};
+  std::atomic<bool>         bg_running{false};
+  std::chrono::milliseconds bg_interval{50};
 
-// 选择用于装载 pid 的 frame；若需要淘汰，返回被逐出的旧 pid
-frame_id_t BufferPoolManager::AcquireFrameFor(page_id_t pid, page_id_t* evicted_pid) {
-   (void)pid; 
-  *evicted_pid = kInvalidPageId;
+  // 在途预读：析构前须等待全部完成（完成回调会访问分区与帧）
+  std::mutex                prefetch_mu;
+  std::condition_variable   prefetch_cv;
+  size_t                    prefetch_inflight{0};
+};
 
+// 选择一个空闲帧或受害者帧（持有 P.mu）；无可用帧返回 -1
+int BufferPoolManager::Impl::AcquireFrame(Partition& P) {
   // 优先用 free_list
-  if (!p_->free_list.empty()) {
-    int fid = p_->free_list.front();
-    p_->free_list.pop_front();
+  if (!P.free_list.empty()) {
+    int fid = P.free_list.front();
+    P.free_list.pop_front();
     return fid;
   }
-
   // 使用替换器找受害者
-  int victim = -1;
-  if (!p_->replacer->Victim(&victim)) return -1;
+  int local = -1;
+  StorageMetrics* m = Metrics();
+  const uint64_t steps0 = m ? P.replacer->ScanSteps() : 0;
+  const bool found = P.replacer->Victim(&local);
+  if (m) m->Record(Metric::kReplacerScan, P.replacer->ScanSteps() - steps0);
+  if (found) return P.base + local;
 
-  Frame& f = p_->frames[victim];
-  // 如果该帧持有旧页，先刷盘（如果脏）
-  if (f.page_id != kInvalidPageId) {
-    if (FlushFrame(victim)) {
-      p_->stats.flushes++;
+  // 普通帧都被占用：收回环中最老的空闲帧，避免扫描环“饿死”前台
+  for (size_t i = 0; i < P.ring.size(); ++i) {
+    const frame_id_t fid = P.ring[i];
+    const Frame& f = frames[fid];
+    if (f.pin_count == 0 && !f.io_in_progress) {
+      RemoveFromRing(P, fid);
+      return fid;
     }
-    // 从 page table 移除旧映射
-    p_->table.Erase(f.page_id);
-    *evicted_pid = f.page_id;
-    p_->stats.evictions++;
   }
-  return victim;
+  return -1;
 }
 
-bool BufferPoolManager::FlushFrame(frame_id_t fid) {
-  Frame& f = p_->frames[fid];
-  if (!f.dirty || f.page_id == kInvalidPageId) return false;
-
-  // 刷盘前回调（WAL 对齐），从 PageHeader 读取 page_lsn
-  auto* hdr = reinterpret_cast<PageHeader*>(f.data);
-  if (p_->flush_cb) {
-    p_->flush_cb(f.page_id, hdr->page_lsn);
+/**
+ * 批量读选帧（持有 P.mu）：环未满时照常取帧并纳入环；已满则复用环中最老的空闲帧，
+ * 使一次大扫描最多占用 ring_cap 个帧；环中帧都在使用时退回普通选帧（不纳入环）。
+ */
+int BufferPoolManager::Impl::AcquireRingFrame(Partition& P) {
+  if (static_cast<int>(P.ring.size()) < P.ring_cap) {
+    const int fid = AcquireFrame(P);
+    if (fid >= 0) {
+      frames[fid].in_ring = true;
+      P.ring.push_back(fid);
+      P.ring_size.Set(P.ring.size());
+    }
+    return fid;
+  }
+  for (size_t i = 0; i < P.ring.size(); ++i) {
+    const frame_id_t fid = P.ring[i];
+    const Frame& f = frames[fid];
+    if (f.pin_count == 0 && !f.io_in_progress) {
+      P.ring.erase(P.ring.begin() + static_cast<std::ptrdiff_t>(i));
+      P.ring.push_back(fid);
+      P.stats.ring_reuses++;
+      return fid;
+    }
   }
+  return AcquireFrame(P);
+}
 
-  if (!p_->disk) return false;
-  Status s = p_->disk->WritePage(f.page_id, f.data);
-  if (!s.ok()) return false;
+// 将帧移出环（持有 P.mu）；调用方负责之后把它交给替换器或 free list
+void BufferPoolManager::Impl::RemoveFromRing(Partition& P, frame_id_t fid) {
+  Frame& f = frames[fid];
+  if (!f.in_ring) return;
+  f.in_ring = false;
+  auto it = std::find(P.ring.begin(), P.ring.end(), fid);
+  if (it != P.ring.end()) P.ring.erase(it);
+  P.ring_size.Set(P.ring.size());
+}
 
-  f.dirty = false;
-  return true;
+// 调整环容量（持有 P.mu）：超出部分的空闲帧交还替换器
+void BufferPoolManager::Impl::SetRingCap(Partition& P, int cap) {
+  P.ring_cap = cap;
+  while (static_cast<int>(P.ring.size()) > cap) {
+    const frame_id_t fid = P.ring.front();
+    RemoveFromRing(P, fid);
+    const Frame& f = frames[fid];
+    if (f.pin_count == 0 && !f.io_in_progress) ReplUnpin(P, fid);
+  }
 }
 
-Status BufferPoolManager::FetchPage(page_id_t pid, std::uint8_t** out_data) {
-  if (!out_data) return Status::InvalidArgument("FetchPage: out_data=null");
+/**
+ * 预读完成（可能在 I/O 后端线程中执行；调用时不持有任何锁）：
+ * 成功则帧成为未固定的候选；失败则撤销映射并回收帧。
+ */
+void BufferPoolManager::Impl::FinishPrefetch(frame_id_t fid, const Status& st) {
+  // 校验失败与读失败同样处理：丢弃这次预读，之后的 FetchPage 会重读并报告 Corruption
+  const bool ok = st.ok() && VerifyChecksum(frames[fid].data);
+  {
+    Partition& P = PartOfFrame(fid);
+    std::lock_guard<std::mutex> g(P.mu);
+    Frame& f = frames[fid];
+    f.io_in_progress = false;
+    if (!ok && st.ok()) P.stats.checksum_failures++;
+    if (ok) {
+      if (f.pin_count == 0) ReplUnpin(P, fid);
+    } else {
+      P.table.Erase(MakePageKey(f.seg_id, f.page_id));
+      RemoveFromRing(P, fid);
+      f.seg_id     = kInvalidSegId;
+      f.page_id    = kInvalidPageId;
+      f.prefetched = false;
+      P.free_list.push_front(fid);
+    }
+    P.io_cv.notify_all();
+  }
+  std::lock_guard<std::mutex> g(prefetch_mu);
+  if (--prefetch_inflight == 0) prefetch_cv.notify_all();
+}
 
-  std::lock_guard<std::mutex> g(p_->mu);
+/**
+ * 未命中装入（调用时持有 P.mu，返回时仍持有）：
+ *  1) 锁内选帧，并把新页映射到该帧、标记 io_in_progress；若受害者有旧页，
+ *     旧页映射暂时保留（同样指向 I/O 中的帧），使其并发获取者等待而不是读到旧盘数据；
+ *  2) 锁外写回脏受害者、读入新页；
+ *  3) 重新加锁后收尾并唤醒等待者。
+ */
+Status BufferPoolManager::Impl::Load(Partition& P, std::unique_lock<std::mutex>& lk,
+                                     seg_id_t seg, page_id_t pid, bool zero_fill,
+                                     AccessMode mode, std::uint8_t** out_data) {
+  const int fid = mode == AccessMode::kBulkRead ? AcquireRingFrame(P) : AcquireFrame(P);
+  if (fid < 0) return Status::Unavailable("FetchPage: no frame available");
 
-  // 命中：直接返回
-  if (int fid = LookupFrame(pid); fid >= 0) {
-    Frame& f = p_->frames[fid];
-    f.pin_count++;
-    p_->replacer->Pin(fid);
-    p_->stats.hits++;
-    *out_data = f.data;
-    return Status::OK();
+  Frame& f = frames[fid];
+  const seg_id_t  victim_seg   = f.seg_id;
+  const page_id_t victim_pid   = f.page_id;
+  const bool      has_victim   = f.page_id != kInvalidPageId;
+  const bool      victim_dirty = has_victim && f.dirty;
+  const PageKey   key          = MakePageKey(seg, pid);
+
+  f.pin_count      = 1;
+  f.prefetched     = false;
+  SetDirty(P, f, false);
+  f.io_in_progress = true;
+  P.table.Insert(key, fid);
+
+  lk.unlock();
+  Status ws;
+  if (victim_dirty) {
+    StorageMetrics* m = Metrics();
+    const uint64_t t0 = m ? MetricsNowNs() : 0;
+    ws = WriteBack(victim_seg, victim_pid, f.data);
+    if (m) m->Record(Metric::kEvictWriteback, MetricsNowNs() - t0);
   }
+  Status rs;
+  if (ws.ok()) {
+    if (zero_fill) std::memset(f.data, 0, page_size);
+    else           rs = ReadIn(seg, pid, f.data);
+  }
+  lk.lock();
+
+  f.io_in_progress = false;
+  P.io_cv.notify_all();
 
-  // 未命中：需要装入
-  page_id_t evicted = kInvalidPageId;
-  int fid = AcquireFrameFor(pid, &evicted);
-  if (fid < 0) {
-    return Status::Unavailable("FetchPage: no frame available");
+  if (!ws.ok()) {
+    // 写回失败：放弃本次装入，恢复受害者（仍为脏，可再次被选中）
+    P.table.Erase(key);
+    f.pin_count = 0;
+    SetDirty(P, f, true);
+    ReplUnpin(P, fid);
+    return ws;
   }
 
-  Frame& f = p_->frames[fid];
+  if (has_victim) {
+    P.table.Erase(MakePageKey(victim_seg, victim_pid));
+    P.stats.evictions++;
+    if (victim_dirty) { P.stats.flushes++; P.stats.evict_writebacks++; }
+  }
 
-  // 从磁盘读取 pid（如果 pid 超出文件范围，返回 NotFound）
-  if (Status s = p_->disk->ReadPage(pid, f.data); !s.ok()) {
-    // 回收该 frame
-    f.page_id = kInvalidPageId;
+  if (!rs.ok()) {
+    // 读失败（如 pid 越界返回 NotFound）或校验失败：回收该帧
+    if (rs.code() == StatusCode::kCorruption) P.stats.checksum_failures++;
+    P.table.Erase(key);
+    RemoveFromRing(P, fid);
+    f.seg_id    = kInvalidSegId;
+    f.page_id   = kInvalidPageId;
     f.pin_count = 0;
-    f.dirty = false;
-    p_->free_list.push_front(fid);
-    return s;
+    P.free_list.push_front(fid);
+    return rs;
   }
 
+  f.seg_id  = seg;
   f.page_id = pid;
-  f.pin_count = 1;
-  f.dirty = false;
-  p_->table.Insert(pid, fid);
-  p_->replacer->Pin(fid);  // 新加载的页默认被固定，不可淘汰
-  p_->stats.misses++;
+  SetDirty(P, f, zero_fill);
+  ReplPin(P, fid);  // 新加载的页默认被固定，不可淘汰
+  ReplLoad(P, fid, key);
+  P.stats.misses++;
   *out_data = f.data;
   return Status::OK();
 }
 
-Status BufferPoolManager::NewPage(page_id_t* out_pid, std::uint8_t** out_data) {
+/**
+ * 写回某个常驻帧（调用时持有 P.mu，返回时仍持有）：
+ * 写盘期间临时固定该帧以防被淘汰；先清 dirty，写盘期间的新修改会重新置脏。
+ */
+Status BufferPoolManager::Impl::FlushFrame(Partition& P, std::unique_lock<std::mutex>& lk,
+                                           frame_id_t fid) {
+  Frame& f = frames[fid];
+  if (!f.dirty || f.io_in_progress || f.page_id == kInvalidPageId) return Status::OK();
+
+  const seg_id_t  seg = f.seg_id;
+  const page_id_t pid = f.page_id;
+  if (f.pin_count++ == 0) ReplPin(P, fid);
+  P.io_pins++;
+  SetDirty(P, f, false);
+
+  lk.unlock();
+  Status s;
+  {
+    // 写者持独占闩锁期间不写出半改的页；已被本函数固定，放开分区锁后帧不会易主
+    std::shared_lock<std::shared_mutex> latch(f.latch);
+    s = WriteBack(seg, pid, f.data);
+  }
+  lk.lock();
+
+  if (s.ok()) P.stats.flushes++;
+  else        SetDirty(P, f, true);
+  if (--f.pin_count == 0) ReplUnpin(P, fid);
+  P.io_pins--;
+  P.io_cv.notify_all();
+  return s;
+}
+
+// 收集分区内的脏帧（持有 P.mu）；only_seg 有效时只收该段的
+void BufferPoolManager::Impl::CollectDirty(Partition& P, bool unpinned_only,
+                                           std::vector<DirtyRef>* out, seg_id_t only_seg) {
+  for (int fid = P.base; fid < P.base + P.count; ++fid) {
+    const Frame& f = frames[fid];
+    if (!f.dirty || f.io_in_progress || f.page_id == kInvalidPageId) continue;
+    if (only_seg != kInvalidSegId && f.seg_id != only_seg) continue;
+    if (unpinned_only && f.pin_count > 0) continue;
+    out->push_back({MakePageKey(f.seg_id, f.page_id), fid});
+  }
+}
+
+/**
+ * 按 (seg, page_id) 升序写回；写前重新校验帧仍持有该页且为脏（后台写回还要求未固定）。
+ * 每次最多固定 kFlushBatch 个帧，按段成组经 DiskManager::ExecutePages 一次性提交，
+ * 使 io_uring 等后端能在一次系统调用中下发整批写请求。
+ * no_wait：被固定的帧不写、闩锁被占用的组不等待，两者都记为 Unavailable（帧保持为脏）。
+ */
+Status BufferPoolManager::Impl::FlushSorted(std::vector<DirtyRef>* refs, bool background, bool no_wait) {
+  constexpr size_t kFlushBatch = 32;
+  std::sort(refs->begin(), refs->end(),
+            [](const DirtyRef& a, const DirtyRef& b) { return a.key < b.key; });
+
+  Status first;
+  std::vector<frame_id_t>          batch;
+  std::vector<DiskManager::PageIo> ios;
+  std::vector<Status>              sts;
+  std::vector<frame_id_t>          latched;
+  batch.reserve(kFlushBatch);
+
+  // 写出 batch 中的帧（均已固定、已清 dirty），随后解固定；失败的帧重新置脏
+  auto drain = [&]() {
+    if (batch.empty()) return;
+    auto cb = std::atomic_load(&flush_cb);
+    sts.assign(batch.size(), Status::OK());
+    for (size_t lo = 0; lo < batch.size();) {
+      const seg_id_t seg = frames[batch[lo]].seg_id;
+      size_t hi = lo;
+      ios.clear();
+      for (; hi < batch.size() && frames[batch[hi]].seg_id == seg; ++hi) {
+        const Frame& f = frames[batch[hi]];
+        ios.push_back({IoOp::kWrite, f.page_id, f.data});
+      }
+      DiskManager* disk = sm ? sm->GetDisk(seg) : nullptr;
+      if (!disk || sm->IsCold(seg)) {
+        const Status e = Status::IOError("WriteBack: unknown or cold segment " + std::to_string(seg));
+        std::fill(sts.begin() + lo, sts.begin() + hi, e);
+      } else {
+        // 与 FlushFrame 相同：整组写盘期间持各帧的共享闩锁。写者可能同时持两个写闩锁
+        // （如索引分裂时的左右节点），所以这里只在一个也没持有时才阻塞等待：
+        // 遇到被占用的帧就放开已持有的，把它换到队首后从头再来
+        latched.assign(batch.begin() + lo, batch.begin() + hi);
+        bool busy = false;
+        for (size_t held = 0; held < latched.size();) {
+          std::shared_mutex& latch = frames[latched[held]].latch;
+          if (held == 0 && !no_wait) {
+            latch.lock_shared();
+            ++held;
+          } else if (latch.try_lock_shared()) {
+            ++held;
+          } else {
+            for (size_t i = 0; i < held; ++i) frames[latched[i]].latch.unlock_shared();
+            if (no_wait) { busy = true; break; }
+            std::rotate(latched.begin(), latched.begin() + static_cast<std::ptrdiff_t>(held), latched.end());
+            held = 0;
+          }
+        }
+        if (busy) {
+          const Status e = Status::Unavailable("WriteBack: page of segment " + std::to_string(seg) + " is latched");
+          std::fill(sts.begin() + lo, sts.begin() + hi, e);
+          lo = hi;
+          continue;
+        }
+        // WAL 回调与校验和都须在闩锁内：回调看到的 page_lsn 与校验和覆盖的正是落盘的页内容
+        if (cb && *cb) {
+          for (frame_id_t fid : latched) {
+            (*cb)(seg, frames[fid].page_id, reinterpret_cast<const PageHeader*>(frames[fid].data)->page_lsn);
+          }
+        }
+        if (checksums.load(std::memory_order_relaxed)) {
+          for (frame_id_t fid : latched) StampPageChecksum(frames[fid].data, page_size);
+        }
+        (void)disk->ExecutePages(ios.data(), ios.size(), sts.data() + lo);
+        for (frame_id_t fid : latched) frames[fid].latch.unlock_shared();
+      }
+      lo = hi;
+    }
+    for (size_t k = 0; k < batch.size(); ++k) {
+      const frame_id_t fid = batch[k];
+      Partition& P = PartOfFrame(fid);
+      std::lock_guard<std::mutex> g(P.mu);
+      Frame& f = frames[fid];
+      if (sts[k].ok()) {
+        P.stats.flushes++;
+        if (background) P.stats.bg_flushes++;
+      } else {
+        SetDirty(P, f, true);
+        if (first.ok()) first = sts[k];
+      }
+      if (--f.pin_count == 0) ReplUnpin(P, fid);
+      P.io_pins--;
+      P.io_cv.notify_all();
+    }
+    batch.clear();
+  };
+
+  for (const auto& r : *refs) {
+    {
+      Partition& P = PartOfFrame(r.fid);
+      std::lock_guard<std::mutex> g(P.mu);
+      Frame& f = frames[r.fid];
+      if (!f.dirty || f.io_in_progress || MakePageKey(f.seg_id, f.page_id) != r.key) continue;
+      if (background && f.pin_count > 0) continue;  // 收集后又被固定：留给下一轮
+      if (no_wait && f.pin_count > 0) {
+        if (first.ok()) first = Status::Unavailable("WriteBack: page " + std::to_string(f.page_id) + " is pinned");
+        continue;
+      }
+      // 写盘期间临时固定以防被淘汰；先清 dirty，写盘期间的新修改会重新置脏
+      if (f.pin_count++ == 0) ReplPin(P, r.fid);
+      P.io_pins++;
+      SetDirty(P, f, false);
+    }
+    batch.push_back(r.fid);
+    if (batch.size() == kFlushBatch) drain();
+  }
+  drain();
+  return first;
+}
+
+// 后台写回线程：负责下标满足 p % nthreads == idx 的分区
+void BufferPoolManager::Impl::WriterLoop(int idx, int nthreads) {
+  // 负责的分区都在同一 NUMA 节点上时，把线程绑到该节点：写回读取的是本地内存
+  int node = -2;
+  for (size_t p = static_cast<size_t>(idx); p < parts.size(); p += static_cast<size_t>(nthreads)) {
+    node = (node == -2 || node == parts[p]->node) ? parts[p]->node : -1;
+  }
+  if (node >= 0) (void)PinThreadToNumaNode(node);
+
+  std::vector<DirtyRef> refs;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> g(bg_mu);
+      bg_cv.wait_for(g, bg_interval, [this] { return bg_stop; });
+      if (bg_stop) return;
+    }
+    refs.clear();
+    for (size_t p = static_cast<size_t>(idx); p < parts.size(); p += static_cast<size_t>(nthreads)) {
+      Partition& P = *parts[p];
+      std::lock_guard<std::mutex> g(P.mu);
+      if (P.dirty_count > P.max_dirty) CollectDirty(P, /*unpinned_only=*/true, &refs);
+    }
+    if (!refs.empty()) (void)FlushSorted(&refs, /*background=*/true);
+  }
+}
+
+// -------------------- BPM 外部接口 --------------------
+
+// 把单个替换器包装成“只调用一次”的工厂（单分区构造使用）
+static BufferPoolManager::ReplacerFactory HandOver(std::unique_ptr<IReplacer> r) {
+  auto holder = std::make_shared<std::unique_ptr<IReplacer>>(std::move(r));
+  return [holder](int) { return std::move(*holder); };
+}
+
+BufferPoolManager::BufferPoolManager(int num_frames,
+                                     uint32_t page_size,
+                                     SegmentManager* sm,
+                                     std::unique_ptr<IReplacer> replacer)
+    : BufferPoolManager(num_frames, page_size, sm, HandOver(std::move(replacer)), 1) {}
+
+BufferPoolManager::BufferPoolManager(int num_frames,
+                                     uint32_t page_size,
+                                     SegmentManager* sm,
+                                     const ReplacerFactory& make_replacer,
+                                     int partitions,
+                                     bool hugepages)
+    : BufferPoolManager(num_frames, page_size, sm, make_replacer, partitions,
+                        PoolMemoryOptions{hugepages, false, false}) {}
+
+BufferPoolManager::BufferPoolManager(int num_frames,
+                                     uint32_t page_size,
+                                     SegmentManager* sm,
+                                     const ReplacerFactory& make_replacer,
+                                     int partitions,
+                                     const PoolMemoryOptions& mem)
+    : p_(new Impl(num_frames, page_size, sm, make_replacer, partitions, mem)),
+      num_frames_(num_frames),
+      page_size_(page_size) {
+  SetScanRingFrames(kDefaultScanRingFrames);
+}
+
+BufferPoolManager::~BufferPoolManager() {
+  StopWarmup();
+  StopBackgroundWriter();
+  {
+    std::unique_lock<std::mutex> lk(p_->prefetch_mu);
+    p_->prefetch_cv.wait(lk, [this] { return p_->prefetch_inflight == 0; });
+  }
+  std::string hot;
+  {
+    std::lock_guard<std::mutex> g(p_->hot_mu);
+    hot = p_->hot_path;
+  }
+  if (!hot.empty()) (void)SaveHotSet(hot);
+}
+
+Status BufferPoolManager::FlushSegment(seg_id_t seg, bool wait) {
+  std::vector<Impl::DirtyRef> refs;
+  for (auto& part : p_->parts) {
+    std::lock_guard<std::mutex> g(part->mu);
+    p_->CollectDirty(*part, /*unpinned_only=*/false, &refs, seg);
+  }
+  Status first = p_->FlushSorted(&refs, /*background=*/false, /*no_wait=*/!wait);
+
+  // 复查：后台写回或淘汰可能正写着本段的页（已清 dirty、尚未落盘），先等分区内的写回结束
+  for (auto& part : p_->parts) {
+    Partition& P = *part;
+    std::unique_lock<std::mutex> lk(P.mu);
+    P.io_cv.wait(lk, [&] { return P.io_pins == 0; });
+    for (int fid = P.base; fid < P.base + P.count; ++fid) {
+      const Frame& f = p_->frames[fid];
+      if (f.seg_id != seg || f.page_id == kInvalidPageId || !f.dirty) continue;
+      if (!first.ok()) return first;
+      return Status::Unavailable("FlushSegment: segment " + std::to_string(seg) + " still has dirty pages");
+    }
+  }
+  return first;
+}
+
+int BufferPoolManager::num_partitions() const noexcept {
+  return static_cast<int>(p_->parts.size());
+}
+
+const char* BufferPoolManager::memory_backing() const noexcept {
+  if (p_->arena.hugetlb()) return "hugetlb";
+  return p_->arena.hugepages() ? "thp" : "4k";
+}
+
+int BufferPoolManager::partition_node(int p) const noexcept {
+  if (p < 0 || p >= num_partitions()) return -1;
+  return p_->parts[static_cast<size_t>(p)]->node;
+}
+
+Status BufferPoolManager::FetchPage(seg_id_t seg, page_id_t pid, std::uint8_t** out_data) {
+  return FetchPage(seg, pid, out_data, AccessMode::kNormal);
+}
+
+Status BufferPoolManager::FetchPage(seg_id_t seg, page_id_t pid, std::uint8_t** out_data,
+                                    AccessMode mode) {
+  if (!out_data) return Status::InvalidArgument("FetchPage: out_data=null");
+
+  const PageKey key = MakePageKey(seg, pid);
+  Partition& P = p_->PartOf(key);
+  StorageMetrics* m = p_->Metrics();
+  const uint64_t t0 = m ? MetricsNowNs() : 0;
+  std::unique_lock<std::mutex> lk = p_->LockPartition(P);
+
+  // 命中：直接返回；若该帧正在 I/O，等待后重新查找（映射可能已变化）
+  frame_id_t fid = -1;
+  for (;;) {
+    if (P.table.Lookup(key, &fid)) {
+      Frame& f = p_->frames[fid];
+      if (f.io_in_progress) { P.io_cv.wait(lk); continue; }
+      // 预读装入时已向替换器报告过装入：第一次真正的访问不再重复计数
+      const bool was_prefetched = f.prefetched;
+      if (f.prefetched) { f.prefetched = false; P.stats.prefetch_hits++; }
+      // 普通访问命中扫描环中的页：说明它并非一次性数据，移出环、纳入替换器
+      const bool from_ring = f.in_ring && mode == AccessMode::kNormal;
+      if (from_ring) p_->RemoveFromRing(P, fid);
+      f.pin_count++;
+      p_->ReplPin(P, fid);
+      if (from_ring) p_->ReplLoad(P, fid, key);
+      else if (!was_prefetched) p_->ReplAccess(P, fid);
+      P.stats.hits++;
+      *out_data = f.data;
+      if (m) m->Record(Metric::kFetchHit, MetricsNowNs() - t0);
+      return Status::OK();
+    }
+    // 帧都被写回临时占用：等其释放后重新查找（期间该页可能已被他人装入）
+    if (!p_->WaitForFrame(P, lk)) break;
+  }
+
+  // 未命中：需要装入（如果 pid 超出文件范围，返回 NotFound）
+  Status s = p_->Load(P, lk, seg, pid, /*zero_fill=*/false, mode, out_data);
+  if (m && s.ok()) m->Record(Metric::kFetchMiss, MetricsNowNs() - t0);
+  return s;
+}
+
+Status BufferPoolManager::NewPage(seg_id_t seg, page_id_t* out_pid, std::uint8_t** out_data) {
   if (!out_pid || !out_data) return Status::InvalidArgument("NewPage: null out param");
-  std::lock_guard<std::mutex> g(p_->mu);
+  if (!p_->sm) return Status::IOError("NewPage: no segment manager");
 
-  page_id_t evicted = kInvalidPageId;
-  int fid = AcquireFrameFor(/*pid*/0, &evicted);
-  if (fid < 0) return Status::Unavailable("NewPage: no frame available");
+  const page_id_t pid = p_->sm->AllocatePage(seg);
+  if (pid == kInvalidPageId) return Status::Unavailable("NewPage: allocate page failed");
+
+  const PageKey key = MakePageKey(seg, pid);
+  Partition& P = p_->PartOf(key);
+  std::unique_lock<std::mutex> lk = p_->LockPartition(P);
+  (void)p_->WaitForFrame(P, lk);  // 新分配的页不会被他人装入，无需重新查找
+  if (Status s = p_->Load(P, lk, seg, pid, /*zero_fill=*/true, AccessMode::kNormal, out_data); !s.ok()) {
+    lk.unlock();
+    p_->sm->FreePage(seg, pid);
+    return s;
+  }
+  *out_pid = pid;
+  return Status::OK();
+}
 
-  // 分配新的 page_id：基于文件长度
-  const uint64_t count = p_->disk->PageCount();
-  const page_id_t pid  = static_cast<page_id_t>(count);
+Status BufferPoolManager::NewPageAt(seg_id_t seg, page_id_t pid, std::uint8_t** out_data) {
+  if (!out_data) return Status::InvalidArgument("NewPageAt: out_data=null");
 
-  std::memset(p_->frames[fid].data, 0, p_->page_size);
-  p_->frames[fid].page_id = pid;
-  p_->frames[fid].pin_count = 1;
-  p_->frames[fid].dirty = false;
-  p_->table.Insert(pid, fid);
-  p_->replacer->Pin(fid);
+  const PageKey key = MakePageKey(seg, pid);
+  Partition& P = p_->PartOf(key);
+  std::unique_lock<std::mutex> lk = p_->LockPartition(P);
+  frame_id_t fid = -1;
+  for (;;) {
+    if (P.table.Lookup(key, &fid)) {
+      Frame& f = p_->frames[fid];
+      if (f.io_in_progress) { P.io_cv.wait(lk); continue; }
+      // 预留页不含存活记录（从未写过，或是归还的空闲区段）：直接复用并覆盖
+      const bool from_ring = f.in_ring;
+      if (from_ring) p_->RemoveFromRing(P, fid);
+      f.prefetched = false;
+      f.pin_count++;
+      p_->ReplPin(P, fid);
+      if (from_ring) p_->ReplLoad(P, fid, key);
+      else p_->ReplAccess(P, fid);
+      // 并发扫描可能正乐观读该页：清零期间版本号为奇数。预留页没有写者，无需闩锁
+      f.version.fetch_add(1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      std::memset(f.data, 0, p_->page_size);
+      f.version.fetch_add(1, std::memory_order_release);
+      p_->SetDirty(P, f, true);
+      P.stats.hits++;
+      *out_data = f.data;
+      return Status::OK();
+    }
+    if (!p_->WaitForFrame(P, lk)) break;
+  }
+  return p_->Load(P, lk, seg, pid, /*zero_fill=*/true, AccessMode::kNormal, out_data);
+}
 
-  // 写一个空页到磁盘尾部，确保文件增长
-  (void)p_->disk->WritePage(pid, p_->frames[fid].data);
+Status BufferPoolManager::FetchPage(seg_id_t seg, page_id_t pid, ReadPageGuard* out,
+                                    AccessMode mode) {
+  if (!out) return Status::InvalidArgument("FetchPage: out=null");
+  std::uint8_t* data = nullptr;
+  if (Status s = FetchPage(seg, pid, &data, mode); !s.ok()) return s;
+  const frame_id_t fid = p_->FrameOf(data);
+  Frame& f = p_->frames[fid];
+  *out = ReadPageGuard(PageGuard(this, seg, pid, fid, data), &f.version, &f.latch);
+  return Status::OK();
+}
 
-  *out_pid  = pid;
-  *out_data = p_->frames[fid].data;
+Status BufferPoolManager::FetchPage(seg_id_t seg, page_id_t pid, WritePageGuard* out) {
+  if (!out) return Status::InvalidArgument("FetchPage: out=null");
+  std::uint8_t* data = nullptr;
+  if (Status s = FetchPage(seg, pid, &data); !s.ok()) return s;
+  *out = LatchForWrite(seg, pid, data);
   return Status::OK();
 }
 
-Status BufferPoolManager::UnpinPage(page_id_t pid, bool is_dirty) {
-  std::lock_guard<std::mutex> g(p_->mu);
-  int fid = LookupFrame(pid);
-  if (fid < 0) return Status::NotFound("UnpinPage: pid not in buffer");
+Status BufferPoolManager::NewPageAt(seg_id_t seg, page_id_t pid, WritePageGuard* out) {
+  if (!out) return Status::InvalidArgument("NewPageAt: out=null");
+  std::uint8_t* data = nullptr;
+  if (Status s = NewPageAt(seg, pid, &data); !s.ok()) return s;
+  *out = LatchForWrite(seg, pid, data);
+  return Status::OK();
+}
+
+WritePageGuard BufferPoolManager::LatchForWrite(seg_id_t seg, page_id_t pid, std::uint8_t* data) {
+  // 页已固定：在分区锁之外等待闩锁（持锁的写者解固定时还要拿分区锁）
+  const frame_id_t fid = p_->FrameOf(data);
+  Frame& f = p_->frames[fid];
+  f.latch.lock();
+  f.version.fetch_add(1, std::memory_order_relaxed);  // 奇数：读者随后的校验必然失败
+  std::atomic_thread_fence(std::memory_order_release);
+  return WritePageGuard(PageGuard(this, seg, pid, fid, data), &f.version, &f.latch);
+}
+
+Status BufferPoolManager::UnpinPage(seg_id_t seg, page_id_t pid, bool is_dirty) {
+  const PageKey key = MakePageKey(seg, pid);
+  frame_id_t fid = -1;
+  {
+    Partition& P = p_->PartOf(key);
+    std::lock_guard<std::mutex> g(P.mu);
+    if (!P.table.Lookup(key, &fid)) return Status::NotFound("UnpinPage: pid not in buffer");
+  }
   return UnpinFrame(fid, is_dirty);
 }
 
 Status BufferPoolManager::UnpinFrame(frame_id_t fid, bool is_dirty) {
+  if (fid < 0 || fid >= p_->num_frames) return Status::InvalidArgument("UnpinFrame: bad fid");
+  Partition& P = p_->PartOfFrame(fid);
+  std::unique_lock<std::mutex> lk = p_->LockPartition(P);
+
   Frame& f = p_->frames[fid];
   if (f.pin_count <= 0) return Status::InvalidArgument("UnpinFrame: pin_count <= 0");
 
   f.pin_count--;
-  f.dirty = f.dirty || is_dirty;
+  if (is_dirty) p_->SetDirty(P, f, true);
   if (f.pin_count == 0) {
-    p_->replacer->Unpin(fid);  // 可被替换
+    p_->ReplUnpin(P, fid);  // 可被替换（环形缓冲中的帧只在环内轮换）
   }
   return Status::OK();
 }
 
-Status BufferPoolManager::FlushPage(page_id_t pid) {
-  std::lock_guard<std::mutex> g(p_->mu);
-  int fid = LookupFrame(pid);
-  if (fid < 0) return Status::NotFound("FlushPage: pid not in buffer");
-  if (FlushFrame(fid)) p_->stats.flushes++;
-  return Status::OK();
+Status BufferPoolManager::FlushPage(seg_id_t seg, page_id_t pid) {
+  const PageKey key = MakePageKey(seg, pid);
+  Partition& P = p_->PartOf(key);
+  std::unique_lock<std::mutex> lk(P.mu);
+  frame_id_t fid = -1;
+  while (P.table.Lookup(key, &fid)) {
+    if (p_->frames[fid].io_in_progress) { P.io_cv.wait(lk); continue; }
+    return p_->FlushFrame(P, lk, fid);
+  }
+  return Status::NotFound("FlushPage: pid not in buffer");
+}
+
+Status BufferPoolManager::Prefetch(seg_id_t seg, page_id_t first, uint32_t count, AccessMode mode,
+                                   uint32_t* out_issued) {
+  return PrefetchRange(seg, first, count, mode, /*free_only=*/false, out_issued);
+}
+
+Status BufferPoolManager::PrefetchRange(seg_id_t seg, page_id_t first, uint32_t count,
+                                        AccessMode mode, bool free_only, uint32_t* out_issued) {
+  if (out_issued) *out_issued = 0;
+  DiskManager* disk = p_->sm ? p_->sm->GetDisk(seg) : nullptr;
+  if (!disk) return Status::NotFound("Prefetch: unknown segment " + std::to_string(seg));
+
+  const uint64_t pages = p_->sm->PageCount(seg);  // 高水位（内存中维护，无 fstat）
+  if (first >= pages || count == 0) return Status::OK();
+  const uint64_t last = std::min<uint64_t>(pages, static_cast<uint64_t>(first) + count);
+
+  // 锁内为每个未驻留的页占一帧并置 io_in_progress；脏受害者需要同步写回，预读直接跳过
+  auto fids = std::make_shared<std::vector<frame_id_t>>();
+  std::vector<DiskManager::PageIo> ios;
+  for (uint64_t p = first; p < last; ++p) {
+    const page_id_t pid = static_cast<page_id_t>(p);
+    const PageKey   key = MakePageKey(seg, pid);
+    Partition& P = p_->PartOf(key);
+    std::lock_guard<std::mutex> g(P.mu);
+
+    frame_id_t fid = -1;
+    if (P.table.Lookup(key, &fid)) continue;
+    if (free_only && P.free_list.empty()) continue;
+    fid = mode == AccessMode::kBulkRead ? p_->AcquireRingFrame(P) : p_->AcquireFrame(P);
+    if (fid < 0) continue;
+
+    Frame& f = p_->frames[fid];
+    if (f.page_id != kInvalidPageId) {
+      if (f.dirty) { p_->ReplUnpin(P, fid); continue; }  // 放回候选（环中帧仍留在环内）
+      P.table.Erase(MakePageKey(f.seg_id, f.page_id));
+      P.stats.evictions++;
+    }
+    f.seg_id         = seg;
+    f.page_id        = pid;
+    f.pin_count      = 0;
+    f.prefetched     = true;
+    f.io_in_progress = true;
+    P.table.Insert(key, fid);
+    p_->ReplLoad(P, fid, key);  // 预读也是装入；完成时 FinishPrefetch 再放回候选
+    P.stats.prefetches++;
+
+    fids->push_back(fid);
+    ios.push_back({IoOp::kRead, pid, f.data});
+  }
+  if (ios.empty()) return Status::OK();
+
+  {
+    std::lock_guard<std::mutex> g(p_->prefetch_mu);
+    p_->prefetch_inflight += ios.size();
+  }
+  Impl* impl = p_.get();
+  if (const ColdSegment* cold = p_->sm->GetColdSegment(seg)) {
+    // 冷段：相邻页的压缩数据一次读出，在本线程解压进帧（压缩后的读量小，不再交给异步后端）
+    std::vector<Status> sts(ios.size());
+    cold->ReadBatch(ios.data(), ios.size(), sts.data());
+    for (size_t i = 0; i < ios.size(); ++i) impl->FinishPrefetch((*fids)[i], sts[i]);
+    if (out_issued) *out_issued = static_cast<uint32_t>(ios.size());
+    return Status::OK();
+  }
+  Status s = disk->SubmitPages(ios.data(), ios.size(), [impl, fids](size_t i, const Status& st) {
+    impl->FinishPrefetch((*fids)[i], st);
+  });
+  if (out_issued) *out_issued = s.ok() ? static_cast<uint32_t>(ios.size()) : 0;
+  return s;
+}
+
+void BufferPoolManager::SetPageChecksums(bool on) {
+  p_->checksums.store(on, std::memory_order_relaxed);
+}
+
+bool BufferPoolManager::page_checksums() const noexcept {
+  return p_->checksums.load(std::memory_order_relaxed);
+}
+
+void BufferPoolManager::SetScanRingFrames(int frames) {
+  const int n = num_partitions();
+  for (auto& part : p_->parts) {
+    std::lock_guard<std::mutex> g(part->mu);
+    // 每分区均分，且不超过分区帧数的 1/4，保证前台始终有足够的普通帧
+    int cap = frames <= 0 ? 0 : (frames + n - 1) / n;
+    cap = std::min(cap, std::max(1, part->count / 4));
+    p_->SetRingCap(*part, cap);
+  }
 }
 
 void BufferPoolManager::FlushAll() {
-  std::lock_guard<std::mutex> g(p_->mu);
-  for (int fid = 0; fid < p_->num_frames; ++fid) {
-    (void)FlushFrame(fid);
+  std::vector<Impl::DirtyRef> refs;
+  for (auto& part : p_->parts) {
+    std::lock_guard<std::mutex> g(part->mu);
+    p_->CollectDirty(*part, /*unpinned_only=*/false, &refs);
+  }
+  (void)p_->FlushSorted(&refs, /*background=*/false);
+
+  std::string hot;
+  {
+    std::lock_guard<std::mutex> g(p_->hot_mu);
+    hot = p_->hot_path;
+  }
+  if (!hot.empty()) (void)SaveHotSet(hot);
+}
+
+Status BufferPoolManager::SaveHotSet(const std::string& path) const {
+  // 各分区的替换器时钟互不可比：分区内按热度排序，再按“分区内名次 / 分区条目数”交织，
+  // 使任一前缀都大致按比例覆盖各分区最热的页
+  struct Ranked { double rank; HotSetEntry e; };
+  std::vector<Ranked> all;
+  std::vector<std::pair<uint64_t, HotSetEntry>> local;
+  std::vector<uint64_t> score;
+  for (const auto& part : p_->parts) {
+    const Partition& P = *part;
+    local.clear();
+    {
+      std::lock_guard<std::mutex> g(P.mu);
+      score.assign(static_cast<size_t>(P.count), 0);
+      P.replacer->Hotness(&score);
+      for (int i = 0; i < P.count; ++i) {
+        const Frame& f = p_->frames[P.base + i];
+        // 扫描环中的页是一次性访问，预读后未被访问的页也谈不上热
+        if (f.page_id == kInvalidPageId || f.io_in_progress || f.in_ring || f.prefetched) continue;
+        const uint64_t s = f.pin_count > 0 ? ~uint64_t{0} : score[static_cast<size_t>(i)];
+        local.push_back({s, HotSetEntry{f.seg_id, f.page_id}});
+      }
+    }
+    std::stable_sort(local.begin(), local.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (size_t i = 0; i < local.size(); ++i) {
+      all.push_back({(static_cast<double>(i) + 0.5) / static_cast<double>(local.size()), local[i].second});
+    }
+  }
+  std::stable_sort(all.begin(), all.end(), [](const Ranked& a, const Ranked& b) { return a.rank < b.rank; });
+
+  std::vector<HotSetEntry> entries(all.size());
+  for (size_t i = 0; i < all.size(); ++i) entries[i] = all[i].e;
+  const size_t payload = entries.size() * sizeof(HotSetEntry);
+  HotSetHeader hdr{kHotSetMagic, kHotSetVersion, page_size_, 0,
+                   static_cast<uint64_t>(entries.size()), Fnv1a64(entries.data(), payload)};
+  std::vector<std::uint8_t> raw(sizeof(hdr) + payload);
+  std::memcpy(raw.data(), &hdr, sizeof(hdr));
+  if (payload) std::memcpy(raw.data() + sizeof(hdr), entries.data(), payload);
+
+  const std::string tmp = path + ".tmp";
+  {
+    File f(tmp);
+    Status s = f.Open(/*create_if_missing=*/true);
+    if (s.ok()) s = f.Resize(0);
+    if (s.ok()) s = f.WriteAt(raw.data(), raw.size(), 0);
+    if (s.ok()) s = f.Sync();
+    if (!s.ok()) return s;
+  }
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+    return Status::IOError("SaveHotSet: rename '" + tmp + "' failed");
+  }
+  return Status::OK();
+}
+
+void BufferPoolManager::SetHotSetFile(const std::string& path) {
+  std::lock_guard<std::mutex> g(p_->hot_mu);
+  p_->hot_path = path;
+}
+
+Status BufferPoolManager::StartWarmup(const std::string& path, const WarmupOptions& opt) {
+  StopWarmup();
+
+  File f(path);
+  if (!f.Open(/*create_if_missing=*/false).ok()) {
+    return Status::NotFound("StartWarmup: no hot set '" + path + "'");
+  }
+  const uint64_t bytes = f.SizeBytes();
+  HotSetHeader hdr{};
+  if (bytes < sizeof(hdr)) return Status::Corruption("StartWarmup: truncated hot set '" + path + "'");
+  std::vector<std::uint8_t> raw(static_cast<size_t>(bytes));
+  if (Status s = f.ReadAt(raw.data(), raw.size(), 0); !s.ok()) return s;
+  std::memcpy(&hdr, raw.data(), sizeof(hdr));
+  if (hdr.magic != kHotSetMagic || hdr.version != kHotSetVersion) {
+    return Status::Corruption("StartWarmup: bad hot set header");
+  }
+  if (hdr.page_size != page_size_) return Status::InvalidArgument("StartWarmup: page size mismatch");
+  const uint64_t payload = hdr.count * sizeof(HotSetEntry);
+  if (sizeof(hdr) + payload != bytes ||
+      Fnv1a64(raw.data() + sizeof(hdr), static_cast<size_t>(payload)) != hdr.checksum) {
+    return Status::Corruption("StartWarmup: hot set checksum mismatch");
+  }
+
+  // 最热在前：帧数之外的页装不下，直接截掉
+  std::vector<HotSetEntry> list(static_cast<size_t>(
+      std::min<uint64_t>(hdr.count, static_cast<uint64_t>(num_frames_))));
+  if (!list.empty()) std::memcpy(list.data(), raw.data() + sizeof(hdr), list.size() * sizeof(HotSetEntry));
+
+  p_->warm_pages.store(list.size(), std::memory_order_relaxed);
+  p_->warm_loaded.store(0, std::memory_order_relaxed);
+  p_->warm_skipped.store(0, std::memory_order_relaxed);
+  p_->warm_stop = false;
+  p_->warm_running.store(true, std::memory_order_relaxed);
+  p_->warmer = std::thread([this, list = std::move(list), opt]() mutable {
+    Impl& I = *p_;
+    const auto   t0    = std::chrono::steady_clock::now();
+    const size_t batch = std::max<uint32_t>(1, opt.batch_pages);
+    size_t done = 0;
+    while (done < list.size()) {
+      {
+        // 限速：已装入的页数不超过 pages_per_sec × 已用时间；停止请求可打断等待
+        std::unique_lock<std::mutex> lk(I.warm_mu);
+        if (opt.pages_per_sec > 0) {
+          const uint64_t loaded = I.warm_loaded.load(std::memory_order_relaxed);
+          const auto due = t0 + std::chrono::microseconds(loaded * 1000000 / opt.pages_per_sec);
+          I.warm_cv.wait_until(lk, due, [&I] { return I.warm_stop; });
+        }
+        if (I.warm_stop) break;
+      }
+      if (!I.HasFreeFrame()) break;  // 前台已占满缓冲池：再装就要淘汰，预热到此为止
+
+      // 批内按 (seg, page_id) 排序，连续页合并为一次批量预读
+      const size_t end = std::min(list.size(), done + batch);
+      std::sort(list.begin() + static_cast<std::ptrdiff_t>(done), list.begin() + static_cast<std::ptrdiff_t>(end),
+                [](const HotSetEntry& a, const HotSetEntry& b) {
+                  return a.seg != b.seg ? a.seg < b.seg : a.pid < b.pid;
+                });
+      for (size_t i = done; i < end;) {
+        size_t j = i + 1;
+        while (j < end && list[j].seg == list[i].seg && list[j].pid == list[j - 1].pid + 1) ++j;
+        uint32_t issued = 0;
+        (void)PrefetchRange(list[i].seg, list[i].pid, static_cast<uint32_t>(j - i), AccessMode::kNormal,
+                            /*free_only=*/true, &issued);
+        I.warm_loaded.fetch_add(issued, std::memory_order_relaxed);
+        I.warm_skipped.fetch_add(j - i - issued, std::memory_order_relaxed);
+        i = j;
+      }
+      done = end;
+    }
+    I.warm_skipped.fetch_add(list.size() - done, std::memory_order_relaxed);  // 提前结束：余下的不再装入
+    I.warm_running.store(false, std::memory_order_relaxed);
+  });
+  return Status::OK();
+}
+
+void BufferPoolManager::StopWarmup() {
+  if (!p_->warmer.joinable()) return;
+  {
+    std::lock_guard<std::mutex> g(p_->warm_mu);
+    p_->warm_stop = true;
   }
+  p_->warm_cv.notify_all();
+  p_->warmer.join();
+}
+
+void BufferPoolManager::StartBackgroundWriter(int threads, double clean_ratio, uint32_t interval_ms) {
+  StopBackgroundWriter();
+  if (threads <= 0) return;
+  threads = std::min(threads, num_partitions());
+  clean_ratio = std::min(1.0, std::max(0.0, clean_ratio));
+
+  for (auto& part : p_->parts) {
+    std::lock_guard<std::mutex> g(part->mu);
+    const int keep_clean = static_cast<int>(std::ceil(clean_ratio * part->count));
+    part->max_dirty = std::max(0, part->count - keep_clean);
+  }
+  {
+    std::lock_guard<std::mutex> g(p_->bg_mu);
+    p_->bg_stop     = false;
+    p_->bg_interval = std::chrono::milliseconds(std::max<uint32_t>(1, interval_ms));
+  }
+  p_->bg_running.store(true);
+  for (int t = 0; t < threads; ++t) {
+    p_->writers.emplace_back([this, t, threads] { p_->WriterLoop(t, threads); });
+  }
+}
+
+void BufferPoolManager::StopBackgroundWriter() {
+  if (p_->writers.empty()) return;
+  {
+    std::lock_guard<std::mutex> g(p_->bg_mu);
+    p_->bg_stop = true;
+  }
+  p_->bg_cv.notify_all();
+  for (auto& t : p_->writers) t.join();
+  p_->writers.clear();
+  p_->bg_running.store(false);
 }
 
 BufferStats BufferPoolManager::GetStats() const {
-  std::lock_guard<std::mutex> g(p_->mu);
-  return p_->stats;
+  BufferStats total;
+  for (const auto& part : p_->parts) {
+    total.hits      += part->stats.hits;
+    total.misses    += part->stats.misses;
+    total.evictions += part->stats.evictions;
+    total.flushes   += part->stats.flushes;
+    total.bg_flushes       += part->stats.bg_flushes;
+    total.evict_writebacks += part->stats.evict_writebacks;
+    total.dirty_frames     += static_cast<uint64_t>(part->dirty_count);
+    total.prefetches       += part->stats.prefetches;
+    total.prefetch_hits    += part->stats.prefetch_hits;
+    total.ring_reuses      += part->stats.ring_reuses;
+    total.ring_frames      += part->ring_size;
+    total.checksum_failures += part->stats.checksum_failures;
+  }
+  total.warmup_pages   = p_->warm_pages.load(std::memory_order_relaxed);
+  total.warmup_loaded  = p_->warm_loaded.load(std::memory_order_relaxed);
+  total.warmup_skipped = p_->warm_skipped.load(std::memory_order_relaxed);
+  total.warmup_running = p_->warm_running.load(std::memory_order_relaxed);
+  return total;
+}
+
+void BufferPoolManager::ResetStats() {
+  for (const auto& part : p_->parts) {
+    std::lock_guard<std::mutex> g(part->mu);
+    part->stats.Reset();
+  }
 }
 
-void BufferPoolManager::RegisterFlushCallback(std::function<void(page_id_t, uint64_t)> cb) {
-  std::lock_guard<std::mutex> g(p_->mu);
-  p_->flush_cb = std::move(cb);
+void BufferPoolManager::SetMetrics(StorageMetrics* metrics) noexcept {
+  p_->metrics.store(metrics, std::memory_order_relaxed);
+}
+
+StorageMetrics* BufferPoolManager::metrics() const noexcept { return p_->Metrics(); }
+
+void BufferPoolManager::RegisterFlushCallback(std::function<void(seg_id_t, page_id_t, uint64_t)> cb) {
+  std::atomic_store(&p_->flush_cb, std::make_shared<FlushCallback>(std::move(cb)));
 }
 
 }  // namespace storage
@@ -1,52 +1,101 @@
 #include "internal/buffer/clock_replacer.h"
 
+#include <algorithm>
+
 namespace dbms {
 namespace storage {
 
-ClockReplacer::ClockReplacer(int capacity)
-    : present_(capacity, 0), ref_(capacity, 0), cap_(capacity) {}
+ClockReplacer::ClockReplacer(int capacity) : cap_(std::max(0, capacity)) {
+  const int words = (cap_ + kWordBits - 1) / kWordBits;
+  present_.reset(new std::atomic<uint64_t>[words]);
+  ref_.reset(new std::atomic<uint8_t>[cap_]);
+  for (int w = 0; w < words; ++w) present_[w].store(0, std::memory_order_relaxed);
+  for (int i = 0; i < cap_; ++i) ref_[i].store(0, std::memory_order_relaxed);
+}
 
 void ClockReplacer::Pin(frame_id_t fid) {
   if (fid < 0 || fid >= cap_) return;
-  present_[fid] = 0;
-  ref_[fid] = 0;
+  const uint64_t mask = uint64_t{1} << (fid % kWordBits);
+  std::atomic<uint64_t>& word = present_[fid / kWordBits];
+  // 已不在候选集（例如已被 Victim 摘除）：只读一次，不写共享字
+  if (!(word.load(std::memory_order_relaxed) & mask)) return;
+  if (word.fetch_and(~mask, std::memory_order_acq_rel) & mask) {
+    size_.fetch_sub(1, std::memory_order_relaxed);
+  }
 }
 
 void ClockReplacer::Unpin(frame_id_t fid) {
   if (fid < 0 || fid >= cap_) return;
-  present_[fid] = 1;
-  ref_[fid] = 1;  // 新近释放，给一次“保留”
+  ref_[fid].store(1, std::memory_order_relaxed);  // 新近释放，给一次“保留”
+  const uint64_t mask = uint64_t{1} << (fid % kWordBits);
+  if (!(present_[fid / kWordBits].fetch_or(mask, std::memory_order_acq_rel) & mask)) {
+    size_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void ClockReplacer::RecordAccess(frame_id_t fid) {
+  if (fid < 0 || fid >= cap_) return;
+  ref_[fid].store(1, std::memory_order_relaxed);
 }
 
 bool ClockReplacer::Victim(frame_id_t* out) {
   if (!out) return false;
-  if (cap_ == 0) return false;
+  if (cap_ == 0 || size_.load(std::memory_order_acquire) == 0) return false;
 
-  // 防止极端死循环：扫描上限 2 * cap_
-  int scanned = 0;
-  const int limit = cap_ * 2;
+  const uint64_t cap = static_cast<uint64_t>(cap_);
+  // 防止极端死循环：扫描上限 2 * cap_（按位置计，整组跳过的帧同样计入）
+  const uint64_t limit = cap * 2;
+  uint64_t scanned = 0;
+  uint64_t raw = hand_.load(std::memory_order_relaxed);
   while (scanned < limit) {
-    if (present_[hand_]) {
-      if (ref_[hand_] == 0) {
-        *out = hand_;
-        present_[hand_] = 0;
-        ref_[hand_] = 0;
-        hand_ = (hand_ + 1) % cap_;
-        return true;
-      } else {
-        ref_[hand_] = 0;
-      }
+    const uint64_t pos = raw % cap;
+    // 在本地连续跳过没有候选的字（至多到环尾），找到候选后只做一次 CAS 占下整段
+    uint64_t at = pos;
+    uint64_t bits = present_[at / kWordBits].load(std::memory_order_acquire) >> (at % kWordBits);
+    while (bits == 0) {
+      at = (at / kWordBits + 1) * kWordBits;
+      if (at >= cap) break;
+      bits = present_[at / kWordBits].load(std::memory_order_acquire);
+    }
+    const uint64_t step = bits == 0 ? cap - pos
+                                    : at - pos + static_cast<uint64_t>(__builtin_ctzll(bits)) + 1;
+    if (!hand_.compare_exchange_weak(raw, raw + step, std::memory_order_relaxed)) continue;  // raw 已更新
+    raw += step;
+    scanned += step;
+    if (bits == 0) continue;
+
+    const uint64_t fid = pos + step - 1;
+    if (ref_[fid].load(std::memory_order_relaxed)) {
+      ref_[fid].store(0, std::memory_order_relaxed);
+      continue;
+    }
+    // 只有真正清掉候选位的线程得到该帧（与并发的 Pin/Victim 竞争）
+    const uint64_t mask = uint64_t{1} << (fid % kWordBits);
+    if (present_[fid / kWordBits].fetch_and(~mask, std::memory_order_acq_rel) & mask) {
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      scan_steps_.fetch_add(scanned, std::memory_order_relaxed);
+      *out = static_cast<frame_id_t>(fid);
+      return true;
     }
-    hand_ = (hand_ + 1) % cap_;
-    ++scanned;
   }
+  scan_steps_.fetch_add(scanned, std::memory_order_relaxed);
   return false;
 }
 
 int ClockReplacer::Size() const {
-  int s = 0;
-  for (int i = 0; i < cap_; ++i) s += present_[i] ? 1 : 0;
-  return s;
+  return size_.load(std::memory_order_relaxed);
+}
+
+void ClockReplacer::Hotness(std::vector<uint64_t>* out) const {
+  if (!out || cap_ == 0) return;
+  // 指针刚扫过的帧要等一整圈才会再被检查；引用位为 1 的还能再躲过一圈
+  const uint64_t cap  = static_cast<uint64_t>(cap_);
+  const uint64_t hand = hand_.load(std::memory_order_relaxed) % cap;
+  const size_t   n    = std::min(out->size(), static_cast<size_t>(cap_));
+  for (size_t i = 0; i < n; ++i) {
+    const uint64_t dist = (i + cap - hand) % cap;
+    (*out)[i] = ref_[i].load(std::memory_order_relaxed) ? cap + dist : dist;
+  }
 }
 
 }  // namespace storage
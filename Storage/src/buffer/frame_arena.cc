@@ -0,0 +1,85 @@
+/**
+ * @file frame_arena.cc
+ * @brief FrameArena 实现（Linux mmap / madvise）。
+ */
+
+#include "internal/buffer/frame_arena.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "internal/util/numa.h"
+
+namespace dbms {
+namespace storage {
+
+static constexpr size_t kHugePageSize = size_t{2} << 20;  // x86-64 / aarch64 常见 PMD 大页
+
+FrameArena::~FrameArena() { Release(); }
+
+void FrameArena::Release() {
+  if (map_) ::munmap(map_, map_len_);
+  data_ = nullptr; size_ = 0; map_ = nullptr; map_len_ = 0; huge_ = false; hugetlb_ = false;
+}
+
+size_t FrameArena::granule() const noexcept {
+  if (huge_) return kHugePageSize;
+  const long ps = ::sysconf(_SC_PAGESIZE);
+  return ps > 0 ? static_cast<size_t>(ps) : size_t{4096};
+}
+
+bool FrameArena::Allocate(size_t bytes, bool hugepages, bool hugetlb) {
+  Release();
+  if (bytes == 0) return true;
+
+#ifdef MAP_HUGETLB
+  // 预留大页：内核保证 2 MiB 对齐，长度须为大页整数倍；大页不足时 mmap 失败，退化为透明大页
+  if (hugetlb) {
+    const size_t span = (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    void* m = ::mmap(nullptr, span, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (m != MAP_FAILED) {
+      map_ = m; map_len_ = span;
+      data_ = static_cast<std::uint8_t*>(m);
+      size_ = bytes;
+      huge_ = hugetlb_ = true;
+      return true;
+    }
+    hugepages = true;
+  }
+#endif
+
+  // 大页需按 2 MiB 对齐：长度取整到大页，并多映射一个大页的余量以便对齐起始地址
+  const size_t align = hugepages ? kHugePageSize : 0;
+  const size_t span  = align ? (bytes + align - 1) / align * align : bytes;
+  map_len_ = span + align;
+  map_ = ::mmap(nullptr, map_len_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map_ == MAP_FAILED) { map_ = nullptr; map_len_ = 0; return false; }
+
+  auto* base = static_cast<std::uint8_t*>(map_);
+  if (align) {
+    const uintptr_t a = (reinterpret_cast<uintptr_t>(base) + align - 1) & ~(uintptr_t{align} - 1);
+    base = reinterpret_cast<std::uint8_t*>(a);
+#ifdef MADV_HUGEPAGE
+    huge_ = ::madvise(base, span, MADV_HUGEPAGE) == 0;
+#endif
+  }
+  data_ = base;
+  size_ = bytes;
+  return true;
+}
+
+bool FrameArena::BindToNode(size_t offset, size_t len, int node) {
+  if (!data_ || offset >= size_) return false;
+  const size_t g     = granule();
+  const size_t limit = (size_ + g - 1) / g * g;  // 映射内可绑定的上界
+  const size_t lo    = std::min(limit, (offset + g - 1) / g * g);
+  const size_t hi    = std::min(limit, (offset + len + g - 1) / g * g);
+  if (hi <= lo) return true;  // 区间落在前一段的取整范围内：由它决定放置
+  return PreferNumaNode(data_ + lo, hi - lo, node);
+}
+
+}  // namespace storage
+}  // namespace dbms
@@ -1,62 +1,150 @@
 #include "internal/buffer/lruk_replacer.h"
 
-#include <limits>
+#include <algorithm>
 
 namespace dbms {
 namespace storage {
 
-LruKReplacer::LruKReplacer(int capacity, int k) : entries_(capacity), cap_(capacity), k_(k) {
-  for (auto& e : entries_) e.k = k_;
+LruKReplacer::LruKReplacer(int capacity, int k, uint64_t correlated_period)
+    : entries_(static_cast<size_t>(std::max(0, capacity))),
+      cap_(std::max(0, capacity)),
+      k_(std::max(1, k)),
+      crp_(correlated_period) {
+  hist_.assign(static_cast<size_t>(cap_) * k_, 0);
+  heap_.reserve(static_cast<size_t>(cap_));
+}
+
+uint64_t LruKReplacer::Oldest(frame_id_t fid) const {
+  const Entry& e = entries_[fid];
+  if (e.count == 0) return 0;
+  const uint32_t idx = (e.head + k_ - (e.count - 1)) % k_;
+  return hist_[static_cast<size_t>(fid) * k_ + idx];
+}
+
+bool LruKReplacer::Less(frame_id_t a, frame_id_t b) const {
+  // 访问不足 K 次（后向 K 距离为无穷）的帧排在前面
+  const bool fa = entries_[a].count >= static_cast<uint32_t>(k_);
+  const bool fb = entries_[b].count >= static_cast<uint32_t>(k_);
+  if (fa != fb) return !fa;
+  const uint64_t ta = Oldest(a), tb = Oldest(b);
+  if (ta != tb) return ta < tb;
+  return a < b;
+}
+
+void LruKReplacer::Place(int i, frame_id_t fid) {
+  heap_[i] = fid;
+  entries_[fid].heap_pos = i;
+}
+
+void LruKReplacer::SiftUp(int i) {
+  const frame_id_t fid = heap_[i];
+  while (i > 0) {
+    const int parent = (i - 1) / 2;
+    if (!Less(fid, heap_[parent])) break;
+    Place(i, heap_[parent]);
+    i = parent;
+  }
+  Place(i, fid);
+}
+
+void LruKReplacer::SiftDown(int i) {
+  const int n = static_cast<int>(heap_.size());
+  const frame_id_t fid = heap_[i];
+  for (;;) {
+    int child = 2 * i + 1;
+    if (child >= n) break;
+    if (child + 1 < n && Less(heap_[child + 1], heap_[child])) ++child;
+    if (!Less(heap_[child], fid)) break;
+    Place(i, heap_[child]);
+    i = child;
+  }
+  Place(i, fid);
+}
+
+void LruKReplacer::HeapErase(frame_id_t fid) {
+  const int i = entries_[fid].heap_pos;
+  entries_[fid].heap_pos = -1;
+  const frame_id_t last = heap_.back();
+  heap_.pop_back();
+  if (last == fid) return;
+  Place(i, last);
+  SiftUp(i);
+  SiftDown(entries_[last].heap_pos);
 }
 
 void LruKReplacer::Pin(frame_id_t fid) {
   if (fid < 0 || fid >= cap_) return;
-  entries_[fid].present = false;
+  std::lock_guard<std::mutex> g(mu_);
+  if (entries_[fid].heap_pos >= 0) HeapErase(fid);
 }
 
 void LruKReplacer::Unpin(frame_id_t fid) {
   if (fid < 0 || fid >= cap_) return;
-  entries_[fid].present = true;
-  Touch(fid);
+  std::lock_guard<std::mutex> g(mu_);
+  if (entries_[fid].heap_pos >= 0) return;
+  heap_.push_back(fid);
+  SiftUp(static_cast<int>(heap_.size()) - 1);
 }
 
-bool LruKReplacer::Victim(frame_id_t* out) {
-  if (!out) return false;
+void LruKReplacer::RecordAccess(frame_id_t fid) {
+  if (fid < 0 || fid >= cap_) return;
+  std::lock_guard<std::mutex> g(mu_);
+  AccessLocked(fid);
+}
+
+void LruKReplacer::RecordLoad(frame_id_t fid, uint64_t /*page_key*/) {
+  if (fid < 0 || fid >= cap_) return;
+  std::lock_guard<std::mutex> g(mu_);
+  Entry& e = entries_[fid];
+  e.count = 0;
+  e.head  = 0;
+  // 历史清空会让排序键变小：在堆中的帧需要上浮
+  AccessLocked(fid);
+  if (e.heap_pos >= 0) SiftUp(e.heap_pos);
+}
 
-  auto worst = Clock::now();
-  bool found = false;
-  frame_id_t fid_sel = -1;
-
-  for (frame_id_t i = 0; i < cap_; ++i) {
-    auto& e = entries_[i];
-    if (!e.present) continue;
-
-    // 取 K=2 的“倒数第二次访问时间”为比较依据；若没有，则退化为 last1。
-    auto key = (e.last2.time_since_epoch().count() != 0) ? e.last2 : e.last1;
-    if (!found || key < worst) {
-      found = true;
-      worst = key;
-      fid_sel = i;
-    }
+void LruKReplacer::AccessLocked(frame_id_t fid) {
+  const uint64_t now = ++now_;
+  Entry& e = entries_[fid];
+  uint64_t* h = &hist_[static_cast<size_t>(fid) * k_];
+  if (e.count > 0 && now - h[e.head] <= crp_) {
+    h[e.head] = now;  // 相关引用：只刷新最近一次
+  } else {
+    e.head = (e.head + 1) % k_;
+    h[e.head] = now;
+    if (e.count < static_cast<uint32_t>(k_)) ++e.count;
   }
+  // 访问只会让排序键变大（更晚被淘汰）
+  if (e.heap_pos >= 0) SiftDown(e.heap_pos);
+}
 
-  if (!found) return false;
-  entries_[fid_sel].present = false;
-  *out = fid_sel;
+bool LruKReplacer::Victim(frame_id_t* out) {
+  if (!out) return false;
+  std::lock_guard<std::mutex> g(mu_);
+  if (heap_.empty()) return false;
+  const frame_id_t fid = heap_.front();
+  HeapErase(fid);
+  scan_steps_.fetch_add(1, std::memory_order_relaxed);
+  *out = fid;
   return true;
 }
 
 int LruKReplacer::Size() const {
-  int s = 0;
-  for (const auto& e : entries_) s += e.present ? 1 : 0;
-  return s;
+  std::lock_guard<std::mutex> g(mu_);
+  return static_cast<int>(heap_.size());
 }
 
-void LruKReplacer::Touch(frame_id_t fid) {
-  auto now = Clock::now();
-  auto& e = entries_[fid];
-  e.last2 = e.last1;
-  e.last1 = now;
+void LruKReplacer::Hotness(std::vector<uint64_t>* out) const {
+  if (!out) return;
+  std::lock_guard<std::mutex> g(mu_);
+  // 与 Less 的次序相反：满 K 次的帧都热于不足 K 次的；同组内最早一次历史越新越热
+  const size_t n = std::min(out->size(), entries_.size());
+  for (size_t i = 0; i < n; ++i) {
+    const frame_id_t fid = static_cast<frame_id_t>(i);
+    if (entries_[i].count == 0) continue;
+    const bool full = entries_[i].count >= static_cast<uint32_t>(k_);
+    (*out)[i] = (full ? uint64_t{1} << 63 : 0) | Oldest(fid);
+  }
 }
 
 }  // namespace storage
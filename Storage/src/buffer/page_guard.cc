@@ -1,6 +1,8 @@
 #include "dbms/storage/buffer/page_guard.h"
 #include "dbms/storage/buffer/buffer_pool_manager.h"
 
+#include <thread>
+
 namespace dbms {
 namespace storage {
 
@@ -11,11 +13,33 @@ void PageGuard::Release() {
   // 由 BPM 进行实际的 unpin；guard 只传递“脏”标记与 frame id
   (void)bpm_->UnpinFrame(fid_, dirty_);
   bpm_   = nullptr;
+  seg_   = kInvalidSegId;
   pid_   = kInvalidPageId;
   fid_   = -1;
   data_  = nullptr;
   dirty_ = false;
 }
 
+std::uint64_t ReadPageGuard::WaitStable() const {
+  for (;;) {
+    // 写者在整个写期间持有独占闩锁：取一次共享锁即等到它离开，而不必空转
+    latch_->lock_shared();
+    latch_->unlock_shared();
+    const std::uint64_t v = version_->load(std::memory_order_acquire);
+    if ((v & 1) == 0) return v;
+    std::this_thread::yield();  // 不经闩锁的短暂写（如 NewPageAt 清零复用帧）
+  }
+}
+
+void WritePageGuard::Release() {
+  if (latch_) {
+    version_->fetch_add(1, std::memory_order_release);  // 回到偶数：此前的写对读者可见
+    latch_->unlock();
+    version_ = nullptr;
+    latch_   = nullptr;
+  }
+  guard_.Release();
+}
+
 }  // namespace storage
 }  // namespace dbms
@@ -0,0 +1,63 @@
+/**
+ * @file replacer_factory.cc
+ * @brief IReplacer::Create：解析替换器文本规格（见 replacer.h）。
+ */
+
+#include "dbms/storage/buffer/replacer.h"
+
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+
+#include "internal/buffer/arc_replacer.h"
+#include "internal/buffer/clock_replacer.h"
+#include "internal/buffer/lruk_replacer.h"
+
+namespace dbms {
+namespace storage {
+
+namespace {
+
+bool ParseU64(std::string_view s, uint64_t* out) {
+  if (s.empty()) return false;
+  auto [p, ec] = std::from_chars(s.data(), s.data() + s.size(), *out);
+  return ec == std::errc() && p == s.data() + s.size();
+}
+
+}  // namespace
+
+std::unique_ptr<IReplacer> IReplacer::Create(const std::string& spec, int capacity) {
+  const std::string_view sv(spec);
+  const size_t colon = sv.find(':');
+  const std::string_view name = sv.substr(0, colon);
+
+  // 参数：逗号分隔的 key=value；名称不接受的参数视为错误
+  uint64_t k = 2, crp = LruKReplacer::kDefaultCorrelatedPeriod;
+  bool has_params = false;
+  if (colon != std::string_view::npos) {
+    std::string_view rest = sv.substr(colon + 1);
+    while (!rest.empty()) {
+      const size_t comma = rest.find(',');
+      const std::string_view kv = rest.substr(0, comma);
+      rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+      const size_t eq = kv.find('=');
+      if (eq == std::string_view::npos) return nullptr;
+      const std::string_view key = kv.substr(0, eq);
+      uint64_t* dst = key == "k" ? &k : key == "crp" ? &crp : nullptr;
+      if (!dst || !ParseU64(kv.substr(eq + 1), dst)) return nullptr;
+      has_params = true;
+    }
+  }
+
+  if (name == "clock" && !has_params) return std::make_unique<ClockReplacer>(capacity);
+  if (name == "arc"   && !has_params) return std::make_unique<ArcReplacer>(capacity);
+  if (name == "lru"   && !has_params) return std::make_unique<LruKReplacer>(capacity, 1, 0);
+  if (name == "lruk") {
+    if (k == 0 || k > 64) return nullptr;
+    return std::make_unique<LruKReplacer>(capacity, static_cast<int>(k), crp);
+  }
+  return nullptr;
+}
+
+}  // namespace storage
+}  // namespace dbms
@@ -6,12 +6,18 @@
 #include "dbms/storage/io/disk_manager.h"
 
 #include <cerrno>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
 #include <cstring>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "internal/io/aligned_buffer.h"
+#include "internal/io/posix_io.h"
+
 namespace dbms {
 namespace storage {
 
@@ -21,21 +27,53 @@ static std::string ErrnoMessage(const char* op, const std::string& path) {
   return std::string(op) + "('" + path + "'): " + std::strerror(errno);
 }
 
+// 执行一次同步 I/O；挂接了观测时记录其耗时
+template <class Fn>
+static Status TimedIo(StorageMetrics* m, Metric what, Fn&& io) {
+  if (!m) return io();
+  const uint64_t t0 = MetricsNowNs();
+  Status s = io();
+  m->Record(what, MetricsNowNs() - t0);
+  return s;
+}
+
 // ======== File 实现（RAII POSIX 包装） ========
 
 File::~File() { Close(); }
 
-Status File::Open(bool create_if_missing) {
+Status File::Open(bool create_if_missing, bool direct) {
   if (Valid()) return Status::OK();
-  int flags = O_RDWR | (create_if_missing ? O_CREAT : 0);
-  int fd = ::open(path_.c_str(), flags, 0644);
+  const int flags = O_RDWR | (create_if_missing ? O_CREAT : 0);
+  int fd = -1;
+  if (direct) {
+    fd = ::open(path_.c_str(), flags | O_DIRECT, 0644);
+    if (fd >= 0) {
+      // 有的文件系统接受 O_DIRECT 的 open 却拒绝读写：用一次对齐读探测（空文件读到 EOF 也算通过）
+      AlignedBuffer probe(kDirectIoAlignment);
+      if (probe.data() && ::pread(fd, probe.data(), kDirectIoAlignment, 0) < 0 && errno == EINVAL) {
+        ::close(fd);
+        fd = -1;
+      }
+    } else if (errno != EINVAL) {
+      return Status::IOError(ErrnoMessage("open", path_));
+    }
+  }
+  const bool is_direct = fd >= 0;
+  if (fd < 0) fd = ::open(path_.c_str(), flags, 0644);
   if (fd < 0) {
     return Status::IOError(ErrnoMessage("open", path_));
   }
   fd_ = fd;
+  direct_.store(is_direct, std::memory_order_relaxed);
   return Status::OK();
 }
 
+void File::DisableDirect() const {
+  if (!direct_.exchange(false, std::memory_order_relaxed)) return;
+  const int fl = ::fcntl(fd_, F_GETFL);
+  if (fl >= 0) (void)::fcntl(fd_, F_SETFL, fl & ~O_DIRECT);
+}
+
 void File::Close() {
   if (fd_ >= 0) {
     ::close(fd_);
@@ -58,17 +96,44 @@ Status File::Resize(uint64_t new_size) {
   return Status::OK();
 }
 
-Status File::WriteAt(const void* buf, size_t n, uint64_t offset) {
+Status File::Allocate(uint64_t offset, uint64_t len) {
   if (fd_ < 0) return Status::IOError(ErrnoMessage("open", path_));
-  if (!buf && n > 0) return Status::InvalidArgument("WriteAt: buf=null");
+  if (len == 0) return Status::OK();
+  if (::fallocate(fd_, 0, static_cast<off_t>(offset), static_cast<off_t>(len)) == 0) {
+    return Status::OK();
+  }
+  // tmpfs 旧内核 / 部分网络文件系统不支持：退化为稀疏扩展
+  if (errno == EOPNOTSUPP || errno == ENOSYS) {
+    if (SizeBytes() >= offset + len) return Status::OK();
+    return Resize(offset + len);
+  }
+  return Status::IOError(ErrnoMessage("fallocate", path_));
+}
+
+Status File::PunchHole(uint64_t offset, uint64_t len) {
+  if (fd_ < 0) return Status::IOError(ErrnoMessage("open", path_));
+  if (len == 0) return Status::OK();
+  if (::fallocate(fd_, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                  static_cast<off_t>(offset), static_cast<off_t>(len)) == 0) {
+    return Status::OK();
+  }
+  if (errno == EOPNOTSUPP || errno == ENOSYS) return Status::Unavailable("punch hole not supported: " + path_);
+  return Status::IOError(ErrnoMessage("fallocate", path_));
+}
+
+// ======== 读满/写满循环（File 与 POSIX 后端共用） ========
+
+Status PosixWriteFull(int fd, const void* buf, size_t n, uint64_t offset, int* err) {
+  if (err) *err = 0;
   const std::uint8_t* p = reinterpret_cast<const std::uint8_t*>(buf);
   size_t   remain = n;
   off_t    off = static_cast<off_t>(offset);
   while (remain > 0) {
-    ssize_t w = ::pwrite(fd_, p, remain, off);
+    ssize_t w = ::pwrite(fd, p, remain, off);
     if (w < 0) {
       if (errno == EINTR) continue;
-      return Status::IOError(ErrnoMessage("pwrite", path_));
+      if (err) *err = errno;
+      return Status::IOError(std::string("pwrite: ") + std::strerror(errno));
     }
     p      += w;
     remain -= static_cast<size_t>(w);
@@ -77,27 +142,22 @@ Status File::WriteAt(const void* buf, size_t n, uint64_t offset) {
   return Status::OK();
 }
 
-Status File::ReadAt(void* buf, size_t n, uint64_t offset) const {
-  if (fd_ < 0) return Status::IOError(ErrnoMessage("open", path_));
-  if (!buf && n > 0) return Status::InvalidArgument("ReadAt: buf=null");
-
-  // 边界检查：若请求越过 EOF，直接返回 NotFound
-  const uint64_t size = SizeBytes();
-  if (offset + n > size) {
-    return Status::NotFound("ReadAt: range beyond EOF");
-  }
-
+Status PosixReadFull(int fd, void* buf, size_t n, uint64_t offset, int* err) {
+  if (err) *err = 0;
   std::uint8_t* p = reinterpret_cast<std::uint8_t*>(buf);
   size_t   remain = n;
   off_t    off = static_cast<off_t>(offset);
   while (remain > 0) {
-    ssize_t r = ::pread(fd_, p, remain, off);
+    ssize_t r = ::pread(fd, p, remain, off);
     if (r == 0) {
-      return Status::Corruption("ReadAt: unexpected EOF");
+      // 以 pread 返回 0 判断 EOF：整段越界为 NotFound，读到一半为 Corruption
+      return remain == n ? Status::NotFound("ReadAt: range beyond EOF")
+                         : Status::Corruption("ReadAt: unexpected EOF");
     }
     if (r < 0) {
       if (errno == EINTR) continue;
-      return Status::IOError(ErrnoMessage("pread", path_));
+      if (err) *err = errno;
+      return Status::IOError(std::string("pread: ") + std::strerror(errno));
     }
     p      += r;
     remain -= static_cast<size_t>(r);
@@ -106,6 +166,67 @@ Status File::ReadAt(void* buf, size_t n, uint64_t offset) const {
   return Status::OK();
 }
 
+Status File::WriteAt(const void* buf, size_t n, uint64_t offset) {
+  if (fd_ < 0) return Status::IOError(ErrnoMessage("open", path_));
+  if (!buf && n > 0) return Status::InvalidArgument("WriteAt: buf=null");
+
+  Status s;
+  int    err = 0;
+  if (direct() && !AlignedBuffer::IsAligned(buf, n, offset)) {
+    // 非对齐写：偏移与长度不对齐时无法避免读-改-写，直接退出直接 I/O 更简单可靠；
+    // 仅地址不对齐时经对齐缓冲区中转
+    if (n % kDirectIoAlignment != 0 || offset % kDirectIoAlignment != 0) {
+      DisableDirect();
+      s = PosixWriteFull(fd_, buf, n, offset, &err);
+    } else {
+      AlignedBuffer tmp(n);
+      if (!tmp.data()) return Status::IOError("WriteAt: out of memory");
+      std::memcpy(tmp.data(), buf, n);
+      s = PosixWriteFull(fd_, tmp.data(), n, offset, &err);
+    }
+  } else {
+    s = PosixWriteFull(fd_, buf, n, offset, &err);
+  }
+  if (err == EINVAL && direct()) {
+    DisableDirect();
+    s = PosixWriteFull(fd_, buf, n, offset, &err);
+  }
+  if (s.code() == StatusCode::kIOError) return Status::IOError(s.message() + " ('" + path_ + "')");
+  return s;
+}
+
+Status File::ReadAt(void* buf, size_t n, uint64_t offset) const {
+  if (fd_ < 0) return Status::IOError(ErrnoMessage("open", path_));
+  if (!buf && n > 0) return Status::InvalidArgument("ReadAt: buf=null");
+
+  Status s;
+  int    err = 0;
+  if (direct() && !AlignedBuffer::IsAligned(buf, n, offset)) {
+    // 非对齐读：扩展到对齐的块区间读入中转缓冲区，再拷出所需部分
+    const uint64_t lo  = offset / kDirectIoAlignment * kDirectIoAlignment;
+    const uint64_t hi  = (offset + n + kDirectIoAlignment - 1) / kDirectIoAlignment * kDirectIoAlignment;
+    AlignedBuffer  tmp(static_cast<size_t>(hi - lo));
+    if (!tmp.data()) return Status::IOError("ReadAt: out of memory");
+    s = PosixReadFull(fd_, tmp.data(), tmp.size(), lo, &err);
+    if (s.code() == StatusCode::kCorruption) {
+      // 对齐区间的尾部越过 EOF 属正常：按实际文件大小判断所需部分是否完整
+      const uint64_t size = SizeBytes();
+      s = offset + n <= size ? Status::OK()
+        : offset >= size     ? Status::NotFound("ReadAt: range beyond EOF")
+                             : Status::Corruption("ReadAt: unexpected EOF");
+    }
+    if (s.ok()) std::memcpy(buf, tmp.data() + (offset - lo), n);
+  } else {
+    s = PosixReadFull(fd_, buf, n, offset, &err);
+  }
+  if (err == EINVAL && direct()) {
+    DisableDirect();
+    s = PosixReadFull(fd_, buf, n, offset, &err);
+  }
+  if (s.code() == StatusCode::kIOError) return Status::IOError(s.message() + " ('" + path_ + "')");
+  return s;
+}
+
 Status File::Sync() const {
   if (fd_ < 0) return Status::IOError(ErrnoMessage("open", path_));
   if (::fdatasync(fd_) != 0) {
@@ -116,35 +237,130 @@ Status File::Sync() const {
 
 // ======== DiskManager 实现 ========
 
-DiskManager::DiskManager(std::string file_path, uint32_t page_size)
+DiskManager::DiskManager(std::string file_path, uint32_t page_size, bool direct_io)
     : file_(std::move(file_path)),
       page_size_(page_size < sizeof(PageHeader) ? kDefaultPageSize : page_size) {
-  (void)file_.Open(/*create_if_missing=*/true);
+  // 页大小不是对齐单位的整数倍时每次页 I/O 都会触发中转，不值得开启直接 I/O
+  const bool direct = direct_io && page_size_ % kDirectIoAlignment == 0;
+  (void)file_.Open(/*create_if_missing=*/true, direct);
 }
 
 DiskManager::~DiskManager() = default;
 
-Status DiskManager::EnsureCapacityFor(page_id_t pid) {
-  const uint64_t need = (static_cast<uint64_t>(pid) + 1) * page_size_;
-  const uint64_t cur  = file_.SizeBytes();
-  if (cur >= need) return Status::OK();
-  return file_.Resize(need);
-}
-
 Status DiskManager::ReadPage(page_id_t pid, void* out_buf) const {
   if (!out_buf) return Status::InvalidArgument("ReadPage: out_buf=null");
   const uint64_t off = static_cast<uint64_t>(pid) * page_size_;
-  return file_.ReadAt(out_buf, page_size_, off);
+  return TimedIo(metrics_.load(std::memory_order_relaxed), Metric::kDiskRead,
+                 [&] { return file_.ReadAt(out_buf, page_size_, off); });
+}
+
+Status DiskManager::ReadPages(page_id_t first, uint32_t n, void* out_buf) const {
+  if (!out_buf) return Status::InvalidArgument("ReadPages: out_buf=null");
+  const uint64_t off = static_cast<uint64_t>(first) * page_size_;
+  return TimedIo(metrics_.load(std::memory_order_relaxed), Metric::kDiskRead,
+                 [&] { return file_.ReadAt(out_buf, static_cast<size_t>(n) * page_size_, off); });
 }
 
 Status DiskManager::WritePage(page_id_t pid, const void* in_buf) {
   if (!in_buf) return Status::InvalidArgument("WritePage: in_buf=null");
-  if (Status s = EnsureCapacityFor(pid); !s.ok()) return s;
+  // pwrite 越过文件尾会自动扩展文件，无需先 fstat + ftruncate
   const uint64_t off = static_cast<uint64_t>(pid) * page_size_;
-  return file_.WriteAt(in_buf, page_size_, off);
+  return TimedIo(metrics_.load(std::memory_order_relaxed), Metric::kDiskWrite,
+                 [&] { return file_.WriteAt(in_buf, page_size_, off); });
 }
 
-Status DiskManager::Sync() const { return file_.Sync(); }
+Status DiskManager::SubmitPages(const PageIo* ios, size_t n, PageDoneFn done) {
+  if (n == 0) return Status::OK();
+  if (!ios) return Status::InvalidArgument("SubmitPages: ios=null");
+
+  // 与 IoBackend::Submit 一致：出错时也让每个请求以该错误完成
+  auto fail_all = [&](const Status& err) {
+    if (done) for (size_t i = 0; i < n; ++i) done(i, err);
+    return err;
+  };
+  if (!file_.Valid()) return fail_all(Status::IOError("SubmitPages: file not open ('" + file_.path() + "')"));
+  bool unaligned = false;
+  for (size_t i = 0; i < n; ++i) {
+    if (!ios[i].buf) return fail_all(Status::InvalidArgument("SubmitPages: buf=null"));
+    unaligned |= !AlignedBuffer::IsAligned(ios[i].buf, page_size_, 0);
+  }
+  if (unaligned && file_.direct()) {
+    // O_DIRECT 下后端无法处理不对齐的缓冲区：整批改走 File 的同步读写（内部中转）
+    for (size_t i = 0; i < n; ++i) {
+      const uint64_t off = static_cast<uint64_t>(ios[i].pid) * page_size_;
+      const Status s = ios[i].op == IoOp::kRead ? file_.ReadAt(ios[i].buf, page_size_, off)
+                                                : file_.WriteAt(ios[i].buf, page_size_, off);
+      if (done) done(i, s);
+    }
+    return Status::OK();
+  }
+
+  auto cb = std::make_shared<PageDoneFn>(std::move(done));
+  std::vector<IoRequest> reqs(n);
+  for (size_t i = 0; i < n; ++i) {
+    IoRequest& q = reqs[i];
+    q.op     = ios[i].op;
+    q.fd     = file_.fd();
+    q.buf    = ios[i].buf;
+    q.len    = page_size_;
+    q.offset = static_cast<uint64_t>(ios[i].pid) * page_size_;
+    q.done   = [cb, i](const Status& s) { if (*cb) (*cb)(i, s); };
+  }
+  return io_->Submit(reqs.data(), reqs.size());
+}
+
+Status DiskManager::ExecutePages(const PageIo* ios, size_t n, Status* per_page) {
+  struct Latch {
+    std::mutex              mu;
+    std::condition_variable cv;
+    size_t                  remaining{0};
+    Status                  first;
+  };
+  StorageMetrics* m = metrics_.load(std::memory_order_relaxed);
+  const uint64_t t0 = m ? MetricsNowNs() : 0;
+  auto latch = std::make_shared<Latch>();
+  latch->remaining = n;
+  Status s = SubmitPages(ios, n, [latch, per_page](size_t i, const Status& st) {
+    std::lock_guard<std::mutex> g(latch->mu);
+    if (per_page) per_page[i] = st;
+    if (!st.ok() && latch->first.ok()) latch->first = st;
+    if (--latch->remaining == 0) latch->cv.notify_all();
+  });
+  if (!s.ok() && !ios) return s;  // 参数错误：没有回调
+
+  std::unique_lock<std::mutex> lk(latch->mu);
+  latch->cv.wait(lk, [&] { return latch->remaining == 0; });
+  if (m && n > 0) {
+    // 一批记一次；读写混合的批次两类各记一次
+    bool reads = false, writes = false;
+    for (size_t i = 0; i < n; ++i) (ios[i].op == IoOp::kRead ? reads : writes) = true;
+    const uint64_t dt = MetricsNowNs() - t0;
+    if (reads)  m->Record(Metric::kDiskRead, dt);
+    if (writes) m->Record(Metric::kDiskWrite, dt);
+  }
+  return s.ok() ? latch->first : s;
+}
+
+std::future<Status> DiskManager::ReadPageAsync(page_id_t pid, void* out_buf) {
+  auto prom = std::make_shared<std::promise<Status>>();
+  std::future<Status> fut = prom->get_future();
+  PageIo io{IoOp::kRead, pid, out_buf};
+  (void)SubmitPages(&io, 1, [prom](size_t, const Status& st) { prom->set_value(st); });
+  return fut;
+}
+
+std::future<Status> DiskManager::WritePageAsync(page_id_t pid, const void* in_buf) {
+  auto prom = std::make_shared<std::promise<Status>>();
+  std::future<Status> fut = prom->get_future();
+  PageIo io{IoOp::kWrite, pid, const_cast<void*>(in_buf)};
+  (void)SubmitPages(&io, 1, [prom](size_t, const Status& st) { prom->set_value(st); });
+  return fut;
+}
+
+Status DiskManager::Sync() const {
+  return TimedIo(metrics_.load(std::memory_order_relaxed), Metric::kDiskSync,
+                 [&] { return file_.Sync(); });
+}
 
 uint64_t DiskManager::PageCount() const {
   const uint64_t bytes = file_.SizeBytes();
@@ -155,5 +371,17 @@ Status DiskManager::ResizeToPages(uint64_t new_page_count) {
   return file_.Resize(new_page_count * static_cast<uint64_t>(page_size_));
 }
 
+Status DiskManager::DiscardPages(page_id_t first, uint64_t n) {
+  const uint64_t ps = static_cast<uint64_t>(page_size_);
+  return file_.PunchHole(static_cast<uint64_t>(first) * ps, n * ps);
+}
+
+Status DiskManager::PreallocateToPages(uint64_t new_page_count) {
+  const uint64_t cur = PageCount();
+  if (new_page_count <= cur) return Status::OK();
+  const uint64_t ps = static_cast<uint64_t>(page_size_);
+  return file_.Allocate(cur * ps, (new_page_count - cur) * ps);
+}
+
 }  // namespace storage
 }  // namespace dbms
@@ -0,0 +1,89 @@
+/**
+ * @file io_backend.cc
+ * @brief IoBackend 公共部分：POSIX 兜底实现、SubmitAndWait 与工厂。
+ */
+
+#include "dbms/storage/io/io_backend.h"
+
+#include <condition_variable>
+#include <mutex>
+
+#include "internal/io/posix_io.h"
+#if DBMS_STORAGE_HAVE_IO_URING
+#include "internal/io/io_uring_backend.h"
+#endif
+
+namespace dbms {
+namespace storage {
+
+// ======== POSIX 后端：调用线程内同步执行 ========
+
+namespace {
+
+class PosixIoBackend final : public IoBackend {
+public:
+  const char* Name() const noexcept override { return "posix"; }
+
+  Status Submit(IoRequest* reqs, size_t n) override {
+    if (!reqs && n > 0) return Status::InvalidArgument("Submit: reqs=null");
+    for (size_t i = 0; i < n; ++i) {
+      IoRequest& q = reqs[i];
+      Status s = q.op == IoOp::kRead ? PosixReadFull(q.fd, q.buf, q.len, q.offset)
+                                     : PosixWriteFull(q.fd, q.buf, q.len, q.offset);
+      if (q.done) q.done(s);
+    }
+    return Status::OK();
+  }
+};
+
+}  // namespace
+
+IoBackend* IoBackend::Posix() {
+  static PosixIoBackend instance;
+  return &instance;
+}
+
+std::unique_ptr<IoBackend> IoBackend::Create(const std::string& name, unsigned queue_depth) {
+  if (name == "posix") return std::make_unique<PosixIoBackend>();
+  if (name == "io_uring") {
+#if DBMS_STORAGE_HAVE_IO_URING
+    if (auto b = IoUringBackend::Open(queue_depth)) return b;
+#endif
+    (void)queue_depth;
+    return std::make_unique<PosixIoBackend>();  // 不可用时回退
+  }
+  return nullptr;
+}
+
+// ======== 同步等待 ========
+
+Status IoBackend::SubmitAndWait(IoRequest* reqs, size_t n) {
+  if (n == 0) return Status::OK();
+  if (!reqs) return Status::InvalidArgument("SubmitAndWait: reqs=null");
+
+  // 共享状态以 shared_ptr 持有：即使 Submit 失败后仍有迟到的回调也能安全访问
+  struct Latch {
+    std::mutex              mu;
+    std::condition_variable cv;
+    size_t                  remaining{0};
+    Status                  first;
+  };
+  auto latch = std::make_shared<Latch>();
+  latch->remaining = n;
+  for (size_t i = 0; i < n; ++i) {
+    reqs[i].done = [latch](const Status& s) {
+      std::lock_guard<std::mutex> g(latch->mu);
+      if (!s.ok() && latch->first.ok()) latch->first = s;
+      if (--latch->remaining == 0) latch->cv.notify_all();
+    };
+  }
+
+  // 提交失败时各请求仍会以错误完成，必须等回调全部返回，调用方的缓冲区才可复用
+  const Status s = Submit(reqs, n);
+  std::unique_lock<std::mutex> lk(latch->mu);
+  latch->cv.wait(lk, [&] { return latch->remaining == 0; });
+  return s.ok() ? latch->first : s;
+}
+
+}  // namespace storage
+}  // namespace dbms
@@ -0,0 +1,34 @@
+#include "internal/page/page_checksum.h"
+
+#include <cstddef>
+#include <cstring>
+
+#include "dbms/storage/page/page.h"
+#include "internal/util/crc32c.h"
+
+namespace dbms {
+namespace storage {
+
+static constexpr size_t kChecksumOff = offsetof(PageHeader, checksum);
+static constexpr size_t kChecksumLen = sizeof(PageHeader::checksum);
+
+uint32_t ComputePageChecksum(const std::uint8_t* page, uint32_t page_size) {
+  // 跳过 checksum 字段分两段续算：不必先拷贝页或临时清零字段
+  uint32_t crc = Crc32c(page, kChecksumOff);
+  crc = Crc32c(page + kChecksumOff + kChecksumLen, page_size - kChecksumOff - kChecksumLen, crc);
+  return crc != 0 ? crc : 1;
+}
+
+void StampPageChecksum(std::uint8_t* page, uint32_t page_size) {
+  const uint32_t crc = ComputePageChecksum(page, page_size);
+  std::memcpy(page + kChecksumOff, &crc, kChecksumLen);
+}
+
+bool VerifyPageChecksum(const std::uint8_t* page, uint32_t page_size) {
+  uint32_t stored;
+  std::memcpy(&stored, page + kChecksumOff, kChecksumLen);
+  return stored == 0 || stored == ComputePageChecksum(page, page_size);
+}
+
+}  // namespace storage
+}  // namespace dbms
@@ -0,0 +1,319 @@
+#include "internal/page/page_codec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+#include "internal/page/pax_page_layout.h"
+#include "internal/util/lz4.h"
+
+namespace dbms {
+namespace storage {
+
+namespace {
+
+/**
+ * kPax 字节串：
+ *   [u8 kPax][u16 区间数]
+ *   每个区间：[u8 方式][u16 页内偏移][u16 行数][u16 值宽]，随后为该方式的负载
+ *     kFor32 ：[i32 最小值][u8 位宽] + 位打包的 (value - min)
+ *     kDict  ：[u16 字典项数][u8 位宽] + 字典（项数 × 值宽）+ 位打包的码
+ *   [其余字节的 LZ4]（长度 = page_size − 各区间字节数之和，解码时由区间推出）
+ * 区间按偏移升序、互不重叠。
+ */
+enum RegionKind : std::uint8_t { kFor32 = 1, kDict = 2 };
+
+struct Region {
+  uint16_t off;
+  uint16_t rows;
+  uint16_t width;
+  uint32_t Bytes() const { return static_cast<uint32_t>(rows) * width; }
+};
+
+constexpr size_t kRegionHeader = 1 + 2 + 2 + 2;
+constexpr size_t kMaxDict      = 256;
+
+inline void Put(std::vector<std::uint8_t>* out, const void* p, size_t n) {
+  const auto* b = static_cast<const std::uint8_t*>(p);
+  out->insert(out->end(), b, b + n);
+}
+template <class T>
+inline void PutPod(std::vector<std::uint8_t>* out, T v) { Put(out, &v, sizeof(v)); }
+
+inline uint8_t BitsFor(uint32_t range) {
+  uint8_t b = 0;
+  while (b < 32 && (static_cast<uint64_t>(range) >> b) != 0) ++b;
+  return b;
+}
+
+inline size_t PackedBytes(size_t count, uint8_t bits) { return (count * bits + 7) / 8; }
+
+/// 把 count 个 b 位的值（低位在前）追加到 out
+template <class Get>
+void PackBits(std::vector<std::uint8_t>* out, size_t count, uint8_t bits, Get&& get) {
+  if (bits == 0) return;
+  uint64_t acc = 0;
+  int have = 0;
+  for (size_t i = 0; i < count; ++i) {
+    acc |= static_cast<uint64_t>(get(i)) << have;
+    have += bits;
+    while (have >= 8) {
+      out->push_back(static_cast<std::uint8_t>(acc));
+      acc >>= 8;
+      have -= 8;
+    }
+  }
+  if (have > 0) out->push_back(static_cast<std::uint8_t>(acc));
+}
+
+/// 逐个解出 count 个 b 位的值交给 put(i, v)；p 须有 PackedBytes(count, bits) 字节
+template <class Put>
+void UnpackBits(const std::uint8_t* p, size_t count, uint8_t bits, Put&& put) {
+  if (bits == 0) {
+    for (size_t i = 0; i < count; ++i) put(i, 0u);
+    return;
+  }
+  const uint64_t mask = (uint64_t{1} << bits) - 1;
+  uint64_t acc = 0;
+  int have = 0;
+  for (size_t i = 0; i < count; ++i) {
+    while (have < bits) {
+      acc |= static_cast<uint64_t>(*p++) << have;
+      have += 8;
+    }
+    put(i, static_cast<uint32_t>(acc & mask));
+    acc >>= bits;
+    have -= bits;
+  }
+}
+
+/// INT32/DATE 列：FOR + 位打包；不比原值小时不编码
+bool EncodeFor32(const std::uint8_t* v, const Region& r, std::vector<std::uint8_t>* out) {
+  if (r.rows == 0) return false;
+  auto load = [v](size_t i) { int32_t x; std::memcpy(&x, v + i * 4, 4); return x; };
+  int32_t lo = load(0), hi = lo;
+  for (size_t i = 1; i < r.rows; ++i) {
+    const int32_t x = load(i);
+    lo = std::min(lo, x);
+    hi = std::max(hi, x);
+  }
+  const uint8_t bits = BitsFor(static_cast<uint32_t>(hi) - static_cast<uint32_t>(lo));
+  const size_t  size = kRegionHeader + 4 + 1 + PackedBytes(r.rows, bits);
+  if (size >= r.Bytes()) return false;
+  PutPod<std::uint8_t>(out, kFor32);
+  PutPod(out, r.off);
+  PutPod(out, r.rows);
+  PutPod(out, r.width);
+  PutPod(out, lo);
+  PutPod(out, bits);
+  PackBits(out, r.rows, bits, [&](size_t i) { return static_cast<uint32_t>(load(i)) - static_cast<uint32_t>(lo); });
+  return true;
+}
+
+/// CHAR 列：不同取值不超过 kMaxDict 个时字典编码；不比原值小时不编码
+bool EncodeDict(const std::uint8_t* v, const Region& r, std::vector<std::uint8_t>* out) {
+  if (r.rows == 0 || r.width == 0) return false;
+  std::unordered_map<std::string_view, uint16_t> ids;
+  std::vector<uint16_t> codes(r.rows);
+  std::vector<std::string_view> dict;
+  for (size_t i = 0; i < r.rows; ++i) {
+    const std::string_view s(reinterpret_cast<const char*>(v + i * r.width), r.width);
+    auto it = ids.find(s);
+    if (it == ids.end()) {
+      if (dict.size() == kMaxDict) return false;
+      it = ids.emplace(s, static_cast<uint16_t>(dict.size())).first;
+      dict.push_back(s);
+    }
+    codes[i] = it->second;
+  }
+  const uint8_t bits = BitsFor(static_cast<uint32_t>(dict.size() - 1));
+  const size_t  size = kRegionHeader + 2 + 1 + dict.size() * r.width + PackedBytes(r.rows, bits);
+  if (size >= r.Bytes()) return false;
+  PutPod<std::uint8_t>(out, kDict);
+  PutPod(out, r.off);
+  PutPod(out, r.rows);
+  PutPod(out, r.width);
+  PutPod(out, static_cast<uint16_t>(dict.size()));
+  PutPod(out, bits);
+  for (std::string_view s : dict) Put(out, s.data(), s.size());
+  PackBits(out, r.rows, bits, [&](size_t i) { return uint32_t{codes[i]}; });
+  return true;
+}
+
+/// 追加 src[0, n) 的 LZ4；失败返回 false（out 已回滚）
+bool AppendLz4(std::vector<std::uint8_t>* out, const std::uint8_t* src, size_t n) {
+  const size_t at = out->size();
+  out->resize(at + Lz4CompressBound(n));
+  const size_t z = Lz4Compress(src, n, out->data() + at, out->size() - at);
+  out->resize(z ? at + z : at);
+  return z != 0;
+}
+
+bool EncodePax(const std::uint8_t* page, uint32_t page_size, const Schema& schema,
+               std::vector<std::uint8_t>* out, PageCodecCounts* counts) {
+  PaxPage pp(const_cast<std::uint8_t*>(page), page_size, schema);  // 只调用只读方法
+  if (!pp.Valid()) return false;
+  const uint16_t rows = pp.RowCount();
+
+  out->clear();
+  PutPod(out, static_cast<std::uint8_t>(PageEncoding::kPax));
+  PutPod<uint16_t>(out, 0);  // 区间数，稍后回填
+  uint16_t nregions = 0;
+  std::vector<Region> regions;
+  uint64_t nfor = 0, ndict = 0;
+  pp.ForEachColumn([&](size_t c, uint32_t values_off, uint32_t /*nulls_off*/) {
+    const Type t = schema.GetColumn(c).type;
+    const Region r{static_cast<uint16_t>(values_off), rows, static_cast<uint16_t>(schema.FixedSizeOf(c))};
+    if (static_cast<uint64_t>(values_off) + r.Bytes() > page_size) return;
+    bool done = false;
+    if (t == Type::INT32 || t == Type::DATE) {
+      done = EncodeFor32(page + values_off, r, out);
+      nfor += done;
+    } else if (t == Type::CHAR) {
+      done = EncodeDict(page + values_off, r, out);
+      ndict += done;
+    }
+    if (done) { regions.push_back(r); ++nregions; }
+  });
+  std::memcpy(out->data() + 1, &nregions, sizeof(nregions));
+
+  // 其余字节按页内顺序拼接后 LZ4
+  std::vector<std::uint8_t> rest;
+  rest.reserve(page_size);
+  uint32_t pos = 0;
+  for (const Region& r : regions) {
+    rest.insert(rest.end(), page + pos, page + r.off);
+    pos = r.off + r.Bytes();
+  }
+  rest.insert(rest.end(), page + pos, page + page_size);
+  if (!AppendLz4(out, rest.data(), rest.size())) return false;
+  if (counts) {
+    counts->for_columns  += nfor;
+    counts->dict_columns += ndict;
+  }
+  return true;
+}
+
+}  // namespace
+
+PageEncoding EncodePage(const std::uint8_t* page, uint32_t page_size, const Schema* schema,
+                        std::vector<std::uint8_t>* out, PageCodecCounts* counts) {
+  if (schema) {
+    PaxHeader ph;
+    std::memcpy(&ph, page + sizeof(PageHeader), sizeof(ph));
+    PageCodecCounts c;
+    if (ph.magic == PaxPage::kMagic && EncodePax(page, page_size, *schema, out, &c) && out->size() < page_size) {
+      if (counts) {
+        counts->for_columns  += c.for_columns;
+        counts->dict_columns += c.dict_columns;
+      }
+      return PageEncoding::kPax;
+    }
+  }
+  out->clear();
+  PutPod(out, static_cast<std::uint8_t>(PageEncoding::kLz4));
+  if (AppendLz4(out, page, page_size) && out->size() < page_size) return PageEncoding::kLz4;
+
+  out->clear();
+  PutPod(out, static_cast<std::uint8_t>(PageEncoding::kRaw));
+  Put(out, page, page_size);
+  return PageEncoding::kRaw;
+}
+
+Status DecodePage(const std::uint8_t* blob, size_t len, std::uint8_t* page, uint32_t page_size) {
+  if (!blob || len == 0 || !page) return Status::InvalidArgument("DecodePage: null argument");
+  const std::uint8_t* p    = blob + 1;
+  const std::uint8_t* end  = blob + len;
+  const auto          kind = static_cast<PageEncoding>(blob[0]);
+
+  if (kind == PageEncoding::kRaw) {
+    if (len - 1 != page_size) return Status::Corruption("DecodePage: raw length mismatch");
+    std::memcpy(page, p, page_size);
+    return Status::OK();
+  }
+  if (kind == PageEncoding::kLz4) {
+    if (!Lz4Decompress(p, len - 1, page, page_size)) return Status::Corruption("DecodePage: bad lz4 page");
+    return Status::OK();
+  }
+  if (kind != PageEncoding::kPax) return Status::Corruption("DecodePage: unknown encoding");
+
+  auto take = [&](void* dst, size_t n) {
+    if (static_cast<size_t>(end - p) < n) return false;
+    std::memcpy(dst, p, n);
+    p += n;
+    return true;
+  };
+  uint16_t nregions = 0;
+  if (!take(&nregions, sizeof(nregions))) return Status::Corruption("DecodePage: truncated");
+
+  // 先解出各列区间（记下位置），再把其余字节解压后填进区间之间的空隙
+  thread_local std::vector<Region> regions;
+  regions.clear();
+  uint32_t covered = 0, last_end = 0;
+  for (uint16_t k = 0; k < nregions; ++k) {
+    std::uint8_t kind_byte = 0;
+    Region r{};
+    if (!take(&kind_byte, 1) || !take(&r.off, 2) || !take(&r.rows, 2) || !take(&r.width, 2)) {
+      return Status::Corruption("DecodePage: truncated region");
+    }
+    if (r.off < last_end || static_cast<uint64_t>(r.off) + r.Bytes() > page_size ||
+        (kind_byte == kFor32 && r.width != 4)) {
+      return Status::Corruption("DecodePage: bad region");
+    }
+    std::uint8_t* dst = page + r.off;
+    if (kind_byte == kFor32) {
+      int32_t lo = 0;
+      uint8_t bits = 0;
+      if (!take(&lo, 4) || !take(&bits, 1) || bits > 32) return Status::Corruption("DecodePage: bad FOR header");
+      if (static_cast<size_t>(end - p) < PackedBytes(r.rows, bits)) return Status::Corruption("DecodePage: truncated FOR");
+      UnpackBits(p, r.rows, bits, [&](size_t i, uint32_t v) {
+        const uint32_t x = static_cast<uint32_t>(lo) + v;
+        std::memcpy(dst + i * 4, &x, 4);
+      });
+      p += PackedBytes(r.rows, bits);
+    } else if (kind_byte == kDict) {
+      uint16_t ndict = 0;
+      uint8_t  bits  = 0;
+      if (!take(&ndict, 2) || !take(&bits, 1) || ndict == 0 || ndict > kMaxDict || bits > 8) {
+        return Status::Corruption("DecodePage: bad dictionary header");
+      }
+      const size_t dict_bytes = static_cast<size_t>(ndict) * r.width;
+      if (static_cast<size_t>(end - p) < dict_bytes + PackedBytes(r.rows, bits)) {
+        return Status::Corruption("DecodePage: truncated dictionary");
+      }
+      const std::uint8_t* dict = p;
+      p += dict_bytes;
+      bool ok = true;
+      UnpackBits(p, r.rows, bits, [&](size_t i, uint32_t code) {
+        if (code >= ndict) { ok = false; code = 0; }
+        std::memcpy(dst + i * r.width, dict + static_cast<size_t>(code) * r.width, r.width);
+      });
+      if (!ok) return Status::Corruption("DecodePage: dictionary code out of range");
+      p += PackedBytes(r.rows, bits);
+    } else {
+      return Status::Corruption("DecodePage: unknown region kind");
+    }
+    regions.push_back(r);
+    covered += r.Bytes();
+    last_end = r.off + r.Bytes();
+  }
+
+  thread_local std::vector<std::uint8_t> rest;
+  rest.resize(page_size - covered);
+  if (!Lz4Decompress(p, static_cast<size_t>(end - p), rest.data(), rest.size())) {
+    return Status::Corruption("DecodePage: bad lz4 remainder");
+  }
+  const std::uint8_t* src = rest.data();
+  uint32_t pos = 0;
+  for (const Region& r : regions) {
+    std::memcpy(page + pos, src, r.off - pos);
+    src += r.off - pos;
+    pos = r.off + r.Bytes();
+  }
+  std::memcpy(page + pos, src, page_size - pos);
+  return Status::OK();
+}
+
+}  // namespace storage
+}  // namespace dbms
@@ -0,0 +1,247 @@
+#include "internal/page/pax_page_layout.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace dbms {
+namespace storage {
+
+// 行格式中 VARCHAR 的固定区条目 / PAX 列小页中的 VARCHAR 条目
+struct VarRef {
+  uint16_t off;
+  uint16_t len;
+};
+
+static inline VarRef LoadVarRef(const std::uint8_t* p) {
+  VarRef v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline void StoreVarRef(std::uint8_t* p, uint16_t off, uint16_t len) {
+  const VarRef v{off, len};
+  std::memcpy(p, &v, sizeof(v));
+}
+
+static inline bool RowNullBit(const Schema& s, const std::uint8_t* row, size_t c) {
+  return s.UseNullBitmap() && ((row[c / 8] >> (c % 8)) & 1);
+}
+
+static inline void AssignBit(std::uint8_t* bitmap, uint32_t r, bool on) {
+  const auto mask = static_cast<std::uint8_t>(1u << (r % 8));
+  bitmap[r / 8] = on ? static_cast<std::uint8_t>(bitmap[r / 8] | mask)
+                     : static_cast<std::uint8_t>(bitmap[r / 8] & ~mask);
+}
+
+// 与 ForEachColumn 的偏移推导保持一致
+uint32_t PaxPage::FixedEndFor(const Schema& schema, uint32_t cap) {
+  const uint32_t bitmap = Align8((cap + 7u) / 8u);
+  uint32_t off = kDeletedOff + bitmap;
+  for (size_t c = 0; c < schema.ColumnCount(); ++c) {
+    if (schema.UseNullBitmap()) off += bitmap;
+    off += Align8(cap * static_cast<uint32_t>(schema.FixedSizeOf(c)));
+  }
+  return off;
+}
+
+PaxPage::PaxPage(std::uint8_t* page, std::uint32_t page_size, const Schema& schema)
+    : page_(page), page_size_(page_size), schema_(schema) {
+  PaxHeader ph;
+  std::memcpy(&ph, page_ + sizeof(PageHeader), sizeof(ph));
+  cap_       = ph.capacity;
+  fixed_end_ = FixedEndFor(schema_, cap_);
+  valid_     = ph.magic == kMagic && ph.ncols == schema_.ColumnCount() && cap_ > 0 &&
+               fixed_end_ <= page_size_;
+}
+
+std::uint32_t PaxPage::DefaultVarEstimate(const Schema& schema) {
+  uint32_t est = 0;
+  for (size_t c = 0; c < schema.ColumnCount(); ++c) est += schema.VarCharMaxLen(c) / 2;
+  return est;
+}
+
+void PaxPage::InitNew(std::uint8_t* page, page_id_t pid, std::uint32_t page_size,
+                      const Schema& schema, std::uint32_t var_bytes_per_row) {
+  std::memset(page, 0, page_size);
+
+  // 每行占用：各列定长值 + 预估变长字节 + (删除位 + 各列 NULL 位)；先按比例估出容量再向下修正
+  uint32_t fixed = 0;
+  for (size_t c = 0; c < schema.ColumnCount(); ++c) fixed += static_cast<uint32_t>(schema.FixedSizeOf(c));
+  const uint32_t bits = 1 + (schema.UseNullBitmap() ? static_cast<uint32_t>(schema.ColumnCount()) : 0);
+  const uint32_t pad  = 8 * (1 + static_cast<uint32_t>(schema.ColumnCount()) * (schema.UseNullBitmap() ? 2 : 1));
+  const uint32_t room = page_size > kDeletedOff + pad ? page_size - kDeletedOff - pad : 0;
+  uint64_t cap = static_cast<uint64_t>(room) * 8 / (8ull * (fixed + var_bytes_per_row) + bits);
+  cap = std::min<uint64_t>(std::max<uint64_t>(cap, 1), 0xFFFF);
+  while (cap > 1 && FixedEndFor(schema, static_cast<uint32_t>(cap)) > page_size) --cap;
+
+  auto* hdr = reinterpret_cast<PageHeader*>(page);
+  hdr->page_id        = pid;
+  hdr->page_lsn       = 0;
+  hdr->slot_count     = 0;
+  hdr->free_off       = static_cast<uint16_t>(page_size);  // 变长区为空
+  hdr->frag_size      = 0;
+  hdr->free_slot_hint = 0;
+  hdr->checksum       = 0;
+  hdr->format_version = kPageFormatVersion;
+
+  PaxHeader ph;
+  ph.magic    = kMagic;
+  ph.capacity = static_cast<uint16_t>(cap);
+  ph.ncols    = static_cast<uint16_t>(schema.ColumnCount());
+  std::memcpy(page + sizeof(PageHeader), &ph, sizeof(ph));
+
+  const uint32_t end = FixedEndFor(schema, ph.capacity);
+  hdr->free_size = static_cast<uint16_t>(end <= page_size ? page_size - end : 0);
+}
+
+std::uint32_t PaxPage::VarBytesOf(const Schema& schema, const std::uint8_t* row, std::uint16_t len) {
+  if (len < schema.FixedAreaSize()) return 0;
+  uint32_t total = 0;
+  for (size_t c = 0; c < schema.ColumnCount(); ++c) {
+    if (schema.GetColumn(c).type != Type::VARCHAR || RowNullBit(schema, row, c)) continue;
+    const VarRef v = LoadVarRef(row + schema.FixedOffsetOf(c));
+    if (static_cast<uint32_t>(v.off) + v.len > len) return 0;
+    total += v.len;
+  }
+  return total;
+}
+
+std::uint16_t PaxPage::RowCount() const {
+  return std::min(Hdr()->slot_count, cap_);
+}
+
+std::uint16_t PaxPage::VarBegin() const {
+  const uint32_t v = Hdr()->free_off;
+  return static_cast<uint16_t>(std::min(std::max(v, fixed_end_), page_size_));
+}
+
+void PaxPage::RefreshFree() {
+  auto* hdr = Hdr();
+  hdr->free_size = hdr->slot_count < cap_ ? static_cast<uint16_t>(hdr->free_off - fixed_end_) : 0;
+}
+
+Status PaxPage::Insert(const std::uint8_t* row, std::uint16_t len, std::uint16_t* out_slot) {
+  if (!row || !out_slot) return Status::InvalidArgument("PaxInsert: null arg");
+  if (!valid_)           return Status::Corruption("PaxInsert: bad page header");
+  if (len < schema_.FixedAreaSize()) return Status::InvalidArgument("PaxInsert: row shorter than fixed area");
+  auto* hdr = Hdr();
+  if (hdr->slot_count >= cap_) return Status::OutOfRange("PaxInsert: page full");
+
+  // 先核对变长数据是否都在行内、变长区是否放得下，再动页
+  uint32_t var_total = 0;
+  for (size_t c = 0; c < schema_.ColumnCount(); ++c) {
+    if (schema_.GetColumn(c).type != Type::VARCHAR || RowNullBit(schema_, row, c)) continue;
+    const VarRef v = LoadVarRef(row + schema_.FixedOffsetOf(c));
+    if (static_cast<uint32_t>(v.off) + v.len > len) return Status::InvalidArgument("PaxInsert: varchar out of row");
+    var_total += v.len;
+  }
+  if (var_total > VarBegin() - fixed_end_) return Status::OutOfRange("PaxInsert: no var space");
+
+  const uint16_t r = hdr->slot_count;
+  ForEachColumn([&](size_t c, uint32_t values_off, uint32_t nulls_off) {
+    const uint32_t w = static_cast<uint32_t>(schema_.FixedSizeOf(c));
+    std::uint8_t* dst = page_ + values_off + static_cast<uint32_t>(r) * w;
+    const bool is_null = RowNullBit(schema_, row, c);
+    if (nulls_off) AssignBit(page_ + nulls_off, r, is_null);
+    if (schema_.GetColumn(c).type == Type::VARCHAR) {
+      const VarRef v = is_null ? VarRef{0, 0} : LoadVarRef(row + schema_.FixedOffsetOf(c));
+      hdr->free_off = static_cast<uint16_t>(hdr->free_off - v.len);
+      std::memcpy(page_ + hdr->free_off, row + v.off, v.len);
+      StoreVarRef(dst, hdr->free_off, v.len);
+    } else {
+      std::memcpy(dst, row + schema_.FixedOffsetOf(c), w);
+    }
+  });
+  AssignBit(page_ + kDeletedOff, r, false);
+  hdr->slot_count = static_cast<uint16_t>(r + 1);
+  RefreshFree();
+  *out_slot = r;
+  return Status::OK();
+}
+
+Status PaxPage::Get(std::uint16_t slot, std::vector<std::uint8_t>* out) const {
+  if (!out)    return Status::InvalidArgument("PaxGet: out=null");
+  if (!valid_) return Status::Corruption("PaxGet: bad page header");
+  if (slot >= RowCount()) return Status::NotFound("PaxGet: slot OOR");
+  if (IsDeleted(slot))    return Status::NotFound("PaxGet: deleted");
+
+  // 乐观读者可能看到撕裂的页：变长引用只读一次，并校验落在变长区内
+  const size_t fixed_area = schema_.FixedAreaSize();
+  out->resize(fixed_area);
+  std::fill(out->begin(), out->begin() + static_cast<std::ptrdiff_t>(schema_.NullBitmapSize()), 0);
+  Status st;
+  ForEachColumn([&](size_t c, uint32_t values_off, uint32_t nulls_off) {
+    if (!st.ok()) return;
+    const uint32_t w = static_cast<uint32_t>(schema_.FixedSizeOf(c));
+    const std::uint8_t* src = page_ + values_off + static_cast<uint32_t>(slot) * w;
+    if (nulls_off && ((page_[nulls_off + slot / 8] >> (slot % 8)) & 1)) (*out)[c / 8] |= static_cast<std::uint8_t>(1u << (c % 8));
+    std::uint8_t* dst = out->data() + schema_.FixedOffsetOf(c);
+    if (schema_.GetColumn(c).type == Type::VARCHAR) {
+      const VarRef v = LoadVarRef(src);
+      if (v.len > 0 && (v.off < fixed_end_ || static_cast<uint32_t>(v.off) + v.len > page_size_)) {
+        st = Status::Corruption("PaxGet: varchar range invalid");
+        return;
+      }
+      const size_t row_off = out->size();
+      StoreVarRef(dst, static_cast<uint16_t>(row_off), v.len);
+      out->insert(out->end(), page_ + v.off, page_ + v.off + v.len);
+    } else {
+      std::memcpy(dst, src, w);
+    }
+  });
+  return st;
+}
+
+Status PaxPage::Update(std::uint16_t slot, const std::uint8_t* row, std::uint16_t len) {
+  if (!row)    return Status::InvalidArgument("PaxUpdate: rec=null");
+  if (!valid_) return Status::Corruption("PaxUpdate: bad page header");
+  if (slot >= RowCount()) return Status::NotFound("PaxUpdate: slot OOR");
+  if (IsDeleted(slot))    return Status::NotFound("PaxUpdate: deleted");
+  if (len < schema_.FixedAreaSize()) return Status::InvalidArgument("PaxUpdate: row shorter than fixed area");
+  auto* hdr = Hdr();
+
+  // 变长值不长于旧值时覆盖旧位置，否则在变长区另取；先算总需求，放不下则不动页
+  uint32_t need = 0;
+  bool     fits = true;
+  ForEachColumn([&](size_t c, uint32_t values_off, uint32_t) {
+    if (schema_.GetColumn(c).type != Type::VARCHAR || RowNullBit(schema_, row, c)) return;
+    const VarRef nv = LoadVarRef(row + schema_.FixedOffsetOf(c));
+    if (static_cast<uint32_t>(nv.off) + nv.len > len) fits = false;
+    const VarRef ov = LoadVarRef(page_ + values_off + static_cast<uint32_t>(slot) * 4);
+    if (nv.len > ov.len) need += nv.len;
+  });
+  if (!fits) return Status::InvalidArgument("PaxUpdate: varchar out of row");
+  if (need > VarBegin() - fixed_end_) return Status::OutOfRange("PaxUpdate: no var space");
+
+  ForEachColumn([&](size_t c, uint32_t values_off, uint32_t nulls_off) {
+    const uint32_t w = static_cast<uint32_t>(schema_.FixedSizeOf(c));
+    std::uint8_t* dst = page_ + values_off + static_cast<uint32_t>(slot) * w;
+    const bool is_null = RowNullBit(schema_, row, c);
+    if (nulls_off) AssignBit(page_ + nulls_off, slot, is_null);
+    if (schema_.GetColumn(c).type == Type::VARCHAR) {
+      const VarRef nv = is_null ? VarRef{0, 0} : LoadVarRef(row + schema_.FixedOffsetOf(c));
+      VarRef ov = LoadVarRef(dst);
+      if (nv.len > ov.len) {
+        hdr->free_off = static_cast<uint16_t>(hdr->free_off - nv.len);
+        ov.off = hdr->free_off;
+      }
+      std::memcpy(page_ + ov.off, row + nv.off, nv.len);
+      StoreVarRef(dst, ov.off, nv.len);
+    } else {
+      std::memcpy(dst, row + schema_.FixedOffsetOf(c), w);
+    }
+  });
+  RefreshFree();
+  return Status::OK();
+}
+
+Status PaxPage::Erase(std::uint16_t slot) {
+  if (!valid_) return Status::Corruption("PaxErase: bad page header");
+  if (slot >= RowCount()) return Status::NotFound("PaxErase: slot OOR");
+  if (IsDeleted(slot))    return Status::NotFound("PaxErase: already deleted");
+  AssignBit(page_ + kDeletedOff, slot, true);
+  return Status::OK();
+}
+
+}  // namespace storage
+}  // namespace dbms
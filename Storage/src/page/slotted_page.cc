@@ -1,7 +1,6 @@
 #include "internal/page/slotted_page_layout.h"
 
 #include <algorithm>
-#include <cassert>
 #include <cstring>
 #include <vector>
 
@@ -13,6 +12,7 @@ struct Slot {
   uint16_t off;  // 记录起始偏移（从页首）
   uint16_t len;  // 记录长度；len==0 表示空槽/已删除
 };
+static_assert(sizeof(Slot) == SlottedPage::kSlotBytes, "slot directory entry size mismatch");
 
 static inline Slot* SlotAt(std::uint8_t* base, std::uint32_t page_size, uint16_t slot_id) {
   return reinterpret_cast<Slot*>(base + page_size - (static_cast<size_t>(slot_id) + 1) * sizeof(Slot));
@@ -29,53 +29,59 @@ void SlottedPage::InitNew(std::uint8_t* page, page_id_t pid, std::uint32_t page_
   hdr->slot_count     = 0;
   hdr->free_off       = static_cast<uint16_t>(sizeof(PageHeader));
   hdr->free_size      = static_cast<uint16_t>(page_size - sizeof(PageHeader));
+  hdr->frag_size      = 0;
+  hdr->free_slot_hint = 0;
   hdr->checksum       = 0;
   hdr->format_version = kPageFormatVersion;
 }
 
 Status SlottedPage::Insert(const std::uint8_t* rec, std::uint16_t len, std::uint16_t* out_slot) {
   if (!rec || !out_slot) return Status::InvalidArgument("Insert: null arg");
-  if (len == 0)          return Status::InvalidArgument("Insert: empty record");
+  std::uint8_t* dst = nullptr;
+  Status s = Allocate(len, out_slot, &dst);
+  if (s.ok()) std::memmove(dst, rec, len);
+  return s;
+}
+
+Status SlottedPage::Allocate(std::uint16_t len, std::uint16_t* out_slot, std::uint8_t** out_rec) {
+  if (!out_slot || !out_rec) return Status::InvalidArgument("Insert: null arg");
+  if (len == 0)              return Status::InvalidArgument("Insert: empty record");
   auto* hdr = reinterpret_cast<PageHeader*>(page_);
 
-  // 1) 先尝试是否需要新槽位，计算最小需求
-  bool reuse_slot = false;
-  uint16_t free_slot = 0;
-  for (uint16_t i = 0; i < hdr->slot_count; ++i) {
-    const Slot* s = SlotAtConst(page_, page_size_, i);
-    if (s->len == 0) { reuse_slot = true; free_slot = i; break; }
-  }
-  const uint16_t extra_slot_bytes = reuse_slot ? 0 : static_cast<uint16_t>(sizeof(Slot));
+  // 1) 从提示位置起找空槽：提示之前的槽均存活，只追加的页上本步为 O(1)
+  uint16_t free_slot = std::min(hdr->free_slot_hint, hdr->slot_count);
+  while (free_slot < hdr->slot_count && SlotAtConst(page_, page_size_, free_slot)->len != 0) ++free_slot;
+  hdr->free_slot_hint = free_slot;  // 扫过的槽均存活（即使本次插入失败提示也成立）
 
-  // 2) 判断是否有足够连续空闲；不足则压缩一次再判断
-  auto need = static_cast<uint32_t>(len) + extra_slot_bytes;
+  // 2) 连续空闲不足时，仅当碎片足以补足才压缩（否则压缩也放不下，直接返回）
+  auto need = static_cast<uint32_t>(len) + (free_slot < hdr->slot_count ? 0 : sizeof(Slot));
   if (hdr->free_size < need) {
+    if (PageUsableSpace(*hdr) < need) return Status::OutOfRange("Insert: no space");
     Compact();
-    hdr = reinterpret_cast<PageHeader*>(page_);
-    if (hdr->free_size < need) {
-      return Status::OutOfRange("Insert: no space");
-    }
+    // 压缩会退还尾部空槽：若选中的空槽恰在其中，改为追加新槽（退还的目录空间足以抵消）
+    free_slot = std::min(free_slot, hdr->slot_count);
+    need = static_cast<uint32_t>(len) + (free_slot < hdr->slot_count ? 0 : sizeof(Slot));
+    if (hdr->free_size < need) return Status::OutOfRange("Insert: no space");
   }
 
-  // 3) 拷贝记录到 free_off
-  std::memmove(page_ + hdr->free_off, rec, len);
+  // 3) 记录空间取自 free_off
   const uint16_t rec_off = hdr->free_off;
   hdr->free_off  = static_cast<uint16_t>(hdr->free_off + len);
   hdr->free_size = static_cast<uint16_t>(hdr->free_size - len);
 
   // 4) 分配槽位（可能复用）
-  uint16_t slot_id = free_slot;
-  if (!reuse_slot) {
-    slot_id = hdr->slot_count;
+  if (free_slot == hdr->slot_count) {
     hdr->slot_count = static_cast<uint16_t>(hdr->slot_count + 1);
     hdr->free_size  = static_cast<uint16_t>(hdr->free_size - sizeof(Slot));
   }
+  hdr->free_slot_hint = static_cast<uint16_t>(free_slot + 1);
 
-  Slot* s = SlotAt(page_, page_size_, slot_id);
+  Slot* s = SlotAt(page_, page_size_, free_slot);
   s->off = rec_off;
   s->len = len;
 
-  *out_slot = slot_id;
+  *out_slot = free_slot;
+  *out_rec  = page_ + rec_off;
   return Status::OK();
 }
 
@@ -83,14 +89,19 @@ Status SlottedPage::Get(std::uint16_t slot, const std::uint8_t** out_ptr, std::u
   if (!out_ptr || !out_len) return Status::InvalidArgument("Get: null out");
   const auto* hdr = reinterpret_cast<const PageHeader*>(page_);
   if (slot >= hdr->slot_count) return Status::NotFound("Get: slot OOR");
+  // 乐观读者可能看到撕裂的页：槽号与槽项都只读一次，并校验落在页内
+  if (sizeof(PageHeader) + (static_cast<size_t>(slot) + 1) * sizeof(Slot) > page_size_) {
+    return Status::Corruption("Get: slot directory out of page");
+  }
 
-  const Slot* s = SlotAtConst(page_, page_size_, slot);
-  if (s->len == 0) return Status::NotFound("Get: tombstone");
-  if (s->off < sizeof(PageHeader) || static_cast<uint32_t>(s->off) + s->len > page_size_) {
+  Slot s;
+  std::memcpy(&s, SlotAtConst(page_, page_size_, slot), sizeof(Slot));
+  if (s.len == 0) return Status::NotFound("Get: tombstone");
+  if (s.off < sizeof(PageHeader) || static_cast<uint32_t>(s.off) + s.len > page_size_) {
     return Status::Corruption("Get: slot range invalid");
   }
-  *out_ptr = page_ + s->off;
-  *out_len = s->len;
+  *out_ptr = page_ + s.off;
+  *out_len = s.len;
   return Status::OK();
 }
 
@@ -101,25 +112,42 @@ Status SlottedPage::Update(std::uint16_t slot, const std::uint8_t* rec, std::uin
 
   Slot* s = SlotAt(page_, page_size_, slot);
   if (s->len == 0) return Status::NotFound("Update: tombstone");
+  const bool at_tail = static_cast<uint32_t>(s->off) + s->len == hdr->free_off;
 
-  // 1) 若新数据不大于旧长度，原地覆盖（保留可能的内碎片，不调整 free_off/free_size）
+  // 1) 若新数据不大于旧长度，原地覆盖；缩短的尾巴位于连续空闲区之前则直接退还，否则计为碎片
   if (len <= s->len) {
+    std::memmove(page_ + s->off, rec, len);
+    const uint16_t shrink = static_cast<uint16_t>(s->len - len);
+    if (at_tail) {
+      hdr->free_off  = static_cast<uint16_t>(hdr->free_off - shrink);
+      hdr->free_size = static_cast<uint16_t>(hdr->free_size + shrink);
+    } else {
+      hdr->frag_size = static_cast<uint16_t>(hdr->frag_size + shrink);
+    }
+    s->len = len;
+    return Status::OK();
+  }
+
+  // 2) 记录紧邻连续空闲区且余量足够：原地向后延长
+  const uint16_t grow = static_cast<uint16_t>(len - s->len);
+  if (at_tail && hdr->free_size >= grow) {
     std::memmove(page_ + s->off, rec, len);
     s->len = len;
+    hdr->free_off  = static_cast<uint16_t>(hdr->free_off + grow);
+    hdr->free_size = static_cast<uint16_t>(hdr->free_size - grow);
     return Status::OK();
   }
 
-  // 2) 需要更大空间：若当前连续空闲不足，尝试压缩一次；仍不足则返回 OutOfRange（交由上层迁移）
+  // 3) 需要新位置：连续空闲不足且碎片足以补足时压缩一次；仍不足返回 OutOfRange（交由上层迁移）
   if (hdr->free_size < len) {
+    if (PageUsableSpace(*hdr) < len) return Status::OutOfRange("Update: no space");
     Compact();
-    hdr = reinterpret_cast<PageHeader*>(page_);
-    if (hdr->free_size < len) {
-      return Status::OutOfRange("Update: no space");
-    }
+    if (hdr->free_size < len) return Status::OutOfRange("Update: no space");
   }
 
-  // 3) 将新副本写到 free_off，更新槽指针；旧区域形成内碎片（下次压缩回收）
+  // 4) 将新副本写到 free_off，更新槽指针；旧副本计为碎片（下次压缩回收）
   std::memmove(page_ + hdr->free_off, rec, len);
+  hdr->frag_size = static_cast<uint16_t>(hdr->frag_size + s->len);
   s->off = hdr->free_off;
   s->len = len;
   hdr->free_off  = static_cast<uint16_t>(hdr->free_off + len);
@@ -132,43 +160,76 @@ Status SlottedPage::Erase(std::uint16_t slot) {
   if (slot >= hdr->slot_count) return Status::NotFound("Erase: slot OOR");
   Slot* s = SlotAt(page_, page_size_, slot);
   if (s->len == 0) return Status::NotFound("Erase: already tombstone");
-  s->len = 0;  // 标记墓碑（不立即回收空洞；由 Compact 回收）
+
+  // 紧邻连续空闲区的记录直接退还，其余计为碎片（由 Compact 回收）
+  if (static_cast<uint32_t>(s->off) + s->len == hdr->free_off) {
+    hdr->free_off  = static_cast<uint16_t>(hdr->free_off - s->len);
+    hdr->free_size = static_cast<uint16_t>(hdr->free_size + s->len);
+  } else {
+    hdr->frag_size = static_cast<uint16_t>(hdr->frag_size + s->len);
+  }
+  s->len = 0;  // 标记墓碑
+  hdr->free_slot_hint = std::min(hdr->free_slot_hint, slot);
+  TrimTrailingSlots();
   return Status::OK();
 }
 
+void SlottedPage::TrimTrailingSlots() {
+  auto* hdr = reinterpret_cast<PageHeader*>(page_);
+  uint16_t n = hdr->slot_count;
+  while (n > 0 && SlotAtConst(page_, page_size_, static_cast<uint16_t>(n - 1))->len == 0) --n;
+  hdr->free_size      = static_cast<uint16_t>(hdr->free_size + (hdr->slot_count - n) * sizeof(Slot));
+  hdr->slot_count     = n;
+  hdr->free_slot_hint = std::min(hdr->free_slot_hint, n);
+}
+
 void SlottedPage::Compact() {
+  TrimTrailingSlots();
   auto* hdr = reinterpret_cast<PageHeader*>(page_);
-  const uint16_t n = hdr->slot_count;
+  const uint16_t n   = hdr->slot_count;
+  const uint16_t top = static_cast<uint16_t>(sizeof(PageHeader));
 
-  // 收集存活条目（(old_off, slot_id, len)），按 old_off 升序以降低重叠移动风险
-  struct Live { uint16_t off, slot, len; };
-  std::vector<Live> lives;
-  lives.reserve(n);
-  for (uint16_t i = 0; i < n; ++i) {
+  // 存活记录的偏移是否随槽号递增（只追加、删除的页总是如此；更新搬迁过记录后才会乱序）
+  bool ordered = true;
+  uint32_t prev_end = top;
+  for (uint16_t i = 0; i < n && ordered; ++i) {
     const Slot* s = SlotAtConst(page_, page_size_, i);
-    if (s->len != 0) lives.push_back({s->off, i, s->len});
+    if (s->len == 0) continue;
+    ordered  = s->off >= prev_end;
+    prev_end = static_cast<uint32_t>(s->off) + s->len;
   }
-  std::sort(lives.begin(), lives.end(), [](const Live& a, const Live& b){ return a.off < b.off; });
-
-  // 新的写入位置从页头之后开始
-  uint16_t cur = static_cast<uint16_t>(sizeof(PageHeader));
-  for (const auto& e : lives) {
-    // 防御性检查
-    if (e.off < sizeof(PageHeader) || static_cast<uint32_t>(e.off) + e.len > page_size_) continue;
-    // 向前紧凑（memmove 支持重叠）
-    std::memmove(page_ + cur, page_ + e.off, e.len);
-    // 更新槽目录
-    Slot* s = SlotAt(page_, page_size_, e.slot);
-    s->off = cur;
-    // s->len 不变
-    cur = static_cast<uint16_t>(cur + e.len);
+
+  uint16_t cur = top;
+  if (ordered) {
+    // 有序：按槽号原地前移（目标总不超过源，memmove 安全）；首个空洞之前的记录不动
+    for (uint16_t i = 0; i < n; ++i) {
+      Slot* s = SlotAt(page_, page_size_, i);
+      if (s->len == 0) continue;
+      if (static_cast<uint32_t>(s->off) + s->len > page_size_) continue;  // 防御性检查
+      if (s->off != cur) std::memmove(page_ + cur, page_ + s->off, s->len);
+      s->off = cur;
+      cur = static_cast<uint16_t>(cur + s->len);
+    }
+  } else {
+    // 乱序：按槽号拷入线程内复用的暂存页再整体拷回，不必排序；压缩后页恢复为有序
+    thread_local std::vector<std::uint8_t> scratch;
+    if (scratch.size() < page_size_) scratch.resize(page_size_);
+    for (uint16_t i = 0; i < n; ++i) {
+      Slot* s = SlotAt(page_, page_size_, i);
+      if (s->len == 0) continue;
+      if (s->off < top || static_cast<uint32_t>(s->off) + s->len > page_size_) continue;  // 防御性检查
+      std::memcpy(scratch.data() + cur, page_ + s->off, s->len);
+      s->off = cur;
+      cur = static_cast<uint16_t>(cur + s->len);
+    }
+    std::memcpy(page_ + top, scratch.data() + top, cur - top);
   }
 
-  // 重算连续空闲区
+  // 重算连续空闲区；碎片已全部回收
   hdr->free_off  = cur;
-  // 槽目录占用：n * sizeof(Slot)（即使含 tombstone 也保留）
   const uint32_t dir_bytes = static_cast<uint32_t>(n) * sizeof(Slot);
   hdr->free_size = static_cast<uint16_t>(page_size_ - cur - dir_bytes);
+  hdr->frag_size = 0;
 }
 
 }  // namespace storage
@@ -0,0 +1,49 @@
+#include "dbms/storage/record/row_codec.h"
+
+namespace dbms {
+namespace storage {
+
+Status RowCodec::Compile(const Schema& s, const std::vector<size_t>& projection, RowCodec* out) {
+  if (!out) return Status::InvalidArgument("RowCodec::Compile: out=null");
+  const size_t n = projection.empty() ? s.ColumnCount() : projection.size();
+  RowCodec codec;
+  codec.fields_.reserve(n);
+  for (size_t k = 0; k < n; ++k) {
+    const size_t c = projection.empty() ? k : projection[k];
+    if (c >= s.ColumnCount()) return Status::OutOfRange("RowCodec::Compile: column OOR");
+    Field f;
+    f.type   = s.GetColumn(c).type;
+    f.column = static_cast<uint32_t>(c);
+    f.offset = static_cast<uint32_t>(s.FixedOffsetOf(c));
+    f.width  = static_cast<uint32_t>(s.FixedSizeOf(c));
+    if (s.UseNullBitmap()) {
+      f.null_byte = static_cast<uint32_t>(c / 8);
+      f.null_mask = static_cast<uint8_t>(1u << (c % 8));
+    }
+    if (f.type == Type::VARCHAR) codec.var_fields_.push_back(static_cast<uint32_t>(k));
+    codec.fields_.push_back(f);
+  }
+  codec.min_row_size_ = s.FixedAreaSize();
+  *out = std::move(codec);
+  return Status::OK();
+}
+
+Status RowCodec::Expect(size_t k, Type t) const {
+  if (k >= fields_.size()) return Status::OutOfRange("RowCodec::Expect: index OOR");
+  if (fields_[k].type != t) return Status::InvalidArgument("RowCodec::Expect: type mismatch");
+  return Status::OK();
+}
+
+bool RowCodec::Valid(const std::uint8_t* row, size_t len) const noexcept {
+  if (!row || len < min_row_size_) return false;
+  for (uint32_t k : var_fields_) {
+    if (IsNull(row, k)) continue;
+    uint16_t ref[2];
+    std::memcpy(ref, row + fields_[k].offset, sizeof(ref));
+    if (static_cast<size_t>(ref[0]) + ref[1] > len) return false;
+  }
+  return true;
+}
+
+}  // namespace storage
+}  // namespace dbms
@@ -1,5 +1,6 @@
 #include "dbms/storage/record/tuple.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
@@ -14,23 +15,27 @@ void Tuple::Serialize(std::uint8_t* out) const {
 
 Tuple Tuple::Deserialize(const std::uint8_t* src, size_t len) {
   Tuple t;
-  t.data_.assign(src, src + len);
+  t.Assign(src, len);
   return t;
 }
 
-bool Tuple::IsNull(const Schema& s, size_t i) const {
+// ================= TupleView =================
+
+Tuple TupleView::ToTuple() const { return Tuple::Deserialize(data_, size_); }
+
+bool TupleView::IsNull(const Schema& s, size_t i) const {
   if (!s.UseNullBitmap()) return false;
   const size_t byte = i / 8;
   const size_t bit  = i % 8;
-  if (s.NullBitmapSize() == 0 || data_.size() < s.NullBitmapSize()) return false;
+  if (s.NullBitmapSize() == 0 || size_ < s.NullBitmapSize()) return false;
   return (data_[byte] >> bit) & 0x1;
 }
 
-static inline const void* FixedPtr(const Tuple& t, const Schema& s, size_t i) {
-  return t.Bytes().data() + s.FixedOffsetOf(i);
+static inline const void* FixedPtr(const TupleView& t, const Schema& s, size_t i) {
+  return t.Data() + s.FixedOffsetOf(i);
 }
 
-Status Tuple::GetInt32(const Schema& s, size_t i, int32_t* out) const {
+Status TupleView::GetInt32(const Schema& s, size_t i, int32_t* out) const {
   if (!out) return Status::InvalidArgument("GetInt32: out=null");
   if (IsNull(s, i)) return Status::NotFound("GetInt32: NULL");
   if (s.GetColumn(i).type != Type::INT32) return Status::InvalidArgument("type mismatch");
@@ -38,7 +43,7 @@ Status Tuple::GetInt32(const Schema& s, size_t i, int32_t* out) const {
   return Status::OK();
 }
 
-Status Tuple::GetInt64(const Schema& s, size_t i, int64_t* out) const {
+Status TupleView::GetInt64(const Schema& s, size_t i, int64_t* out) const {
   if (!out) return Status::InvalidArgument("GetInt64: out=null");
   if (IsNull(s, i)) return Status::NotFound("GetInt64: NULL");
   if (s.GetColumn(i).type != Type::INT64) return Status::InvalidArgument("type mismatch");
@@ -46,7 +51,7 @@ Status Tuple::GetInt64(const Schema& s, size_t i, int64_t* out) const {
   return Status::OK();
 }
 
-Status Tuple::GetFloat(const Schema& s, size_t i, float* out) const {
+Status TupleView::GetFloat(const Schema& s, size_t i, float* out) const {
   if (!out) return Status::InvalidArgument("GetFloat: out=null");
   if (IsNull(s, i)) return Status::NotFound("GetFloat: NULL");
   if (s.GetColumn(i).type != Type::FLOAT) return Status::InvalidArgument("type mismatch");
@@ -54,7 +59,7 @@ Status Tuple::GetFloat(const Schema& s, size_t i, float* out) const {
   return Status::OK();
 }
 
-Status Tuple::GetDouble(const Schema& s, size_t i, double* out) const {
+Status TupleView::GetDouble(const Schema& s, size_t i, double* out) const {
   if (!out) return Status::InvalidArgument("GetDouble: out=null");
   if (IsNull(s, i)) return Status::NotFound("GetDouble: NULL");
   if (s.GetColumn(i).type != Type::DOUBLE) return Status::InvalidArgument("type mismatch");
@@ -62,7 +67,7 @@ Status Tuple::GetDouble(const Schema& s, size_t i, double* out) const {
   return Status::OK();
 }
 
-Status Tuple::GetDate(const Schema& s, size_t i, int32_t* out_days) const {
+Status TupleView::GetDate(const Schema& s, size_t i, int32_t* out_days) const {
   if (!out_days) return Status::InvalidArgument("GetDate: out=null");
   if (IsNull(s, i)) return Status::NotFound("GetDate: NULL");
   if (s.GetColumn(i).type != Type::DATE) return Status::InvalidArgument("type mismatch");
@@ -70,7 +75,7 @@ Status Tuple::GetDate(const Schema& s, size_t i, int32_t* out_days) const {
   return Status::OK();
 }
 
-Status Tuple::GetChar(const Schema& s, size_t i, std::string* out) const {
+Status TupleView::GetCharView(const Schema& s, size_t i, std::string_view* out) const {
   if (!out) return Status::InvalidArgument("GetChar: out=null");
   if (IsNull(s, i)) return Status::NotFound("GetChar: NULL");
   if (s.GetColumn(i).type != Type::CHAR) return Status::InvalidArgument("type mismatch");
@@ -78,11 +83,11 @@ Status Tuple::GetChar(const Schema& s, size_t i, std::string* out) const {
   const char* p  = reinterpret_cast<const char*>(FixedPtr(*this, s, i));
   size_t real = n;
   while (real > 0 && p[real - 1] == '\0') --real;
-  out->assign(p, p + real);
+  *out = std::string_view(p, real);
   return Status::OK();
 }
 
-Status Tuple::GetVarChar(const Schema& s, size_t i, std::string* out) const {
+Status TupleView::GetVarCharView(const Schema& s, size_t i, std::string_view* out) const {
   if (!out) return Status::InvalidArgument("GetVarChar: out=null");
   if (IsNull(s, i)) return Status::NotFound("GetVarChar: NULL");
   if (s.GetColumn(i).type != Type::VARCHAR) return Status::InvalidArgument("type mismatch");
@@ -90,26 +95,54 @@ Status Tuple::GetVarChar(const Schema& s, size_t i, std::string* out) const {
   uint16_t off = 0, len = 0;
   std::memcpy(&off, meta + 0, sizeof(uint16_t));
   std::memcpy(&len, meta + 2, sizeof(uint16_t));
-  if (off + len > data_.size()) return Status::Corruption("varchar offset/len out of range");
-  out->assign(reinterpret_cast<const char*>(data_.data() + off), len);
+  if (static_cast<size_t>(off) + len > size_) return Status::Corruption("varchar offset/len out of range");
+  *out = std::string_view(reinterpret_cast<const char*>(data_ + off), len);
+  return Status::OK();
+}
+
+Status TupleView::GetChar(const Schema& s, size_t i, std::string* out) const {
+  if (!out) return Status::InvalidArgument("GetChar: out=null");
+  std::string_view v;
+  if (Status st = GetCharView(s, i, &v); !st.ok()) return st;
+  out->assign(v.data(), v.size());
+  return Status::OK();
+}
+
+Status TupleView::GetVarChar(const Schema& s, size_t i, std::string* out) const {
+  if (!out) return Status::InvalidArgument("GetVarChar: out=null");
+  std::string_view v;
+  if (Status st = GetVarCharView(s, i, &v); !st.ok()) return st;
+  out->assign(v.data(), v.size());
   return Status::OK();
 }
 
+// ================= Tuple（读取接口委托给 TupleView） =================
+
+bool Tuple::IsNull(const Schema& s, size_t i) const { return View().IsNull(s, i); }
+
+Status Tuple::GetInt32 (const Schema& s, size_t i, int32_t* out) const { return View().GetInt32(s, i, out); }
+Status Tuple::GetInt64 (const Schema& s, size_t i, int64_t* out) const { return View().GetInt64(s, i, out); }
+Status Tuple::GetFloat (const Schema& s, size_t i, float*   out) const { return View().GetFloat(s, i, out); }
+Status Tuple::GetDouble(const Schema& s, size_t i, double*  out) const { return View().GetDouble(s, i, out); }
+Status Tuple::GetDate  (const Schema& s, size_t i, int32_t* out_days) const { return View().GetDate(s, i, out_days); }
+Status Tuple::GetChar  (const Schema& s, size_t i, std::string* out) const { return View().GetChar(s, i, out); }
+Status Tuple::GetVarChar(const Schema& s, size_t i, std::string* out) const { return View().GetVarChar(s, i, out); }
+
 // ================= TupleBuilder =================
 
-TupleBuilder::TupleBuilder(const Schema& s) : s_(s) {
-  row_.assign(s_.FixedAreaSize(), 0);
-  set_.assign(s_.ColumnCount(), false);
+TupleBuilder::TupleBuilder(const Schema& s) : s_(&s) {
+  row_.assign(s_->FixedAreaSize(), 0);
+  set_.assign(s_->ColumnCount(), false);
 }
 
 void TupleBuilder::SetNullBit(size_t i) {
-  if (!s_.UseNullBitmap()) return;
+  if (!s_->UseNullBitmap()) return;
   const size_t byte = i / 8, bit = i % 8;
   row_[byte] |= static_cast<std::uint8_t>(1u << bit);
 }
 
 bool TupleBuilder::GetNullBit(size_t i) const {
-  if (!s_.UseNullBitmap()) return false;
+  if (!s_->UseNullBitmap()) return false;
   const size_t byte = i / 8, bit = i % 8;
   return (row_[byte] >> bit) & 0x1;
 }
@@ -124,10 +157,10 @@ void TupleBuilder::WriteVarMeta(size_t fixed_off, uint16_t off, uint16_t len) {
 }
 
 Status TupleBuilder::SetNull(size_t i) {
-  if (i >= s_.ColumnCount()) return Status::OutOfRange("SetNull: index OOR");
-  if (!s_.GetColumn(i).nullable && s_.UseNullBitmap())
+  if (i >= s_->ColumnCount()) return Status::OutOfRange("SetNull: index OOR");
+  if (!s_->GetColumn(i).nullable && s_->UseNullBitmap())
     return Status::InvalidArgument("SetNull: column not nullable");
-  if (s_.UseNullBitmap()) {
+  if (s_->UseNullBitmap()) {
     SetNullBit(i);
     set_[i] = true;
   } else {
@@ -137,76 +170,99 @@ Status TupleBuilder::SetNull(size_t i) {
 }
 
 Status TupleBuilder::SetInt32(size_t i, int32_t v) {
-  if (i >= s_.ColumnCount()) return Status::OutOfRange("SetInt32: index OOR");
-  if (s_.GetColumn(i).type != Type::INT32) return Status::InvalidArgument("type mismatch");
-  WriteFixed(s_.FixedOffsetOf(i), &v, sizeof(v));
+  if (i >= s_->ColumnCount()) return Status::OutOfRange("SetInt32: index OOR");
+  if (s_->GetColumn(i).type != Type::INT32) return Status::InvalidArgument("type mismatch");
+  WriteFixed(s_->FixedOffsetOf(i), &v, sizeof(v));
   set_[i] = true; return Status::OK();
 }
 
 Status TupleBuilder::SetInt64(size_t i, int64_t v) {
-  if (i >= s_.ColumnCount()) return Status::OutOfRange("SetInt64: index OOR");
-  if (s_.GetColumn(i).type != Type::INT64) return Status::InvalidArgument("type mismatch");
-  WriteFixed(s_.FixedOffsetOf(i), &v, sizeof(v));
+  if (i >= s_->ColumnCount()) return Status::OutOfRange("SetInt64: index OOR");
+  if (s_->GetColumn(i).type != Type::INT64) return Status::InvalidArgument("type mismatch");
+  WriteFixed(s_->FixedOffsetOf(i), &v, sizeof(v));
   set_[i] = true; return Status::OK();
 }
 
 Status TupleBuilder::SetFloat(size_t i, float v) {
-  if (i >= s_.ColumnCount()) return Status::OutOfRange("SetFloat: index OOR");
-  if (s_.GetColumn(i).type != Type::FLOAT) return Status::InvalidArgument("type mismatch");
-  WriteFixed(s_.FixedOffsetOf(i), &v, sizeof(v));
+  if (i >= s_->ColumnCount()) return Status::OutOfRange("SetFloat: index OOR");
+  if (s_->GetColumn(i).type != Type::FLOAT) return Status::InvalidArgument("type mismatch");
+  WriteFixed(s_->FixedOffsetOf(i), &v, sizeof(v));
   set_[i] = true; return Status::OK();
 }
 
 Status TupleBuilder::SetDouble(size_t i, double v) {
-  if (i >= s_.ColumnCount()) return Status::OutOfRange("SetDouble: index OOR");
-  if (s_.GetColumn(i).type != Type::DOUBLE) return Status::InvalidArgument("type mismatch");
-  WriteFixed(s_.FixedOffsetOf(i), &v, sizeof(v));
+  if (i >= s_->ColumnCount()) return Status::OutOfRange("SetDouble: index OOR");
+  if (s_->GetColumn(i).type != Type::DOUBLE) return Status::InvalidArgument("type mismatch");
+  WriteFixed(s_->FixedOffsetOf(i), &v, sizeof(v));
   set_[i] = true; return Status::OK();
 }
 
 Status TupleBuilder::SetDate(size_t i, int32_t days) {
-  if (i >= s_.ColumnCount()) return Status::OutOfRange("SetDate: index OOR");
-  if (s_.GetColumn(i).type != Type::DATE) return Status::InvalidArgument("type mismatch");
-  WriteFixed(s_.FixedOffsetOf(i), &days, sizeof(days));
+  if (i >= s_->ColumnCount()) return Status::OutOfRange("SetDate: index OOR");
+  if (s_->GetColumn(i).type != Type::DATE) return Status::InvalidArgument("type mismatch");
+  WriteFixed(s_->FixedOffsetOf(i), &days, sizeof(days));
   set_[i] = true; return Status::OK();
 }
 
 Status TupleBuilder::SetChar(size_t i, std::string_view v) {
-  if (i >= s_.ColumnCount()) return Status::OutOfRange("SetChar: index OOR");
-  const auto& c = s_.GetColumn(i);
+  if (i >= s_->ColumnCount()) return Status::OutOfRange("SetChar: index OOR");
+  const auto& c = s_->GetColumn(i);
   if (c.type != Type::CHAR) return Status::InvalidArgument("type mismatch");
-  const size_t N = s_.FixedSizeOf(i);
-  std::vector<char> buf(N, '\0');
+  // 直接写入定长区：拷贝前 min(N, |v|) 字节，其余补 '\0'（不借助临时缓冲）
+  const size_t N    = s_->FixedSizeOf(i);
   const size_t copy = std::min(N, v.size());
-  std::memcpy(buf.data(), v.data(), copy);
-  WriteFixed(s_.FixedOffsetOf(i), buf.data(), N);
+  std::uint8_t* dst = row_.data() + s_->FixedOffsetOf(i);
+  std::memcpy(dst, v.data(), copy);
+  std::memset(dst + copy, 0, N - copy);
   set_[i] = true; return Status::OK();
 }
 
 Status TupleBuilder::SetVarChar(size_t i, std::string_view v) {
-  if (i >= s_.ColumnCount()) return Status::OutOfRange("SetVarChar: index OOR");
-  const auto& c = s_.GetColumn(i);
+  if (i >= s_->ColumnCount()) return Status::OutOfRange("SetVarChar: index OOR");
+  const auto& c = s_->GetColumn(i);
   if (c.type != Type::VARCHAR) return Status::InvalidArgument("type mismatch");
   if (v.size() > c.len) return Status::OutOfRange("varchar exceeds max length");
 
-  const uint16_t off = static_cast<uint16_t>(s_.FixedAreaSize() + var_.size());
+  const uint16_t off = static_cast<uint16_t>(s_->FixedAreaSize() + var_.size());
   const uint16_t len = static_cast<uint16_t>(v.size());
-  WriteVarMeta(s_.FixedOffsetOf(i), off, len);
+  WriteVarMeta(s_->FixedOffsetOf(i), off, len);
   var_.insert(var_.end(), v.begin(), v.end());
 
   set_[i] = true; return Status::OK();
 }
 
+void TupleBuilder::Reset() {
+  std::fill(row_.begin(), row_.end(), 0);
+  std::fill(set_.begin(), set_.end(), false);
+  var_.clear();  // 保留容量
+}
+
+bool TupleBuilder::Complete() const noexcept {
+  return std::find(set_.begin(), set_.end(), false) == set_.end();
+}
+
 Status TupleBuilder::Build(Tuple* out) {
   if (!out) return Status::InvalidArgument("Build: out=null");
-  for (size_t i = 0; i < s_.ColumnCount(); ++i) {
+  for (size_t i = 0; i < s_->ColumnCount(); ++i) {
     if (!set_[i]) return Status::InvalidArgument("column not set: idx=" + std::to_string(i));
   }
-  std::vector<std::uint8_t> bytes;
-  bytes.reserve(s_.FixedAreaSize() + var_.size());
+  // 写入 out 已有的缓冲：反复构造到同一个 Tuple 时不再分配
+  std::vector<std::uint8_t>& bytes = out->data_;
+  bytes.clear();
+  bytes.reserve(BuiltSize());
   bytes.insert(bytes.end(), row_.begin(), row_.end());
   bytes.insert(bytes.end(), var_.begin(), var_.end());
-  *out = Tuple(std::move(bytes));
+  return Status::OK();
+}
+
+Status TupleBuilder::BuildInto(std::uint8_t* dst, size_t cap, size_t* out_len) const {
+  if (!dst) return Status::InvalidArgument("BuildInto: dst=null");
+  if (!Complete()) return Status::InvalidArgument("BuildInto: column not set");
+  const size_t n = BuiltSize();
+  if (cap < n) return Status::OutOfRange("BuildInto: buffer too small");
+  std::memcpy(dst, row_.data(), row_.size());
+  if (!var_.empty()) std::memcpy(dst + row_.size(), var_.data(), var_.size());
+  if (out_len) *out_len = n;
   return Status::OK();
 }
 
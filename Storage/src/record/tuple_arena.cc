@@ -0,0 +1,47 @@
+#include "dbms/storage/record/tuple_arena.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace dbms {
+namespace storage {
+
+TupleArena::TupleArena(size_t block_size) : block_size_(block_size ? block_size : kDefaultBlockSize) {}
+
+std::uint8_t* TupleArena::AllocateSlow(size_t n, size_t align) {
+  // 先试 Reset 后留下的后续块（跳过放不下的）；都不行再申请新块，大分配单独成块
+  const size_t need = n + align;
+  size_t next = blocks_.empty() ? 0 : cur_ + 1;
+  while (next < blocks_.size() && blocks_[next].size < need) ++next;
+  if (next == blocks_.size()) {
+    Block b;
+    b.size = std::max(block_size_, need);
+    b.mem.reset(new std::uint8_t[b.size]);
+    reserved_ += b.size;
+    blocks_.push_back(std::move(b));
+  }
+  cur_ = next;
+  off_ = 0;
+  return Allocate(n, align);
+}
+
+TupleView TupleArena::Copy(const std::uint8_t* data, size_t len) {
+  std::uint8_t* p = Allocate(len, 1);
+  if (len) std::memcpy(p, data, len);
+  return TupleView(p, len);
+}
+
+void TupleArena::Reset() noexcept {
+  cur_  = 0;
+  off_  = 0;
+  used_ = 0;
+}
+
+void TupleArena::Release() noexcept {
+  blocks_.clear();
+  Reset();
+  reserved_ = 0;
+}
+
+}  // namespace storage
+}  // namespace dbms
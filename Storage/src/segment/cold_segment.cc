@@ -0,0 +1,237 @@
+#include "internal/segment/cold_segment.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#include "dbms/storage/page/page.h"
+#include "internal/io/aligned_buffer.h"
+#include "internal/page/page_codec.h"
+#include "internal/util/crc32c.h"
+#include "internal/util/hash.h"
+
+namespace dbms {
+namespace storage {
+
+namespace {
+
+constexpr uint32_t kColdMagic   = 0x444C4344;  // "DCLD"
+constexpr uint32_t kColdVersion = 1;
+constexpr uint32_t kBuildChunk  = 256;          // 建段时每次顺序读取的页数
+constexpr size_t   kWriteBuffer = 1u << 20;     // 建段时页数据的写缓冲
+
+struct ColdHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t page_size;
+  uint32_t reserved;
+  uint64_t page_count;
+  uint64_t stored_bytes;
+  uint64_t raw_pages;
+  uint64_t lz4_pages;
+  uint64_t pax_pages;
+  uint64_t for_columns;
+  uint64_t dict_columns;
+  uint64_t checksum;  // 覆盖 page_count ~ dict_columns 与目录
+};
+
+uint64_t HeaderChecksum(const ColdHeader& h, const void* dir, size_t dir_bytes) {
+  const auto* fields = reinterpret_cast<const std::uint8_t*>(&h.page_count);
+  const size_t n = offsetof(ColdHeader, checksum) - offsetof(ColdHeader, page_count);
+  return Fnv1a64(dir, dir_bytes, Fnv1a64(fields, n));
+}
+
+}  // namespace
+
+Status ColdSegment::Build(const std::string& path, DiskManager* src, uint64_t pages, uint32_t page_size,
+                          const Schema* schema) {
+  if (!src) return Status::InvalidArgument("ColdSegment::Build: src=null");
+  const std::string tmp = path + ".tmp";
+  File f(tmp);
+  if (Status s = f.Open(/*create_if_missing=*/true); !s.ok()) return s;
+  if (Status s = f.Resize(0); !s.ok()) return s;
+
+  std::vector<DirEntry> dir(static_cast<size_t>(pages));
+  const uint64_t data_begin = sizeof(ColdHeader) + dir.size() * sizeof(DirEntry);
+  uint64_t       data_off   = data_begin;
+
+  ColdHeader hdr{};
+  hdr.magic      = kColdMagic;
+  hdr.version    = kColdVersion;
+  hdr.page_size  = page_size;
+  hdr.page_count = pages;
+
+  AlignedBuffer in(static_cast<size_t>(kBuildChunk) * page_size);
+  if (!in.data()) return Status::IOError("ColdSegment::Build: out of memory");
+  std::vector<std::uint8_t> blob, wbuf;
+  wbuf.reserve(kWriteBuffer + page_size + 1);
+  PageCodecCounts counts;
+  auto flush = [&]() {
+    if (wbuf.empty()) return Status::OK();
+    Status s = f.WriteAt(wbuf.data(), wbuf.size(), data_off);
+    data_off += wbuf.size();
+    wbuf.clear();
+    return s;
+  };
+
+  for (uint64_t done = 0; done < pages;) {
+    const uint32_t n = static_cast<uint32_t>(std::min<uint64_t>(kBuildChunk, pages - done));
+    if (Status s = src->ReadPages(static_cast<page_id_t>(done), n, in.data()); !s.ok()) return s;
+    for (uint32_t i = 0; i < n; ++i) {
+      const std::uint8_t* page = in.data() + static_cast<size_t>(i) * page_size;
+      const PageEncoding enc = EncodePage(page, page_size, schema, &blob, &counts);
+      DirEntry& e = dir[done + i];
+      e = DirEntry{};
+      e.off      = data_off + wbuf.size();
+      e.len      = static_cast<uint32_t>(blob.size());
+      e.crc      = Crc32c(blob.data(), blob.size());
+      e.encoding = static_cast<uint8_t>(enc);
+      const auto* ph = reinterpret_cast<const PageHeader*>(page);
+      e.usable   = ph->format_version == kPageFormatVersion ? PageUsableSpace(*ph) : 0;
+      switch (enc) {
+        case PageEncoding::kRaw: hdr.raw_pages++; break;
+        case PageEncoding::kLz4: hdr.lz4_pages++; break;
+        case PageEncoding::kPax: hdr.pax_pages++; break;
+      }
+      hdr.stored_bytes += blob.size();
+      wbuf.insert(wbuf.end(), blob.begin(), blob.end());
+      if (wbuf.size() >= kWriteBuffer) {
+        if (Status s = flush(); !s.ok()) return s;
+      }
+    }
+    done += n;
+  }
+  if (Status s = flush(); !s.ok()) return s;
+
+  hdr.for_columns  = counts.for_columns;
+  hdr.dict_columns = counts.dict_columns;
+  hdr.checksum     = HeaderChecksum(hdr, dir.data(), dir.size() * sizeof(DirEntry));
+  Status s = f.WriteAt(dir.data(), dir.size() * sizeof(DirEntry), sizeof(ColdHeader));
+  if (s.ok()) s = f.WriteAt(&hdr, sizeof(hdr), 0);
+  if (s.ok()) s = f.Sync();
+  if (!s.ok()) return s;
+  f.Close();
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+    return Status::IOError("ColdSegment::Build: rename '" + tmp + "' failed");
+  }
+  return Status::OK();
+}
+
+Status ColdSegment::Open(const std::string& path, uint32_t page_size, std::unique_ptr<ColdSegment>* out) {
+  if (!out) return Status::InvalidArgument("ColdSegment::Open: out=null");
+  std::unique_ptr<ColdSegment> c(new ColdSegment(path, page_size));
+  if (!c->file_.Open(/*create_if_missing=*/false).ok()) return Status::NotFound("no cold file: " + path);
+
+  ColdHeader hdr{};
+  const uint64_t bytes = c->file_.SizeBytes();
+  if (bytes < sizeof(hdr) || !c->file_.ReadAt(&hdr, sizeof(hdr), 0).ok()) {
+    return Status::Corruption("ColdSegment::Open: truncated header");
+  }
+  if (hdr.magic != kColdMagic || hdr.version != kColdVersion || hdr.page_size != page_size ||
+      hdr.page_count > (bytes - sizeof(hdr)) / sizeof(DirEntry)) {
+    return Status::Corruption("ColdSegment::Open: bad header");
+  }
+  c->dir_.resize(static_cast<size_t>(hdr.page_count));
+  const size_t dir_bytes = c->dir_.size() * sizeof(DirEntry);
+  if (dir_bytes > 0 && !c->file_.ReadAt(c->dir_.data(), dir_bytes, sizeof(hdr)).ok()) {
+    return Status::Corruption("ColdSegment::Open: truncated directory");
+  }
+  if (HeaderChecksum(hdr, c->dir_.data(), dir_bytes) != hdr.checksum) {
+    return Status::Corruption("ColdSegment::Open: checksum mismatch");
+  }
+  for (const DirEntry& e : c->dir_) {
+    if (e.len == 0 || e.off + e.len > bytes) return Status::Corruption("ColdSegment::Open: bad directory entry");
+  }
+  c->built_.cold         = true;
+  c->built_.pages        = hdr.page_count;
+  c->built_.raw_bytes    = hdr.page_count * page_size;
+  c->built_.stored_bytes = hdr.stored_bytes;
+  c->built_.raw_pages    = hdr.raw_pages;
+  c->built_.lz4_pages    = hdr.lz4_pages;
+  c->built_.pax_pages    = hdr.pax_pages;
+  c->built_.for_columns  = hdr.for_columns;
+  c->built_.dict_columns = hdr.dict_columns;
+  *out = std::move(c);
+  return Status::OK();
+}
+
+Status ColdSegment::ReadRun(page_id_t first, uint32_t n, std::uint8_t* const* outs, Status* per_page) const {
+  const DirEntry& lo = dir_[first];
+  const DirEntry& hi = dir_[first + n - 1];
+  const uint64_t  begin = lo.off;
+  const uint64_t  end   = hi.off + hi.len;
+  // 建段时页数据按页号顺序写入，连续页号的数据在文件中也连续
+  if (end < begin) return Status::Corruption("ColdSegment: directory out of order");
+
+  thread_local std::vector<std::uint8_t> buf;
+  buf.resize(static_cast<size_t>(end - begin));
+  if (Status s = file_.ReadAt(buf.data(), buf.size(), begin); !s.ok()) {
+    if (per_page) for (uint32_t i = 0; i < n; ++i) per_page[i] = s;
+    return s;
+  }
+  read_bytes_.fetch_add(buf.size(), std::memory_order_relaxed);
+
+  const auto t0 = std::chrono::steady_clock::now();
+  Status first_err;
+  for (uint32_t i = 0; i < n; ++i) {
+    const DirEntry& e = dir_[first + i];
+    const std::uint8_t* blob = buf.data() + (e.off - begin);
+    Status s;
+    if (e.off < begin || e.off + e.len > end || Crc32c(blob, e.len) != e.crc) {
+      s = Status::Corruption("ColdSegment: page " + std::to_string(first + i) + " checksum mismatch");
+    } else {
+      s = DecodePage(blob, e.len, outs[i], page_size_);
+    }
+    if (!s.ok() && first_err.ok()) first_err = s;
+    if (per_page) per_page[i] = std::move(s);
+  }
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+  decode_ns_.fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+  decoded_pages_.fetch_add(n, std::memory_order_relaxed);
+  return first_err;
+}
+
+Status ColdSegment::ReadPages(page_id_t first, uint32_t n, void* out) const {
+  auto* dst = static_cast<std::uint8_t*>(out);
+  const uint64_t have = first < dir_.size() ? std::min<uint64_t>(n, dir_.size() - first) : 0;
+  if (have < n) std::memset(dst + have * page_size_, 0, static_cast<size_t>(n - have) * page_size_);
+  if (have == 0) return Status::OK();
+  thread_local std::vector<std::uint8_t*> outs;
+  outs.resize(static_cast<size_t>(have));
+  for (size_t i = 0; i < outs.size(); ++i) outs[i] = dst + i * page_size_;
+  return ReadRun(first, static_cast<uint32_t>(have), outs.data(), nullptr);
+}
+
+void ColdSegment::ReadBatch(const DiskManager::PageIo* ios, size_t n, Status* per_page) const {
+  std::vector<std::uint8_t*> outs;
+  for (size_t lo = 0; lo < n;) {
+    const page_id_t first = ios[lo].pid;
+    if (ios[lo].op != IoOp::kRead) {
+      per_page[lo++] = Status::InvalidArgument("ColdSegment: segment is read-only");
+      continue;
+    }
+    if (first >= dir_.size()) {
+      std::memset(ios[lo].buf, 0, page_size_);
+      per_page[lo++] = Status::OK();
+      continue;
+    }
+    size_t hi = lo + 1;
+    while (hi < n && ios[hi].op == IoOp::kRead && ios[hi].pid == first + (hi - lo) && ios[hi].pid < dir_.size()) ++hi;
+    outs.clear();
+    for (size_t i = lo; i < hi; ++i) outs.push_back(static_cast<std::uint8_t*>(ios[i].buf));
+    (void)ReadRun(first, static_cast<uint32_t>(hi - lo), outs.data(), per_page + lo);
+    lo = hi;
+  }
+}
+
+void ColdSegment::FillStats(ColdSegmentStats* st) const {
+  *st = built_;
+  st->decoded_pages = decoded_pages_.load(std::memory_order_relaxed);
+  st->read_bytes    = read_bytes_.load(std::memory_order_relaxed);
+  st->decode_ns     = decode_ns_.load(std::memory_order_relaxed);
+}
+
+}  // namespace storage
+}  // namespace dbms
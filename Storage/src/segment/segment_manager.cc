@@ -1,14 +1,73 @@
 #include "dbms/storage/segment/segment_manager.h"
+#include <algorithm>
 #include <cassert>
+#include <cstdio>
 #include <cstring>
+#include <iterator>
 #include <utility>
 #include <vector>
 
+#include "dbms/storage/io/file.h"
+#include "internal/io/aligned_buffer.h"
+#include "internal/segment/cold_segment.h"
+#include "internal/util/hash.h"
+
 namespace dbms {
 namespace storage {
 
-SegmentManager::SegmentManager(uint32_t page_size, std::string base_dir)
-    : page_size_(page_size), base_dir_(std::move(base_dir)) {}
+namespace {
+
+constexpr uint32_t kSegMetaMagic   = 0x47455344;  // "DSEG"
+constexpr uint32_t kSegMetaVersion = 2;           // v2：增加区段表与空闲区段
+constexpr uint32_t kProbeChunk     = 256;         // 批量探测/恢复时每次顺序读取的页数
+
+/// seg_<id>.meta 文件头；其后依次为 free_count 个 page_id_t、
+/// extent_count 个区段、free_extent_count 个空闲区段（区段为 {first, count} 两个 uint32）
+struct SegMetaHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t page_size;
+  uint32_t reserved;
+  uint64_t page_count;   // 检查点时的高水位
+  uint64_t free_count;
+  uint64_t extent_count;
+  uint64_t free_extent_count;
+  uint64_t checksum;     // 覆盖 page_count 与其后的全部内容
+};
+
+/// 页内是否可能还有存活记录（空闲页恢复时用来剔除已被复用的页）
+bool PageMayHoldRecords(const std::uint8_t* page) {
+  const auto* hdr = reinterpret_cast<const PageHeader*>(page);
+  return hdr->format_version == kPageFormatVersion && hdr->slot_count > 0;
+}
+
+bool PageInitialized(const std::uint8_t* page) {
+  return reinterpret_cast<const PageHeader*>(page)->format_version == kPageFormatVersion;
+}
+
+/// 从 hi 向 lo 逆向分块读取（read(first, n, buf)），返回最后一个已初始化页之后的页号（全部未初始化返回 lo）
+template <class ReadFn>
+uint64_t ScanHighWater(ReadFn&& read, uint32_t page_size, uint64_t lo, uint64_t hi) {
+  AlignedBuffer buf(static_cast<size_t>(kProbeChunk) * page_size);
+  if (!buf.data()) return hi;  // 无法探测时保守地认为全部已用
+  for (uint64_t end = hi; end > lo;) {
+    const uint64_t begin = end - std::min<uint64_t>(kProbeChunk, end - lo);
+    const uint32_t n = static_cast<uint32_t>(end - begin);
+    if (!read(static_cast<page_id_t>(begin), n, buf.data()).ok()) return end;
+    for (uint32_t i = n; i-- > 0;) {
+      if (PageInitialized(buf.data() + static_cast<size_t>(i) * page_size)) return begin + i + 1;
+    }
+    end = begin;
+  }
+  return lo;
+}
+
+}  // namespace
+
+SegmentManager::SegmentManager(uint32_t page_size, std::string base_dir, bool direct_io)
+    : page_size_(page_size), base_dir_(std::move(base_dir)), direct_io_(direct_io) {
+  SetExtentPolicy(kDefaultExtentMinBytes, kDefaultExtentMaxBytes);
+}
 
 SegmentManager::~SegmentManager() = default;
 
@@ -18,31 +77,252 @@ std::string SegmentManager::MakePath(seg_id_t seg) const {
 
 std::string SegmentManager::SegmentPath(seg_id_t seg) const { return MakePath(seg); }
 
-Status SegmentManager::EnsureSegment(seg_id_t seg) {
-  std::lock_guard<std::mutex> g(mu_);
+void SegmentManager::SetExtentPolicy(uint64_t min_bytes, uint64_t max_bytes) {
+  const uint64_t lo = std::max<uint64_t>(1, min_bytes / page_size_);
+  const uint64_t hi = std::max<uint64_t>(lo, max_bytes / page_size_);
+  extent_min_pages_.store(lo, std::memory_order_relaxed);
+  extent_max_pages_.store(hi, std::memory_order_relaxed);
+}
+
+SegmentManager::Segment* SegmentManager::FindSegment(seg_id_t seg) const {
+  std::shared_lock<std::shared_mutex> g(mu_);
   auto it = segs_.find(seg);
-  if (it != segs_.end()) return Status::OK();
+  return it == segs_.end() ? nullptr : it->second.get();  // 段不会被移除，指针长期有效
+}
+
+SegmentManager::Segment* SegmentManager::GetOrCreateSegment(seg_id_t seg) {
+  if (Segment* s = FindSegment(seg)) return s;
+
+  std::unique_lock<std::shared_mutex> g(mu_);
+  auto it = segs_.find(seg);
+  if (it != segs_.end()) return it->second.get();
+
+  auto s = std::make_unique<Segment>();
+  s->disk = std::make_unique<DiskManager>(MakePath(seg), page_size_, direct_io_);
+  s->disk->SetIoBackend(io_);
+  s->disk->SetMetrics(metrics_);
+  std::unique_ptr<ColdSegment> cold;
+  if (ColdSegment::Open(MakePath(seg) + ".cold", page_size_, &cold).ok()) {
+    s->cold.store(cold.get(), std::memory_order_release);
+    s->read_only.store(true);
+    s->retired.push_back(std::move(cold));
+  }
+  LoadMeta(seg, s.get());
+  return segs_.emplace(seg, std::move(s)).first->second.get();
+}
+
+void SegmentManager::LoadMeta(seg_id_t seg, Segment* s) {
+  DiskManager* dm = s->disk.get();
+  s->file_pages = dm->PageCount();  // 打开时 fstat 一次，之后只在内存中维护
+  uint64_t hwm_floor = 0;
+
+  std::vector<page_id_t> free_list;
+  std::vector<Extent> extents, free_extents;
+  File f(MakePath(seg) + ".meta");
+  bool meta_ok = false;
+  if (f.Open(/*create_if_missing=*/false).ok()) {  // 无元数据：新段或旧版本
+    const uint64_t bytes = f.SizeBytes();
+    std::vector<std::uint8_t> raw(static_cast<size_t>(bytes));
+    SegMetaHeader hdr{};
+    if (bytes >= sizeof(hdr) && f.ReadAt(raw.data(), raw.size(), 0).ok()) {
+      std::memcpy(&hdr, raw.data(), sizeof(hdr));
+      const uint64_t payload = hdr.free_count * sizeof(page_id_t) +
+                               (hdr.extent_count + hdr.free_extent_count) * sizeof(Extent);
+      meta_ok = hdr.magic == kSegMetaMagic && hdr.version == kSegMetaVersion &&
+                hdr.page_size == page_size_ && sizeof(hdr) + payload == bytes &&
+                Fnv1a64(raw.data() + sizeof(hdr), static_cast<size_t>(payload),
+                        Fnv1a64(&hdr.page_count, sizeof(hdr.page_count))) == hdr.checksum;
+    }
+    if (meta_ok) {
+      const std::uint8_t* p = raw.data() + sizeof(hdr);
+      free_list.resize(static_cast<size_t>(hdr.free_count));
+      extents.resize(static_cast<size_t>(hdr.extent_count));
+      free_extents.resize(static_cast<size_t>(hdr.free_extent_count));
+      std::memcpy(free_list.data(), p, free_list.size() * sizeof(page_id_t));
+      p += free_list.size() * sizeof(page_id_t);
+      std::memcpy(extents.data(), p, extents.size() * sizeof(Extent));
+      p += extents.size() * sizeof(Extent);
+      std::memcpy(free_extents.data(), p, free_extents.size() * sizeof(Extent));
+      hwm_floor = std::min(hdr.page_count, s->file_pages);
+    }
+  }
+
+  // 检查点之后分配并写出的页不在元数据里：从文件尾逆向找最后一个已初始化页
+  // （预留但从未写过的尾部页不算已分配）；冷段的页数总是已分配的
+  auto read = [this, s](page_id_t first, uint32_t n, void* out) { return ReadPagesRouted(s, first, n, out); };
+  if (ColdSegment* c = s->cold.load(std::memory_order_acquire)) hwm_floor = std::max(hwm_floor, c->page_count());
+  const uint64_t hwm = std::max(hwm_floor, ScanHighWater(read, page_size_, hwm_floor, s->file_pages));
+  s->hwm.store(hwm, std::memory_order_relaxed);
+
+  // 区段表只影响之后的增长节奏：缺失时把现有文件视为一个区段
+  for (const Extent& e : extents) {
+    if (e.first + static_cast<uint64_t>(e.count) <= s->file_pages) s->extents.push_back(e);
+  }
+  if (s->extents.empty() && s->file_pages > 0) {
+    s->extents.push_back(Extent{0, static_cast<uint32_t>(std::min<uint64_t>(s->file_pages, UINT32_MAX))});
+  }
+
+  // 检查点之后空闲页可能已被再次分配：只保留仍在高水位之内、且确实没有记录的页
+  AlignedBuffer buf(static_cast<size_t>(kProbeChunk) * page_size_);
+  if (!buf.data()) return;
+  auto keep_empty = [&](uint64_t first, uint64_t n, bool as_pages) {
+    if (first >= hwm) return;
+    n = std::min(n, hwm - first);
+    for (uint64_t done = 0; done < n;) {
+      const uint32_t cnt = static_cast<uint32_t>(std::min<uint64_t>(kProbeChunk, n - done));
+      if (!read(static_cast<page_id_t>(first + done), cnt, buf.data()).ok()) return;
+      for (uint32_t i = 0; i < cnt; ++i) {
+        if (PageMayHoldRecords(buf.data() + static_cast<size_t>(i) * page_size_)) continue;
+        const page_id_t pid = static_cast<page_id_t>(first + done + i);
+        if (as_pages) s->free_list.push_back(pid);
+        else FreeRunLocked(s, pid, 1);  // 连续的空页会重新合并成区段
+      }
+      done += cnt;
+    }
+  };
+  for (page_id_t pid : free_list) keep_empty(pid, 1, /*as_pages=*/true);
+  for (const Extent& e : free_extents) keep_empty(e.first, e.count, /*as_pages=*/false);
+}
 
-  std::string path = MakePath(seg);
-  auto dm = std::make_unique<DiskManager>(path, page_size_);
+Status SegmentManager::Checkpoint(seg_id_t seg) {
+  Segment* S = FindSegment(seg);
+  if (!S || !S->disk) return Status::NotFound("Checkpoint: unknown segment");
 
-  Segment s;
-  s.disk = std::move(dm);
-  s.free_list.clear();
-  segs_.emplace(seg, std::move(s));
+  std::vector<page_id_t> free_list;
+  std::vector<Extent> extents, free_extents;
+  uint64_t pages = 0;
+  {
+    std::lock_guard<std::mutex> g(S->mu);
+    free_list    = S->free_list;
+    extents      = S->extents;
+    free_extents = S->free_extents;
+    pages        = S->hwm.load(std::memory_order_relaxed);
+  }
+
+  // 数据页需先于元数据持久化（元数据里的页数不能超前于文件）
+  if (Status s = S->disk->Sync(); !s.ok()) return s;
+
+  SegMetaHeader hdr{kSegMetaMagic, kSegMetaVersion, page_size_, 0, pages,
+                    static_cast<uint64_t>(free_list.size()),
+                    static_cast<uint64_t>(extents.size()),
+                    static_cast<uint64_t>(free_extents.size()), 0};
+  std::vector<std::uint8_t> raw(sizeof(hdr));
+  auto append = [&raw](const void* p, size_t n) {
+    const auto* b = static_cast<const std::uint8_t*>(p);
+    raw.insert(raw.end(), b, b + n);
+  };
+  append(free_list.data(), free_list.size() * sizeof(page_id_t));
+  append(extents.data(), extents.size() * sizeof(Extent));
+  append(free_extents.data(), free_extents.size() * sizeof(Extent));
+  hdr.checksum = Fnv1a64(raw.data() + sizeof(hdr), raw.size() - sizeof(hdr),
+                         Fnv1a64(&hdr.page_count, sizeof(hdr.page_count)));
+  std::memcpy(raw.data(), &hdr, sizeof(hdr));
+
+  const std::string path = MakePath(seg) + ".meta";
+  const std::string tmp  = path + ".tmp";
+  {
+    File f(tmp);
+    Status s = f.Open(/*create_if_missing=*/true);
+    if (s.ok()) s = f.Resize(0);
+    if (s.ok()) s = f.WriteAt(raw.data(), raw.size(), 0);
+    if (s.ok()) s = f.Sync();
+    if (!s.ok()) return s;
+  }
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+    return Status::IOError("Checkpoint: rename '" + tmp + "' failed");
+  }
   return Status::OK();
 }
 
-page_id_t SegmentManager::AllocatePage(seg_id_t seg) {
-  std::lock_guard<std::mutex> g(mu_);
-  auto it = segs_.find(seg);
-  if (it == segs_.end()) {
-    if (!EnsureSegment(seg).ok()) return kInvalidPageId;
-    it = segs_.find(seg);
-    if (it == segs_.end()) return kInvalidPageId;
+Status SegmentManager::CheckpointAll() {
+  std::vector<seg_id_t> ids;
+  {
+    std::shared_lock<std::shared_mutex> g(mu_);
+    for (const auto& kv : segs_) ids.push_back(kv.first);
+  }
+  for (seg_id_t seg : ids) {
+    if (Status s = Checkpoint(seg); !s.ok()) return s;
+  }
+  return Status::OK();
+}
+
+DiskManager* SegmentManager::GetFsmDisk(seg_id_t seg) {
+  Segment* S = FindSegment(seg);
+  if (!S) return nullptr;
+  std::lock_guard<std::mutex> g(S->mu);
+  if (!S->fsm_disk) {
+    // FSM 分叉只在检查点/启动时整体读写，不需要直接 I/O
+    S->fsm_disk = std::make_unique<DiskManager>(MakePath(seg) + ".fsm", page_size_);
+  }
+  return S->fsm_disk.get();
+}
+
+DiskManager* SegmentManager::GetZoneDisk(seg_id_t seg) {
+  Segment* S = FindSegment(seg);
+  if (!S) return nullptr;
+  std::lock_guard<std::mutex> g(S->mu);
+  if (!S->zone_disk) S->zone_disk = std::make_unique<DiskManager>(MakePath(seg) + ".zone", page_size_);
+  return S->zone_disk.get();
+}
+
+Status SegmentManager::EnsureSegment(seg_id_t seg) {
+  GetOrCreateSegment(seg);
+  return Status::OK();
+}
+
+bool SegmentManager::GrowLocked(Segment* S, uint64_t pages) {
+  if (pages <= S->file_pages) return true;
+  if (pages > kInvalidPageId) return false;  // 页号空间耗尽
+
+  // 几何增长：从上一个区段翻倍（封顶 extent_max），且至少满足本次需要
+  const uint64_t lo = extent_min_pages_.load(std::memory_order_relaxed);
+  const uint64_t hi = extent_max_pages_.load(std::memory_order_relaxed);
+  uint64_t ext = S->extents.empty() ? lo : std::min(hi, std::max(lo, 2 * uint64_t{S->extents.back().count}));
+  ext = std::max(ext, pages - S->file_pages);
+  ext = std::min<uint64_t>(ext, uint64_t{kInvalidPageId} - S->file_pages);
+
+  if (!S->disk->PreallocateToPages(S->file_pages + ext).ok()) {
+    // 磁盘紧张时退而只扩展本次需要的页
+    ext = pages - S->file_pages;
+    if (!S->disk->PreallocateToPages(pages).ok()) return false;
   }
+  S->extents.push_back(Extent{static_cast<page_id_t>(S->file_pages), static_cast<uint32_t>(ext)});
+  S->file_pages += ext;
+  return true;
+}
+
+void SegmentManager::FreeRunLocked(Segment* S, page_id_t first, uint64_t n) {
+  if (n == 0) return;
+  auto& fe = S->free_extents;
+  auto it = std::lower_bound(fe.begin(), fe.end(), first,
+                             [](const Extent& e, page_id_t p) { return e.first < p; });
+  // 与前后相邻的空闲区段合并
+  uint64_t b = first, e = first + n;
+  if (it != fe.begin() && uint64_t{std::prev(it)->first} + std::prev(it)->count >= b) {
+    --it;
+    b = it->first;
+    e = std::max(e, uint64_t{it->first} + it->count);
+    it = fe.erase(it);
+  }
+  while (it != fe.end() && it->first <= e) {
+    e = std::max(e, uint64_t{it->first} + it->count);
+    it = fe.erase(it);
+  }
+  // 位于高水位末尾：直接回退高水位（文件仍保留预留块，之后追加时复用）
+  if (e >= S->hwm.load(std::memory_order_relaxed)) {
+    S->hwm.store(b, std::memory_order_relaxed);
+    // 空闲栈里落到新高水位之外的页会被再次追加分配，不能重复发放
+    auto& fl = S->free_list;
+    fl.erase(std::remove_if(fl.begin(), fl.end(), [b](page_id_t p) { return p >= b; }), fl.end());
+    return;
+  }
+  fe.insert(it, Extent{static_cast<page_id_t>(b), static_cast<uint32_t>(e - b)});
+}
 
-  Segment& S = it->second;
+page_id_t SegmentManager::AllocatePage(seg_id_t seg) {
+  Segment& S = *GetOrCreateSegment(seg);
+  std::lock_guard<std::mutex> g(S.mu);
+  if (S.read_only.load(std::memory_order_relaxed)) return kInvalidPageId;  // 冷段 / 正在冻结
 
   // 1) 复用空闲页
   if (!S.free_list.empty()) {
@@ -51,51 +331,287 @@ page_id_t SegmentManager::AllocatePage(seg_id_t seg) {
     return pid;
   }
 
-  // 2) 追加新页
-  DiskManager* dm = S.disk.get();
-  if (!dm) return kInvalidPageId;
+  // 2) 复用空闲区段（取页号最小者的首页）
+  if (!S.free_extents.empty()) {
+    Extent& e = S.free_extents.front();
+    const page_id_t pid = e.first++;
+    if (--e.count == 0) S.free_extents.erase(S.free_extents.begin());
+    return pid;
+  }
+
+  // 3) 推进高水位；只有用完已预留的区段时才扩展文件
+  const uint64_t hwm = S.hwm.load(std::memory_order_relaxed);
+  if (!GrowLocked(&S, hwm + 1)) return kInvalidPageId;
+  S.hwm.store(hwm + 1, std::memory_order_relaxed);
+  return static_cast<page_id_t>(hwm);
+}
+
+page_id_t SegmentManager::AllocatePages(seg_id_t seg, uint32_t n) {
+  if (n == 0) return kInvalidPageId;
+  Segment& S = *GetOrCreateSegment(seg);
+  std::lock_guard<std::mutex> g(S.mu);
+  if (S.read_only.load(std::memory_order_relaxed)) return kInvalidPageId;  // 冷段 / 正在冻结
 
-  const uint64_t count = dm->PageCount();
-  const page_id_t pid  = static_cast<page_id_t>(count);
-  Status s = dm->ResizeToPages(count + 1);
-  if (!s.ok()) return kInvalidPageId;
-  return pid;
+  // 1) 首次适配空闲区段
+  for (auto it = S.free_extents.begin(); it != S.free_extents.end(); ++it) {
+    if (it->count < n) continue;
+    const page_id_t first = it->first;
+    it->first += n;
+    it->count -= n;
+    if (it->count == 0) S.free_extents.erase(it);
+    return first;
+  }
+
+  // 2) 高水位之后
+  const uint64_t hwm = S.hwm.load(std::memory_order_relaxed);
+  if (!GrowLocked(&S, hwm + n)) return kInvalidPageId;
+  S.hwm.store(hwm + n, std::memory_order_relaxed);
+  return static_cast<page_id_t>(hwm);
 }
 
 void SegmentManager::FreePage(seg_id_t seg, page_id_t pid) {
-  std::lock_guard<std::mutex> g(mu_);
-  auto it = segs_.find(seg);
-  if (it == segs_.end()) return;
-  it->second.free_list.push_back(pid);
+  Segment* S = FindSegment(seg);
+  if (!S) return;
+  std::lock_guard<std::mutex> g(S->mu);
+  S->free_list.push_back(pid);
+}
+
+void SegmentManager::FreePages(seg_id_t seg, page_id_t first, uint32_t n) {
+  Segment* S = FindSegment(seg);
+  if (!S || n == 0) return;
+  std::lock_guard<std::mutex> g(S->mu);
+  const uint64_t hwm = S->hwm.load(std::memory_order_relaxed);
+  if (first >= hwm) return;
+  FreeRunLocked(S, first, std::min<uint64_t>(n, hwm - first));
+}
+
+SegmentManager::SpaceStats SegmentManager::GetSpaceStats(seg_id_t seg) const {
+  SpaceStats st;
+  Segment* S = FindSegment(seg);
+  if (!S) return st;
+  std::lock_guard<std::mutex> g(S->mu);
+  st.page_count = S->hwm.load(std::memory_order_relaxed);
+  st.file_pages = S->file_pages;
+  st.extents    = S->extents.size();
+  st.free_pages = S->free_list.size();
+  for (const Extent& e : S->free_extents) st.free_extent_pages += e.count;
+  return st;
 }
 
 uint64_t SegmentManager::PageCount(seg_id_t seg) const {
-  std::lock_guard<std::mutex> g(mu_);
-  auto it = segs_.find(seg);
-  if (it == segs_.end() || !it->second.disk) return 0;
-  return it->second.disk->PageCount();
+  Segment* S = FindSegment(seg);
+  return S ? S->hwm.load(std::memory_order_relaxed) : 0;
 }
 
 uint16_t SegmentManager::ProbePageFree(seg_id_t seg, page_id_t pid) const {
-  std::lock_guard<std::mutex> g(mu_);
-  auto it = segs_.find(seg);
-  if (it == segs_.end() || !it->second.disk) return 0;
+  Segment* S = FindSegment(seg);
+  if (!S || !S->disk) return 0;
+  if (ColdSegment* c = S->cold.load(std::memory_order_acquire)) return c->UsableSpace(pid);
+  DiskManager* dm = S->disk.get();  // 读盘时无需持锁
 
-  DiskManager* dm = it->second.disk.get();
-  std::vector<std::uint8_t> buf(page_size_, 0);
+  AlignedBuffer buf(page_size_);  // 直接 I/O 下避免走中转
+  if (!buf.data()) return 0;
   Status s = dm->ReadPage(pid, buf.data());
   if (!s.ok()) return 0;
 
   const auto* hdr = reinterpret_cast<const PageHeader*>(buf.data());
   if (hdr->format_version != kPageFormatVersion) return 0;
-  return hdr->free_size;
+  return PageUsableSpace(*hdr);
+}
+
+Status SegmentManager::ProbePagesFree(seg_id_t seg, page_id_t first, uint32_t count,
+                                      uint16_t* out) const {
+  if (!out && count > 0) return Status::InvalidArgument("ProbePagesFree: out=null");
+  Segment* S = FindSegment(seg);
+  if (!S || !S->disk) return Status::NotFound("ProbePagesFree: unknown segment");
+  if (ColdSegment* c = S->cold.load(std::memory_order_acquire)) {  // 目录里存有各页可用空间，无需解压
+    for (uint32_t i = 0; i < count; ++i) out[i] = c->UsableSpace(first + i);
+    return Status::OK();
+  }
+  DiskManager* dm = S->disk.get();
+
+  const uint32_t chunk = std::min(count, kProbeChunk);
+  AlignedBuffer buf(static_cast<size_t>(chunk) * page_size_);
+  if (chunk > 0 && !buf.data()) return Status::IOError("ProbePagesFree: out of memory");
+  for (uint32_t done = 0; done < count;) {
+    const uint32_t n = std::min(chunk, count - done);
+    if (Status s = dm->ReadPages(first + done, n, buf.data()); !s.ok()) return s;
+    for (uint32_t i = 0; i < n; ++i) {
+      const auto* hdr = reinterpret_cast<const PageHeader*>(buf.data() + static_cast<size_t>(i) * page_size_);
+      out[done + i] = hdr->format_version == kPageFormatVersion ? PageUsableSpace(*hdr) : 0;
+    }
+    done += n;
+  }
+  return Status::OK();
+}
+
+Status SegmentManager::ReadPagesRouted(Segment* S, page_id_t first, uint32_t n, void* out) const {
+  if (ColdSegment* c = S->cold.load(std::memory_order_acquire)) return c->ReadPages(first, n, out);
+  return S->disk->ReadPages(first, n, out);
+}
+
+Status SegmentManager::FreezeSegment(seg_id_t seg, const Schema* schema) {
+  Segment* S = FindSegment(seg);
+  if (!S || !S->disk) return Status::NotFound("FreezeSegment: unknown segment");
+  uint64_t pages = 0;
+  {
+    std::lock_guard<std::mutex> g(S->mu);
+    if (S->cold.load(std::memory_order_relaxed)) return Status::OK();
+    if (S->transition) return Status::Unavailable("FreezeSegment: freeze or thaw in progress");
+    S->transition = true;
+    S->read_only.store(true);  // 通常已由 SetReadOnly 置位；失败时由调用方清除
+    pages = S->hwm.load(std::memory_order_relaxed);
+  }
+
+  // 读整段、压缩并落盘不持段锁：段已只读，高水位与页内容都不再变化
+  const std::string path = MakePath(seg) + ".cold";
+  std::unique_ptr<ColdSegment> cold;
+  Status s = ColdSegment::Build(path, S->disk.get(), pages, page_size_, schema);
+  if (s.ok()) s = ColdSegment::Open(path, page_size_, &cold);
+  if (!s.ok()) {
+    std::lock_guard<std::mutex> g(S->mu);
+    S->transition = false;
+    return s;
+  }
+  uint64_t file_pages = 0;
+  {
+    std::lock_guard<std::mutex> g(S->mu);
+    S->cold.store(cold.get(), std::memory_order_release);
+    S->retired.push_back(std::move(cold));
+    file_pages = S->file_pages;
+  }
+
+  // 冷段文件已落盘：原段文件的数据块（连同高水位之后的预分配尾部）可以释放；
+  // 文件大小不变，区段与高水位照旧，解冻时按页写回即可。释放完才结束冻结，解冻不会与它交错
+  (void)S->disk->DiscardPages(0, file_pages);
+  std::lock_guard<std::mutex> g(S->mu);
+  S->transition = false;
+  return Status::OK();
+}
+
+Status SegmentManager::ThawSegment(seg_id_t seg) {
+  Segment* S = FindSegment(seg);
+  if (!S || !S->disk) return Status::NotFound("ThawSegment: unknown segment");
+  ColdSegment* c = nullptr;
+  {
+    std::lock_guard<std::mutex> g(S->mu);
+    c = S->cold.load(std::memory_order_relaxed);
+    if (!c) return Status::OK();
+    if (S->transition) return Status::Unavailable("ThawSegment: freeze or thaw in progress");
+    S->transition = true;
+  }
+
+  // 解压写回不持段锁：段仍是冷段（只读，读页照旧经冷段解压），写回的段文件此时没有读者
+  auto rewrite = [&]() -> Status {
+    AlignedBuffer buf(static_cast<size_t>(kProbeChunk) * page_size_);
+    if (!buf.data()) return Status::IOError("ThawSegment: out of memory");
+    std::vector<DiskManager::PageIo> ios;
+    for (uint64_t done = 0; done < c->page_count();) {
+      const uint32_t n = static_cast<uint32_t>(std::min<uint64_t>(kProbeChunk, c->page_count() - done));
+      if (Status s = c->ReadPages(static_cast<page_id_t>(done), n, buf.data()); !s.ok()) return s;
+      ios.clear();
+      for (uint32_t i = 0; i < n; ++i) {
+        ios.push_back({IoOp::kWrite, static_cast<page_id_t>(done + i), buf.data() + static_cast<size_t>(i) * page_size_});
+      }
+      if (Status s = S->disk->ExecutePages(ios.data(), ios.size()); !s.ok()) return s;
+      done += n;
+    }
+    // 段文件落盘之后才删除冷段文件：中途崩溃时冷段文件仍在，重新打开照旧以它为准
+    return S->disk->Sync();
+  };
+  const Status s = rewrite();
+
+  std::lock_guard<std::mutex> g(S->mu);
+  S->transition = false;
+  if (!s.ok()) return s;
+  S->cold.store(nullptr, std::memory_order_release);
+  S->read_only.store(false);
+  if (std::remove(c->path().c_str()) != 0) return Status::IOError("ThawSegment: remove '" + c->path() + "' failed");
+  return Status::OK();
+}
+
+bool SegmentManager::IsCold(seg_id_t seg) const { return GetColdSegment(seg) != nullptr; }
+
+Status SegmentManager::SetReadOnly(seg_id_t seg, bool on) {
+  Segment* S = FindSegment(seg);
+  if (!S) return Status::NotFound("SetReadOnly: unknown segment");
+  std::unique_lock<std::mutex> lk(S->mu);
+  if (!on) {
+    if (!S->cold.load(std::memory_order_relaxed)) S->read_only.store(false);
+    return Status::OK();
+  }
+  if (S->read_only.load()) return Status::Unavailable("SetReadOnly: segment is cold or being frozen");
+  S->read_only.store(true);
+  // 写者先登记再检查标记，这里先置标记再看计数（均为顺序一致）：两边至少有一方看到对方。
+  // 等待时放开段锁（区间内的写者可能还要分配页，拿段锁后被拒绝）；最后退出的写者在段锁下通知
+  S->writers_cv.wait(lk, [S] { return S->writers.load() == 0; });
+  return Status::OK();
+}
+
+bool SegmentManager::IsReadOnly(seg_id_t seg) const {
+  Segment* S = FindSegment(seg);
+  return S && S->read_only.load();
+}
+
+SegmentManager::WriteScope::WriteScope(SegmentManager* sm, seg_id_t seg) {
+  Segment* S = sm->FindSegment(seg);
+  if (!S) { ok_ = true; return; }  // 段尚未创建：没有可冻结的页
+  S->writers.fetch_add(1);
+  if (S->read_only.load()) {
+    LeaveWrite(S);
+    return;
+  }
+  seg_ = S;
+  ok_  = true;
+}
+
+SegmentManager::WriteScope::~WriteScope() {
+  if (seg_) LeaveWrite(seg_);
+}
+
+void SegmentManager::LeaveWrite(Segment* s) {
+  // 先减计数再看标记（与 SetReadOnly 的顺序相反）：只有冻结在等时才拿段锁，常态只是一次 fetch_sub
+  if (s->writers.fetch_sub(1) == 1 && s->read_only.load()) {
+    std::lock_guard<std::mutex> g(s->mu);
+    s->writers_cv.notify_all();
+  }
+}
+
+ColdSegment* SegmentManager::GetColdSegment(seg_id_t seg) const {
+  Segment* S = FindSegment(seg);
+  return S ? S->cold.load(std::memory_order_acquire) : nullptr;
+}
+
+ColdSegmentStats SegmentManager::GetColdStats(seg_id_t seg) const {
+  ColdSegmentStats st;
+  if (ColdSegment* c = GetColdSegment(seg)) c->FillStats(&st);
+  return st;
+}
+
+void SegmentManager::SetIoBackend(IoBackend* io) {
+  std::unique_lock<std::shared_mutex> g(mu_);
+  io_ = io ? io : IoBackend::Posix();
+  for (auto& kv : segs_) {
+    if (kv.second->disk) kv.second->disk->SetIoBackend(io_);
+  }
+}
+
+IoBackend* SegmentManager::io_backend() const {
+  std::shared_lock<std::shared_mutex> g(mu_);
+  return io_;
+}
+
+void SegmentManager::SetMetrics(StorageMetrics* m) {
+  std::unique_lock<std::shared_mutex> g(mu_);
+  metrics_ = m;
+  for (auto& kv : segs_) {
+    if (kv.second->disk) kv.second->disk->SetMetrics(m);
+  }
 }
 
 DiskManager* SegmentManager::GetDisk(seg_id_t seg) {
-  std::lock_guard<std::mutex> g(mu_);
-  auto it = segs_.find(seg);
-  if (it == segs_.end()) return nullptr;
-  return it->second.disk.get();
+  Segment* S = FindSegment(seg);
+  return S ? S->disk.get() : nullptr;
 }
 
 }  // namespace storage
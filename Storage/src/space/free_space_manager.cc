@@ -1,68 +1,249 @@
 #include "dbms/storage/space/free_space_manager.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
+#include "dbms/storage/io/disk_manager.h"
+#include "internal/io/aligned_buffer.h"
+#include "internal/space/fsm_tree.h"
+#include "internal/util/hash.h"
 
 namespace dbms {
 namespace storage {
 
+namespace {
+
+constexpr uint8_t  kMaxCategory = 255;
+constexpr uint32_t kFsmMagic    = 0x4D534644;  // "DFSM"
+constexpr uint32_t kFsmVersion  = 1;
+constexpr uint32_t kRebuildChunk = 1024;  // 批量重建时每次探测的页数
+
+/// FSM 段首页
+struct FsmFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t page_size;   // 数据页大小（决定类别编码），不是 FSM 段自己的页大小
+  uint32_t step;
+  uint64_t pages;       // 类别数组长度
+  uint64_t checksum;    // 类别数组的 FNV-1a
+};
+
+/// 调用线程的主条带：线程首次调用时轮转分配，之后固定
+size_t HomeStripe() {
+  static std::atomic<unsigned> next{0};
+  thread_local const unsigned id = next.fetch_add(1, std::memory_order_relaxed);
+  return id % FreeSpaceManager::kStripes;
+}
+
+}  // namespace
+
+/// 条带：管理 pid % kStripes == 本条带下标的页，本地下标 local = pid / kStripes
+struct alignas(64) FreeSpaceManager::Stripe {
+  std::mutex mu;
+  FsmTree    tree;                                  // 可查找的类别；被预留的页在树中为 0
+  std::unordered_map<uint32_t, uint8_t> reserved;   // 被预留页的 local -> 真实类别
+  std::vector<size_t> bin_counts;                   // 按真实类别计（含被预留的页）
+  size_t     tracked{0};
+  std::atomic<page_id_t> hint{kInvalidPageId};      // 以本条带为主条带的线程最近释放的页
+
+  uint8_t Category(uint32_t local) const {
+    auto it = reserved.find(local);
+    return it != reserved.end() ? it->second : tree.Get(local);
+  }
+};
+
 FreeSpaceManager::FreeSpaceManager(uint32_t page_size, std::vector<uint32_t> thresholds)
-    : page_size_(page_size), thresholds_(std::move(thresholds)) {
+    : page_size_(page_size), thresholds_(std::move(thresholds)), stripes_(new Stripe[kStripes]) {
   // 阈值规范化：升序 + 去重
   std::sort(thresholds_.begin(), thresholds_.end());
   thresholds_.erase(std::unique(thresholds_.begin(), thresholds_.end()), thresholds_.end());
   // 桶数 = 阈值数 + 1
-  bins_.resize(thresholds_.size() + 1);
+  for (size_t i = 0; i < kStripes; ++i) stripes_[i].bin_counts.assign(thresholds_.size() + 1, 0);
+
+  step_ = std::max<uint32_t>(1, (page_size_ + kMaxCategory - 1) / kMaxCategory);
+  cat2bin_.assign(kMaxCategory + 1, 0);
+  for (uint32_t c = 1; c <= kMaxCategory; ++c) {
+    cat2bin_[c] = static_cast<uint8_t>(BinIndex((c - 1) * step_));
+  }
 }
 
+FreeSpaceManager::~FreeSpaceManager() = default;
+
 size_t FreeSpaceManager::BinIndex(uint32_t free_bytes) const {
   auto it = std::lower_bound(thresholds_.begin(), thresholds_.end(), free_bytes);
   return static_cast<size_t>(std::distance(thresholds_.begin(), it));
 }
 
+uint8_t FreeSpaceManager::ToCategory(uint16_t free_bytes) const {
+  return static_cast<uint8_t>(1 + std::min<uint32_t>(kMaxCategory - 1, free_bytes / step_));
+}
+
+uint8_t FreeSpaceManager::MinCategory(uint16_t need_bytes) const {
+  const uint32_t min_cat = 1 + (static_cast<uint32_t>(need_bytes) + step_ - 1) / step_;
+  return min_cat > kMaxCategory ? 0 : static_cast<uint8_t>(min_cat);
+}
+
+FreeSpaceManager::Stripe& FreeSpaceManager::StripeOf(page_id_t pid) const {
+  return stripes_[pid % kStripes];
+}
+
+void FreeSpaceManager::SetCategory(Stripe& st, uint32_t local, uint8_t cat) {
+  auto it = st.reserved.find(local);
+  const uint8_t old = it != st.reserved.end() ? it->second : st.tree.Get(local);
+  if (old == cat) return;
+  if (old) { st.bin_counts[cat2bin_[old]]--; st.tracked--; }
+  if (cat) { st.bin_counts[cat2bin_[cat]]++; st.tracked++; }
+  // 被预留的页只记真实类别，保持对查找不可见
+  if (it != st.reserved.end()) it->second = cat;
+  else st.tree.Set(local, cat);
+}
+
+void FreeSpaceManager::Reserve(Stripe& st, uint32_t local) {
+  st.reserved.emplace(local, st.tree.Get(local));
+  st.tree.Set(local, 0);
+}
+
+void FreeSpaceManager::RecountBins(Stripe& st) {
+  std::fill(st.bin_counts.begin(), st.bin_counts.end(), 0);
+  st.tracked = 0;
+  auto count = [&](uint8_t c) {
+    if (!c) return;
+    st.bin_counts[cat2bin_[c]]++;
+    st.tracked++;
+  };
+  for (uint8_t c : st.tree.leaves()) count(c);
+  for (const auto& kv : st.reserved) count(kv.second);
+}
+
 page_id_t FreeSpaceManager::Find(uint16_t need_bytes) const {
-  std::lock_guard<std::mutex> g(mu_);
-  const size_t start = BinIndex(need_bytes);
-  for (size_t i = start; i < bins_.size(); ++i) {
-    for (const auto pid : bins_[i]) {
-      auto it = pid2free_.find(pid);
-      if (it != pid2free_.end() && it->second >= need_bytes) {
-        return pid;
-      }
+  const uint8_t min_cat = MinCategory(need_bytes);
+  if (!min_cat) return kInvalidPageId;
+
+  // 各条带的首个命中按全局页号取最小，保持首次适配语义
+  page_id_t best = kInvalidPageId;
+  for (size_t s = 0; s < kStripes; ++s) {
+    Stripe& st = stripes_[s];
+    std::lock_guard<std::mutex> g(st.mu);
+    const size_t i = st.tree.FindFirst(min_cat);
+    if (i == FsmTree::npos) continue;
+    const page_id_t pid = static_cast<page_id_t>(i * kStripes + s);
+    if (best == kInvalidPageId || pid < best) best = pid;
+  }
+  return best;
+}
+
+page_id_t FreeSpaceManager::Acquire(uint16_t need_bytes) {
+  const uint8_t min_cat = MinCategory(need_bytes);
+  if (!min_cat) return kInvalidPageId;
+
+  const size_t home = HomeStripe();
+
+  // 1) 本线程上次释放的页：多半仍放得下，且页帧仍在缓存中
+  const page_id_t h = stripes_[home].hint.load(std::memory_order_relaxed);
+  if (h != kInvalidPageId) {
+    Stripe& st = StripeOf(h);
+    const uint32_t local = static_cast<uint32_t>(h / kStripes);
+    std::lock_guard<std::mutex> g(st.mu);
+    if (st.tree.Get(local) >= min_cat) {  // 被预留的页在树中为 0，不会命中
+      Reserve(st, local);
+      return h;
     }
   }
+
+  // 2) 从主条带起依次首次适配：不同线程优先落在不同的锁与不同的页上
+  for (size_t k = 0; k < kStripes; ++k) {
+    const size_t s = (home + k) % kStripes;
+    Stripe& st = stripes_[s];
+    std::lock_guard<std::mutex> g(st.mu);
+    const size_t i = st.tree.FindFirst(min_cat);
+    if (i == FsmTree::npos) continue;
+    Reserve(st, static_cast<uint32_t>(i));
+    return static_cast<page_id_t>(i * kStripes + s);
+  }
   return kInvalidPageId;
 }
 
-void FreeSpaceManager::Update(page_id_t pid, uint16_t free_bytes) {
-  const size_t new_bin = BinIndex(free_bytes);
-  std::lock_guard<std::mutex> g(mu_);
-
-  auto it_bin = pid2bin_.find(pid);
-  if (it_bin != pid2bin_.end()) {
-    const size_t old_bin = it_bin->second;
-    if (old_bin != new_bin) {
-      bins_[old_bin].erase(pid);
-      bins_[new_bin].insert(pid);
-      it_bin->second = new_bin;
+void FreeSpaceManager::Release(page_id_t pid, uint16_t free_bytes) {
+  if (pid == kInvalidPageId) return;
+  const uint8_t cat = ToCategory(free_bytes);
+  Stripe& st = StripeOf(pid);
+  const uint32_t local = static_cast<uint32_t>(pid / kStripes);
+  {
+    std::lock_guard<std::mutex> g(st.mu);
+    SetCategory(st, local, cat);
+    auto it = st.reserved.find(local);
+    if (it != st.reserved.end()) {
+      st.reserved.erase(it);
+      st.tree.Set(local, cat);
     }
-    pid2free_[pid] = free_bytes;
-    return;
   }
+  stripes_[HomeStripe()].hint.store(pid, std::memory_order_relaxed);
+}
 
-  bins_[new_bin].insert(pid);
-  pid2bin_.emplace(pid, new_bin);
-  pid2free_.emplace(pid, free_bytes);
+void FreeSpaceManager::Release(page_id_t pid) {
+  if (pid == kInvalidPageId) return;
+  Stripe& st = StripeOf(pid);
+  const uint32_t local = static_cast<uint32_t>(pid / kStripes);
+  std::lock_guard<std::mutex> g(st.mu);
+  auto it = st.reserved.find(local);
+  if (it == st.reserved.end()) return;
+  st.tree.Set(local, it->second);
+  st.reserved.erase(it);
+}
+
+void FreeSpaceManager::Update(page_id_t pid, uint16_t free_bytes) {
+  if (pid == kInvalidPageId) return;
+  const uint8_t cat = ToCategory(free_bytes);
+  Stripe& st = StripeOf(pid);
+  std::lock_guard<std::mutex> g(st.mu);
+  SetCategory(st, static_cast<uint32_t>(pid / kStripes), cat);
 }
 
 void FreeSpaceManager::Remove(page_id_t pid) {
-  std::lock_guard<std::mutex> g(mu_);
-  auto it_bin = pid2bin_.find(pid);
-  if (it_bin == pid2bin_.end()) return;
+  if (pid == kInvalidPageId) return;
+  Stripe& st = StripeOf(pid);
+  std::lock_guard<std::mutex> g(st.mu);
+  SetCategory(st, static_cast<uint32_t>(pid / kStripes), 0);
+}
 
-  const size_t bin = it_bin->second;
-  bins_[bin].erase(pid);
-  pid2bin_.erase(it_bin);
-  pid2free_.erase(pid);
+std::vector<uint8_t> FreeSpaceManager::Snapshot() const {
+  size_t n = 0;
+  std::vector<std::vector<uint8_t>> parts(kStripes);
+  for (size_t s = 0; s < kStripes; ++s) {
+    Stripe& st = stripes_[s];
+    std::lock_guard<std::mutex> g(st.mu);
+    parts[s] = st.tree.leaves();
+    for (const auto& kv : st.reserved) {
+      if (kv.first >= parts[s].size()) parts[s].resize(kv.first + 1, 0);
+      parts[s][kv.first] = kv.second;
+    }
+    if (!parts[s].empty()) n = std::max(n, (parts[s].size() - 1) * kStripes + s + 1);
+  }
+  std::vector<uint8_t> cats(n, 0);
+  for (size_t s = 0; s < kStripes; ++s) {
+    for (size_t i = 0; i < parts[s].size(); ++i) cats[i * kStripes + s] = parts[s][i];
+  }
+  return cats;
+}
+
+void FreeSpaceManager::AssignAll(const std::vector<uint8_t>& cats) {
+  for (size_t s = 0; s < kStripes; ++s) {
+    std::vector<uint8_t> part;
+    part.reserve(cats.size() / kStripes + 1);
+    for (size_t p = s; p < cats.size(); p += kStripes) part.push_back(cats[p]);
+
+    Stripe& st = stripes_[s];
+    std::lock_guard<std::mutex> g(st.mu);
+    // 仍被预留的页保持对查找不可见，新类别在 Release 前记在预留表中
+    for (auto& kv : st.reserved) {
+      if (kv.first < part.size()) { kv.second = part[kv.first]; part[kv.first] = 0; }
+    }
+    st.tree.Assign(std::move(part));
+    RecountBins(st);
+  }
 }
 
 void FreeSpaceManager::RegisterSegmentProbe(FreeProbeFn free_probe, PageCountFn page_count) {
@@ -71,42 +252,181 @@ void FreeSpaceManager::RegisterSegmentProbe(FreeProbeFn free_probe, PageCountFn
   probe_count_ = std::move(page_count);
 }
 
-Status FreeSpaceManager::RebuildFromSegment(seg_id_t seg) {
+void FreeSpaceManager::RegisterSegmentProbe(FreeBatchProbeFn batch_probe, PageCountFn page_count) {
   std::lock_guard<std::mutex> g(mu_);
-  if (!probe_free_ || !probe_count_) return Status::Unavailable("FSM: no probe registered");
+  probe_batch_ = std::move(batch_probe);
+  probe_count_ = std::move(page_count);
+}
+
+Status FreeSpaceManager::RebuildFromSegment(seg_id_t seg, page_id_t first, int threads) {
+  FreeProbeFn      probe_free;
+  FreeBatchProbeFn probe_batch;
+  PageCountFn      probe_count;
+  {
+    std::lock_guard<std::mutex> g(mu_);
+    probe_free  = probe_free_;
+    probe_batch = probe_batch_;
+    probe_count = probe_count_;
+  }
+  if ((!probe_free && !probe_batch) || !probe_count) return Status::Unavailable("FSM: no probe registered");
+
+  const uint64_t pages = probe_count(seg);
+  if (pages <= first) return Status::OK();
+  const uint64_t n = pages - first;
 
-  for (auto& s : bins_) s.clear();
-  pid2bin_.clear();
-  pid2free_.clear();
+  // 探测在锁外进行：重建期间的并发 Update 不会被长时间阻塞
+  std::vector<uint16_t> frees(static_cast<size_t>(n), 0);
+  if (probe_batch) {
+    const uint64_t chunks = (n + kRebuildChunk - 1) / kRebuildChunk;
+    unsigned t = threads > 0 ? static_cast<unsigned>(threads) : std::thread::hardware_concurrency();
+    t = static_cast<unsigned>(std::max<uint64_t>(1, std::min<uint64_t>(t ? t : 1, chunks)));
 
-  const uint64_t pages = probe_count_(seg);
-  for (uint64_t i = 0; i < pages; ++i) {
-    const page_id_t pid = static_cast<page_id_t>(i);
-    const uint16_t  free = probe_free_(seg, pid);
-    const size_t b = BinIndex(free);
-    bins_[b].insert(pid);
-    pid2bin_.emplace(pid, b);
-    pid2free_.emplace(pid, free);
+    std::vector<Status> errs(t);
+    auto work = [&](unsigned w) {
+      // 每个线程负责一段连续的块区间，保持顺序读
+      const uint64_t cb = chunks * w / t, ce = chunks * (w + 1) / t;
+      for (uint64_t c = cb; c < ce && errs[w].ok(); ++c) {
+        const uint64_t off = c * kRebuildChunk;
+        const uint32_t cnt = static_cast<uint32_t>(std::min<uint64_t>(kRebuildChunk, n - off));
+        errs[w] = probe_batch(seg, static_cast<page_id_t>(first + off), cnt, frees.data() + off);
+      }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned w = 1; w < t; ++w) pool.emplace_back(work, w);
+    work(0);
+    for (auto& th : pool) th.join();
+    for (const Status& s : errs) if (!s.ok()) return s;
+  } else {
+    for (uint64_t i = 0; i < n; ++i) frees[i] = probe_free(seg, static_cast<page_id_t>(first + i));
+  }
+
+  if (first == 0) {
+    std::vector<uint8_t> cats(static_cast<size_t>(n));
+    for (uint64_t i = 0; i < n; ++i) cats[i] = ToCategory(frees[i]);
+    AssignAll(cats);
+  } else {
+    for (size_t s = 0; s < kStripes; ++s) {
+      Stripe& st = stripes_[s];
+      std::lock_guard<std::mutex> g(st.mu);
+      // 本条带在 [first, pages) 内的第一个页
+      for (uint64_t p = first + (s + kStripes - first % kStripes) % kStripes; p < pages; p += kStripes) {
+        SetCategory(st, static_cast<uint32_t>(p / kStripes), ToCategory(frees[p - first]));
+      }
+    }
   }
   return Status::OK();
 }
 
+uint64_t FreeSpaceManager::size() const {
+  uint64_t n = 0;
+  for (size_t s = 0; s < kStripes; ++s) {
+    Stripe& st = stripes_[s];
+    std::lock_guard<std::mutex> g(st.mu);
+    size_t len = st.tree.size();
+    for (const auto& kv : st.reserved) len = std::max<size_t>(len, kv.first + 1);
+    if (len) n = std::max<uint64_t>(n, (len - 1) * kStripes + s + 1);
+  }
+  return n;
+}
+
+Status FreeSpaceManager::SaveTo(DiskManager* disk) const {
+  if (!disk) return Status::InvalidArgument("FSM SaveTo: disk=null");
+  const uint32_t ps = disk->page_size();
+  if (ps < sizeof(FsmFileHeader)) return Status::InvalidArgument("FSM SaveTo: page too small");
+
+  const std::vector<uint8_t> cats = Snapshot();  // 只在拷贝各条带时持锁（每页 1 字节）
+  const uint64_t data_pages = (cats.size() + ps - 1) / ps;
+
+  AlignedBuffer buf(ps);
+  if (!buf.data()) return Status::IOError("FSM SaveTo: out of memory");
+
+  Status s = disk->ResizeToPages(1 + data_pages);
+  for (uint64_t p = 0; s.ok() && p < data_pages; ++p) {
+    const size_t off = static_cast<size_t>(p) * ps;
+    const size_t n   = std::min<size_t>(ps, cats.size() - off);
+    std::memset(buf.data(), 0, ps);
+    std::memcpy(buf.data(), cats.data() + off, n);
+    s = disk->WritePage(static_cast<page_id_t>(1 + p), buf.data());
+  }
+  if (!s.ok()) return s;
+
+  // 数据页落盘后再写头：头页有效即意味着其后的数据完整
+  if (s = disk->Sync(); !s.ok()) return s;
+  FsmFileHeader hdr{kFsmMagic, kFsmVersion, page_size_, step_,
+                    static_cast<uint64_t>(cats.size()), Fnv1a64(cats.data(), cats.size())};
+  std::memset(buf.data(), 0, ps);
+  std::memcpy(buf.data(), &hdr, sizeof(hdr));
+  if (s = disk->WritePage(0, buf.data()); !s.ok()) return s;
+  return disk->Sync();
+}
+
+Status FreeSpaceManager::LoadFrom(DiskManager* disk) {
+  if (!disk) return Status::InvalidArgument("FSM LoadFrom: disk=null");
+  const uint32_t ps = disk->page_size();
+  if (ps < sizeof(FsmFileHeader)) return Status::InvalidArgument("FSM LoadFrom: page too small");
+  if (disk->PageCount() == 0) return Status::NotFound("FSM LoadFrom: empty FSM segment");
+
+  AlignedBuffer buf(ps);
+  if (!buf.data()) return Status::IOError("FSM LoadFrom: out of memory");
+  if (Status s = disk->ReadPage(0, buf.data()); !s.ok()) return s;
+
+  FsmFileHeader hdr;
+  std::memcpy(&hdr, buf.data(), sizeof(hdr));
+  if (hdr.magic != kFsmMagic || hdr.version != kFsmVersion) {
+    return Status::Corruption("FSM LoadFrom: bad header");
+  }
+  if (hdr.page_size != page_size_ || hdr.step != step_) {
+    return Status::Corruption("FSM LoadFrom: page size mismatch");
+  }
+  const uint64_t data_pages = (hdr.pages + ps - 1) / ps;
+  if (1 + data_pages > disk->PageCount()) return Status::Corruption("FSM LoadFrom: truncated");
+
+  std::vector<uint8_t> cats(static_cast<size_t>(hdr.pages), 0);
+  for (uint64_t p = 0; p < data_pages; ++p) {
+    if (Status s = disk->ReadPage(static_cast<page_id_t>(1 + p), buf.data()); !s.ok()) return s;
+    const size_t off = static_cast<size_t>(p) * ps;
+    std::memcpy(cats.data() + off, buf.data(), std::min<size_t>(ps, cats.size() - off));
+  }
+  if (Fnv1a64(cats.data(), cats.size()) != hdr.checksum) {
+    return Status::Corruption("FSM LoadFrom: checksum mismatch");
+  }
+
+  AssignAll(cats);
+  return Status::OK();
+}
+
 std::vector<size_t> FreeSpaceManager::BinSizes() const {
-  std::lock_guard<std::mutex> g(mu_);
-  std::vector<size_t> v;
-  v.reserve(bins_.size());
-  for (const auto& s : bins_) v.push_back(s.size());
-  return v;
+  std::vector<size_t> out(thresholds_.size() + 1, 0);
+  for (size_t s = 0; s < kStripes; ++s) {
+    Stripe& st = stripes_[s];
+    std::lock_guard<std::mutex> g(st.mu);
+    for (size_t b = 0; b < out.size(); ++b) out[b] += st.bin_counts[b];
+  }
+  return out;
 }
 
 std::vector<uint32_t> FreeSpaceManager::BinThresholds() const {
-  std::lock_guard<std::mutex> g(mu_);
   return thresholds_;
 }
 
 size_t FreeSpaceManager::TotalTrackedPages() const {
-  std::lock_guard<std::mutex> g(mu_);
-  return pid2bin_.size();
+  size_t n = 0;
+  for (size_t s = 0; s < kStripes; ++s) {
+    Stripe& st = stripes_[s];
+    std::lock_guard<std::mutex> g(st.mu);
+    n += st.tracked;
+  }
+  return n;
+}
+
+size_t FreeSpaceManager::MemoryBytes() const {
+  size_t n = 0;
+  for (size_t s = 0; s < kStripes; ++s) {
+    Stripe& st = stripes_[s];
+    std::lock_guard<std::mutex> g(st.mu);
+    n += st.tree.MemoryBytes() + st.reserved.size() * (sizeof(uint32_t) + sizeof(uint8_t));
+  }
+  return n;
 }
 
 }  // namespace storage
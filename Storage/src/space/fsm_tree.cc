@@ -0,0 +1,93 @@
+#include "internal/space/fsm_tree.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace dbms {
+namespace storage {
+
+uint8_t FsmTree::GroupMax(const std::vector<uint8_t>& lv, size_t g) {
+  const size_t b = g * kFanout;
+  const size_t e = std::min(lv.size(), b + kFanout);
+  uint8_t m = 0;
+  for (size_t i = b; i < e; ++i) m = std::max(m, lv[i]);
+  return m;
+}
+
+void FsmTree::BuildLevel(size_t k) {
+  const std::vector<uint8_t>& lv = levels_[k];
+  std::vector<uint8_t> up((lv.size() + kFanout - 1) / kFanout, 0);
+  for (size_t g = 0; g < up.size(); ++g) up[g] = GroupMax(lv, g);
+  if (levels_.size() == k + 1) levels_.push_back(std::move(up));
+  else levels_[k + 1] = std::move(up);
+}
+
+void FsmTree::Resize(size_t n) {
+  if (levels_.empty()) levels_.emplace_back();
+  levels_[0].resize(n, 0);
+  // 新增叶子为 0，不改变已有分组的最大值：已有上层只需按新长度补 0；
+  // 叶子越过 64^k 需要新的一层时，新层由下一层整体算出
+  for (size_t k = 0; levels_[k].size() > kFanout; ++k) {
+    const size_t need = (levels_[k].size() + kFanout - 1) / kFanout;
+    if (levels_.size() == k + 1) BuildLevel(k);
+    else levels_[k + 1].resize(need, 0);
+  }
+}
+
+void FsmTree::Set(size_t i, uint8_t v) {
+  if (i >= size()) {
+    if (v == 0) return;
+    Resize(i + 1);
+  }
+  levels_[0][i] = v;
+  for (size_t k = 0; k + 1 < levels_.size(); ++k) {
+    const size_t g = i / kFanout;
+    const uint8_t m = GroupMax(levels_[k], g);
+    if (levels_[k + 1][g] == m) break;
+    levels_[k + 1][g] = m;
+    i = g;
+  }
+}
+
+size_t FsmTree::FindFirst(uint8_t min) const {
+  if (size() == 0) return npos;
+  const std::vector<uint8_t>& top = levels_.back();
+  size_t idx = npos;
+  for (size_t i = 0; i < top.size(); ++i) {
+    if (top[i] >= min) { idx = i; break; }
+  }
+  if (idx == npos) return npos;
+
+  for (size_t k = levels_.size() - 1; k-- > 0;) {
+    const std::vector<uint8_t>& lv = levels_[k];
+    const size_t b = idx * kFanout;
+    const size_t e = std::min(lv.size(), b + kFanout);
+    size_t next = npos;
+    for (size_t i = b; i < e; ++i) {
+      if (lv[i] >= min) { next = i; break; }
+    }
+    if (next == npos) return npos;  // 不变式被破坏时保守返回
+    idx = next;
+  }
+  return idx;
+}
+
+void FsmTree::Assign(std::vector<uint8_t> leaves) {
+  levels_.clear();
+  levels_.push_back(std::move(leaves));
+  for (size_t k = 0; levels_[k].size() > kFanout; ++k) BuildLevel(k);
+}
+
+const std::vector<uint8_t>& FsmTree::leaves() const {
+  static const std::vector<uint8_t> kEmpty;
+  return levels_.empty() ? kEmpty : levels_[0];
+}
+
+size_t FsmTree::MemoryBytes() const {
+  size_t n = 0;
+  for (const auto& lv : levels_) n += lv.capacity();
+  return n;
+}
+
+}  // namespace storage
+}  // namespace dbms
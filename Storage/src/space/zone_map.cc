@@ -0,0 +1,384 @@
+#include "dbms/storage/space/zone_map.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+#include "dbms/storage/io/disk_manager.h"
+#include "internal/io/aligned_buffer.h"
+#include "internal/util/hash.h"
+
+namespace dbms {
+namespace storage {
+
+namespace {
+
+constexpr uint32_t kZoneMagic   = 0x4E4F5A44;  // "DZON"
+constexpr uint32_t kZoneVersion = 1;
+constexpr double   kInf         = std::numeric_limits<double>::infinity();
+
+/// zone 文件首页：头部之后是 columns 个 ZoneColumnDesc，其后各页依次为每页 columns 个 ZoneEntry
+struct ZoneFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t columns;
+  uint32_t entry_size;
+  uint64_t pages;      // 页号范围上界
+  uint64_t checksum;   // 列描述 + 摘要数组的 FNV-1a
+};
+
+struct ZoneColumnDesc {
+  uint32_t column;
+  uint32_t type;
+};
+
+bool Zoned(Type t) {
+  return t == Type::INT32 || t == Type::INT64 || t == Type::DATE || t == Type::FLOAT || t == Type::DOUBLE;
+}
+bool Floating(Type t) { return t == Type::FLOAT || t == Type::DOUBLE; }
+
+int64_t Bits(double d) {
+  int64_t b;
+  std::memcpy(&b, &d, sizeof(b));
+  return b;
+}
+
+/// 并入非 NULL 值的区间 [lo, hi]（first 为 e 之前没有非 NULL 值）
+void WidenInt(ZoneEntry* e, bool first, int64_t lo, int64_t hi) {
+  if (first) { e->min = lo; e->max = hi; return; }
+  e->min = std::min(e->min, lo);
+  e->max = std::max(e->max, hi);
+}
+
+void WidenDouble(ZoneEntry* e, bool first, double lo, double hi) {
+  if (first) { e->min = Bits(lo); e->max = Bits(hi); return; }
+  if (lo < e->dmin()) e->min = Bits(lo);
+  if (hi > e->dmax()) e->max = Bits(hi);
+}
+
+/// rows / nulls 计数（饱和时保持 rows > nulls 的关系不变，min/max 的有效性判断仍然安全）
+void Count(ZoneEntry* e, uint32_t rows, uint32_t nulls) {
+  const uint64_t r = uint64_t{e->rows} + rows, n = uint64_t{e->nulls} + nulls;
+  if (r <= UINT32_MAX) { e->rows = static_cast<uint32_t>(r); e->nulls = static_cast<uint32_t>(n); return; }
+  const bool values = e->rows > e->nulls || rows > nulls;
+  e->rows  = UINT32_MAX;
+  e->nulls = static_cast<uint32_t>(std::min<uint64_t>(n, values ? UINT32_MAX - 1 : UINT32_MAX));
+}
+
+}  // namespace
+
+/// 条带：管理 pid % kStripes == 本条带下标的页，本地下标 local = pid / kStripes
+struct alignas(64) ZoneMap::Stripe {
+  std::mutex             mu;
+  std::vector<ZoneEntry> entries;  // local * 列数 + k
+  bool                   changed{false};  // SaveTo 快照之后被修改过
+};
+
+ZoneMap::ZoneMap(const Schema& schema) : schema_(&schema), stripes_(new Stripe[kStripes]) {
+  for (size_t c = 0; c < schema.ColumnCount(); ++c) {
+    const Type t = schema.GetColumn(c).type;
+    if (!Zoned(t)) continue;
+    columns_.push_back(c);
+    types_.push_back(t);
+  }
+  (void)RowCodec::Compile(schema, columns_, &codec_);  // 列号来自 schema 本身
+  if (columns_.empty()) codec_ = RowCodec{};
+}
+
+ZoneMap::~ZoneMap() = default;
+
+int ZoneMap::SlotOf(size_t column) const noexcept {
+  auto it = std::find(columns_.begin(), columns_.end(), column);
+  return it == columns_.end() ? -1 : static_cast<int>(it - columns_.begin());
+}
+
+ZoneMap::Stripe& ZoneMap::StripeOf(page_id_t pid) const { return stripes_[pid % kStripes]; }
+
+ZoneEntry* ZoneMap::EntriesLocked(Stripe& st, page_id_t pid) {
+  const size_t at = static_cast<size_t>(pid / kStripes) * columns_.size();
+  if (st.entries.size() < at + columns_.size()) st.entries.resize(at + columns_.size());
+  return st.entries.data() + at;
+}
+
+template <class Fn>
+void ZoneMap::Mutate(page_id_t pid, Fn&& fn) {
+  Stripe& st = StripeOf(pid);
+  for (;;) {
+    {
+      // 在条带锁内检查：与 SaveTo“先发布 persisted_、再逐条带查 changed”配对，
+      // 两边至少有一方看到对方（见 SaveTo）
+      std::lock_guard<std::mutex> g(st.mu);
+      if (!persisted_.load(std::memory_order_acquire)) {
+        fn(EntriesLocked(st, pid));
+        st.changed = true;
+        return;
+      }
+    }
+    // 少见：调用方没有先 Invalidate，或其后检查点又保存了一次。仍须先作废再修改；
+    // 作废失败时文件仍视为有效（下次 Invalidate 重试并报告），修改照常进行
+    if (!Invalidate().ok()) {
+      std::lock_guard<std::mutex> g(st.mu);
+      fn(EntriesLocked(st, pid));
+      st.changed = true;
+      return;
+    }
+  }
+}
+
+Status ZoneMap::Invalidate() {
+  if (!persisted_.load(std::memory_order_acquire)) return Status::OK();
+  std::lock_guard<std::mutex> g(persist_mu_);
+  return InvalidateLocked();
+}
+
+Status ZoneMap::InvalidateLocked() {
+  if (!persisted_.load(std::memory_order_relaxed)) return Status::OK();
+  // 之后写回的页可能含有文件中没有记入的值：文件头作废并落盘后才允许修改
+  AlignedBuffer buf(disk_->page_size());
+  Status s = buf.data() ? Status::OK() : Status::IOError("ZoneMap: out of memory");
+  if (s.ok()) {
+    std::memset(buf.data(), 0, disk_->page_size());
+    s = disk_->WritePage(0, buf.data());
+  }
+  if (s.ok()) s = disk_->Sync();
+  // 写不了头页就截断（空文件同样载入失败）；两者都失败时文件头可能仍有效，不能当作已作废
+  if (!s.ok() && !disk_->ResizeToPages(0).ok()) return s;
+  persisted_.store(false, std::memory_order_release);
+  return Status::OK();
+}
+
+void ZoneMap::AccumulateValue(ZoneEntry* e, Type type, const std::uint8_t* value, bool null) {
+  const bool first = !e->has_values();
+  Count(e, 1, null ? 1 : 0);
+  if (null) return;
+  switch (type) {
+    case Type::INT32:
+    case Type::DATE: {
+      int32_t v;
+      std::memcpy(&v, value, sizeof(v));
+      WidenInt(e, first, v, v);
+      break;
+    }
+    case Type::INT64: {
+      int64_t v;
+      std::memcpy(&v, value, sizeof(v));
+      WidenInt(e, first, v, v);
+      break;
+    }
+    case Type::FLOAT:
+    case Type::DOUBLE: {
+      double d;
+      if (type == Type::FLOAT) { float f; std::memcpy(&f, value, sizeof(f)); d = f; }
+      else std::memcpy(&d, value, sizeof(d));
+      if (std::isnan(d)) WidenDouble(e, first, -kInf, kInf);
+      else               WidenDouble(e, first, d, d);
+      break;
+    }
+    default: break;
+  }
+}
+
+void ZoneMap::Accumulate(ZoneEntry* acc, const std::uint8_t* row, size_t len) const {
+  if (columns_.empty() || !row || len < codec_.min_row_size()) return;
+  for (size_t k = 0; k < columns_.size(); ++k) {
+    AccumulateValue(&acc[k], types_[k], row + codec_.field(k).offset, codec_.IsNull(row, k));
+  }
+}
+
+void ZoneMap::Add(page_id_t pid, const std::uint8_t* row, size_t len) {
+  if (columns_.empty() || pid == kInvalidPageId || !row || len < codec_.min_row_size()) return;
+  Mutate(pid, [&](ZoneEntry* e) { Accumulate(e, row, len); });
+}
+
+void ZoneMap::Merge(page_id_t pid, const ZoneEntry* acc) {
+  if (columns_.empty() || pid == kInvalidPageId || !acc[0].tracked()) return;
+  Mutate(pid, [&](ZoneEntry* e) {
+    for (size_t k = 0; k < columns_.size(); ++k) {
+      const bool first = !e[k].has_values();
+      if (acc[k].has_values()) {
+        if (Floating(types_[k])) WidenDouble(&e[k], first, acc[k].dmin(), acc[k].dmax());
+        else                     WidenInt(&e[k], first, acc[k].min, acc[k].max);
+      }
+      Count(&e[k], acc[k].rows, acc[k].nulls);
+    }
+  });
+}
+
+void ZoneMap::Assign(page_id_t pid, const ZoneEntry* entries) {
+  if (columns_.empty() || pid == kInvalidPageId) return;
+  Mutate(pid, [&](ZoneEntry* e) { std::copy(entries, entries + columns_.size(), e); });
+}
+
+bool ZoneMap::Get(page_id_t pid, ZoneEntry* out) const {
+  if (columns_.empty() || pid == kInvalidPageId) return false;
+  Stripe& st = StripeOf(pid);
+  const size_t at = static_cast<size_t>(pid / kStripes) * columns_.size();
+  std::lock_guard<std::mutex> g(st.mu);
+  if (at + columns_.size() > st.entries.size() || !st.entries[at].tracked()) return false;
+  std::copy(st.entries.begin() + at, st.entries.begin() + at + columns_.size(), out);
+  return true;
+}
+
+uint64_t ZoneMap::size() const {
+  if (columns_.empty()) return 0;
+  uint64_t n = 0;
+  for (size_t s = 0; s < kStripes; ++s) {
+    Stripe& st = stripes_[s];
+    std::lock_guard<std::mutex> g(st.mu);
+    const size_t len = st.entries.size() / columns_.size();
+    if (len) n = std::max<uint64_t>(n, (len - 1) * kStripes + s + 1);
+  }
+  return n;
+}
+
+size_t ZoneMap::TrackedPages() const {
+  size_t n = 0;
+  for (size_t s = 0; s < kStripes && !columns_.empty(); ++s) {
+    Stripe& st = stripes_[s];
+    std::lock_guard<std::mutex> g(st.mu);
+    for (size_t i = 0; i < st.entries.size(); i += columns_.size()) n += st.entries[i].tracked();
+  }
+  return n;
+}
+
+size_t ZoneMap::MemoryBytes() const {
+  size_t n = 0;
+  for (size_t s = 0; s < kStripes; ++s) {
+    Stripe& st = stripes_[s];
+    std::lock_guard<std::mutex> g(st.mu);
+    n += st.entries.capacity() * sizeof(ZoneEntry);
+  }
+  return n;
+}
+
+std::vector<ZoneEntry> ZoneMap::Snapshot(uint64_t* pages) {
+  *pages = size();
+  const size_t ncols = columns_.size();
+  std::vector<ZoneEntry> all(static_cast<size_t>(*pages) * ncols);
+  for (size_t s = 0; s < kStripes && ncols; ++s) {
+    Stripe& st = stripes_[s];
+    std::lock_guard<std::mutex> g(st.mu);
+    st.changed = false;
+    for (size_t i = 0; i < st.entries.size() / ncols; ++i) {
+      const size_t pid = i * kStripes + s;
+      if (pid >= *pages) break;
+      std::copy_n(st.entries.begin() + i * ncols, ncols, all.begin() + pid * ncols);
+    }
+  }
+  return all;
+}
+
+Status ZoneMap::SaveTo(DiskManager* disk) {
+  if (!disk) return Status::InvalidArgument("ZoneMap SaveTo: disk=null");
+  const uint32_t ps = disk->page_size();
+  const size_t   desc_bytes = columns_.size() * sizeof(ZoneColumnDesc);
+  if (ps < sizeof(ZoneFileHeader) + desc_bytes) return Status::InvalidArgument("ZoneMap SaveTo: page too small");
+
+  // 与 Invalidate 互斥；修改不持此锁，快照之后的并发修改在写完文件头后复查
+  std::lock_guard<std::mutex> g(persist_mu_);
+  uint64_t pages = 0;
+  const std::vector<ZoneEntry> all = Snapshot(&pages);
+  const auto* bytes = reinterpret_cast<const std::uint8_t*>(all.data());
+  const size_t total = all.size() * sizeof(ZoneEntry);
+  const uint64_t data_pages = (total + ps - 1) / ps;
+
+  std::vector<ZoneColumnDesc> desc;
+  for (size_t k = 0; k < columns_.size(); ++k) {
+    desc.push_back({static_cast<uint32_t>(columns_[k]), static_cast<uint32_t>(types_[k])});
+  }
+
+  AlignedBuffer buf(ps);
+  if (!buf.data()) return Status::IOError("ZoneMap SaveTo: out of memory");
+
+  persisted_.store(false, std::memory_order_release);  // 中途失败时不再认为文件有效
+  Status s = disk->ResizeToPages(1 + data_pages);
+  for (uint64_t p = 0; s.ok() && p < data_pages; ++p) {
+    const size_t off = static_cast<size_t>(p) * ps;
+    std::memset(buf.data(), 0, ps);
+    std::memcpy(buf.data(), bytes + off, std::min<size_t>(ps, total - off));
+    s = disk->WritePage(static_cast<page_id_t>(1 + p), buf.data());
+  }
+  if (!s.ok()) return s;
+
+  // 数据页落盘后再写头：头页有效即意味着其后的数据完整
+  if (s = disk->Sync(); !s.ok()) return s;
+  const uint64_t sum = Fnv1a64(bytes, total, Fnv1a64(desc.data(), desc_bytes));
+  ZoneFileHeader hdr{kZoneMagic, kZoneVersion, static_cast<uint32_t>(columns_.size()),
+                     static_cast<uint32_t>(sizeof(ZoneEntry)), pages, sum};
+  std::memset(buf.data(), 0, ps);
+  std::memcpy(buf.data(), &hdr, sizeof(hdr));
+  if (desc_bytes) std::memcpy(buf.data() + sizeof(hdr), desc.data(), desc_bytes);
+  if (s = disk->WritePage(0, buf.data()); !s.ok()) return s;
+  if (s = disk->Sync(); !s.ok()) return s;
+
+  disk_ = disk;
+  persisted_.store(true);
+  // 快照之后仍有修改（它们看到的 persisted_ 为 false）：文件不覆盖内存，立即作废。
+  // 此后的修改会在条带锁内看到 persisted_ 并先经 Invalidate
+  for (size_t i = 0; i < kStripes; ++i) {
+    Stripe& st = stripes_[i];
+    std::lock_guard<std::mutex> sg(st.mu);
+    if (st.changed) return InvalidateLocked();
+  }
+  return Status::OK();
+}
+
+Status ZoneMap::LoadFrom(DiskManager* disk) {
+  if (!disk) return Status::InvalidArgument("ZoneMap LoadFrom: disk=null");
+  const uint32_t ps = disk->page_size();
+  const size_t   ncols = columns_.size();
+  const size_t   desc_bytes = ncols * sizeof(ZoneColumnDesc);
+  if (ps < sizeof(ZoneFileHeader) + desc_bytes) return Status::InvalidArgument("ZoneMap LoadFrom: page too small");
+  if (disk->PageCount() == 0) return Status::NotFound("ZoneMap LoadFrom: empty zone file");
+
+  AlignedBuffer buf(ps);
+  if (!buf.data()) return Status::IOError("ZoneMap LoadFrom: out of memory");
+  if (Status s = disk->ReadPage(0, buf.data()); !s.ok()) return s;
+
+  ZoneFileHeader hdr;
+  std::memcpy(&hdr, buf.data(), sizeof(hdr));
+  if (hdr.magic != kZoneMagic || hdr.version != kZoneVersion || hdr.entry_size != sizeof(ZoneEntry)) {
+    return Status::Corruption("ZoneMap LoadFrom: bad header");
+  }
+  std::vector<ZoneColumnDesc> desc(ncols);
+  if (desc_bytes) std::memcpy(desc.data(), buf.data() + sizeof(hdr), desc_bytes);
+  bool same = hdr.columns == ncols;
+  for (size_t k = 0; same && k < ncols; ++k) {
+    same = desc[k].column == columns_[k] && desc[k].type == static_cast<uint32_t>(types_[k]);
+  }
+  if (!same) return Status::Corruption("ZoneMap LoadFrom: column mismatch");
+
+  const size_t total = static_cast<size_t>(hdr.pages) * ncols * sizeof(ZoneEntry);
+  const uint64_t data_pages = (total + ps - 1) / ps;
+  if (1 + data_pages > disk->PageCount()) return Status::Corruption("ZoneMap LoadFrom: truncated");
+
+  std::vector<ZoneEntry> all(static_cast<size_t>(hdr.pages) * ncols);
+  auto* bytes = reinterpret_cast<std::uint8_t*>(all.data());
+  for (uint64_t p = 0; p < data_pages; ++p) {
+    if (Status s = disk->ReadPage(static_cast<page_id_t>(1 + p), buf.data()); !s.ok()) return s;
+    const size_t off = static_cast<size_t>(p) * ps;
+    std::memcpy(bytes + off, buf.data(), std::min<size_t>(ps, total - off));
+  }
+  if (Fnv1a64(bytes, total, Fnv1a64(desc.data(), desc_bytes)) != hdr.checksum) {
+    return Status::Corruption("ZoneMap LoadFrom: checksum mismatch");
+  }
+
+  std::lock_guard<std::mutex> g(persist_mu_);
+  for (size_t s = 0; s < kStripes && ncols; ++s) {
+    Stripe& st = stripes_[s];
+    std::lock_guard<std::mutex> sg(st.mu);
+    st.changed = false;
+    st.entries.clear();
+    for (uint64_t pid = s; pid < hdr.pages; pid += kStripes) {
+      st.entries.insert(st.entries.end(), all.begin() + static_cast<size_t>(pid) * ncols,
+                        all.begin() + static_cast<size_t>(pid + 1) * ncols);
+    }
+  }
+  disk_ = disk;
+  persisted_.store(true, std::memory_order_release);
+  return Status::OK();
+}
+
+}  // namespace storage
+}  // namespace dbms
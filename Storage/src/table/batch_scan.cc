@@ -0,0 +1,407 @@
+#include "dbms/storage/table/batch_scan.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "dbms/storage/space/zone_map.h"
+#include "dbms/storage/table/table_heap.h"
+#include "internal/table/filter_kernels.h"
+
+namespace dbms {
+namespace storage {
+
+namespace {
+
+constexpr int64_t kI64Min = std::numeric_limits<int64_t>::min();
+constexpr int64_t kI64Max = std::numeric_limits<int64_t>::max();
+constexpr double  kInf    = std::numeric_limits<double>::infinity();
+
+/// 已取整的浮点数相对 int64 值域的位置：-1 低于、+1 高于，0 时 *out 为其值（NaN 由调用方先排除）
+int ClassifyI64(double integral, int64_t* out) {
+  if (integral < -9223372036854775808.0)  return -1;
+  if (integral >= 9223372036854775808.0)  return 1;
+  *out = static_cast<int64_t>(integral);
+  return 0;
+}
+
+/// 空区间：任何值都不满足 lo <= x <= hi
+void SetEmpty(int64_t* lo, int64_t* hi) { *lo = 1; *hi = 0; }
+
+/// 下界 x >= ceil(d)（整数常量即 x >= v）
+void IntLowerBound(const Predicate::Operand& v, int64_t* lo, int64_t* hi) {
+  if (v.integral) { *lo = v.i; return; }
+  int64_t c = 0;
+  const int pos = ClassifyI64(std::ceil(v.d), &c);
+  if (pos > 0) SetEmpty(lo, hi);
+  else if (pos == 0) *lo = c;
+}
+
+/// 上界 x <= floor(d)（整数常量即 x <= v）
+void IntUpperBound(const Predicate::Operand& v, int64_t* lo, int64_t* hi) {
+  if (v.integral) { *hi = v.i; return; }
+  int64_t f = 0;
+  const int pos = ClassifyI64(std::floor(v.d), &f);
+  if (pos < 0) SetEmpty(lo, hi);
+  else if (pos == 0) *hi = f;
+}
+
+/// 整数列上的比较换成闭区间 [lo, hi]（kNe 为 [v, v] 取补）
+void IntRange(CompareOp op, const Predicate::Operand& v, int64_t* lo, int64_t* hi, bool* negate) {
+  *lo = kI64Min; *hi = kI64Max; *negate = op == CompareOp::kNe;
+  if (!v.integral && std::isnan(v.d)) {  // 与 NaN 比较恒为假；kNe 因此恒为真
+    SetEmpty(lo, hi);
+    return;
+  }
+  switch (op) {
+    case CompareOp::kEq:
+    case CompareOp::kNe: {
+      int64_t x = v.i;
+      if (v.integral || (std::floor(v.d) == v.d && ClassifyI64(v.d, &x) == 0)) *lo = *hi = x;
+      else SetEmpty(lo, hi);
+      break;
+    }
+    case CompareOp::kLe: IntUpperBound(v, lo, hi); break;
+    case CompareOp::kGe: IntLowerBound(v, lo, hi); break;
+    case CompareOp::kLt:  // x < v 即 x <= v - 1；浮点常量即 x <= ceil(d) - 1
+    case CompareOp::kGt: {  // x > v 即 x >= v + 1；浮点常量即 x >= floor(d) + 1
+      const bool lt = op == CompareOp::kLt;
+      int64_t x = v.i;
+      const int pos = v.integral ? 0 : ClassifyI64(lt ? std::ceil(v.d) : std::floor(v.d), &x);
+      if (lt ? pos < 0 || (pos == 0 && x == kI64Min) : pos > 0 || (pos == 0 && x == kI64Max)) SetEmpty(lo, hi);
+      else if (pos == 0) (lt ? *hi : *lo) = lt ? x - 1 : x + 1;
+      break;
+    }
+  }
+}
+
+/// DOUBLE 列上的比较换成闭区间 [lo, hi]：开端点用相邻可表示值收紧
+void DoubleRange(CompareOp op, double v, double* lo, double* hi, bool* negate) {
+  *lo = -kInf; *hi = kInf; *negate = false;
+  switch (op) {
+    case CompareOp::kEq: *lo = *hi = v; break;
+    case CompareOp::kNe: *lo = *hi = v; *negate = true; break;
+    case CompareOp::kLt:
+      if (v == -kInf) { *lo = 1; *hi = 0; } else *hi = std::nextafter(v, -kInf);
+      break;
+    case CompareOp::kLe: *hi = v; break;
+    case CompareOp::kGt:
+      if (v == kInf) { *lo = 1; *hi = 0; } else *lo = std::nextafter(v, kInf);
+      break;
+    case CompareOp::kGe: *lo = v; break;
+  }
+}
+
+/// 把 bits[0, n) 按位拼接到 dst 的第 at 位起（dst 须已按新长度清零）
+void AppendBits(uint64_t* dst, uint32_t at, const std::uint8_t* bits, uint32_t n) {
+  for (uint32_t i = 0; i < n; i += 8) {
+    uint64_t b = bits[i / 8];
+    if (n - i < 8) b &= (1u << (n - i)) - 1;
+    const uint32_t pos = at + i;
+    dst[pos / 64] |= b << (pos % 64);
+    if (pos % 64 > 56 && (b >> (64 - pos % 64))) dst[pos / 64 + 1] |= b >> (64 - pos % 64);
+  }
+}
+
+/// 按区间摘要判断一页能否命中：各项对应的列摘要与谓词范围不相交即可跳过。
+/// 按值持有所需的一切，随 ColumnScanner 一起移动
+struct ZoneFilter {
+  struct Term {
+    int                  slot;  // ZoneMap 中的列位置
+    bool                 floating;
+    bool                 negate;
+    int64_t              lo, hi;
+    double               dlo, dhi;
+    bool                 in;    // IN 项：值落在 set（升序）中
+    std::vector<int64_t> set;
+  };
+  const ZoneMap*                 zones;
+  std::vector<Term>              terms;
+  mutable std::vector<ZoneEntry> buf;  // 各列摘要的拷贝缓冲
+
+  static bool MayMatch(const Term& t, const ZoneEntry& e) {
+    if (!e.has_values()) return false;  // 全为 NULL：NULL 不满足任何一项
+    if (t.in) {
+      auto it = std::lower_bound(t.set.begin(), t.set.end(), e.min);
+      return it != t.set.end() && *it <= e.max;
+    }
+    if (t.floating) {
+      if (t.negate) return !(t.dlo == t.dhi && e.dmin() == t.dlo && e.dmax() == t.dlo);
+      return t.dlo <= t.dhi && e.dmax() >= t.dlo && e.dmin() <= t.dhi;
+    }
+    if (t.negate) return !(t.lo == t.hi && e.min == t.lo && e.max == t.lo);
+    return t.lo <= t.hi && e.max >= t.lo && e.min <= t.hi;
+  }
+
+  bool operator()(page_id_t pid) const {
+    if (!zones->Get(pid, buf.data())) return true;  // 未被跟踪的页照常读取
+    for (const Term& t : terms) {
+      if (!MayMatch(t, buf[static_cast<size_t>(t.slot)])) return false;
+    }
+    return true;
+  }
+};
+
+}  // namespace
+
+// ---------------- Predicate ----------------
+
+Predicate& Predicate::Compare(size_t column, CompareOp op, Operand v) {
+  Term t;
+  t.kind = Term::Kind::kCompare; t.column = column; t.op = op; t.lo = v;
+  terms_.push_back(std::move(t));
+  return *this;
+}
+
+Predicate& Predicate::Between(size_t column, Operand lo, Operand hi) {
+  Term t;
+  t.kind = Term::Kind::kBetween; t.column = column; t.lo = lo; t.hi = hi;
+  terms_.push_back(std::move(t));
+  return *this;
+}
+
+Predicate& Predicate::In(size_t column, std::vector<int64_t> values) {
+  Term t;
+  t.kind = Term::Kind::kIn; t.column = column; t.values = std::move(values);
+  terms_.push_back(std::move(t));
+  return *this;
+}
+
+// ---------------- RecordBatch ----------------
+
+std::string_view RecordBatch::String(size_t k, uint32_t r) const {
+  const BatchColumn& c = columns[k];
+  if (c.type == Type::VARCHAR) return std::string_view(c.data + c.offsets[r], c.offsets[r + 1] - c.offsets[r]);
+  const auto* p = reinterpret_cast<const char*>(c.values + static_cast<size_t>(r) * c.width);
+  size_t n = c.width;
+  while (n > 0 && p[n - 1] == '\0') --n;
+  return std::string_view(p, n);
+}
+
+// ---------------- BatchScanner ----------------
+
+std::vector<size_t> BatchScanner::ScanColumnsFor(std::vector<size_t> projection, const Predicate& predicate) {
+  for (const auto& t : predicate.terms()) {
+    if (std::find(projection.begin(), projection.end(), t.column) == projection.end()) {
+      projection.push_back(t.column);
+    }
+  }
+  return projection;
+}
+
+BatchScanner::BatchScanner(const TableHeap* table, std::vector<size_t> projection,
+                           const Predicate& predicate, const BatchScanOptions& opt)
+    : schema_(table ? table->schema() : nullptr),
+      opt_(opt),
+      cols_(ScanColumnsFor(projection, predicate)),
+      nproj_(projection.size()),
+      scan_(table, cols_, opt.scan),
+      kernels_(opt.simd ? &BestFilterKernels() : &ScalarFilterKernels()) {
+  if (!scan_.status().ok()) { status_ = scan_.status(); return; }
+  if (opt_.batch_rows == 0) opt_.batch_rows = 1;
+  if (Status s = Bind(predicate); !s.ok()) { status_ = std::move(s); return; }
+  if (opt_.zone_maps) InstallZoneFilter(table);
+
+  values_.resize(cols_.size());
+  nulls_.resize(cols_.size());
+  offsets_.resize(cols_.size());
+  data_.resize(cols_.size());
+  batch_.columns.resize(nproj_);
+  for (size_t k = 0; k < nproj_; ++k) {
+    BatchColumn& c = batch_.columns[k];
+    c.column = cols_[k];
+    c.type   = schema_->GetColumn(cols_[k]).type;
+    c.width  = static_cast<uint32_t>(schema_->FixedSizeOf(cols_[k]));
+  }
+}
+
+const char* BatchScanner::kernel() const noexcept { return kernels_->name; }
+
+Status BatchScanner::Bind(const Predicate& predicate) {
+  for (const auto& t : predicate.terms()) {
+    BoundTerm b;
+    b.slot = static_cast<size_t>(std::find(cols_.begin(), cols_.end(), t.column) - cols_.begin());
+    const Type type = schema_->GetColumn(t.column).type;  // 列号已由 ColumnScanner 校验
+    const bool i32  = type == Type::INT32 || type == Type::DATE;
+    if (!i32 && type != Type::INT64 && type != Type::DOUBLE) {
+      return Status::InvalidArgument("ScanBatches: predicate column must be INT32/INT64/DATE/DOUBLE");
+    }
+
+    if (t.kind == Predicate::Term::Kind::kIn) {
+      if (type == Type::DOUBLE) return Status::InvalidArgument("ScanBatches: IN needs an integer column");
+      std::vector<int64_t> set = t.values;
+      std::sort(set.begin(), set.end());
+      set.erase(std::unique(set.begin(), set.end()), set.end());
+      if (i32) {
+        b.kind = BoundTerm::Kind::kInI32;
+        for (int64_t v : set) {
+          if (v >= std::numeric_limits<int32_t>::min() && v <= std::numeric_limits<int32_t>::max()) {
+            b.set32.push_back(static_cast<int32_t>(v));
+          }
+        }
+      } else {
+        b.kind  = BoundTerm::Kind::kInI64;
+        b.set64 = std::move(set);
+      }
+      terms_.push_back(std::move(b));
+      continue;
+    }
+
+    if (type == Type::DOUBLE) {
+      b.kind = BoundTerm::Kind::kRangeF64;
+      if (t.kind == Predicate::Term::Kind::kCompare) DoubleRange(t.op, t.lo.d, &b.dlo, &b.dhi, &b.negate);
+      else { b.dlo = t.lo.d; b.dhi = t.hi.d; }
+      terms_.push_back(std::move(b));
+      continue;
+    }
+
+    if (t.kind == Predicate::Term::Kind::kCompare) {
+      IntRange(t.op, t.lo, &b.lo, &b.hi, &b.negate);
+    } else if ((!t.lo.integral && std::isnan(t.lo.d)) || (!t.hi.integral && std::isnan(t.hi.d))) {
+      SetEmpty(&b.lo, &b.hi);
+    } else {
+      b.lo = kI64Min; b.hi = kI64Max;
+      IntLowerBound(t.lo, &b.lo, &b.hi);
+      if (b.lo <= b.hi) IntUpperBound(t.hi, &b.lo, &b.hi);
+    }
+    if (i32) {
+      // 收窄到 int32：区间与列值域求交，交集为空即空区间
+      b.kind = BoundTerm::Kind::kRangeI32;
+      b.lo = std::max<int64_t>(b.lo, std::numeric_limits<int32_t>::min());
+      b.hi = std::min<int64_t>(b.hi, std::numeric_limits<int32_t>::max());
+      if (b.lo > b.hi) SetEmpty(&b.lo, &b.hi);
+    } else {
+      b.kind = BoundTerm::Kind::kRangeI64;
+    }
+    terms_.push_back(std::move(b));
+  }
+  return Status::OK();
+}
+
+void BatchScanner::InstallZoneFilter(const TableHeap* table) {
+  const ZoneMap* zones = table->zone_map();
+  if (!zones || terms_.empty()) return;
+  ZoneFilter f{zones, {}, std::vector<ZoneEntry>(zones->columns().size())};
+  for (const BoundTerm& b : terms_) {
+    const int slot = zones->SlotOf(cols_[b.slot]);
+    if (slot < 0) continue;  // 没有摘要的列不参与判断
+    ZoneFilter::Term t{slot, b.kind == BoundTerm::Kind::kRangeF64, b.negate, b.lo, b.hi, b.dlo, b.dhi, false, {}};
+    if (b.kind == BoundTerm::Kind::kInI32) {
+      t.in = true;
+      t.set.assign(b.set32.begin(), b.set32.end());
+    } else if (b.kind == BoundTerm::Kind::kInI64) {
+      t.in  = true;
+      t.set = b.set64;
+    }
+    f.terms.push_back(std::move(t));
+  }
+  if (!f.terms.empty()) scan_.SetPageFilter(std::move(f));
+}
+
+bool BatchScanner::Next() {
+  if (!status_.ok()) return false;
+  while (!done_) {
+    // 清空批：位图按 batch_rows 预留，Append 按需扩展
+    rows_ = 0;
+    sel_.assign((opt_.batch_rows + 63) / 64, 0);
+    for (size_t i = 0; i < cols_.size(); ++i) {
+      values_[i].clear();
+      if (schema_->UseNullBitmap()) nulls_[i].assign(sel_.size(), 0);
+      if (schema_->GetColumn(cols_[i]).type == Type::VARCHAR) {
+        offsets_[i].assign(1, 0);
+        data_[i].clear();
+      }
+    }
+
+    for (;;) {
+      if (!pending_) {
+        if (!scan_.Next()) { done_ = true; break; }
+        pending_ = true;
+      }
+      const ColumnPage& pg = scan_.page();
+      if (rows_ > 0 && rows_ + pg.rows > opt_.batch_rows) break;
+      Append(pg);
+      pending_ = false;
+      if (rows_ >= opt_.batch_rows) break;
+    }
+    if (!scan_.status().ok()) { status_ = scan_.status(); return false; }
+    if (rows_ == 0) return false;
+
+    Filter();
+    if (batch_.selected > 0) return true;
+  }
+  return false;
+}
+
+void BatchScanner::Append(const ColumnPage& pg) {
+  const uint32_t at    = rows_;
+  const uint32_t rows  = at + pg.rows;
+  const size_t   words = (static_cast<size_t>(rows) + 63) / 64;
+  if (sel_.size() < words) sel_.resize(words, 0);
+  AppendBits(sel_.data(), at, pg.live, pg.rows);
+
+  for (size_t i = 0; i < cols_.size(); ++i) {
+    const ColumnChunk& ch = pg.columns[i];
+    if (ch.nulls) {
+      if (nulls_[i].size() < words) nulls_[i].resize(words, 0);
+      AppendBits(nulls_[i].data(), at, ch.nulls, pg.rows);
+    }
+    if (ch.type != Type::VARCHAR) {
+      const size_t n = static_cast<size_t>(pg.rows) * ch.width;
+      values_[i].resize(values_[i].size() + n);
+      std::memcpy(values_[i].data() + static_cast<size_t>(at) * ch.width, ch.values, n);
+      continue;
+    }
+    // VARCHAR 改为 offsets + 连续数据；非存活行与 NULL 为空串
+    std::vector<uint32_t>& off = offsets_[i];
+    std::vector<char>&     dat = data_[i];
+    for (uint32_t r = 0; r < pg.rows; ++r) {
+      if (pg.IsLive(r) && !pg.IsNull(i, r)) {
+        const std::string_view s = pg.String(i, r);
+        dat.insert(dat.end(), s.begin(), s.end());
+      }
+      off.push_back(static_cast<uint32_t>(dat.size()));
+    }
+  }
+  rows_ = rows;
+}
+
+void BatchScanner::Filter() {
+  const size_t words = (static_cast<size_t>(rows_) + 63) / 64;
+  uint64_t* sel = sel_.data();
+  for (const BoundTerm& t : terms_) {
+    if (schema_->UseNullBitmap()) {
+      const uint64_t* nulls = nulls_[t.slot].data();
+      for (size_t w = 0; w < words; ++w) sel[w] &= ~nulls[w];
+    }
+    const std::uint8_t* v = values_[t.slot].data();
+    switch (t.kind) {
+      case BoundTerm::Kind::kRangeI32:
+        kernels_->range_i32(v, rows_, static_cast<int32_t>(t.lo), static_cast<int32_t>(t.hi), t.negate, sel);
+        break;
+      case BoundTerm::Kind::kRangeI64: kernels_->range_i64(v, rows_, t.lo,  t.hi,  t.negate, sel); break;
+      case BoundTerm::Kind::kRangeF64: kernels_->range_f64(v, rows_, t.dlo, t.dhi, t.negate, sel); break;
+      case BoundTerm::Kind::kInI32: kernels_->in_i32(v, rows_, t.set32.data(), t.set32.size(), sel); break;
+      case BoundTerm::Kind::kInI64: kernels_->in_i64(v, rows_, t.set64.data(), t.set64.size(), sel); break;
+    }
+  }
+
+  uint32_t selected = 0;
+  for (size_t w = 0; w < words; ++w) selected += static_cast<uint32_t>(__builtin_popcountll(sel[w]));
+
+  batch_.rows      = rows_;
+  batch_.selected  = selected;
+  batch_.selection = sel;
+  for (size_t k = 0; k < nproj_; ++k) {
+    BatchColumn& c = batch_.columns[k];
+    const bool var = c.type == Type::VARCHAR;
+    c.values  = var ? nullptr : values_[k].data();
+    c.nulls   = schema_->UseNullBitmap() ? nulls_[k].data() : nullptr;
+    c.offsets = var ? offsets_[k].data() : nullptr;
+    c.data    = var ? data_[k].data() : nullptr;
+  }
+}
+
+}  // namespace storage
+}  // namespace dbms
@@ -0,0 +1,199 @@
+#include "dbms/storage/table/column_scan.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "dbms/storage/table/table_heap.h"
+#include "dbms/storage/page/page.h"
+#include "internal/page/pax_page_layout.h"
+#include "internal/page/slotted_page_layout.h"
+
+namespace dbms {
+namespace storage {
+
+struct VarRef {
+  uint16_t off;
+  uint16_t len;
+};
+
+std::string_view ColumnPage::String(size_t k, uint32_t r) const {
+  const ColumnChunk& c = columns[k];
+  const auto* p = reinterpret_cast<const char*>(c.values + static_cast<size_t>(r) * c.width);
+  if (c.type == Type::VARCHAR) {
+    VarRef v;
+    std::memcpy(&v, p, sizeof(v));
+    return std::string_view(reinterpret_cast<const char*>(c.var) + v.off, v.len);
+  }
+  size_t n = c.width;
+  while (n > 0 && p[n - 1] == '\0') --n;
+  return std::string_view(p, n);
+}
+
+ColumnScanner::ColumnScanner(const TableHeap* table, std::vector<size_t> columns, const ScanOptions& opt)
+    : table_(table), schema_(table ? table->schema_ : nullptr), cols_(std::move(columns)), opt_(opt) {
+  if (!schema_) { status_ = Status::InvalidArgument("ScanColumns: table has no schema"); return; }
+  for (size_t c : cols_) {
+    if (c >= schema_->ColumnCount()) { status_ = Status::InvalidArgument("ScanColumns: column OOR"); return; }
+  }
+  (void)RowCodec::Compile(*schema_, cols_, &codec_);  // 列号已校验
+  values_.resize(cols_.size());
+  nulls_.resize(cols_.size());
+  var_.resize(cols_.size());
+  page_.columns.resize(cols_.size());
+  for (size_t k = 0; k < cols_.size(); ++k) {
+    ColumnChunk& ch = page_.columns[k];
+    ch.column = cols_[k];
+    ch.type   = schema_->GetColumn(cols_[k]).type;
+    ch.width  = static_cast<uint32_t>(schema_->FixedSizeOf(cols_[k]));
+  }
+  page_count_ = table_->sm_->PageCount(table_->seg_id_);
+  next_pid_   = opt_.first_page;
+}
+
+bool ColumnScanner::Next() {
+  if (!status_.ok() || !table_) return false;
+  for (;;) {
+    if (next_pid_ >= opt_.end_page) return false;
+    if (next_pid_ >= page_count_) {
+      page_count_ = table_->sm_->PageCount(table_->seg_id_);  // 容纳扫描期间追加的页
+      if (next_pid_ >= page_count_) return false;
+    }
+    const page_id_t pid = next_pid_++;
+    if (keep_ && !keep_(pid)) { ++pages_skipped_; continue; }
+    bool empty = true;
+    Status s = LoadPage(pid, &empty);
+    if (s.code() == StatusCode::kCorruption) { status_ = std::move(s); return false; }
+    if (s.ok() && !empty) return true;  // 其余取页失败与 TableIterator 一样跳过该页
+  }
+}
+
+void ColumnScanner::Prefetch(page_id_t pid) {
+  if (opt_.prefetch_pages == 0 || prefetched_until_ > pid + opt_.prefetch_pages / 2) return;
+  const page_id_t want = std::min<page_id_t>(pid + 1 + opt_.prefetch_pages, opt_.end_page);
+  const page_id_t from = std::max<page_id_t>(pid + 1, prefetched_until_);
+  if (from >= want) return;
+  const AccessMode mode = opt_.bulk_read ? AccessMode::kBulkRead : AccessMode::kNormal;
+  prefetched_until_ = want;
+  if (!keep_) {
+    (void)table_->bpm_->Prefetch(table_->seg_id_, from, want - from, mode);
+    return;
+  }
+  // 有页过滤器时只预读会被读取的页：按连续的保留页分段发起
+  for (page_id_t p = from; p < want;) {
+    while (p < want && !keep_(p)) ++p;
+    const page_id_t run = p;
+    while (p < want && keep_(p)) ++p;
+    if (p > run) (void)table_->bpm_->Prefetch(table_->seg_id_, run, p - run, mode);
+  }
+}
+
+Status ColumnScanner::LoadPage(page_id_t pid, bool* out_empty) {
+  Prefetch(pid);
+  ReadPageGuard page;
+  const AccessMode mode = opt_.bulk_read ? AccessMode::kBulkRead : AccessMode::kNormal;
+  if (Status s = table_->bpm_->FetchPage(table_->seg_id_, pid, &page, mode); !s.ok()) return s;
+
+  // 乐观读：整页拷完再校验，期间有写者则重拷；拷贝在页内做了越界检查，撕裂的页不会越界
+  Status st;
+  page.Read([&](const std::uint8_t* data) {
+    st = Status::OK();
+    if (table_->format_ == TableFormat::kPax) CopyPax(data, &st);
+    else                                      CopySlotted(data, &st);
+  });
+  page.Release();
+  if (!st.ok()) return st;
+
+  page_.page_id = pid;
+  page_.live    = live_.data();
+  for (size_t k = 0; k < cols_.size(); ++k) {
+    page_.columns[k].values = values_[k].data();
+    page_.columns[k].nulls  = schema_->UseNullBitmap() ? nulls_[k].data() : nullptr;
+    page_.columns[k].var    = var_[k].data();
+  }
+  *out_empty = page_.rows == 0;
+  return Status::OK();
+}
+
+void ColumnScanner::CopyPax(const std::uint8_t* data, Status* st) {
+  PaxPage pp(const_cast<std::uint8_t*>(data), table_->page_size_, *schema_);  // 只调用只读方法
+  page_.rows = 0;
+  if (!pp.Valid()) {
+    // 已分配但从未初始化的页（全零）视为空页
+    PaxHeader ph;
+    std::memcpy(&ph, data + sizeof(PageHeader), sizeof(ph));
+    if (ph.magic != 0) *st = Status::Corruption("ScanColumns: bad PAX page header");
+    return;
+  }
+  const uint32_t rows  = pp.RowCount();
+  const uint32_t bytes = (rows + 7) / 8;
+  page_.rows = rows;
+
+  live_.resize(bytes);
+  const std::uint8_t* del = pp.DeletedBitmap();
+  for (uint32_t i = 0; i < bytes; ++i) live_[i] = static_cast<std::uint8_t>(~del[i]);
+  if (rows % 8) live_[bytes - 1] &= static_cast<std::uint8_t>((1u << (rows % 8)) - 1);
+
+  // 各列小页偏移随页的容量而变：每页算一次（投影列可以任意顺序、重复）
+  col_off_.resize(schema_->ColumnCount());
+  pp.ForEachColumn([&](size_t c, uint32_t values_off, uint32_t nulls_off) {
+    col_off_[c] = {values_off, nulls_off};
+  });
+
+  const uint32_t var_begin = pp.VarBegin();
+  for (size_t k = 0; k < cols_.size(); ++k) {
+    const ColumnChunk& ch = page_.columns[k];
+    const auto [values_off, nulls_off] = col_off_[cols_[k]];
+    values_[k].assign(data + values_off, data + values_off + static_cast<size_t>(rows) * ch.width);
+    if (nulls_off) nulls_[k].assign(data + nulls_off, data + nulls_off + bytes);
+    if (ch.type != Type::VARCHAR) continue;
+    // 变长区整体拷出，off 改为相对拷贝起点；越界的引用置空（只可能出现在撕裂的读中）
+    var_[k].assign(data + var_begin, data + table_->page_size_);
+    for (uint32_t r = 0; r < rows; ++r) {
+      VarRef v;
+      std::uint8_t* p = values_[k].data() + static_cast<size_t>(r) * sizeof(VarRef);
+      std::memcpy(&v, p, sizeof(v));
+      if (v.off < var_begin || static_cast<uint32_t>(v.off) + v.len > table_->page_size_) v = VarRef{0, 0};
+      else v.off = static_cast<uint16_t>(v.off - var_begin);
+      std::memcpy(p, &v, sizeof(v));
+    }
+  }
+}
+
+void ColumnScanner::CopySlotted(const std::uint8_t* data, Status* st) {
+  SlottedPage sp(const_cast<std::uint8_t*>(data), table_->page_size_);  // 只调用只读方法
+  const uint32_t rows  = sp.SlotCount();
+  const uint32_t bytes = (rows + 7) / 8;
+  page_.rows = rows;
+
+  live_.assign(bytes, 0);
+  for (size_t k = 0; k < cols_.size(); ++k) {
+    values_[k].resize(static_cast<size_t>(rows) * page_.columns[k].width);
+    if (schema_->UseNullBitmap()) nulls_[k].assign(bytes, 0);
+    var_[k].clear();
+  }
+  // 逐行把所选列的定长部分收集到列数组；长度不足固定区的记录不属于本表的 Schema，视为不存活
+  for (uint32_t r = 0; r < rows; ++r) {
+    const std::uint8_t* rec = nullptr;
+    uint16_t len = 0;
+    if (!sp.Get(static_cast<uint16_t>(r), &rec, &len).ok() || len < codec_.min_row_size()) continue;
+    live_[r / 8] |= static_cast<std::uint8_t>(1u << (r % 8));
+    for (size_t k = 0; k < cols_.size(); ++k) {
+      const RowCodec::Field& f = codec_.field(k);
+      std::uint8_t* dst = values_[k].data() + static_cast<size_t>(r) * f.width;
+      std::memcpy(dst, rec + f.offset, f.width);
+      if (codec_.IsNull(rec, k)) nulls_[k][r / 8] |= static_cast<std::uint8_t>(1u << (r % 8));
+      if (f.type != Type::VARCHAR) continue;
+      VarRef v;
+      std::memcpy(&v, dst, sizeof(v));
+      if (static_cast<uint32_t>(v.off) + v.len > len) v = VarRef{0, 0};
+      const auto at = static_cast<uint16_t>(var_[k].size());
+      var_[k].insert(var_[k].end(), rec + v.off, rec + v.off + v.len);
+      v.off = at;
+      std::memcpy(dst, &v, sizeof(v));
+    }
+  }
+  (void)st;
+}
+
+}  // namespace storage
+}  // namespace dbms
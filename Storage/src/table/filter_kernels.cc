@@ -0,0 +1,316 @@
+/**
+ * @file filter_kernels.cc
+ * @brief 批扫描谓词内核：标量 / AVX2 / NEON。
+ *
+ * 每次处理 64 行（选择位图的一个字）：SIMD 比较产生每通道一位的掩码，拼成 64 位后与 sel 合并；
+ * 不足 64 行的尾字与 IN 列表较长（> kSimdSetMax）时走标量路径。
+ */
+
+#include "internal/table/filter_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define DBMS_FILTER_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DBMS_FILTER_NEON 1
+#endif
+
+namespace dbms {
+namespace storage {
+
+namespace {
+
+constexpr size_t kSimdSetMax = 16;  // IN 列表不超过此长度时逐个广播比较，否则标量二分查找
+
+template <class T>
+inline T LoadAt(const std::uint8_t* v, uint32_t r) {
+  T x;
+  std::memcpy(&x, v + static_cast<size_t>(r) * sizeof(T), sizeof(T));
+  return x;
+}
+
+inline void Merge(uint64_t* sel, uint64_t m, bool negate) { *sel &= negate ? ~m : m; }
+
+// ---------------- 标量实现 ----------------
+
+template <class T>
+uint64_t ScalarRangeWord(const std::uint8_t* v, uint32_t base, uint32_t cnt, T lo, T hi) {
+  uint64_t m = 0;
+  for (uint32_t i = 0; i < cnt; ++i) {
+    const T x = LoadAt<T>(v, base + i);
+    m |= static_cast<uint64_t>(x >= lo && x <= hi) << i;
+  }
+  return m;
+}
+
+template <class T>
+uint64_t ScalarInWord(const std::uint8_t* v, uint32_t base, uint32_t cnt, const T* set, size_t k) {
+  uint64_t m = 0;
+  for (uint32_t i = 0; i < cnt; ++i) {
+    const T x = LoadAt<T>(v, base + i);
+    m |= static_cast<uint64_t>(std::binary_search(set, set + k, x)) << i;
+  }
+  return m;
+}
+
+template <class T>
+void ScalarRange(const std::uint8_t* v, uint32_t n, T lo, T hi, bool negate, uint64_t* sel) {
+  for (uint32_t base = 0, w = 0; base < n; base += 64, ++w) {
+    if (sel[w]) Merge(&sel[w], ScalarRangeWord<T>(v, base, std::min(64u, n - base), lo, hi), negate);
+  }
+}
+
+template <class T>
+void ScalarIn(const std::uint8_t* v, uint32_t n, const T* set, size_t k, uint64_t* sel) {
+  for (uint32_t base = 0, w = 0; base < n; base += 64, ++w) {
+    if (sel[w]) sel[w] &= ScalarInWord<T>(v, base, std::min(64u, n - base), set, k);
+  }
+}
+
+void ScalarRangeI32(const std::uint8_t* v, uint32_t n, int32_t lo, int32_t hi, bool neg, uint64_t* sel) {
+  ScalarRange<int32_t>(v, n, lo, hi, neg, sel);
+}
+void ScalarRangeI64(const std::uint8_t* v, uint32_t n, int64_t lo, int64_t hi, bool neg, uint64_t* sel) {
+  ScalarRange<int64_t>(v, n, lo, hi, neg, sel);
+}
+void ScalarRangeF64(const std::uint8_t* v, uint32_t n, double lo, double hi, bool neg, uint64_t* sel) {
+  ScalarRange<double>(v, n, lo, hi, neg, sel);
+}
+void ScalarInI32(const std::uint8_t* v, uint32_t n, const int32_t* set, size_t k, uint64_t* sel) {
+  ScalarIn<int32_t>(v, n, set, k, sel);
+}
+void ScalarInI64(const std::uint8_t* v, uint32_t n, const int64_t* set, size_t k, uint64_t* sel) {
+  ScalarIn<int64_t>(v, n, set, k, sel);
+}
+
+const FilterKernels kScalar = {
+  "scalar", &ScalarRangeI32, &ScalarRangeI64, &ScalarRangeF64, &ScalarInI32, &ScalarInI64,
+};
+
+#if defined(DBMS_FILTER_X86)
+
+// ---------------- AVX2：i32 8 通道、i64/f64 4 通道 ----------------
+
+__attribute__((target("avx2")))
+void Avx2RangeI32(const std::uint8_t* v, uint32_t n, int32_t lo, int32_t hi, bool neg, uint64_t* sel) {
+  const __m256i vlo = _mm256_set1_epi32(lo);
+  const __m256i vhi = _mm256_set1_epi32(hi);
+  uint32_t base = 0, w = 0;
+  for (; base + 64 <= n; base += 64, ++w) {
+    if (!sel[w]) continue;
+    uint64_t m = 0;
+    for (uint32_t j = 0; j < 8; ++j) {
+      const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + (base + 8 * j) * 4u));
+      const __m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(vlo, x), _mm256_cmpgt_epi32(x, vhi));
+      m |= static_cast<uint64_t>(~_mm256_movemask_ps(_mm256_castsi256_ps(out)) & 0xff) << (8 * j);
+    }
+    Merge(&sel[w], m, neg);
+  }
+  if (base < n && sel[w]) Merge(&sel[w], ScalarRangeWord<int32_t>(v, base, n - base, lo, hi), neg);
+}
+
+__attribute__((target("avx2")))
+void Avx2RangeI64(const std::uint8_t* v, uint32_t n, int64_t lo, int64_t hi, bool neg, uint64_t* sel) {
+  const __m256i vlo = _mm256_set1_epi64x(lo);
+  const __m256i vhi = _mm256_set1_epi64x(hi);
+  uint32_t base = 0, w = 0;
+  for (; base + 64 <= n; base += 64, ++w) {
+    if (!sel[w]) continue;
+    uint64_t m = 0;
+    for (uint32_t j = 0; j < 16; ++j) {
+      const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + (base + 4 * j) * 8u));
+      const __m256i out = _mm256_or_si256(_mm256_cmpgt_epi64(vlo, x), _mm256_cmpgt_epi64(x, vhi));
+      m |= static_cast<uint64_t>(~_mm256_movemask_pd(_mm256_castsi256_pd(out)) & 0xf) << (4 * j);
+    }
+    Merge(&sel[w], m, neg);
+  }
+  if (base < n && sel[w]) Merge(&sel[w], ScalarRangeWord<int64_t>(v, base, n - base, lo, hi), neg);
+}
+
+__attribute__((target("avx2")))
+void Avx2RangeF64(const std::uint8_t* v, uint32_t n, double lo, double hi, bool neg, uint64_t* sel) {
+  const __m256d vlo = _mm256_set1_pd(lo);
+  const __m256d vhi = _mm256_set1_pd(hi);
+  uint32_t base = 0, w = 0;
+  for (; base + 64 <= n; base += 64, ++w) {
+    if (!sel[w]) continue;
+    uint64_t m = 0;
+    for (uint32_t j = 0; j < 16; ++j) {
+      const __m256d x  = _mm256_loadu_pd(reinterpret_cast<const double*>(v + (base + 4 * j) * 8u));
+      const __m256d in = _mm256_and_pd(_mm256_cmp_pd(x, vlo, _CMP_GE_OQ), _mm256_cmp_pd(x, vhi, _CMP_LE_OQ));
+      m |= static_cast<uint64_t>(_mm256_movemask_pd(in)) << (4 * j);
+    }
+    Merge(&sel[w], m, neg);
+  }
+  if (base < n && sel[w]) Merge(&sel[w], ScalarRangeWord<double>(v, base, n - base, lo, hi), neg);
+}
+
+__attribute__((target("avx2")))
+void Avx2InI32(const std::uint8_t* v, uint32_t n, const int32_t* set, size_t k, uint64_t* sel) {
+  if (k > kSimdSetMax) { ScalarIn<int32_t>(v, n, set, k, sel); return; }
+  __m256i keys[kSimdSetMax];
+  for (size_t i = 0; i < k; ++i) keys[i] = _mm256_set1_epi32(set[i]);
+  uint32_t base = 0, w = 0;
+  for (; base + 64 <= n; base += 64, ++w) {
+    if (!sel[w]) continue;
+    uint64_t m = 0;
+    for (uint32_t j = 0; j < 8; ++j) {
+      const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + (base + 8 * j) * 4u));
+      __m256i hit = _mm256_setzero_si256();
+      for (size_t i = 0; i < k; ++i) hit = _mm256_or_si256(hit, _mm256_cmpeq_epi32(x, keys[i]));
+      m |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(hit))) << (8 * j);
+    }
+    sel[w] &= m;
+  }
+  if (base < n && sel[w]) sel[w] &= ScalarInWord<int32_t>(v, base, n - base, set, k);
+}
+
+__attribute__((target("avx2")))
+void Avx2InI64(const std::uint8_t* v, uint32_t n, const int64_t* set, size_t k, uint64_t* sel) {
+  if (k > kSimdSetMax) { ScalarIn<int64_t>(v, n, set, k, sel); return; }
+  __m256i keys[kSimdSetMax];
+  for (size_t i = 0; i < k; ++i) keys[i] = _mm256_set1_epi64x(set[i]);
+  uint32_t base = 0, w = 0;
+  for (; base + 64 <= n; base += 64, ++w) {
+    if (!sel[w]) continue;
+    uint64_t m = 0;
+    for (uint32_t j = 0; j < 16; ++j) {
+      const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + (base + 4 * j) * 8u));
+      __m256i hit = _mm256_setzero_si256();
+      for (size_t i = 0; i < k; ++i) hit = _mm256_or_si256(hit, _mm256_cmpeq_epi64(x, keys[i]));
+      m |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(hit))) << (4 * j);
+    }
+    sel[w] &= m;
+  }
+  if (base < n && sel[w]) sel[w] &= ScalarInWord<int64_t>(v, base, n - base, set, k);
+}
+
+const FilterKernels kAvx2 = {
+  "avx2", &Avx2RangeI32, &Avx2RangeI64, &Avx2RangeF64, &Avx2InI32, &Avx2InI64,
+};
+
+#elif defined(DBMS_FILTER_NEON)
+
+// ---------------- NEON：i32 4 通道、i64/f64 2 通道；各通道与位权相与后横向求和得掩码 ----------------
+
+inline uint64_t Mask4(uint32x4_t ok) {
+  static const uint32_t kBits[4] = {1, 2, 4, 8};
+  return vaddvq_u32(vandq_u32(ok, vld1q_u32(kBits)));
+}
+inline uint64_t Mask2(uint64x2_t ok) {
+  static const uint64_t kBits[2] = {1, 2};
+  return vaddvq_u64(vandq_u64(ok, vld1q_u64(kBits)));
+}
+inline int32x4_t LoadI32x4(const std::uint8_t* p) { return vreinterpretq_s32_u8(vld1q_u8(p)); }
+inline int64x2_t LoadI64x2(const std::uint8_t* p) { return vreinterpretq_s64_u8(vld1q_u8(p)); }
+inline float64x2_t LoadF64x2(const std::uint8_t* p) { return vreinterpretq_f64_u8(vld1q_u8(p)); }
+
+void NeonRangeI32(const std::uint8_t* v, uint32_t n, int32_t lo, int32_t hi, bool neg, uint64_t* sel) {
+  const int32x4_t vlo = vdupq_n_s32(lo), vhi = vdupq_n_s32(hi);
+  uint32_t base = 0, w = 0;
+  for (; base + 64 <= n; base += 64, ++w) {
+    if (!sel[w]) continue;
+    uint64_t m = 0;
+    for (uint32_t j = 0; j < 16; ++j) {
+      const int32x4_t x = LoadI32x4(v + (base + 4 * j) * 4u);
+      m |= Mask4(vandq_u32(vcgeq_s32(x, vlo), vcleq_s32(x, vhi))) << (4 * j);
+    }
+    Merge(&sel[w], m, neg);
+  }
+  if (base < n && sel[w]) Merge(&sel[w], ScalarRangeWord<int32_t>(v, base, n - base, lo, hi), neg);
+}
+
+void NeonRangeI64(const std::uint8_t* v, uint32_t n, int64_t lo, int64_t hi, bool neg, uint64_t* sel) {
+  const int64x2_t vlo = vdupq_n_s64(lo), vhi = vdupq_n_s64(hi);
+  uint32_t base = 0, w = 0;
+  for (; base + 64 <= n; base += 64, ++w) {
+    if (!sel[w]) continue;
+    uint64_t m = 0;
+    for (uint32_t j = 0; j < 32; ++j) {
+      const int64x2_t x = LoadI64x2(v + (base + 2 * j) * 8u);
+      m |= Mask2(vandq_u64(vcgeq_s64(x, vlo), vcleq_s64(x, vhi))) << (2 * j);
+    }
+    Merge(&sel[w], m, neg);
+  }
+  if (base < n && sel[w]) Merge(&sel[w], ScalarRangeWord<int64_t>(v, base, n - base, lo, hi), neg);
+}
+
+void NeonRangeF64(const std::uint8_t* v, uint32_t n, double lo, double hi, bool neg, uint64_t* sel) {
+  const float64x2_t vlo = vdupq_n_f64(lo), vhi = vdupq_n_f64(hi);
+  uint32_t base = 0, w = 0;
+  for (; base + 64 <= n; base += 64, ++w) {
+    if (!sel[w]) continue;
+    uint64_t m = 0;
+    for (uint32_t j = 0; j < 32; ++j) {
+      const float64x2_t x = LoadF64x2(v + (base + 2 * j) * 8u);
+      m |= Mask2(vandq_u64(vcgeq_f64(x, vlo), vcleq_f64(x, vhi))) << (2 * j);
+    }
+    Merge(&sel[w], m, neg);
+  }
+  if (base < n && sel[w]) Merge(&sel[w], ScalarRangeWord<double>(v, base, n - base, lo, hi), neg);
+}
+
+void NeonInI32(const std::uint8_t* v, uint32_t n, const int32_t* set, size_t k, uint64_t* sel) {
+  if (k > kSimdSetMax) { ScalarIn<int32_t>(v, n, set, k, sel); return; }
+  uint32_t base = 0, w = 0;
+  for (; base + 64 <= n; base += 64, ++w) {
+    if (!sel[w]) continue;
+    uint64_t m = 0;
+    for (uint32_t j = 0; j < 16; ++j) {
+      const int32x4_t x = LoadI32x4(v + (base + 4 * j) * 4u);
+      uint32x4_t hit = vdupq_n_u32(0);
+      for (size_t i = 0; i < k; ++i) hit = vorrq_u32(hit, vceqq_s32(x, vdupq_n_s32(set[i])));
+      m |= Mask4(hit) << (4 * j);
+    }
+    sel[w] &= m;
+  }
+  if (base < n && sel[w]) sel[w] &= ScalarInWord<int32_t>(v, base, n - base, set, k);
+}
+
+void NeonInI64(const std::uint8_t* v, uint32_t n, const int64_t* set, size_t k, uint64_t* sel) {
+  if (k > kSimdSetMax) { ScalarIn<int64_t>(v, n, set, k, sel); return; }
+  uint32_t base = 0, w = 0;
+  for (; base + 64 <= n; base += 64, ++w) {
+    if (!sel[w]) continue;
+    uint64_t m = 0;
+    for (uint32_t j = 0; j < 32; ++j) {
+      const int64x2_t x = LoadI64x2(v + (base + 2 * j) * 8u);
+      uint64x2_t hit = vdupq_n_u64(0);
+      for (size_t i = 0; i < k; ++i) hit = vorrq_u64(hit, vceqq_s64(x, vdupq_n_s64(set[i])));
+      m |= Mask2(hit) << (2 * j);
+    }
+    sel[w] &= m;
+  }
+  if (base < n && sel[w]) sel[w] &= ScalarInWord<int64_t>(v, base, n - base, set, k);
+}
+
+const FilterKernels kNeon = {
+  "neon", &NeonRangeI32, &NeonRangeI64, &NeonRangeF64, &NeonInI32, &NeonInI64,
+};
+
+#endif
+
+const FilterKernels& Detect() {
+#if defined(DBMS_FILTER_X86)
+  if (__builtin_cpu_supports("avx2")) return kAvx2;
+#elif defined(DBMS_FILTER_NEON)
+  return kNeon;
+#endif
+  return kScalar;
+}
+
+}  // namespace
+
+const FilterKernels& ScalarFilterKernels() { return kScalar; }
+
+const FilterKernels& BestFilterKernels() {
+  static const FilterKernels& best = Detect();
+  return best;
+}
+
+}  // namespace storage
+}  // namespace dbms
@@ -0,0 +1,172 @@
+#include "dbms/storage/table/parallel_scan.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "dbms/storage/table/table_heap.h"
+
+namespace dbms {
+namespace storage {
+
+namespace {
+
+/// 一个工作线程尚未处理的 morsel 区间 [begin, end)，打包为 (begin << 32 | end) 以便整体 CAS：
+/// 属主从前端取，窃取者从尾端截走一半
+struct alignas(64) MorselRange {
+  std::atomic<uint64_t> r{0};
+};
+
+constexpr uint64_t Pack(uint32_t b, uint32_t e) { return static_cast<uint64_t>(b) << 32 | e; }
+constexpr uint32_t Begin(uint64_t v) { return static_cast<uint32_t>(v >> 32); }
+constexpr uint32_t End(uint64_t v)   { return static_cast<uint32_t>(v); }
+
+bool PopFront(MorselRange* q, uint32_t* m) {
+  uint64_t v = q->r.load(std::memory_order_acquire);
+  while (Begin(v) < End(v)) {
+    if (q->r.compare_exchange_weak(v, Pack(Begin(v) + 1, End(v)), std::memory_order_acq_rel)) {
+      *m = Begin(v);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool StealHalf(MorselRange* q, uint32_t* b, uint32_t* e) {
+  uint64_t v = q->r.load(std::memory_order_acquire);
+  while (Begin(v) < End(v)) {
+    const uint32_t take = (End(v) - Begin(v) + 1) / 2;
+    if (q->r.compare_exchange_weak(v, Pack(Begin(v), End(v) - take), std::memory_order_acq_rel)) {
+      *b = End(v) - take;
+      *e = End(v);
+      return true;
+    }
+  }
+  return false;
+}
+
+uint32_t MorselCount(uint64_t pages, uint32_t morsel_pages) {
+  return static_cast<uint32_t>((pages + morsel_pages - 1) / morsel_pages);
+}
+
+}  // namespace
+
+ParallelScanner::ParallelScanner(const TableHeap* table, const ParallelScanOptions& opt)
+    : table_(table), opt_(opt) {
+  if (opt_.morsel_pages == 0) opt_.morsel_pages = 1;
+  if (opt_.threads == 0) opt_.threads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+uint32_t ParallelScanner::threads() const {
+  if (!table_) return 0;
+  const uint32_t morsels = MorselCount(table_->sm_->PageCount(table_->seg_id_), opt_.morsel_pages);
+  return std::max(1u, std::min(opt_.threads, morsels));
+}
+
+Status ParallelScanner::ForEachMorsel(const MorselFn& fn) { return RunMorsels(fn, true); }
+
+Status ParallelScanner::RunMorsels(const MorselFn& fn, bool prefetch) {
+  stats_ = ParallelScanStats{};
+  if (!table_) return Status::InvalidArgument("ParallelScan: table=null");
+  const uint64_t pages   = table_->sm_->PageCount(table_->seg_id_);
+  const uint32_t morsels = MorselCount(pages, opt_.morsel_pages);
+  if (morsels == 0) return Status::OK();
+  const uint32_t nthreads = std::max(1u, std::min(opt_.threads, morsels));
+
+  // 初始按线程均分连续的 morsel 区间：各线程顺序扫一段相邻的页，预读与 OS 读前瞻都更有效
+  std::unique_ptr<MorselRange[]> queues(new MorselRange[nthreads]);
+  for (uint32_t w = 0; w < nthreads; ++w) {
+    const auto b = static_cast<uint32_t>(static_cast<uint64_t>(morsels) * w / nthreads);
+    const auto e = static_cast<uint32_t>(static_cast<uint64_t>(morsels) * (w + 1) / nthreads);
+    queues[w].r.store(Pack(b, e), std::memory_order_relaxed);
+  }
+
+  std::atomic<bool>     stop{false};
+  std::atomic<uint64_t> done{0}, stolen{0};
+  std::mutex            err_mu;
+  Status                first_err = Status::OK();
+  const AccessMode mode = opt_.scan.bulk_read ? AccessMode::kBulkRead : AccessMode::kNormal;
+
+  auto run = [&](uint32_t w, uint32_t m) {
+    const page_id_t first = static_cast<page_id_t>(static_cast<uint64_t>(m) * opt_.morsel_pages);
+    const page_id_t end   = static_cast<page_id_t>(std::min<uint64_t>(pages, uint64_t{first} + opt_.morsel_pages));
+    if (prefetch && opt_.scan.prefetch_pages > 0) {
+      (void)table_->bpm_->Prefetch(table_->seg_id_, first, std::min(opt_.scan.prefetch_pages, end - first), mode);
+    }
+    done.fetch_add(1, std::memory_order_relaxed);
+    Status s = fn(w, first, end);
+    if (!s.ok()) {
+      std::lock_guard<std::mutex> lk(err_mu);
+      if (first_err.ok()) first_err = std::move(s);
+      stop.store(true, std::memory_order_release);
+    }
+  };
+
+  auto worker = [&](uint32_t w) {
+    MorselRange* own = &queues[w];
+    while (!stop.load(std::memory_order_acquire)) {
+      uint32_t m = 0;
+      if (PopFront(own, &m)) { run(w, m); continue; }
+
+      // 本线程已取空：从剩余最多的线程尾端窃取一半，首个立即处理，其余放入自己的区间
+      uint32_t victim = nthreads, most = 0;
+      for (uint32_t i = 0; i < nthreads; ++i) {
+        const uint64_t v = queues[i].r.load(std::memory_order_relaxed);
+        if (i != w && End(v) > Begin(v) && End(v) - Begin(v) > most) { most = End(v) - Begin(v); victim = i; }
+      }
+      if (victim == nthreads) break;  // 各线程都已取空（只剩各自正在处理的 morsel）
+      uint32_t b = 0, e = 0;
+      if (!StealHalf(&queues[victim], &b, &e)) continue;
+      stolen.fetch_add(e - b, std::memory_order_relaxed);
+      own->r.store(Pack(b + 1, e), std::memory_order_release);
+      run(w, b);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(nthreads - 1);
+  for (uint32_t w = 1; w < nthreads; ++w) pool.emplace_back(worker, w);
+  worker(0);
+  for (auto& t : pool) t.join();
+
+  stats_.threads = nthreads;
+  stats_.morsels = done.load();
+  stats_.stolen  = stolen.load();
+  return first_err;
+}
+
+Status ParallelScanner::ForEachRow(const RowFn& fn) {
+  return ForEachMorsel([&](uint32_t w, page_id_t first, page_id_t end) {
+    ScanOptions so = opt_.scan;
+    so.first_page  = first;
+    so.end_page    = end;
+    TableIterator it = table_->Begin(so);
+    for (; !it.IsEnd(); ++it) fn(w, it);
+    return it.status();
+  });
+}
+
+Status ParallelScanner::ForEachBatch(std::vector<size_t> projection, const Predicate& predicate,
+                                     const BatchScanOptions& bopt, const BatchFn& fn) {
+  // 可能按区间摘要跳页时，morsel 首部的预读交给批扫描（只预读保留的页）
+  const bool prune = bopt.zone_maps && !predicate.empty() && table_ && table_->zone_map();
+  std::atomic<uint64_t> skipped{0};
+  Status s = RunMorsels([&](uint32_t w, page_id_t first, page_id_t end) {
+    BatchScanOptions o = bopt;
+    o.scan             = opt_.scan;
+    o.scan.first_page  = first;
+    o.scan.end_page    = end;
+    BatchScanner bs = table_->ScanBatches(projection, predicate, o);
+    while (bs.Next()) fn(w, bs.batch());
+    skipped.fetch_add(bs.pages_skipped(), std::memory_order_relaxed);
+    return bs.status();
+  }, !prune);
+  stats_.pages_skipped = skipped.load();
+  return s;
+}
+
+}  // namespace storage
+}  // namespace dbms
@@ -0,0 +1,105 @@
+#include "dbms/storage/table/table_appender.h"
+
+#include "dbms/storage/table/table_heap.h"
+#include "dbms/storage/page/page.h"
+
+namespace dbms {
+namespace storage {
+
+TableAppender::TableAppender(TableHeap* table, uint32_t extent_pages)
+    : table_(table), extent_pages_(extent_pages ? extent_pages : 1) {}
+
+TableAppender::~TableAppender() { (void)Finish(); }
+
+Status TableAppender::OpenPage() {
+  // 此时不持任何页闩锁：检查点之后的第一张页在这里作废磁盘上的区间摘要，封页时的 Merge 不做 I/O
+  if (table_->zones_) {
+    if (Status s = table_->zones_->Invalidate(); !s.ok()) return s;
+  }
+  if (next_ == limit_) {
+    const page_id_t first = table_->sm_->AllocatePages(table_->seg_id_, extent_pages_);
+    if (first == kInvalidPageId) return Status::Unavailable("Append: allocate extent failed");
+    next_  = first;
+    limit_ = first + extent_pages_;
+  }
+
+  Status s = table_->bpm_->NewPageAt(table_->seg_id_, next_, &page_);
+  if (!s.ok()) return s;
+  table_->InitPage(page_.Data(), next_);
+  if (table_->zones_) zone_acc_.assign(table_->zones_->columns().size(), ZoneEntry{});
+  pid_ = next_++;
+  ++pages_;
+  return Status::OK();
+}
+
+void TableAppender::SealPage() {
+  if (!page_.Valid()) return;
+  table_->UpdateFsmForPage(pid_, page_.Data());
+  if (table_->zones_) table_->zones_->Merge(pid_, zone_acc_.data());  // 页写回之前（仍持有写闩锁）
+  table_->NoteSealedPage(page_.Data());
+  // 页内逐行的修改不单独记日志：封页时记一份整页映像（页写闩锁仍在，写回不会抢在它之前）
+  table_->LogPage(page_.Data(), PageLogOp::kPageImage, pid_, 0, page_.Data(), table_->page_size_);
+  page_.MarkDirty();
+  page_.Release();
+  pid_ = kInvalidPageId;
+}
+
+template <class InsertFn>
+Status TableAppender::AppendWith(InsertFn&& insert, RID* out) {
+  // 冻结置只读后拒绝；持有的当前页仍是脏页，冻结会因此放弃（见 TableHeap::Freeze）
+  SegmentManager::WriteScope ws(table_->sm_, table_->seg_id_);
+  if (!ws.ok()) return Status::InvalidArgument("Append: table is cold (read-only), Thaw first");
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    if (!page_.Valid()) {
+      if (Status s = OpenPage(); !s.ok()) return s;
+    }
+    uint16_t slot = 0;
+    Status ins = insert(page_.Data(), &slot);
+    if (ins.ok()) {
+      if (out) *out = RID{pid_, slot};
+      ++rows_;
+      return Status::OK();
+    }
+    const uint16_t rows_on_page = reinterpret_cast<const PageHeader*>(page_.Data())->slot_count;
+    if (ins.code() != StatusCode::kOutOfRange || rows_on_page == 0) return ins;  // 空页也放不下
+    SealPage();  // 当前页已满：封页后换下一张
+  }
+  return Status::OutOfRange("Append: tuple does not fit in a page");
+}
+
+Status TableAppender::Append(const Tuple& t, RID* out) {
+  return Append(t.Bytes().data(), static_cast<uint16_t>(t.Size()), out);
+}
+
+Status TableAppender::Append(const std::uint8_t* rec, uint16_t len, RID* out) {
+  if (!rec || len == 0) return Status::InvalidArgument("Append: empty tuple");
+  return AppendWith([&](std::uint8_t* page, uint16_t* slot) {
+    Status s = table_->PageInsert(page, rec, len, slot);
+    if (s.ok() && table_->zones_) table_->zones_->Accumulate(zone_acc_.data(), rec, len);
+    return s;
+  }, out);
+}
+
+Status TableAppender::Append(const TupleBuilder& tb, RID* out) {
+  if (!tb.Complete()) return Status::InvalidArgument("Append: column not set");
+  const size_t n = tb.BuiltSize();
+  if (n == 0 || n > UINT16_MAX) return Status::OutOfRange("Append: tuple does not fit in a page");
+  const auto len = static_cast<uint16_t>(n);
+  return AppendWith([&](std::uint8_t* page, uint16_t* slot) {
+    const std::uint8_t* row = nullptr;
+    Status s = table_->PageInsert(page, tb, len, slot, &row);
+    if (s.ok() && table_->zones_) table_->zones_->Accumulate(zone_acc_.data(), row, len);
+    return s;
+  }, out);
+}
+
+Status TableAppender::Finish() {
+  SealPage();
+  // 未用的预留页作为一个区段归还（位于段尾时直接回退高水位），留给后续分配复用
+  if (next_ < limit_) table_->sm_->FreePages(table_->seg_id_, next_, limit_ - next_);
+  next_ = limit_;
+  return Status::OK();
+}
+
+}  // namespace storage
+}  // namespace dbms
@@ -1,126 +1,226 @@
 #include "dbms/storage/table/table_heap.h"
 #include "dbms/storage/table/table_iterator.h"
+#include <algorithm>
 #include <cstring>
+#include <utility>
 
+#include "internal/page/pax_page_layout.h"
 #include "internal/page/slotted_page_layout.h"
 #include "dbms/storage/page/page.h"
 
 namespace dbms {
 namespace storage {
 
+TableHeap::TableHeap(seg_id_t seg_id, uint32_t page_size, BufferPoolManager* bpm,
+                     FreeSpaceManager* fsm, SegmentManager* sm, const Schema* schema,
+                     TableFormat format)
+    : seg_id_(seg_id), page_size_(page_size), bpm_(bpm), fsm_(fsm), sm_(sm), schema_(schema),
+      format_(schema && schema->ColumnCount() > 0 ? format : TableFormat::kSlotted) {
+  if (format_ == TableFormat::kPax) pax_var_estimate_.store(PaxPage::DefaultVarEstimate(*schema_));
+  if (schema_) {
+    zones_ = std::make_unique<ZoneMap>(*schema_);
+    if (zones_->empty()) zones_.reset();
+  }
+}
+
 void TableHeap::UpdateFsmForPage(page_id_t pid, std::uint8_t* page) {
   auto* hdr = reinterpret_cast<PageHeader*>(page);
-  fsm_->Update(pid, hdr->free_size);
+  fsm_->Update(pid, PageUsableSpace(*hdr));
 }
 
-Status TableHeap::Insert(const Tuple& t, RID* out) {
-  if (!out) return Status::InvalidArgument("Insert: out=null");
-  if (t.Empty()) return Status::InvalidArgument("Insert: empty tuple");
+// -------------------- 按页格式分派 --------------------
+
+void TableHeap::InitPage(std::uint8_t* page, page_id_t pid) const {
+  if (format_ == TableFormat::kPax) {
+    PaxPage::InitNew(page, pid, page_size_, *schema_, pax_var_estimate_.load(std::memory_order_relaxed));
+  } else {
+    SlottedPage::InitNew(page, pid, page_size_);
+  }
+}
+
+uint16_t TableHeap::SpaceNeeded(const std::uint8_t* rec, uint16_t len) const {
+  // 槽位页还需一个新槽目录项；只按记录长度查找会反复选中“差几个字节”的满页。
+  // PAX 页的定长部分已按行预留，只需变长区空间（至少 1，使行已满的页 free_size=0 不被选中）
+  if (format_ == TableFormat::kPax) {
+    return static_cast<uint16_t>(std::max<uint32_t>(1, PaxPage::VarBytesOf(*schema_, rec, len)));
+  }
+  return static_cast<uint16_t>(len + SlottedPage::kSlotBytes);
+}
 
-  const uint16_t need = static_cast<uint16_t>(t.Size());
+Status TableHeap::PageInsert(std::uint8_t* page, const std::uint8_t* rec, uint16_t len,
+                             uint16_t* slot) const {
+  if (format_ == TableFormat::kPax) return PaxPage(page, page_size_, *schema_).Insert(rec, len, slot);
+  return SlottedPage(page, page_size_).Insert(rec, len, slot);
+}
 
-  // 1) 从 FSM 找页
-  page_id_t pid = fsm_->Find(need);
+Status TableHeap::PageInsert(std::uint8_t* page, const TupleBuilder& tb, uint16_t len,
+                             uint16_t* slot, const std::uint8_t** row) const {
+  if (format_ == TableFormat::kPax) {
+    thread_local std::vector<std::uint8_t> buf;  // 每线程复用
+    buf.resize(len);
+    if (Status s = tb.BuildInto(buf.data(), buf.size()); !s.ok()) return s;
+    if (row) *row = buf.data();
+    return PaxPage(page, page_size_, *schema_).Insert(buf.data(), len, slot);
+  }
+  std::uint8_t* dst = nullptr;
+  Status s = SlottedPage(page, page_size_).Allocate(len, slot, &dst);
+  if (s.ok()) (void)tb.BuildInto(dst, len);  // 调用方已确认 tb.Complete() 且 len == tb.BuiltSize()
+  if (row) *row = dst;
+  return s;
+}
 
-  // 2) 若没有可用页，分配新页并初始化
-  if (pid == kInvalidPageId) {
-    pid = sm_->AllocatePage(seg_id_);
-    if (pid == kInvalidPageId) return Status::Unavailable("Insert: allocate page failed");
+Status TableHeap::PageUpdate(std::uint8_t* page, uint16_t slot, const std::uint8_t* rec,
+                             uint16_t len) const {
+  if (format_ == TableFormat::kPax) return PaxPage(page, page_size_, *schema_).Update(slot, rec, len);
+  return SlottedPage(page, page_size_).Update(slot, rec, len);
+}
 
-    std::uint8_t* data = nullptr;
-    Status s = bpm_->FetchPage(pid, &data);
-    if (!s.ok()) return s;
-    SlottedPage::InitNew(data, pid, page_size_);
-    bpm_->UnpinPage(pid, /*dirty=*/true);
+Status TableHeap::PageErase(std::uint8_t* page, uint16_t slot) const {
+  if (format_ == TableFormat::kPax) return PaxPage(page, page_size_, *schema_).Erase(slot);
+  return SlottedPage(page, page_size_).Erase(slot);
+}
 
-    // 初始空闲上报 FSM
-    if (bpm_->FetchPage(pid, &data).ok()) {
-      UpdateFsmForPage(pid, data);
-      bpm_->UnpinPage(pid, /*dirty=*/false);
-    }
+Status TableHeap::PageGet(const std::uint8_t* page, uint16_t slot,
+                          std::vector<std::uint8_t>* out) const {
+  auto* p = const_cast<std::uint8_t*>(page);  // 只调用只读方法
+  if (format_ == TableFormat::kPax) return PaxPage(p, page_size_, *schema_).Get(slot, out);
+  const std::uint8_t* rec = nullptr;
+  uint16_t len = 0;
+  Status g = SlottedPage(p, page_size_).Get(slot, &rec, &len);
+  if (g.ok()) out->assign(rec, rec + len);
+  return g;
+}
+
+void TableHeap::NoteSealedPage(const std::uint8_t* page) {
+  if (format_ != TableFormat::kPax) return;
+  const auto* hdr = reinterpret_cast<const PageHeader*>(page);
+  if (hdr->slot_count == 0) return;
+  // 用刚填满的页的实际均值作为后续新页的估计（装载数据的变长分布通常平稳）
+  pax_var_estimate_.store((page_size_ - hdr->free_off) / hdr->slot_count, std::memory_order_relaxed);
+}
+
+void TableHeap::LogPage(std::uint8_t* page, PageLogOp op, page_id_t pid, uint16_t slot,
+                        const std::uint8_t* data, uint32_t len) const {
+  if (!log_) return;
+  const uint64_t lsn = log_->LogPage(op, seg_id_, pid, slot, data, len);
+  if (lsn) reinterpret_cast<PageHeader*>(page)->page_lsn = lsn;
+}
+
+// -------------------- DML --------------------
+
+static Status ColdTable(const char* op) {
+  return Status::InvalidArgument(std::string(op) + ": table is cold (read-only), Thaw first");
+}
+
+Status TableHeap::Insert(const Tuple& t, RID* out) {
+  if (!out) return Status::InvalidArgument("Insert: out=null");
+  SegmentManager::WriteScope ws(sm_, seg_id_);  // 冻结置只读后拒绝；已在途的写入先于冻结写回完成
+  if (!ws.ok()) return ColdTable("Insert");
+  if (t.Empty()) return Status::InvalidArgument("Insert: empty tuple");
+  // 检查点之后的第一次修改：在取页写闩锁之前作废磁盘上的区间摘要（之后只读一个原子标记）
+  if (zones_) {
+    if (Status s = zones_->Invalidate(); !s.ok()) return s;
   }
 
-  // 3) 在候选页尝试插入；若失败则分配新页再尝试
-  {
-    std::uint8_t* data = nullptr;
-    Status s = bpm_->FetchPage(pid, &data);
-    if (!s.ok()) return s;
+  const std::uint8_t* rec = t.Bytes().data();
+  const uint16_t len  = static_cast<uint16_t>(t.Size());
+  const uint16_t need = SpaceNeeded(rec, len);
+  uint16_t slot = 0;
 
-    SlottedPage sp(data, page_size_);
-    uint16_t slot = 0;
-    Status ins = sp.Insert(t.Bytes().data(), static_cast<uint16_t>(t.Size()), &slot);
-    if (!ins.ok()) {
-      bpm_->UnpinPage(pid, /*dirty=*/false);
-
-      page_id_t npid = sm_->AllocatePage(seg_id_);
-      if (npid == kInvalidPageId) return ins;
-
-      std::uint8_t* ndata = nullptr;
-      if (!bpm_->FetchPage(npid, &ndata).ok()) return Status::Unavailable("Fetch new page failed");
-      SlottedPage::InitNew(ndata, npid, page_size_);
-      SlottedPage sp2(ndata, page_size_);
-      Status ins2 = sp2.Insert(t.Bytes().data(), static_cast<uint16_t>(t.Size()), &slot);
-      if (!ins2.ok()) {
-        bpm_->UnpinPage(npid, /*dirty=*/false);
-        return ins2;
-      }
-      UpdateFsmForPage(npid, ndata);
-      bpm_->UnpinPage(npid, /*dirty=*/true);
-      *out = RID{npid, slot};
+  // 1) 从 FSM 预留一页：Release 之前其他插入者不会拿到同一页
+  page_id_t pid = fsm_->Acquire(need);
+  if (pid != kInvalidPageId) {
+    WritePageGuard page;
+    Status s = bpm_->FetchPage(seg_id_, pid, &page);
+    if (!s.ok()) { fsm_->Release(pid); return s; }
+
+    Status ins = PageInsert(page.Data(), rec, len, &slot);
+    if (ins.ok()) {
+      if (zones_) zones_->Add(pid, rec, len);  // 在页写回之前（仍持有写闩锁）
+      LogPage(page.Data(), PageLogOp::kInsert, pid, slot, rec, len);
+    }
+    // 失败时同样以页的真实空闲释放：FSM 只是提示（例如来自较旧的检查点），避免反复选中该页
+    fsm_->Release(pid, PageUsableSpace(*reinterpret_cast<PageHeader*>(page.Data())));
+    if (ins.ok()) {
+      page.MarkDirty();
+      *out = RID{pid, slot};
       return Status::OK();
     }
-    UpdateFsmForPage(pid, data);
-    bpm_->UnpinPage(pid, /*dirty=*/true);
-    *out = RID{pid, slot};
-    return Status::OK();
   }
-}
-
-Status TableHeap::Update(const RID& rid, const Tuple& t) {
-  std::uint8_t* data = nullptr;
-  Status s = bpm_->FetchPage(rid.page_id, &data);
-  if (!s.ok()) return s;
 
-  SlottedPage sp(data, page_size_);
-  Status up = sp.Update(rid.slot, t.Bytes().data(), static_cast<uint16_t>(t.Size()));
-  if (up.ok()) {
-    UpdateFsmForPage(rid.page_id, data);
-    bpm_->UnpinPage(rid.page_id, /*dirty=*/true);
-    return Status::OK();
+  // 2) 没有可用页（或候选页放不下）：分配新页；新页尚未进入 FSM，天然由本线程独占
+  pid = sm_->AllocatePage(seg_id_);
+  if (pid == kInvalidPageId) {
+    return sm_->IsReadOnly(seg_id_) ? ColdTable("Insert") : Status::Unavailable("Insert: allocate page failed");
   }
 
-  if (up.code() == StatusCode::kOutOfRange) {
-    bpm_->UnpinPage(rid.page_id, /*dirty=*/false);
+  // 新页不读盘：缓冲池直接给出置零、已固定的帧（预留的区段块在盘上本就是全零）
+  WritePageGuard page;
+  Status s = bpm_->NewPageAt(seg_id_, pid, &page);
+  if (!s.ok()) { sm_->FreePage(seg_id_, pid); return s; }
+  InitPage(page.Data(), pid);
+  LogPage(page.Data(), PageLogOp::kPageInit, pid, 0);
+  Status ins = PageInsert(page.Data(), rec, len, &slot);
+  if (ins.ok()) {
+    if (zones_) zones_->Add(pid, rec, len);
+    LogPage(page.Data(), PageLogOp::kInsert, pid, slot, rec, len);
+  }
+  fsm_->Release(pid, PageUsableSpace(*reinterpret_cast<PageHeader*>(page.Data())));
+  page.MarkDirty();
+  if (!ins.ok()) return ins;
+  *out = RID{pid, slot};
+  return Status::OK();
+}
 
-    RID new_rid;
-    Status ins = Insert(t, &new_rid);
-    if (!ins.ok()) return ins;
+Status TableHeap::Update(const RID& rid, const Tuple& t) {
+  SegmentManager::WriteScope ws(sm_, seg_id_);  // 覆盖两阶段（异地插入 + 删除旧记录）
+  if (!ws.ok()) return ColdTable("Update");
+  if (zones_) {
+    if (Status s = zones_->Invalidate(); !s.ok()) return s;
+  }
+  Status up;
+  {
+    WritePageGuard page;
+    Status s = bpm_->FetchPage(seg_id_, rid.page_id, &page);
+    if (!s.ok()) return s;
 
-    std::uint8_t* data_old = nullptr;
-    if (!bpm_->FetchPage(rid.page_id, &data_old).ok()) return Status::Unavailable("Re-fetch old page failed");
-    SlottedPage sp_old(data_old, page_size_);
-    (void)sp_old.Erase(rid.slot);
-    UpdateFsmForPage(rid.page_id, data_old);
-    bpm_->UnpinPage(rid.page_id, /*dirty=*/true);
-    return Status::OK();
+    up = PageUpdate(page.Data(), rid.slot, t.Bytes().data(), static_cast<uint16_t>(t.Size()));
+    if (up.ok()) {
+      if (zones_) zones_->Add(rid.page_id, t.Bytes().data(), t.Size());  // 摘要只放宽，旧值留在范围内
+      LogPage(page.Data(), PageLogOp::kUpdate, rid.page_id, rid.slot, t.Bytes().data(),
+              static_cast<uint32_t>(t.Size()));
+      UpdateFsmForPage(rid.page_id, page.Data());
+      page.MarkDirty();
+      return Status::OK();
+    }
+    if (up.code() != StatusCode::kOutOfRange) return up;
   }
 
-  bpm_->UnpinPage(rid.page_id, /*dirty=*/false);
-  return up;
+  // 原页放不下：先放开原页的写闩锁（同一时刻只持一个），插入新位置后再回来删除旧记录
+  RID new_rid;
+  Status ins = Insert(t, &new_rid);
+  if (!ins.ok()) return ins;
+
+  WritePageGuard old_page;
+  if (!bpm_->FetchPage(seg_id_, rid.page_id, &old_page).ok()) return Status::Unavailable("Re-fetch old page failed");
+  if (PageErase(old_page.Data(), rid.slot).ok()) LogPage(old_page.Data(), PageLogOp::kErase, rid.page_id, rid.slot);
+  UpdateFsmForPage(rid.page_id, old_page.Data());
+  old_page.MarkDirty();
+  return Status::OK();
 }
 
 Status TableHeap::Erase(const RID& rid) {
-  std::uint8_t* data = nullptr;
-  Status s = bpm_->FetchPage(rid.page_id, &data);
+  SegmentManager::WriteScope ws(sm_, seg_id_);
+  if (!ws.ok()) return ColdTable("Erase");
+  WritePageGuard page;
+  Status s = bpm_->FetchPage(seg_id_, rid.page_id, &page);
   if (!s.ok()) return s;
 
-  SlottedPage sp(data, page_size_);
-  Status del = sp.Erase(rid.slot);
+  Status del = PageErase(page.Data(), rid.slot);
   if (del.ok()) {
-    UpdateFsmForPage(rid.page_id, data);
-    bpm_->UnpinPage(rid.page_id, /*dirty=*/true);
-  } else {
-    bpm_->UnpinPage(rid.page_id, /*dirty=*/false);
+    LogPage(page.Data(), PageLogOp::kErase, rid.page_id, rid.slot);
+    UpdateFsmForPage(rid.page_id, page.Data());
+    page.MarkDirty();
   }
   return del;
 }
@@ -128,26 +228,144 @@ Status TableHeap::Erase(const RID& rid) {
 Status TableHeap::Get(const RID& rid, Tuple* out) const {
   if (!out) return Status::InvalidArgument("Get: out=null");
 
-  std::uint8_t* data = nullptr;
-  Status s = bpm_->FetchPage(rid.page_id, &data);
+  ReadPageGuard page;
+  Status s = bpm_->FetchPage(seg_id_, rid.page_id, &page);
   if (!s.ok()) return s;
 
-  SlottedPage sp(data, page_size_);
-  const std::uint8_t* p = nullptr;
-  uint16_t len = 0;
-  Status g = sp.Get(rid.slot, &p, &len);
-  if (g.ok()) {
-    *out = Tuple::Deserialize(p, len);
-    bpm_->UnpinPage(rid.page_id, /*dirty=*/false);
-    return Status::OK();
-  }
-  bpm_->UnpinPage(rid.page_id, /*dirty=*/false);
+  // 乐观读：不加页闩锁，拷出记录后校验版本；期间有写者则整段重读。拷入 out 原有的缓冲
+  Status g;
+  std::vector<std::uint8_t> bytes = out->ReleaseBytes();
+  page.Read([&](const std::uint8_t* data) { g = PageGet(data, rid.slot, &bytes); });
+  *out = Tuple(std::move(bytes));
   return g;
 }
 
+Status TableHeap::Get(const RID& rid, TupleArena* arena, TupleView* out) const {
+  if (!arena || !out) return Status::InvalidArgument("Get: arena/out=null");
+
+  ReadPageGuard page;
+  Status s = bpm_->FetchPage(seg_id_, rid.page_id, &page);
+  if (!s.ok()) return s;
+
+  thread_local std::vector<std::uint8_t> scratch;  // 每线程复用：乐观读重试也不分配
+  Status g;
+  page.Read([&](const std::uint8_t* data) { g = PageGet(data, rid.slot, &scratch); });
+  if (g.ok()) *out = arena->Copy(scratch.data(), scratch.size());
+  return g;
+}
+
+Status TableHeap::BulkInsert(const Tuple* rows, size_t n, std::vector<RID>* out_rids) {
+  if (!rows && n > 0) return Status::InvalidArgument("BulkInsert: rows=null");
+  if (IsCold()) return ColdTable("BulkInsert");
+  if (out_rids) out_rids->reserve(out_rids->size() + n);
+
+  // 小批量时按数据量收窄区段，避免每次调用都在段尾留下大段未用的预留页
+  uint64_t bytes = 0;
+  for (size_t i = 0; i < n; ++i) bytes += rows[i].Size() + SlottedPage::kSlotBytes;
+  const uint64_t est = bytes / (page_size_ - page_size_ / 8) + 1;
+  TableAppender app(this, static_cast<uint32_t>(
+      std::min<uint64_t>(est, TableAppender::kDefaultExtentPages)));
+  for (size_t i = 0; i < n; ++i) {
+    RID rid;
+    Status s = app.Append(rows[i], &rid);
+    if (!s.ok()) return s;
+    if (out_rids) out_rids->push_back(rid);
+  }
+  return app.Finish();
+}
+
+Status TableHeap::Checkpoint() {
+  DiskManager* fsm_disk = sm_->GetFsmDisk(seg_id_);
+  if (!fsm_disk) return Status::NotFound("Checkpoint: unknown segment");
+  // FSM 可能比数据页新（页仍在缓冲池中），这只会让插入多一次失败重试；反之则需重建，
+  // 所以先写段元数据（内部先 Sync 数据文件），再写 FSM
+  if (Status s = sm_->Checkpoint(seg_id_); !s.ok()) return s;
+  if (Status s = fsm_->SaveTo(fsm_disk); !s.ok()) return s;
+  // 区间摘要只放宽不收窄，比磁盘上的页新（覆盖更多值）总是安全的
+  if (!zones_) return Status::OK();
+  DiskManager* zone_disk = sm_->GetZoneDisk(seg_id_);
+  if (!zone_disk) return Status::NotFound("Checkpoint: unknown segment");
+  return zones_->SaveTo(zone_disk);
+}
+
+Status TableHeap::RecoverSpace(bool* out_loaded) {
+  if (out_loaded) *out_loaded = false;
+  DiskManager* fsm_disk = sm_->GetFsmDisk(seg_id_);
+  if (fsm_disk && fsm_->LoadFrom(fsm_disk).ok()) {
+    if (out_loaded) *out_loaded = true;
+    return fsm_->RebuildFromSegment(seg_id_, static_cast<page_id_t>(fsm_->size()));
+  }
+  return fsm_->RebuildFromSegment(seg_id_, 0);
+}
+
+Status TableHeap::RecoverZoneMap(bool* out_loaded) {
+  if (out_loaded) *out_loaded = false;
+  if (!zones_) return Status::OK();
+  page_id_t first = 0;
+  DiskManager* zone_disk = sm_->GetZoneDisk(seg_id_);
+  if (zone_disk && zones_->LoadFrom(zone_disk).ok()) {
+    if (out_loaded) *out_loaded = true;
+    first = static_cast<page_id_t>(zones_->size());
+  }
+  if (first >= sm_->PageCount(seg_id_)) return Status::OK();
+  if (Status s = zones_->Invalidate(); !s.ok()) return s;  // 载入的文件不覆盖之后的页：补齐前先作废
+
+  // 从页内容求精确摘要：列扫描 [b, e)，每页按存活行汇总后整页替换
+  const std::vector<size_t>& cols = zones_->columns();
+  auto summarize = [&](page_id_t b, page_id_t e) {
+    ScanOptions so;
+    so.first_page = b;
+    so.end_page   = e;
+    ColumnScanner cs = ScanColumns(cols, so);
+    std::vector<ZoneEntry> acc(cols.size());
+    while (cs.Next()) {
+      const ColumnPage& pg = cs.page();
+      std::fill(acc.begin(), acc.end(), ZoneEntry{});
+      for (uint32_t r = 0; r < pg.rows; ++r) {
+        if (!pg.IsLive(r)) continue;
+        for (size_t k = 0; k < cols.size(); ++k) {
+          const ColumnChunk& ch = pg.columns[k];
+          ZoneMap::AccumulateValue(&acc[k], ch.type, ch.values + static_cast<size_t>(r) * ch.width, pg.IsNull(k, r));
+        }
+      }
+      zones_->Assign(pg.page_id, acc.data());
+    }
+    return cs.status();
+  };
+  // 只补检查点之后追加的页时顺序扫描；全量重建按 morsel 并行
+  if (first > 0) return summarize(first, kInvalidPageId);
+  return ParallelScan().ForEachMorsel([&](uint32_t, page_id_t b, page_id_t e) { return summarize(b, e); });
+}
+
+Status TableHeap::Freeze() {
+  if (IsCold()) return Status::OK();
+  // 冷段从段文件压缩，原段文件的数据块随后被释放：先置只读挡住分配与 DML（并等在途写入结束），
+  // 再只写回本段的脏页；仍有脏页（写回失败，或未结束的追加器还持有页）时撤销只读、不冻结
+  if (Status s = sm_->SetReadOnly(seg_id_, true); !s.ok()) return s;
+  Status s = bpm_->FlushSegment(seg_id_, /*wait=*/false);  // 不等追加器封页：直接放弃
+  if (s.ok()) s = sm_->FreezeSegment(seg_id_, format_ == TableFormat::kPax ? schema_ : nullptr);
+  if (!s.ok()) (void)sm_->SetReadOnly(seg_id_, false);
+  return s;
+}
+
+Status TableHeap::Thaw() { return sm_->ThawSegment(seg_id_); }
+
 // 迭代器接口（实现见 table_iterator.cc）
-TableIterator TableHeap::Begin() const { return TableIterator(this); }
+TableIterator TableHeap::Begin(const ScanOptions& opt) const { return TableIterator(this, opt); }
 TableIterator TableHeap::End()   const { return TableIterator(); }
 
+ColumnScanner TableHeap::ScanColumns(std::vector<size_t> columns, const ScanOptions& opt) const {
+  return ColumnScanner(this, std::move(columns), opt);
+}
+
+BatchScanner TableHeap::ScanBatches(std::vector<size_t> projection, const Predicate& predicate,
+                                     const BatchScanOptions& opt) const {
+  return BatchScanner(this, std::move(projection), predicate, opt);
+}
+
+ParallelScanner TableHeap::ParallelScan(const ParallelScanOptions& opt) const {
+  return ParallelScanner(this, opt);
+}
+
 }  // namespace storage
 }  // namespace dbms
@@ -1,92 +1,213 @@
 #include "dbms/storage/table/table_iterator.h"
 
+#include <algorithm>
+#include <utility>
+
 #include "dbms/storage/table/table_heap.h"
 #include "dbms/storage/page/page.h"
+#include "internal/page/pax_page_layout.h"
 #include "internal/page/slotted_page_layout.h"
 
 namespace dbms {
 namespace storage {
 
-TableIterator::TableIterator(const TableHeap* table)
-    : table_(table), pid_(0), slot_(0), end_(false), current_{} {
-  SeekFirst();
+TableIterator::TableIterator(const TableHeap* table, const ScanOptions& opt)
+    : table_(table), end_(false), opt_(opt) {
+  if (!table_) { end_ = true; return; }
+  page_count_ = table_->sm_->PageCount(table_->seg_id_);
+  if (!SeekFrom(opt_.first_page, 0)) { end_ = true; ReleasePage(); }
 }
 
-void TableIterator::SeekFirst() {
-  if (!table_) { end_ = true; return; }
+TableIterator::~TableIterator() { ReleasePage(); }
+
+TableIterator::TableIterator(const TableIterator& other) { *this = other; }
+
+TableIterator& TableIterator::operator=(const TableIterator& other) {
+  if (this == &other) return *this;
+  ReleasePage();
+  table_        = other.table_;
+  end_          = other.end_;
+  status_       = other.status_;
+  rid_          = other.rid_;
+  view_         = other.view_;
+  view_version_ = other.view_version_;
+  page_count_   = other.page_count_;
+  current_      = other.current_;
+  materialized_ = other.materialized_;
+  opt_          = other.opt_;
+  last_pid_     = other.last_pid_;
+  seq_run_      = other.seq_run_;
+  prefetched_until_ = other.prefetched_until_;
+  row_buf_      = other.row_buf_;
+  view_copied_  = other.view_copied_;
+  if (view_copied_) view_ = TupleView(row_buf_.data(), row_buf_.size());
+  // 副本对当前页另持一次固定（页仍驻留，必然命中；视图地址与版本号不变）
+  if (other.page_.Valid() && table_) {
+    if (!table_->bpm_->FetchPage(table_->seg_id_, other.page_.PageId(), &page_).ok()) end_ = true;
+  }
+  return *this;
+}
 
-  const uint64_t pages = table_->sm_->PageCount(table_->seg_id_);
-  if (pages == 0) { end_ = true; return; }
-
-  for (page_id_t p = 0; p < pages; ++p) {
-    std::uint8_t* data = nullptr;
-    if (!table_->bpm_->FetchPage(p, &data).ok()) continue;
-
-    const auto* hdr = reinterpret_cast<const PageHeader*>(data);
-    const uint16_t max_slot = hdr->slot_count;
-
-    SlottedPage sp(data, table_->page_size_);
-    for (uint16_t s = 0; s < max_slot; ++s) {
-      const std::uint8_t* rec = nullptr;
-      uint16_t len = 0;
-      if (sp.Get(s, &rec, &len).ok()) {
-        current_.rid = RID{p, s};
-        current_.tuple = Tuple::Deserialize(rec, len);
-        table_->bpm_->UnpinPage(p, /*dirty=*/false);
-        pid_ = p; slot_ = s; end_ = false;
-        return;
-      }
+TableIterator::TableIterator(TableIterator&& other) noexcept { *this = std::move(other); }
+
+TableIterator& TableIterator::operator=(TableIterator&& other) noexcept {
+  if (this == &other) return *this;
+  ReleasePage();
+  table_        = other.table_;
+  end_          = other.end_;
+  status_       = other.status_;
+  rid_          = other.rid_;
+  view_         = other.view_;
+  view_version_ = other.view_version_;
+  page_         = std::move(other.page_);
+  page_count_   = other.page_count_;
+  current_      = std::move(other.current_);
+  materialized_ = other.materialized_;
+  opt_          = other.opt_;
+  last_pid_     = other.last_pid_;
+  seq_run_      = other.seq_run_;
+  prefetched_until_ = other.prefetched_until_;
+  row_buf_      = std::move(other.row_buf_);
+  view_copied_  = other.view_copied_;
+  if (view_copied_) view_ = TupleView(row_buf_.data(), row_buf_.size());
+  other.end_ = true;
+  return *this;
+}
+
+const TableIterator::Row& TableIterator::operator*() const {
+  if (!materialized_) {
+    current_.rid   = rid_;
+    current_.tuple = view_.ToTuple();
+    // 拷贝期间页被改过：按 RID 重新定位后再拷；记录已被删除则得到空 Tuple（自有拷贝无需校验）
+    if (!view_copied_ && !page_.Validate(view_version_)) {
+      const uint16_t slot = rid_.slot;
+      page_.Read([&](const std::uint8_t* data) {
+        SlottedPage sp(const_cast<std::uint8_t*>(data), table_->page_size_);  // 只调用只读方法
+        const std::uint8_t* rec = nullptr;
+        uint16_t len = 0;
+        current_.tuple = sp.Get(slot, &rec, &len).ok() ? Tuple::Deserialize(rec, len) : Tuple();
+      });
     }
-    table_->bpm_->UnpinPage(p, /*dirty=*/false);
+    materialized_  = true;
   }
-  end_ = true;
+  return current_;
+}
+
+Status TableIterator::CopyTo(TupleArena* arena, TupleView* out) const {
+  if (!arena || !out) return Status::InvalidArgument("CopyTo: arena/out=null");
+  if (end_ || !table_) return Status::NotFound("CopyTo: at end");
+  *out = arena->Copy(view_);
+  if (view_copied_ || page_.Validate(view_version_)) return Status::OK();
+
+  // 同 operator*：按 RID 在当前页上重新定位后再拷
+  Status st;
+  const uint16_t slot = rid_.slot;
+  page_.Read([&](const std::uint8_t* data) {
+    SlottedPage sp(const_cast<std::uint8_t*>(data), table_->page_size_);  // 只调用只读方法
+    const std::uint8_t* rec = nullptr;
+    uint16_t len = 0;
+    st = sp.Get(slot, &rec, &len);
+    if (st.ok()) *out = arena->Copy(rec, len);
+  });
+  return st;
 }
 
-bool TableIterator::LoadAt(page_id_t pid, uint16_t slot) {
-  std::uint8_t* data = nullptr;
-  if (!table_->bpm_->FetchPage(pid, &data).ok()) return false;
+Status TableIterator::FetchForScan(page_id_t pid, ReadPageGuard* page) {
+  OnPageAccess(pid);
+  const AccessMode mode = opt_.bulk_read ? AccessMode::kBulkRead : AccessMode::kNormal;
+  return table_->bpm_->FetchPage(table_->seg_id_, pid, page, mode);
+}
 
-  const auto* hdr = reinterpret_cast<const PageHeader*>(data);
-  if (slot >= hdr->slot_count) {
-    table_->bpm_->UnpinPage(pid, /*dirty=*/false);
-    return false;
-  }
+void TableIterator::OnPageAccess(page_id_t pid) {
+  if (pid == last_pid_) return;  // 同一页内的多次访问
+  seq_run_  = (last_pid_ != kInvalidPageId && pid == last_pid_ + 1) ? seq_run_ + 1 : 0;
+  last_pid_ = pid;
+  if (opt_.prefetch_pages == 0 || seq_run_ == 0) return;
+
+  // 窗口消耗过半时补齐到 pid+1+prefetch_pages，使预读始终领先当前页
+  // 有界扫描的窗口不越过 end_page
+  const page_id_t want = std::min<page_id_t>(pid + 1 + opt_.prefetch_pages, opt_.end_page);
+  if (prefetched_until_ > pid + opt_.prefetch_pages / 2) return;
+  const page_id_t from = std::max<page_id_t>(pid + 1, prefetched_until_);
+  if (from >= want) return;
+  const AccessMode mode = opt_.bulk_read ? AccessMode::kBulkRead : AccessMode::kNormal;
+  (void)table_->bpm_->Prefetch(table_->seg_id_, from, want - from, mode);
+  prefetched_until_ = want;
+}
 
-  SlottedPage sp(data, table_->page_size_);
-  const std::uint8_t* rec = nullptr;
-  uint16_t len = 0;
-  bool ok = sp.Get(slot, &rec, &len).ok();
-  if (ok) {
-    current_.rid = RID{pid, slot};
-    current_.tuple = Tuple::Deserialize(rec, len);
-  }
-  table_->bpm_->UnpinPage(pid, /*dirty=*/false);
-  return ok;
+bool TableIterator::PastEnd(page_id_t pid) {
+  if (pid >= opt_.end_page) return true;
+  if (pid < page_count_) return false;
+  // 到达快照末尾：刷新一次页数，扫描期间追加的页同样可见
+  page_count_ = table_->sm_->PageCount(table_->seg_id_);
+  return pid >= page_count_;
 }
 
-bool TableIterator::AdvanceOne() {
-  const uint64_t pages = table_->sm_->PageCount(table_->seg_id_);
-  page_id_t p = pid_;
-  uint16_t  s = static_cast<uint16_t>(slot_ + 1);
+Status TableIterator::PinPage(page_id_t pid) {
+  ReleasePage();
+  return FetchForScan(pid, &page_);
+}
 
-  while (p < pages) {
-    std::uint8_t* data = nullptr;
-    if (!table_->bpm_->FetchPage(p, &data).ok()) { ++p; s = 0; continue; }
-    const auto* hdr = reinterpret_cast<const PageHeader*>(data);
-    const uint16_t max_slot = hdr->slot_count;
-    table_->bpm_->UnpinPage(p, /*dirty=*/false);
+void TableIterator::ReleasePage() { page_.Release(); }
+
+bool TableIterator::SeekFrom(page_id_t pid, uint32_t slot) {
+  materialized_ = false;
+  for (;;) {
+    if (PastEnd(pid)) return false;
+    if (!page_.Valid() || page_.PageId() != pid) {
+      // 取页失败一般跳过该页；校验和不匹配则结束扫描并经 status() 报告，不静默丢行
+      Status ps = PinPage(pid);
+      if (ps.code() == StatusCode::kCorruption) { status_ = std::move(ps); return false; }
+      if (!ps.ok()) { ++pid; slot = 0; continue; }
+    }
 
-    for (; s < max_slot; ++s) {
-      if (LoadAt(p, s)) { pid_ = p; slot_ = s; return true; }
+    if (table_->format_ == TableFormat::kPax) {
+      // PAX 页没有连续的行字节可供零拷贝：在乐观读内把行拼到自有缓冲，校验通过即稳定
+      const uint64_t v = page_.ReadBegin();
+      PaxPage pp(const_cast<std::uint8_t*>(page_.Data()), table_->page_size_, *table_->schema_);
+      const uint16_t max_slot = pp.Valid() ? pp.RowCount() : 0;
+      uint32_t s = slot;
+      while (s < max_slot && pp.IsDeleted(static_cast<uint16_t>(s))) ++s;
+      const Status g = s < max_slot ? pp.Get(static_cast<uint16_t>(s), &row_buf_) : Status::OK();
+      if (!page_.Validate(v)) continue;
+      if (s < max_slot) {
+        if (!g.ok()) { slot = s + 1; continue; }  // 校验通过仍不可解析：跳过该行
+        rid_          = RID{pid, static_cast<uint16_t>(s)};
+        view_         = TupleView(row_buf_.data(), row_buf_.size());
+        view_version_ = v;
+        view_copied_  = true;
+        return true;
+      }
+      ++pid; slot = 0;
+      continue;
     }
-    ++p; s = 0;
+
+    // 乐观读：找到的槽（或“页内已无记录”的结论）只有在版本未变时才采用，否则从同一槽位重找
+    const uint64_t v = page_.ReadBegin();
+    SlottedPage sp(const_cast<std::uint8_t*>(page_.Data()), table_->page_size_);  // 只调用只读方法
+    const uint16_t max_slot = sp.SlotCount();
+    uint32_t s = slot;
+    const std::uint8_t* rec = nullptr;
+    uint16_t len = 0;
+    while (s < max_slot && !sp.Get(static_cast<uint16_t>(s), &rec, &len).ok()) ++s;
+    if (!page_.Validate(v)) continue;
+    if (s < max_slot) {
+      rid_          = RID{pid, static_cast<uint16_t>(s)};
+      view_         = TupleView(rec, len);
+      view_version_ = v;
+      view_copied_  = false;
+      return true;
+    }
+    ++pid; slot = 0;
   }
-  return false;
 }
 
 TableIterator& TableIterator::operator++() {
   if (end_ || !table_) return *this;
-  if (!AdvanceOne()) { end_ = true; }
+  if (!SeekFrom(rid_.page_id, static_cast<uint32_t>(rid_.slot) + 1)) {
+    end_ = true;
+    ReleasePage();
+  }
   return *this;
 }
 
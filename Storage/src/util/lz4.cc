@@ -0,0 +1,153 @@
+/**
+ * @file lz4.cc
+ * @brief LZ4 块格式：贪心压缩 + 带越界检查的解压。
+ *
+ * 序列 = token(高 4 位字面量长度、低 4 位匹配长度-4，15 表示后续以 255 累加) + 字面量
+ *        + 16 位小端偏移 + 匹配长度扩展；末尾一个序列只有字面量。
+ * 格式约束：最后 5 字节必须是字面量，最后一个匹配须起始于距末尾至少 12 字节处。
+ */
+
+#include "internal/util/lz4.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace dbms {
+namespace storage {
+
+namespace {
+
+constexpr int      kHashLog   = 12;
+constexpr size_t   kMinMatch  = 4;
+constexpr size_t   kLastLits  = 5;   // 末尾必须是字面量的字节数
+constexpr size_t   kMfLimit   = 12;  // 最后一个匹配的起点距末尾至少这么多字节
+constexpr size_t   kMaxInput  = 64 * 1024;
+constexpr size_t   kMaxOffset = 65535;
+
+inline uint32_t Read32(const std::uint8_t* p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint32_t Hash(uint32_t v) { return (v * 2654435761u) >> (32 - kHashLog); }
+
+/// 写长度扩展字节（len 已减去 15）
+inline std::uint8_t* PutLength(std::uint8_t* op, size_t len) {
+  for (; len >= 255; len -= 255) *op++ = 255;
+  *op++ = static_cast<std::uint8_t>(len);
+  return op;
+}
+
+/// 输出一个序列；match_len 为 0 表示末尾只含字面量的序列。空间不足返回 nullptr
+std::uint8_t* PutSequence(std::uint8_t* op, std::uint8_t* oend, const std::uint8_t* lit, size_t lit_len,
+                          size_t offset, size_t match_len) {
+  const size_t need = 1 + (lit_len >= 15 ? lit_len / 255 + 1 : 0) + lit_len +
+                      (match_len ? 2 + ((match_len - kMinMatch) >= 15 ? (match_len - kMinMatch) / 255 + 1 : 0) : 0);
+  if (static_cast<size_t>(oend - op) < need) return nullptr;
+  std::uint8_t* token = op++;
+  *token = static_cast<std::uint8_t>(std::min<size_t>(lit_len, 15) << 4);
+  if (lit_len >= 15) op = PutLength(op, lit_len - 15);
+  if (lit_len) std::memcpy(op, lit, lit_len);
+  op += lit_len;
+  if (match_len == 0) return op;
+  *op++ = static_cast<std::uint8_t>(offset & 0xFF);
+  *op++ = static_cast<std::uint8_t>(offset >> 8);
+  const size_t ml = match_len - kMinMatch;
+  *token |= static_cast<std::uint8_t>(std::min<size_t>(ml, 15));
+  if (ml >= 15) op = PutLength(op, ml - 15);
+  return op;
+}
+
+}  // namespace
+
+size_t Lz4Compress(const std::uint8_t* src, size_t n, std::uint8_t* dst, size_t cap) {
+  if (n > kMaxInput || (n > 0 && !src) || !dst) return 0;
+  std::uint8_t*       op     = dst;
+  std::uint8_t* const oend   = dst + cap;
+  const std::uint8_t* anchor = src;
+
+  if (n > kMfLimit) {
+    uint16_t table[1u << kHashLog] = {};  // 位置自 src 起算；0 也是合法位置，命中后再比较字节
+    const std::uint8_t* const mflimit    = src + n - kMfLimit;
+    const std::uint8_t* const matchlimit = src + n - kLastLits;
+    const std::uint8_t* ip = src + 1;
+    while (ip <= mflimit) {
+      const uint32_t h = Hash(Read32(ip));
+      const std::uint8_t* ref = src + table[h];
+      table[h] = static_cast<uint16_t>(ip - src);
+      if (ref >= ip || static_cast<size_t>(ip - ref) > kMaxOffset || Read32(ref) != Read32(ip)) {
+        ++ip;
+        continue;
+      }
+      // 向后延伸进未输出的字面量，再向前延伸到不等或 matchlimit
+      while (ip > anchor && ref > src && ip[-1] == ref[-1]) { --ip; --ref; }
+      const std::uint8_t* m = ip + kMinMatch;
+      const std::uint8_t* r = ref + kMinMatch;
+      while (m < matchlimit && *m == *r) { ++m; ++r; }
+      op = PutSequence(op, oend, anchor, static_cast<size_t>(ip - anchor),
+                       static_cast<size_t>(ip - ref), static_cast<size_t>(m - ip));
+      if (!op) return 0;
+      ip = anchor = m;
+      if (ip - 2 > src) table[Hash(Read32(ip - 2))] = static_cast<uint16_t>(ip - 2 - src);
+    }
+  }
+  op = PutSequence(op, oend, anchor, static_cast<size_t>(src + n - anchor), 0, 0);
+  return op ? static_cast<size_t>(op - dst) : 0;
+}
+
+bool Lz4Decompress(const std::uint8_t* src, size_t n, std::uint8_t* dst, size_t out_n) {
+  if (!src || n == 0 || (!dst && out_n > 0)) return false;
+  const std::uint8_t*       ip   = src;
+  const std::uint8_t* const iend = src + n;
+  std::uint8_t*             op   = dst;
+  std::uint8_t* const       oend = dst + out_n;
+
+  auto get_length = [&](size_t* len) {
+    std::uint8_t b;
+    do {
+      if (ip >= iend) return false;
+      b = *ip++;
+      *len += b;
+    } while (b == 255);
+    return true;
+  };
+
+  for (;;) {
+    const std::uint8_t token = *ip++;
+    size_t lit = token >> 4;
+    if (lit == 15 && !get_length(&lit)) return false;
+    if (lit > static_cast<size_t>(iend - ip) || lit > static_cast<size_t>(oend - op)) return false;
+    if (lit) std::memcpy(op, ip, lit);
+    op += lit;
+    ip += lit;
+    if (ip == iend) break;  // 末尾序列
+
+    if (iend - ip < 2) return false;
+    const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+    ip += 2;
+    if (offset == 0 || offset > static_cast<size_t>(op - dst)) return false;
+    size_t ml = token & 15;
+    if (ml == 15 && !get_length(&ml)) return false;
+    ml += kMinMatch;
+    if (ml > static_cast<size_t>(oend - op)) return false;
+
+    const std::uint8_t* m = op - offset;
+    if (offset >= ml) {
+      std::memcpy(op, m, ml);
+    } else {
+      // 重叠复制：输出以 offset 为周期，每轮以 [m, op + done) 为源，复制量逐轮翻倍
+      for (size_t done = 0; done < ml;) {
+        const size_t c = std::min(done + offset, ml - done);
+        std::memcpy(op + done, m, c);
+        done += c;
+      }
+    }
+    op += ml;
+    if (ip >= iend) return false;  // 匹配之后必须还有末尾的字面量序列
+  }
+  return op == oend;
+}
+
+}  // namespace storage
+}  // namespace dbms
@@ -0,0 +1,189 @@
+#include "dbms/storage/metrics.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace dbms {
+namespace storage {
+
+namespace {
+
+/// 线程首次记录时领取一个分条号（轮转分配）
+size_t ThisThreadStripe() noexcept {
+  static std::atomic<size_t> next{0};
+  thread_local const size_t stripe = next.fetch_add(1, std::memory_order_relaxed) % LatencyHistogram::kStripes;
+  return stripe;
+}
+
+}  // namespace
+
+// ---------------- HistogramSnapshot ----------------
+
+uint64_t HistogramSnapshot::Percentile(double q) const noexcept {
+  if (count == 0 || buckets.empty()) return 0;
+  q = std::min(1.0, std::max(0.0, q));
+  // 第 rank 个样本（1 起）所在的格
+  const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(count) + 0.5));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= rank) return std::min(LatencyHistogram::BucketHigh(i), max);
+  }
+  return max;
+}
+
+void HistogramSnapshot::Merge(const HistogramSnapshot& o) {
+  if (buckets.size() < o.buckets.size()) buckets.resize(o.buckets.size(), 0);
+  for (size_t i = 0; i < o.buckets.size(); ++i) buckets[i] += o.buckets[i];
+  count += o.count;
+  sum   += o.sum;
+  max    = std::max(max, o.max);
+}
+
+// ---------------- LatencyHistogram ----------------
+
+LatencyHistogram::LatencyHistogram() : stripes_(new Stripe[kStripes]) { Reset(); }
+
+size_t LatencyHistogram::BucketOf(uint64_t v) noexcept {
+  if (v < static_cast<uint64_t>(kSub)) return static_cast<size_t>(v);
+  const int e = 63 - __builtin_clzll(v);
+  if (e >= kMaxExp) return kBuckets - 1;
+  const size_t group = static_cast<size_t>(e - kSubBits + 1);
+  const size_t sub   = static_cast<size_t>((v >> (e - kSubBits)) & (kSub - 1));
+  return group * kSub + sub;
+}
+
+uint64_t LatencyHistogram::BucketLow(size_t i) noexcept {
+  const size_t group = i / kSub, sub = i % kSub;
+  if (group == 0) return sub;
+  const int shift = static_cast<int>(group) - 1;
+  return static_cast<uint64_t>(kSub + sub) << shift;
+}
+
+uint64_t LatencyHistogram::BucketHigh(size_t i) noexcept {
+  const size_t group = i / kSub;
+  if (group == 0) return BucketLow(i);
+  if (i == kBuckets - 1) return UINT64_MAX;
+  return BucketLow(i) + (uint64_t{1} << (group - 1)) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t v) noexcept {
+  Stripe& s = stripes_[ThisThreadStripe()];
+  s.buckets[BucketOf(v)].fetch_add(1, std::memory_order_relaxed);
+  s.sum.fetch_add(v, std::memory_order_relaxed);
+  uint64_t m = s.max.load(std::memory_order_relaxed);
+  while (v > m && !s.max.compare_exchange_weak(m, v, std::memory_order_relaxed)) {}
+}
+
+HistogramSnapshot LatencyHistogram::Snapshot() const {
+  HistogramSnapshot out;
+  out.buckets.assign(kBuckets, 0);
+  for (size_t k = 0; k < kStripes; ++k) {
+    const Stripe& s = stripes_[k];
+    for (size_t i = 0; i < kBuckets; ++i) {
+      const uint64_t c = s.buckets[i].load(std::memory_order_relaxed);
+      out.buckets[i] += c;
+      out.count      += c;
+    }
+    out.sum += s.sum.load(std::memory_order_relaxed);
+    out.max  = std::max(out.max, s.max.load(std::memory_order_relaxed));
+  }
+  return out;
+}
+
+void LatencyHistogram::Reset() noexcept {
+  for (size_t k = 0; k < kStripes; ++k) {
+    Stripe& s = stripes_[k];
+    for (auto& b : s.buckets) b.store(0, std::memory_order_relaxed);
+    s.sum.store(0, std::memory_order_relaxed);
+    s.max.store(0, std::memory_order_relaxed);
+  }
+}
+
+// ---------------- StorageMetrics ----------------
+
+const char* MetricName(Metric m) noexcept {
+  switch (m) {
+    case Metric::kFetchHit:       return "fetch_hit";
+    case Metric::kFetchMiss:      return "fetch_miss";
+    case Metric::kEvictWriteback: return "evict_writeback";
+    case Metric::kDiskRead:       return "disk_read";
+    case Metric::kDiskWrite:      return "disk_write";
+    case Metric::kDiskSync:       return "disk_sync";
+    case Metric::kLockWait:       return "lock_wait";
+    case Metric::kReplacerScan:   return "replacer_scan";
+    case Metric::kCount:          break;
+  }
+  return "?";
+}
+
+std::string MetricsSnapshot::ToString() const {
+  std::string out;
+  char line[256];
+  for (size_t i = 0; i < hist.size(); ++i) {
+    const HistogramSnapshot& h = hist[i];
+    if (h.count == 0) continue;
+    const Metric m = static_cast<Metric>(i);
+    if (m == Metric::kReplacerScan) {
+      std::snprintf(line, sizeof(line), "%-16s count=%llu mean=%.1f p50=%llu p99=%llu p999=%llu max=%llu (frames)\n",
+                    MetricName(m), static_cast<unsigned long long>(h.count), h.Mean(),
+                    static_cast<unsigned long long>(h.Percentile(0.50)),
+                    static_cast<unsigned long long>(h.Percentile(0.99)),
+                    static_cast<unsigned long long>(h.Percentile(0.999)),
+                    static_cast<unsigned long long>(h.max));
+    } else {
+      std::snprintf(line, sizeof(line), "%-16s count=%llu mean=%.2f p50=%.2f p99=%.2f p999=%.2f max=%.2f (us)\n",
+                    MetricName(m), static_cast<unsigned long long>(h.count), h.Mean() / 1e3,
+                    h.Percentile(0.50) / 1e3, h.Percentile(0.99) / 1e3, h.Percentile(0.999) / 1e3, h.max / 1e3);
+    }
+    out += line;
+  }
+  return out;
+}
+
+StorageMetrics::StorageMetrics() : since_ns_(MetricsNowNs()) {}
+
+StorageMetrics::~StorageMetrics() { StopPeriodicDump(); }
+
+MetricsSnapshot StorageMetrics::Snapshot() const {
+  MetricsSnapshot s;
+  for (size_t i = 0; i < hist_.size(); ++i) s.hist[i] = hist_[i].Snapshot();
+  s.seconds = static_cast<double>(MetricsNowNs() - since_ns_.load(std::memory_order_relaxed)) / 1e9;
+  return s;
+}
+
+void StorageMetrics::Reset() noexcept {
+  for (auto& h : hist_) h.Reset();
+  since_ns_.store(MetricsNowNs(), std::memory_order_relaxed);
+}
+
+void StorageMetrics::StartPeriodicDump(uint32_t interval_ms, std::function<void(const MetricsSnapshot&)> sink,
+                                       bool reset_after) {
+  StopPeriodicDump();
+  if (interval_ms == 0 || !sink) return;
+  {
+    std::lock_guard<std::mutex> g(dump_mu_);
+    dump_stop_ = false;
+  }
+  dump_thread_ = std::thread([this, interval_ms, sink = std::move(sink), reset_after] {
+    std::unique_lock<std::mutex> lk(dump_mu_);
+    while (!dump_cv_.wait_for(lk, std::chrono::milliseconds(interval_ms), [&] { return dump_stop_; })) {
+      lk.unlock();
+      sink(Snapshot());
+      if (reset_after) Reset();
+      lk.lock();
+    }
+  });
+}
+
+void StorageMetrics::StopPeriodicDump() {
+  {
+    std::lock_guard<std::mutex> g(dump_mu_);
+    dump_stop_ = true;
+  }
+  dump_cv_.notify_all();
+  if (dump_thread_.joinable()) dump_thread_.join();
+}
+
+}  // namespace storage
+}  // namespace dbms
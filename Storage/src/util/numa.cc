@@ -0,0 +1,86 @@
+/**
+ * @file numa.cc
+ * @brief NUMA 辅助实现（sysfs 解析 + mbind / sched_setaffinity）。
+ */
+
+#include "internal/util/numa.h"
+
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace dbms {
+namespace storage {
+
+namespace {
+
+constexpr int kMpolPreferred = 1;  // <numaif.h> 中的 MPOL_PREFERRED（避免依赖 libnuma 头文件）
+
+/// 解析 sysfs 的列表格式（如 "0-3,8,10-11"）
+std::vector<int> ParseList(const std::string& s) {
+  std::vector<int> out;
+  std::stringstream ss(s);
+  std::string part;
+  while (std::getline(ss, part, ',')) {
+    if (part.empty()) continue;
+    const size_t dash = part.find('-');
+    try {
+      const int lo = std::stoi(part.substr(0, dash));
+      const int hi = dash == std::string::npos ? lo : std::stoi(part.substr(dash + 1));
+      for (int i = lo; i <= hi; ++i) out.push_back(i);
+    } catch (...) {
+      return {};
+    }
+  }
+  return out;
+}
+
+std::vector<int> ReadList(const std::string& path) {
+  std::ifstream in(path);
+  std::string line;
+  if (!in || !std::getline(in, line)) return {};
+  return ParseList(line);
+}
+
+}  // namespace
+
+int NumaNodeCount() {
+  const std::vector<int> nodes = ReadList("/sys/devices/system/node/online");
+  int n = 0;
+  for (int id : nodes) n = std::max(n, id + 1);
+  return n > 0 ? n : 1;
+}
+
+bool PreferNumaNode(void* addr, size_t len, int node) {
+#ifdef SYS_mbind
+  if (node < 0 || node >= 64 || len == 0) return false;
+  const unsigned long mask = 1ul << node;
+  return ::syscall(SYS_mbind, addr, len, kMpolPreferred, &mask,
+                   static_cast<unsigned long>(sizeof(mask) * 8), 0u) == 0;
+#else
+  (void)addr; (void)len; (void)node;
+  return false;
+#endif
+}
+
+bool PinThreadToNumaNode(int node) {
+  const std::vector<int> cpus =
+      ReadList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+  if (cpus.empty()) return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int c : cpus) {
+    if (c >= 0 && c < CPU_SETSIZE) CPU_SET(c, &set);
+  }
+  return ::sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+}  // namespace storage
+}  // namespace dbms
@@ -33,9 +33,12 @@ for root in "${ROOTS[@]}"; do
         [[ -z "$page"     ]] && page=$(sed -E 's/.*page_size=([0-9]+).*/\1/' <<<"$line")
         [[ -z "$frames"   ]] && frames=$(sed -E 's/.*frames=([0-9]+).*/\1/' <<<"$line")
         [[ -z "$replacer" ]] && replacer=$(sed -E 's/.*replacer=([[:alnum:]]+).*/\1/' <<<"$line")
-        [[ "$replacer" == "lruk" && -z "$kval" ]] && kval=$(sed -nE 's/.*replacer=lruk.*\(k=([0-9]+)\).*/\1/p' "$log" | head -n1)
       fi
     fi
+    # LRU-K 的 K 取自日志：新格式 replacer=lruk:k=N,crp=M，旧格式 replacer=lruk...(k=N)
+    if [[ "$replacer" == "lruk" && -z "$kval" ]]; then
+      kval=$(sed -nE 's/.*replacer=lruk:([^ ,]*,)*k=([0-9]+).*/\2/p; s/.*replacer=lruk.*\(k=([0-9]+).*/\1/p' "$log" | head -n1)
+    fi
 
     # [LOAD] done 行
     done_line=$(grep -F "[LOAD] done:" "$log" | tail -n1 || true)